@@ -0,0 +1,396 @@
+// ProdStarterHub - C++ gRPC Service
+// bench/bench_client.cpp
+// Load generator for the server (bench_client target).
+//
+// Sends one unary method as raw bytes through grpc::GenericStub, so it needs
+// no generated code and can drive any engine or service:
+//
+//   bench_client --target 127.0.0.1:50051 --mode closed --concurrency 64 --channels 4 --duration 30
+//   bench_client --mode open --rate 20000 --method /myproto.Example/MyRpc --payload-file req.bin
+//
+// Closed loop (default) keeps --concurrency calls outstanding and measures
+// each from its send. A stalled call hides the calls it held back, so with
+// --expected-interval-us the report also has HdrHistogram's
+// coordinated-omission-corrected percentiles.
+//
+// Open loop sends at a constant --rate and measures every call from its
+// intended send time. When the server falls behind, the queueing shows up in
+// the latency instead of lowering the offered load. Service time (from the
+// actual send) is reported next to it. --concurrency caps outstanding calls
+// there.
+//
+// The default method is the health check, which every engine serves. The
+// result is one JSON object on stdout (--format text for humans), labelled
+// with --label so runs against sync, async and callback engines can be
+// compared by a script.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fmt/format.h>
+#include <grpcpp/generic/generic_stub.h>
+#include <grpcpp/grpcpp.h>
+
+#include "hdr_histogram.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct BenchOptions {
+    std::string target = "127.0.0.1:50051";
+    std::string method = "/grpc.health.v1.Health/Check";
+    std::string mode = "closed"; // closed | open
+    int concurrency = 64;        // closed: calls kept outstanding; open: cap on outstanding calls
+    int channels = 4;            // separate connections; calls are spread round-robin
+    int64_t payload_bytes = 0;   // request is field 1 (bytes) of this size; ignored with --payload-file
+    std::string payload_file;    // serialized request message sent as-is
+    double rate = 0;             // open loop: calls per second
+    std::chrono::milliseconds warmup{2000};
+    std::chrono::milliseconds duration{10000};
+    std::chrono::milliseconds timeout{10000}; // per-call deadline
+    int64_t expected_interval_us = 0;         // closed loop: coordinated-omission correction; 0 disables
+    std::string label;                        // free-form tag copied into the report, e.g. the engine
+    std::string format = "json";              // json | text
+};
+
+void Usage(const char* argv0) {
+    std::fprintf(stderr,
+                 "Usage: %s [--target host:port] [--method /pkg.Service/Method] [--mode closed|open]\n"
+                 "          [--concurrency N] [--channels N] [--payload-bytes N | --payload-file PATH]\n"
+                 "          [--rate CALLS_PER_SECOND] [--warmup SECONDS] [--duration SECONDS] [--timeout-ms N]\n"
+                 "          [--expected-interval-us N] [--label TEXT] [--format json|text]\n",
+                 argv0);
+}
+
+std::chrono::milliseconds Seconds(const std::string& value) {
+    return std::chrono::milliseconds(static_cast<int64_t>(std::stod(value) * 1000));
+}
+
+// 0 = run, 1 = help, 2 = error (the exit code).
+int ParseArgs(int argc, char** argv, BenchOptions& opts) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        std::string inline_value;
+        bool has_inline = false;
+        const auto eq = arg.find('=');
+        if (arg.rfind("--", 0) == 0 && eq != std::string::npos) {
+            inline_value = arg.substr(eq + 1);
+            has_inline = true;
+            arg.resize(eq);
+        }
+        auto value = [&]() -> std::string {
+            if (has_inline) return inline_value;
+            if (i + 1 >= argc) throw std::invalid_argument("missing value");
+            return argv[++i];
+        };
+
+        try {
+            if (arg == "--target") { opts.target = value(); }
+            else if (arg == "--method") { opts.method = value(); }
+            else if (arg == "--mode") { opts.mode = value(); }
+            else if (arg == "--concurrency") { opts.concurrency = std::stoi(value()); }
+            else if (arg == "--channels") { opts.channels = std::stoi(value()); }
+            else if (arg == "--payload-bytes") { opts.payload_bytes = std::stoll(value()); }
+            else if (arg == "--payload-file") { opts.payload_file = value(); }
+            else if (arg == "--rate") { opts.rate = std::stod(value()); }
+            else if (arg == "--warmup") { opts.warmup = Seconds(value()); }
+            else if (arg == "--duration") { opts.duration = Seconds(value()); }
+            else if (arg == "--timeout-ms") { opts.timeout = std::chrono::milliseconds(std::stoll(value())); }
+            else if (arg == "--expected-interval-us") { opts.expected_interval_us = std::stoll(value()); }
+            else if (arg == "--label") { opts.label = value(); }
+            else if (arg == "--format") { opts.format = value(); }
+            else if (arg == "--help") { return 1; }
+            else {
+                std::fprintf(stderr, "unknown flag %s\n", arg.c_str());
+                return 2;
+            }
+        } catch (const std::exception& ex) {
+            std::fprintf(stderr, "invalid value for %s: %s\n", arg.c_str(), ex.what());
+            return 2;
+        }
+    }
+
+    std::vector<std::string> errors;
+    if (opts.mode != "closed" && opts.mode != "open") errors.push_back("mode must be closed or open");
+    if (opts.mode == "open" && opts.rate <= 0) errors.push_back("open loop needs --rate > 0");
+    if (opts.concurrency < 1) errors.push_back("concurrency must be at least 1");
+    if (opts.channels < 1) errors.push_back("channels must be at least 1");
+    if (opts.payload_bytes < 0) errors.push_back("payload bytes must not be negative");
+    if (opts.duration.count() <= 0) errors.push_back("duration must be positive");
+    if (opts.format != "json" && opts.format != "text") errors.push_back("format must be json or text");
+    for (const auto& error : errors) std::fprintf(stderr, "invalid configuration: %s\n", error.c_str());
+    return errors.empty() ? 0 : 2;
+}
+
+// Field 1, wire type 2: a bytes or string field most request messages start with.
+std::string MakePayload(int64_t size) {
+    if (size == 0) return {};
+    std::string payload(1, '\x0a');
+    for (uint64_t n = static_cast<uint64_t>(size); ; n >>= 7) {
+        if (n < 0x80) {
+            payload.push_back(static_cast<char>(n));
+            break;
+        }
+        payload.push_back(static_cast<char>((n & 0x7f) | 0x80));
+    }
+    payload.append(static_cast<size_t>(size), 'x');
+    return payload;
+}
+
+// `s` escaped for a JSON string, as the server's JSON log formatter does.
+std::string JsonEscape(const std::string& s) {
+    static constexpr char kHex[] = "0123456789abcdef";
+    std::string out;
+    for (char c : s) {
+        switch (c) {
+        case '"': out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\n': out += "\\n"; break;
+        case '\r': out += "\\r"; break;
+        case '\t': out += "\\t"; break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                out += {'\\', 'u', '0', '0', kHex[(c >> 4) & 0xf], kHex[c & 0xf]};
+            } else {
+                out.push_back(c);
+            }
+        }
+    }
+    return out;
+}
+
+// The request to send: --payload-file as-is, otherwise a generated one. False when the file cannot be read.
+bool LoadPayload(const BenchOptions& opts, std::string* payload) {
+    if (opts.payload_file.empty()) {
+        *payload = MakePayload(opts.payload_bytes);
+        return true;
+    }
+    std::ifstream in(opts.payload_file, std::ios::binary);
+    if (!in) return false;
+    payload->assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    return !in.bad();
+}
+
+int64_t ToNs(Clock::time_point t) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(t.time_since_epoch()).count();
+}
+
+// Histograms and counters for one closed-loop slot or one open-loop stripe.
+struct Recorder {
+    std::mutex mu; // open loop only; a closed-loop slot completes one call at a time
+    prodstarter::HdrHistogram latency;
+    prodstarter::HdrHistogram secondary; // corrected latency (closed) or service time (open)
+    std::map<int, int64_t> codes;
+};
+
+class LoadRun {
+public:
+    LoadRun(const BenchOptions& opts, const std::string& payload) : opts_(opts), recorders_(opts.concurrency) {
+        payload_size_ = payload.size();
+        grpc::Slice slice(payload);
+        request_ = grpc::ByteBuffer(&slice, 1);
+
+        for (int i = 0; i < opts_.channels; ++i) {
+            grpc::ChannelArguments args;
+            args.SetInt(GRPC_ARG_USE_LOCAL_SUBCHANNEL_POOL, 1); // one connection per channel
+            stubs_.push_back(std::make_unique<grpc::GenericStub>(
+                grpc::CreateCustomChannel(opts_.target, grpc::InsecureChannelCredentials(), args)));
+        }
+    }
+
+    void Run() {
+        start_ = Clock::now();
+        measure_from_ = start_ + opts_.warmup;
+        end_ = measure_from_ + opts_.duration;
+        if (opts_.mode == "closed") {
+            for (int slot = 0; slot < opts_.concurrency; ++slot) Issue(slot, Clock::now());
+            std::this_thread::sleep_until(end_);
+        } else {
+            Pace();
+        }
+        stopping_.store(true);
+        std::unique_lock<std::mutex> lock(mu_);
+        idle_.wait_for(lock, opts_.timeout + std::chrono::seconds(1), [this] { return outstanding_ == 0; });
+    }
+
+    void Report() const;
+
+private:
+    struct Call {
+        grpc::ClientContext ctx;
+        grpc::ByteBuffer response;
+        Clock::time_point intended;
+        Clock::time_point sent;
+        int slot;
+    };
+
+    void Issue(int slot, Clock::time_point intended) {
+        {
+            std::lock_guard<std::mutex> lock(mu_);
+            ++outstanding_;
+        }
+        auto* call = new Call;
+        call->slot = slot;
+        call->intended = intended;
+        call->sent = Clock::now();
+        call->ctx.set_deadline(std::chrono::system_clock::now() + opts_.timeout);
+        auto& stub = *stubs_[next_stub_.fetch_add(1, std::memory_order_relaxed) % stubs_.size()];
+        stub.UnaryCall(&call->ctx, opts_.method, grpc::StubOptions(), &request_, &call->response,
+                       [this, call](grpc::Status status) { Done(call, status); });
+    }
+
+    void Done(Call* call, const grpc::Status& status) {
+        const auto now = Clock::now();
+        const int slot = call->slot;
+        // Calls belong to the window they were meant to start in, however late they finish.
+        if (call->intended >= measure_from_ && call->intended < end_) {
+            Recorder& rec = recorders_[slot];
+            const int64_t from_intended = ToNs(now) - ToNs(call->intended);
+            const int64_t from_send = ToNs(now) - ToNs(call->sent);
+            std::lock_guard<std::mutex> lock(rec.mu);
+            if (opts_.mode == "closed") {
+                rec.latency.Record(from_send);
+                if (opts_.expected_interval_us > 0) {
+                    rec.secondary.RecordCorrected(from_send, opts_.expected_interval_us * 1000);
+                }
+            } else {
+                rec.latency.Record(from_intended);
+                rec.secondary.Record(from_send);
+            }
+            ++rec.codes[status.error_code()];
+        }
+        delete call;
+
+        if (opts_.mode == "closed" && !stopping_.load() && now < end_) Issue(slot, now);
+        std::lock_guard<std::mutex> lock(mu_);
+        if (--outstanding_ == 0) idle_.notify_all();
+        if (opts_.mode == "open") slot_free_.notify_one();
+    }
+
+    // Open loop: issues call i at start + i / rate, whether or not earlier ones finished.
+    void Pace() {
+        const auto period = std::chrono::duration<double>(1.0 / opts_.rate);
+        for (int64_t i = 0;; ++i) {
+            const auto intended = start_ + std::chrono::duration_cast<Clock::duration>(period * static_cast<double>(i));
+            if (intended >= end_) break;
+            std::this_thread::sleep_until(intended);
+            {
+                // Keeps its intended time while it waits, so the wait counts as latency.
+                std::unique_lock<std::mutex> lock(mu_);
+                slot_free_.wait(lock, [this] { return outstanding_ < opts_.concurrency; });
+            }
+            Issue(static_cast<int>(i % opts_.concurrency), intended);
+        }
+    }
+
+    const BenchOptions& opts_;
+    grpc::ByteBuffer request_;
+    size_t payload_size_ = 0;
+    std::vector<std::unique_ptr<grpc::GenericStub>> stubs_;
+    std::atomic<size_t> next_stub_{0};
+    mutable std::vector<Recorder> recorders_;
+
+    Clock::time_point start_, measure_from_, end_;
+    std::atomic<bool> stopping_{false};
+    std::mutex mu_;
+    std::condition_variable idle_;
+    std::condition_variable slot_free_;
+    int outstanding_ = 0;
+};
+
+std::string Percentiles(const prodstarter::HdrHistogram& h, bool json) {
+    auto us = [](int64_t ns) { return static_cast<double>(ns) / 1000.0; };
+    if (json) {
+        return fmt::format("{{\"p50\":{:.1f},\"p90\":{:.1f},\"p99\":{:.1f},\"p999\":{:.1f},\"p9999\":{:.1f},"
+                           "\"max\":{:.1f},\"mean\":{:.1f}}}",
+                           us(h.ValueAtPercentile(50)), us(h.ValueAtPercentile(90)), us(h.ValueAtPercentile(99)),
+                           us(h.ValueAtPercentile(99.9)), us(h.ValueAtPercentile(99.99)), us(h.max()),
+                           h.mean() / 1000.0);
+    }
+    return fmt::format("p50={:.1f} p90={:.1f} p99={:.1f} p99.9={:.1f} p99.99={:.1f} max={:.1f} mean={:.1f} (us)",
+                       us(h.ValueAtPercentile(50)), us(h.ValueAtPercentile(90)), us(h.ValueAtPercentile(99)),
+                       us(h.ValueAtPercentile(99.9)), us(h.ValueAtPercentile(99.99)), us(h.max()), h.mean() / 1000.0);
+}
+
+void LoadRun::Report() const {
+    prodstarter::HdrHistogram latency;
+    prodstarter::HdrHistogram secondary;
+    std::map<int, int64_t> codes;
+    for (auto& rec : recorders_) {
+        std::lock_guard<std::mutex> lock(rec.mu);
+        latency.Merge(rec.latency);
+        secondary.Merge(rec.secondary);
+        for (const auto& [code, n] : rec.codes) codes[code] += n;
+    }
+    int64_t errors = 0;
+    for (const auto& [code, n] : codes) {
+        if (code != 0) errors += n;
+    }
+    const double seconds = std::chrono::duration<double>(opts_.duration).count();
+    const double throughput = static_cast<double>(latency.count()) / seconds;
+    const bool closed = opts_.mode == "closed";
+    const char* secondary_name = closed ? "corrected_latency_us" : "service_time_us";
+    const bool has_secondary = !closed || opts_.expected_interval_us > 0;
+
+    if (opts_.format == "json") {
+        std::string code_json;
+        for (const auto& [code, n] : codes) {
+            code_json += fmt::format("{}\"{}\":{}", code_json.empty() ? "" : ",", code, n);
+        }
+        std::string out = fmt::format(
+            "{{\"label\":\"{}\",\"target\":\"{}\",\"method\":\"{}\",\"mode\":\"{}\",\"concurrency\":{},"
+            "\"channels\":{},\"payload_bytes\":{},\"rate\":{},\"duration_s\":{:.3f},\"requests\":{},\"errors\":{},"
+            "\"throughput_rps\":{:.1f},\"latency_us\":{}",
+            JsonEscape(opts_.label), JsonEscape(opts_.target), JsonEscape(opts_.method), opts_.mode, opts_.concurrency,
+            opts_.channels, payload_size_, opts_.rate, seconds, latency.count(), errors, throughput,
+            Percentiles(latency, true));
+        if (has_secondary) out += fmt::format(",\"{}\":{}", secondary_name, Percentiles(secondary, true));
+        out += fmt::format(",\"status_codes\":{{{}}}}}", code_json);
+        std::printf("%s\n", out.c_str());
+        return;
+    }
+    std::printf("%s %s loop against %s %s: %d outstanding, %d channels, %zu byte requests\n",
+                opts_.label.empty() ? "bench" : opts_.label.c_str(), opts_.mode.c_str(), opts_.target.c_str(),
+                opts_.method.c_str(), opts_.concurrency, opts_.channels, payload_size_);
+    std::printf("  requests=%lld errors=%lld throughput=%.1f/s\n", static_cast<long long>(latency.count()),
+                static_cast<long long>(errors), throughput);
+    std::printf("  latency:   %s\n", Percentiles(latency, false).c_str());
+    if (has_secondary) {
+        std::printf("  %s %s\n", closed ? "corrected:" : "service:  ", Percentiles(secondary, false).c_str());
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    BenchOptions opts;
+    const int parsed = ParseArgs(argc, argv, opts);
+    if (parsed != 0) {
+        Usage(argv[0]);
+        return parsed == 1 ? 0 : 2;
+    }
+    std::string payload;
+    if (!LoadPayload(opts, &payload)) {
+        std::fprintf(stderr, "cannot read payload file %s\n", opts.payload_file.c_str());
+        return 2;
+    }
+    LoadRun run(opts, payload);
+    run.Run();
+    run.Report();
+    return 0;
+}
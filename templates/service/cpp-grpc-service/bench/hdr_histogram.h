@@ -0,0 +1,116 @@
+// ProdStarterHub - C++ gRPC Service
+// bench/hdr_histogram.h
+// High-dynamic-range latency histogram for the load generator.
+//
+// Same bucket layout as HdrHistogram: values are kept to three significant
+// digits from 1 ns up to an hour, so p99.99 of a 40 us call is as exact as the
+// max of a 30 s stall, and recording is one index computation and an add.
+//
+// RecordCorrected() applies HdrHistogram's coordinated-omission correction
+// for closed-loop runs: a call that took N expected intervals also stands in
+// for the calls that would have been sent, and stalled, while it was blocking
+// its slot. Open-loop runs measure from the intended send time instead and
+// record plain values.
+//
+// Not thread-safe; keep one per thread (or lock) and Merge() at the end.
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace prodstarter {
+
+class HdrHistogram {
+public:
+    static constexpr int kSubBucketHalfCountMagnitude = 10; // 3 significant digits: 2048 sub-buckets
+    static constexpr int64_t kSubBucketCount = int64_t{1} << (kSubBucketHalfCountMagnitude + 1);
+    static constexpr int64_t kSubBucketHalfCount = kSubBucketCount / 2;
+    static constexpr int64_t kSubBucketMask = kSubBucketCount - 1;
+    static constexpr int64_t kHighestTrackable = int64_t{3600} * 1000 * 1000 * 1000; // 1 h in ns
+
+    HdrHistogram() {
+        int buckets = 1;
+        for (int64_t smallest_untrackable = kSubBucketCount; smallest_untrackable <= kHighestTrackable;
+             smallest_untrackable <<= 1) {
+            ++buckets;
+        }
+        counts_.assign(static_cast<size_t>(buckets + 1) * kSubBucketHalfCount, 0);
+    }
+
+    // Values above the trackable range are clamped to it.
+    void Record(int64_t value, int64_t count = 1) {
+        value = std::clamp<int64_t>(value, 0, kHighestTrackable);
+        counts_[IndexOf(value)] += count;
+        total_ += count;
+        min_ = std::min(min_, value);
+        max_ = std::max(max_, value);
+        sum_ += static_cast<double>(value) * static_cast<double>(count);
+    }
+
+    // Records `value` plus the samples a closed loop missed while it was
+    // blocked: value - interval, value - 2 * interval, ... down to `interval`.
+    void RecordCorrected(int64_t value, int64_t expected_interval) {
+        Record(value);
+        if (expected_interval <= 0 || value <= expected_interval) return;
+        for (int64_t missing = value - expected_interval; missing >= expected_interval; missing -= expected_interval) {
+            Record(missing);
+        }
+    }
+
+    void Merge(const HdrHistogram& other) {
+        for (size_t i = 0; i < counts_.size(); ++i) counts_[i] += other.counts_[i];
+        total_ += other.total_;
+        min_ = std::min(min_, other.min_);
+        max_ = std::max(max_, other.max_);
+        sum_ += other.sum_;
+    }
+
+    // Highest value equivalent to the `percentile`-th (0..100) sample.
+    int64_t ValueAtPercentile(double percentile) const {
+        if (total_ == 0) return 0;
+        const double fraction = std::clamp(percentile, 0.0, 100.0) / 100.0;
+        const int64_t rank =
+            std::max<int64_t>(1, static_cast<int64_t>(std::ceil(fraction * static_cast<double>(total_))));
+        int64_t seen = 0;
+        for (size_t i = 0; i < counts_.size(); ++i) {
+            seen += counts_[i];
+            if (seen >= rank) return std::min(HighestEquivalent(static_cast<int64_t>(i)), max_);
+        }
+        return max_;
+    }
+
+    int64_t count() const { return total_; }
+    int64_t min() const { return total_ > 0 ? min_ : 0; }
+    int64_t max() const { return max_; }
+    double mean() const { return total_ > 0 ? sum_ / static_cast<double>(total_) : 0.0; }
+
+private:
+    static size_t IndexOf(int64_t value) {
+        const int pow2_ceiling = 64 - __builtin_clzll(static_cast<uint64_t>(value | kSubBucketMask));
+        const int bucket = pow2_ceiling - (kSubBucketHalfCountMagnitude + 1);
+        const int64_t sub_bucket = value >> bucket;
+        return static_cast<size_t>(((int64_t{bucket} + 1) << kSubBucketHalfCountMagnitude) +
+                                   (sub_bucket - kSubBucketHalfCount));
+    }
+
+    static int64_t HighestEquivalent(int64_t index) {
+        int64_t bucket = (index >> kSubBucketHalfCountMagnitude) - 1;
+        int64_t sub_bucket = (index & (kSubBucketHalfCount - 1)) + kSubBucketHalfCount;
+        if (bucket < 0) {
+            sub_bucket -= kSubBucketHalfCount;
+            bucket = 0;
+        }
+        return ((sub_bucket + 1) << bucket) - 1;
+    }
+
+    std::vector<int64_t> counts_;
+    int64_t total_ = 0;
+    int64_t min_ = INT64_MAX;
+    int64_t max_ = 0;
+    double sum_ = 0.0;
+};
+
+} // namespace prodstarter
@@ -0,0 +1,217 @@
+// ProdStarterHub - C++ gRPC Service
+// bench/microbench.cpp
+// Google Benchmark suite for the server's hot paths (microbench target).
+//
+// Covers what every call pays for outside the handler: the bookkeeping the
+// interceptors do (call-context registry, RPC metrics, phase breakdown,
+// limiter), response-cache keys and lookups, coalescing, executor handoff and
+// protobuf parse/serialize with and without pooled arenas. Interceptors are
+// measured through the component calls they make, since gRPC only builds the
+// interceptor batch objects inside a live call.
+//
+//   microbench --benchmark_format=json --benchmark_out=microbench.json
+//
+// Run on an idle machine and compare JSON from two builds with Google
+// Benchmark's tools/compare.py to catch regressions between releases.
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <google/protobuf/arena.h>
+#include <google/protobuf/wrappers.pb.h>
+#include <grpcpp/grpcpp.h>
+#include <grpcpp/impl/codegen/proto_utils.h>
+
+#include "cache/response_cache.h"
+#include "cache/singleflight.h"
+#include "call/call_context.h"
+#include "engine/arena_pool.h"
+#include "exec/executor.h"
+#include "metrics/latency_breakdown.h"
+#include "metrics/rpc_metrics.h"
+#include "overload/concurrency_limiter.h"
+
+namespace {
+
+using prodstarter::CallContext;
+
+grpc::ByteBuffer MakeBuffer(size_t size) {
+    grpc::Slice slice(std::string(size, 'x'));
+    return grpc::ByteBuffer(&slice, 1);
+}
+
+grpc::ByteBuffer Serialize(const google::protobuf::MessageLite& message) {
+    grpc::ByteBuffer buffer;
+    bool own_buffer = false;
+    (void)grpc::GenericSerialize<grpc::ProtoBufferWriter, google::protobuf::MessageLite>(message, &buffer, &own_buffer);
+    return buffer;
+}
+
+// ---- Interceptor bookkeeping ----
+
+void BM_CallContextRegistry(benchmark::State& state) {
+    grpc::ServerContext ctx;
+    for (auto _ : state) {
+        CallContext call;
+        prodstarter::RegisterCallContext(&ctx, &call);
+        call.Stamp(CallContext::Mark::kDispatched);
+        benchmark::DoNotOptimize(prodstarter::FindCallContext(&ctx));
+        prodstarter::UnregisterCallContext(&ctx);
+    }
+}
+BENCHMARK(BM_CallContextRegistry)->ThreadRange(1, 8)->UseRealTime();
+
+void BM_RpcMetricsRecord(benchmark::State& state) {
+    static prodstarter::RpcMetrics metrics;
+    for (auto _ : state) {
+        metrics.Record("/myproto.Example/MyRpc", grpc::StatusCode::OK, std::chrono::microseconds(250));
+    }
+}
+BENCHMARK(BM_RpcMetricsRecord)->ThreadRange(1, 8)->UseRealTime();
+
+void BM_LatencyBreakdownRecord(benchmark::State& state) {
+    static prodstarter::LatencyBreakdown latency(32);
+    CallContext call;
+    call.Stamp(CallContext::Mark::kDispatched);
+    call.Stamp(CallContext::Mark::kHandlerDone);
+    call.Stamp(CallContext::Mark::kSerialized);
+    for (auto _ : state) {
+        latency.Record("/myproto.Example/MyRpc", grpc::StatusCode::OK, call, CallContext::NowNs());
+    }
+}
+BENCHMARK(BM_LatencyBreakdownRecord)->ThreadRange(1, 8)->UseRealTime();
+
+void BM_LimiterAcquireRelease(benchmark::State& state) {
+    static prodstarter::ConcurrencyLimiter limiter([] {
+        prodstarter::LimiterOptions options;
+        options.max_limit = options.initial_limit = 1 << 20; // measure admission, not rejection
+        return options;
+    }());
+    for (auto _ : state) {
+        auto* limit = limiter.LimitFor("/myproto.Example/MyRpc");
+        if (limiter.TryAcquire(limit)) {
+            limiter.Release(limit, std::chrono::microseconds(250), grpc::StatusCode::OK, true);
+        }
+    }
+}
+BENCHMARK(BM_LimiterAcquireRelease)->ThreadRange(1, 8)->UseRealTime();
+
+// ---- Response cache and coalescing ----
+
+void BM_ResponseCacheMakeKey(benchmark::State& state) {
+    const prodstarter::CachePolicy policy{"/myproto.Example/Lookup", std::chrono::seconds(5), {}};
+    grpc::ServerContext ctx;
+    const grpc::ByteBuffer request = MakeBuffer(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(prodstarter::ResponseCache::MakeKey(policy, ctx, request));
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ResponseCacheMakeKey)->Range(16, 16 << 10);
+
+void BM_ResponseCacheHit(benchmark::State& state) {
+    static prodstarter::ResponseCache cache(64 << 20);
+    static const int primed = [] {
+        for (int i = 0; i < 1024; ++i) cache.Insert("key-" + std::to_string(i), MakeBuffer(256), std::chrono::hours(1));
+        return 0;
+    }();
+    benchmark::DoNotOptimize(primed);
+    const std::string key = "key-" + std::to_string(state.thread_index() % 1024);
+    grpc::ByteBuffer response;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(cache.Lookup(key, &response));
+    }
+}
+BENCHMARK(BM_ResponseCacheHit)->ThreadRange(1, 8)->UseRealTime();
+
+void BM_ResponseCacheInsert(benchmark::State& state) {
+    prodstarter::ResponseCache cache(1 << 20); // small enough to keep evicting
+    const grpc::ByteBuffer response = MakeBuffer(256);
+    int64_t i = 0;
+    for (auto _ : state) {
+        cache.Insert("key-" + std::to_string(i++), response, std::chrono::hours(1));
+    }
+}
+BENCHMARK(BM_ResponseCacheInsert);
+
+void BM_SingleflightLead(benchmark::State& state) {
+    static prodstarter::Singleflight flights;
+    const std::string key = "key-" + std::to_string(state.thread_index());
+    const grpc::ByteBuffer response = MakeBuffer(256);
+    grpc::ByteBuffer unused;
+    for (auto _ : state) {
+        // Nobody else is in flight for this key, so every call leads.
+        if (!flights.Join(key, std::chrono::system_clock::time_point::max(), std::chrono::seconds(1), &unused,
+                          [](const grpc::Status&) {})) {
+            flights.Finish(key, grpc::Status::OK, response);
+        }
+    }
+}
+BENCHMARK(BM_SingleflightLead)->ThreadRange(1, 8)->UseRealTime();
+
+// ---- Executor ----
+
+void BM_ExecutorPostBatch(benchmark::State& state) {
+    prodstarter::Executor executor(static_cast<int>(state.range(0)), "bench");
+    constexpr int kBatch = 1024;
+    for (auto _ : state) {
+        std::atomic<int> pending{kBatch};
+        for (int i = 0; i < kBatch; ++i) {
+            executor.Post([&pending] { pending.fetch_sub(1, std::memory_order_release); });
+        }
+        while (pending.load(std::memory_order_acquire) > 0) {
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * kBatch);
+    executor.Shutdown();
+}
+BENCHMARK(BM_ExecutorPostBatch)->Arg(1)->Arg(4)->Arg(8)->UseRealTime();
+
+// ---- Serialization ----
+
+void BM_Serialize(benchmark::State& state) {
+    google::protobuf::StringValue message;
+    message.set_value(std::string(static_cast<size_t>(state.range(0)), 'x'));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Serialize(message));
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Serialize)->Range(16, 64 << 10);
+
+void BM_ParseHeap(benchmark::State& state) {
+    google::protobuf::StringValue source;
+    source.set_value(std::string(static_cast<size_t>(state.range(0)), 'x'));
+    const grpc::ByteBuffer wire = Serialize(source);
+    for (auto _ : state) {
+        grpc::ByteBuffer buffer = wire;
+        google::protobuf::StringValue message;
+        benchmark::DoNotOptimize(
+            grpc::GenericDeserialize<grpc::ProtoBufferReader, google::protobuf::StringValue>(&buffer, &message));
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ParseHeap)->Range(16, 64 << 10);
+
+void BM_ParseArena(benchmark::State& state) {
+    prodstarter::ArenaPool pool;
+    google::protobuf::StringValue source;
+    source.set_value(std::string(static_cast<size_t>(state.range(0)), 'x'));
+    const grpc::ByteBuffer wire = Serialize(source);
+    for (auto _ : state) {
+        grpc::ByteBuffer buffer = wire;
+        prodstarter::ArenaPool::Lease arena = pool.Acquire();
+        auto* message = google::protobuf::Arena::CreateMessage<google::protobuf::StringValue>(arena.get());
+        benchmark::DoNotOptimize(
+            grpc::GenericDeserialize<grpc::ProtoBufferReader, google::protobuf::StringValue>(&buffer, message));
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ParseArena)->Range(16, 64 << 10);
+
+} // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,266 @@
+// ProdStarterHub - C++ gRPC Service
+// src/admin/admin_service.cpp
+
+#include "admin/admin_service.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <string_view>
+
+#include <grpcpp/impl/codegen/proto_utils.h>
+#include <grpcpp/impl/rpc_service_method.h>
+#include <grpcpp/support/method_handler.h>
+#include <spdlog/fmt/fmt.h>
+#include <spdlog/spdlog.h>
+
+#include "config/runtime_config.h"
+#include "memory/allocator.h"
+#include "metrics/latency_breakdown.h"
+#include "profiling/profiler.h"
+
+namespace prodstarter {
+
+namespace {
+
+void AppendJsonString(std::string& out, std::string_view value) {
+    out.push_back('"');
+    for (char c : value) {
+        switch (c) {
+        case '"': out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\n': out += "\\n"; break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                out += fmt::format("\\u{:04x}", static_cast<int>(c));
+            } else {
+                out.push_back(c);
+            }
+        }
+    }
+    out.push_back('"');
+}
+
+// Compares in time independent of where the strings differ, so the token cannot be guessed byte by byte.
+bool ConstantTimeEquals(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) return false;
+    unsigned char diff = 0;
+    for (size_t i = 0; i < a.size(); ++i) diff |= static_cast<unsigned char>(a[i] ^ b[i]);
+    return diff == 0;
+}
+
+std::string ProfileJson(const ProfileResult& result, bool cpu) {
+    std::string json = "{\"path\":";
+    AppendJsonString(json, result.path);
+    json += ",\"format\":";
+    AppendJsonString(json, result.format);
+    if (cpu) {
+        json += fmt::format(",\"samples\":{},\"dropped\":{},\"seconds\":{:.3f}", result.samples, result.dropped,
+                            result.seconds);
+    }
+    json.push_back('}');
+    return json;
+}
+
+std::string RuntimeConfigJson(const RuntimeConfig& config) {
+    std::string json = fmt::format("{{\"version\":{},\"source\":", config.version);
+    AppendJsonString(json, config.source);
+    json += fmt::format(",\"executor_threads\":{},\"limiter_min\":{},\"limiter_max\":{},"
+                        "\"response_cache_bytes\":{}",
+                        config.executor_threads, config.limiter_min, config.limiter_max, config.response_cache_bytes);
+    json += ",\"log_level\":";
+    AppendJsonString(json, config.log_level);
+    json += fmt::format(",\"log_sample_rate\":{}}}", config.log_sample_rate);
+    return json;
+}
+
+} // namespace
+
+bool ReadAdminToken(const std::string& path, std::string* token, std::string* error) {
+    std::ifstream in(path);
+    if (!in) {
+        *error = fmt::format("cannot read admin token file {}", path);
+        return false;
+    }
+    std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    const size_t first = text.find_first_not_of(" \t\r\n");
+    if (first == std::string::npos) {
+        *error = fmt::format("admin token file {} is empty", path);
+        return false;
+    }
+    *token = text.substr(first, text.find_last_not_of(" \t\r\n") - first + 1);
+    return true;
+}
+
+AdminService::AdminService(const LatencyBreakdown* latency, Profiler* profiler, RuntimeConfigStore* runtime,
+                           std::string token)
+    : latency_(latency), profiler_(profiler), runtime_(runtime), token_(std::move(token)) {
+    AddMethod(new grpc::internal::RpcServiceMethod(
+        kSlowCallsMethod, grpc::internal::RpcMethod::NORMAL_RPC,
+        new grpc::internal::RpcMethodHandler<AdminService, google::protobuf::Empty, google::protobuf::StringValue,
+                                             google::protobuf::MessageLite, google::protobuf::MessageLite>(
+            [](AdminService* service, grpc::ServerContext* ctx, const google::protobuf::Empty* request,
+               google::protobuf::StringValue* response) { return service->SlowCalls(ctx, request, response); },
+            this)));
+    AddMethod(new grpc::internal::RpcServiceMethod(
+        kPurgeMemoryMethod, grpc::internal::RpcMethod::NORMAL_RPC,
+        new grpc::internal::RpcMethodHandler<AdminService, google::protobuf::Empty, google::protobuf::StringValue,
+                                             google::protobuf::MessageLite, google::protobuf::MessageLite>(
+            [](AdminService* service, grpc::ServerContext* ctx, const google::protobuf::Empty* request,
+               google::protobuf::StringValue* response) { return service->PurgeMemory(ctx, request, response); },
+            this)));
+    AddMethod(new grpc::internal::RpcServiceMethod(
+        kCpuProfileMethod, grpc::internal::RpcMethod::NORMAL_RPC,
+        new grpc::internal::RpcMethodHandler<AdminService, google::protobuf::Int32Value, google::protobuf::StringValue,
+                                             google::protobuf::MessageLite, google::protobuf::MessageLite>(
+            [](AdminService* service, grpc::ServerContext* ctx, const google::protobuf::Int32Value* request,
+               google::protobuf::StringValue* response) { return service->CpuProfile(ctx, request, response); },
+            this)));
+    AddMethod(new grpc::internal::RpcServiceMethod(
+        kHeapProfileMethod, grpc::internal::RpcMethod::NORMAL_RPC,
+        new grpc::internal::RpcMethodHandler<AdminService, google::protobuf::Empty, google::protobuf::StringValue,
+                                             google::protobuf::MessageLite, google::protobuf::MessageLite>(
+            [](AdminService* service, grpc::ServerContext* ctx, const google::protobuf::Empty* request,
+               google::protobuf::StringValue* response) { return service->HeapProfile(ctx, request, response); },
+            this)));
+    AddMethod(new grpc::internal::RpcServiceMethod(
+        kReconfigureMethod, grpc::internal::RpcMethod::NORMAL_RPC,
+        new grpc::internal::RpcMethodHandler<AdminService, google::protobuf::StringValue,
+                                             google::protobuf::StringValue, google::protobuf::MessageLite,
+                                             google::protobuf::MessageLite>(
+            [](AdminService* service, grpc::ServerContext* ctx, const google::protobuf::StringValue* request,
+               google::protobuf::StringValue* response) { return service->Reconfigure(ctx, request, response); },
+            this)));
+}
+
+grpc::Status AdminService::Authorize(const grpc::ServerContext& ctx, const char* method, bool privileged) const {
+    if (token_.empty()) {
+        if (!privileged) return grpc::Status::OK;
+        return grpc::Status(grpc::StatusCode::PERMISSION_DENIED,
+                            fmt::format("{} requires --admin-token-file", method));
+    }
+    constexpr std::string_view kBearer = "Bearer ";
+    const auto& metadata = ctx.client_metadata();
+    const auto header = metadata.find("authorization");
+    if (header != metadata.end()) {
+        const std::string_view value(header->second.data(), header->second.size());
+        if (value.substr(0, kBearer.size()) == kBearer && ConstantTimeEquals(value.substr(kBearer.size()), token_)) {
+            return grpc::Status::OK;
+        }
+    }
+    spdlog::warn("Admin: rejected unauthenticated call to {} from {}", method, ctx.peer());
+    return grpc::Status(grpc::StatusCode::UNAUTHENTICATED, "missing or wrong admin bearer token");
+}
+
+grpc::Status AdminService::SlowCalls(grpc::ServerContext* ctx, const google::protobuf::Empty*,
+                                     google::protobuf::StringValue* response) {
+    if (grpc::Status status = Authorize(*ctx, kSlowCallsMethod, false); !status.ok()) return status;
+    std::string json = "{\"calls\":[";
+    if (latency_ != nullptr) {
+        bool first = true;
+        for (const auto& call : latency_->SlowCalls()) {
+            if (!first) json.push_back(',');
+            first = false;
+            json += "{\"method\":";
+            AppendJsonString(json, call.method);
+            json += fmt::format(",\"code\":{},\"start_unix_us\":{},\"total_us\":{}", static_cast<int>(call.code),
+                                call.start_unix_us, call.total_us);
+            for (size_t i = 0; i < LatencyBreakdown::kNumPhases; ++i) {
+                json += fmt::format(",\"{}_us\":{}", LatencyBreakdown::PhaseName(static_cast<LatencyBreakdown::Phase>(i)),
+                                    call.phase_us[i]);
+            }
+            json.push_back('}');
+        }
+    }
+    json += fmt::format("],\"capacity\":{},\"window_s\":{}}}", latency_ != nullptr ? latency_->slow_call_capacity() : 0,
+                        latency_ != nullptr ? latency_->slow_call_window().count() : 0);
+    response->set_value(std::move(json));
+    return grpc::Status::OK;
+}
+
+grpc::Status AdminService::PurgeMemory(grpc::ServerContext* ctx, const google::protobuf::Empty*,
+                                       google::protobuf::StringValue* response) {
+    if (grpc::Status status = Authorize(*ctx, kPurgeMemoryMethod, false); !status.ok()) return status;
+    const AllocatorStats before = GetAllocatorStats();
+    PurgeAllocator();
+    const AllocatorStats after = GetAllocatorStats();
+    const uint64_t released = before.process_resident > after.process_resident
+        ? before.process_resident - after.process_resident : 0;
+    spdlog::info("Admin/PurgeMemory: {} released {} bytes (RSS {} -> {})", after.allocator, released,
+                 before.process_resident, after.process_resident);
+
+    std::string json = "{\"allocator\":";
+    AppendJsonString(json, after.allocator);
+    json += fmt::format(",\"resident_before\":{},\"resident_after\":{},\"process_resident_before\":{},"
+                        "\"process_resident_after\":{},\"released\":{}}}",
+                        before.resident, after.resident, before.process_resident, after.process_resident, released);
+    response->set_value(std::move(json));
+    return grpc::Status::OK;
+}
+
+grpc::Status AdminService::CpuProfile(grpc::ServerContext* ctx, const google::protobuf::Int32Value* request,
+                                      google::protobuf::StringValue* response) {
+    if (grpc::Status status = Authorize(*ctx, kCpuProfileMethod, true); !status.ok()) return status;
+    if (profiler_ == nullptr) {
+        return grpc::Status(grpc::StatusCode::FAILED_PRECONDITION, "profiling is off (--profile-dir)");
+    }
+    if (request->value() < 0) {
+        return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "seconds must be >= 0");
+    }
+    if (profiler_->busy()) {
+        return grpc::Status(grpc::StatusCode::RESOURCE_EXHAUSTED, "a CPU profile is already being captured");
+    }
+    const ProfilerOptions& options = profiler_->options();
+    spdlog::info("Admin/CpuProfile: capturing for {} s from {}",
+                 request->value() > 0 ? std::min<int64_t>(request->value(), options.max_duration.count())
+                                      : options.default_duration.count(),
+                 ctx->peer());
+    ProfileResult result;
+    std::string error;
+    // Holds this handler thread for the whole capture.
+    if (!profiler_->CaptureCpu(std::chrono::seconds(request->value()), [ctx] { return ctx->IsCancelled(); },
+                               &result, &error)) {
+        return grpc::Status(grpc::StatusCode::INTERNAL, error);
+    }
+    spdlog::info("Admin/CpuProfile: wrote {} ({} samples, {} dropped)", result.path, result.samples, result.dropped);
+    response->set_value(ProfileJson(result, true));
+    return grpc::Status::OK;
+}
+
+grpc::Status AdminService::HeapProfile(grpc::ServerContext* ctx, const google::protobuf::Empty*,
+                                       google::protobuf::StringValue* response) {
+    if (grpc::Status status = Authorize(*ctx, kHeapProfileMethod, true); !status.ok()) return status;
+    if (profiler_ == nullptr) {
+        return grpc::Status(grpc::StatusCode::FAILED_PRECONDITION, "profiling is off (--profile-dir)");
+    }
+    ProfileResult result;
+    std::string error;
+    if (!profiler_->CaptureHeap(&result, &error)) return grpc::Status(grpc::StatusCode::INTERNAL, error);
+    spdlog::info("Admin/HeapProfile: wrote {}", result.path);
+    response->set_value(ProfileJson(result, false));
+    return grpc::Status::OK;
+}
+
+grpc::Status AdminService::Reconfigure(grpc::ServerContext* ctx, const google::protobuf::StringValue* request,
+                                       google::protobuf::StringValue* response) {
+    const bool change = request->value().find_first_not_of(" \t\r\n") != std::string::npos;
+    if (grpc::Status status = Authorize(*ctx, kReconfigureMethod, change); !status.ok()) return status;
+    if (runtime_ == nullptr) {
+        return grpc::Status(grpc::StatusCode::FAILED_PRECONDITION, "runtime reconfiguration is off");
+    }
+    if (!change) {
+        response->set_value(RuntimeConfigJson(*runtime_->Current()));
+        return grpc::Status::OK;
+    }
+    RuntimeConfig applied;
+    std::string error;
+    if (!runtime_->Update(request->value(), "admin", &applied, &error)) {
+        spdlog::warn("Admin/Reconfigure from {} rejected: {}", ctx->peer(), error);
+        return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, error);
+    }
+    response->set_value(RuntimeConfigJson(applied));
+    return grpc::Status::OK;
+}
+
+} // namespace prodstarter
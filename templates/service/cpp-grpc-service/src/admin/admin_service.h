@@ -0,0 +1,91 @@
+// ProdStarterHub - C++ gRPC Service
+// src/admin/admin_service.h
+// Debug RPCs for operators, registered next to reflection (disable with --no-admin).
+//
+// The service is registered by hand on well-known protobuf types, so no
+// generated code is needed and any gRPC client can call it:
+//
+//   service prodstarter.admin.v1.Admin {
+//     // JSON document with the slowest recent calls and their phase breakdown.
+//     rpc SlowCalls(google.protobuf.Empty) returns (google.protobuf.StringValue);
+//     // Returns free and dirty allocator pages to the kernel (memory/allocator.h); JSON with
+//     // resident bytes before and after.
+//     rpc PurgeMemory(google.protobuf.Empty) returns (google.protobuf.StringValue);
+//     // Samples the process for `value` seconds (0: --profile-seconds) and writes a CPU profile into
+//     // --profile-dir (profiling/profiler.h); JSON with its path and sample count. Cancelling the call ends
+//     // the capture early, the profile is written anyway.
+//     rpc CpuProfile(google.protobuf.Int32Value) returns (google.protobuf.StringValue);
+//     // Writes a heap profile of the allocator into --profile-dir; JSON with its path.
+//     rpc HeapProfile(google.protobuf.Empty) returns (google.protobuf.StringValue);
+//     // Applies "key = value" settings (config/runtime_config.h) to the running server; JSON with the resulting
+//     // snapshot. An empty value only returns the current one.
+//     rpc Reconfigure(google.protobuf.StringValue) returns (google.protobuf.StringValue);
+//   }
+//
+//   grpcurl -plaintext -d '{}' localhost:50051 prodstarter.admin.v1.Admin/SlowCalls
+//   (with -proto pointing at a file containing the definition above)
+//
+// With --admin-token-file every Admin call needs "authorization: Bearer <token>"
+// (grpcurl -H) and fails with UNAUTHENTICATED otherwise. The profiling RPCs run
+// code in the process on request and Reconfigure changes it, so they are
+// refused with PERMISSION_DENIED unless a token is configured.
+
+#pragma once
+
+#include <string>
+
+#include <google/protobuf/empty.pb.h>
+#include <google/protobuf/wrappers.pb.h>
+#include <grpcpp/grpcpp.h>
+#include <grpcpp/impl/service_type.h>
+
+namespace prodstarter {
+
+class LatencyBreakdown;
+class Profiler;
+class RuntimeConfigStore;
+
+// Reads the admin bearer token from `path`, without surrounding whitespace. Returns false with `error` set when
+// the file cannot be read or holds no token.
+bool ReadAdminToken(const std::string& path, std::string* token, std::string* error);
+
+class AdminService final : public grpc::Service {
+public:
+    static constexpr const char* kSlowCallsMethod = "/prodstarter.admin.v1.Admin/SlowCalls";
+    static constexpr const char* kPurgeMemoryMethod = "/prodstarter.admin.v1.Admin/PurgeMemory";
+    static constexpr const char* kCpuProfileMethod = "/prodstarter.admin.v1.Admin/CpuProfile";
+    static constexpr const char* kHeapProfileMethod = "/prodstarter.admin.v1.Admin/HeapProfile";
+    static constexpr const char* kReconfigureMethod = "/prodstarter.admin.v1.Admin/Reconfigure";
+
+    // `latency` may be null; SlowCalls then reports an empty list. Without a `profiler` the profiling RPCs fail
+    // with FAILED_PRECONDITION, and so does Reconfigure without `runtime`; with an empty `token` the other RPCs
+    // need no credentials.
+    explicit AdminService(const LatencyBreakdown* latency, Profiler* profiler = nullptr,
+                          RuntimeConfigStore* runtime = nullptr, std::string token = {});
+
+    grpc::Status SlowCalls(grpc::ServerContext* ctx, const google::protobuf::Empty* request,
+                           google::protobuf::StringValue* response);
+
+    grpc::Status PurgeMemory(grpc::ServerContext* ctx, const google::protobuf::Empty* request,
+                             google::protobuf::StringValue* response);
+
+    grpc::Status CpuProfile(grpc::ServerContext* ctx, const google::protobuf::Int32Value* request,
+                            google::protobuf::StringValue* response);
+
+    grpc::Status HeapProfile(grpc::ServerContext* ctx, const google::protobuf::Empty* request,
+                             google::protobuf::StringValue* response);
+
+    grpc::Status Reconfigure(grpc::ServerContext* ctx, const google::protobuf::StringValue* request,
+                             google::protobuf::StringValue* response);
+
+private:
+    // OK when the call carries the token, or no token is configured and `privileged` is false.
+    grpc::Status Authorize(const grpc::ServerContext& ctx, const char* method, bool privileged) const;
+
+    const LatencyBreakdown* latency_;
+    Profiler* const profiler_;
+    RuntimeConfigStore* const runtime_;
+    const std::string token_;
+};
+
+} // namespace prodstarter
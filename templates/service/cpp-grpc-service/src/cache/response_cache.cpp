@@ -0,0 +1,142 @@
+// ProdStarterHub - C++ gRPC Service
+// src/cache/response_cache.cpp
+
+#include "cache/response_cache.h"
+
+#include <functional>
+#include <iterator>
+#include <string_view>
+#include <utility>
+
+namespace prodstarter {
+
+namespace {
+
+// Bookkeeping per entry on top of key and payload: list node, index slot, buffer header.
+constexpr size_t kEntryOverheadBytes = 128;
+
+int64_t NowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+// Length-prefixed so that no combination of fields can collide with another.
+void AppendField(std::string& key, std::string_view field) {
+    const uint32_t size = static_cast<uint32_t>(field.size());
+    key.append(reinterpret_cast<const char*>(&size), sizeof(size));
+    key.append(field.data(), field.size());
+}
+
+} // namespace
+
+ResponseCache::ResponseCache(size_t max_bytes) : max_bytes_(max_bytes), shard_budget_(max_bytes / kNumShards) {}
+
+std::string ResponseCache::MakeKey(const CachePolicy& policy, const grpc::ServerContextBase& ctx,
+                                   const grpc::ByteBuffer& request) {
+    std::string key;
+    key.reserve(policy.method.size() + request.Length() + 16);
+    AppendField(key, policy.method);
+    if (!policy.metadata_keys.empty()) {
+        const auto& metadata = ctx.client_metadata();
+        for (const auto& name : policy.metadata_keys) {
+            auto range = metadata.equal_range(grpc::string_ref(name));
+            uint32_t values = 0;
+            for (auto it = range.first; it != range.second; ++it) ++values;
+            key.append(reinterpret_cast<const char*>(&values), sizeof(values));
+            for (auto it = range.first; it != range.second; ++it) {
+                AppendField(key, std::string_view(it->second.data(), it->second.size()));
+            }
+        }
+    }
+    std::vector<grpc::Slice> slices;
+    if (request.Dump(&slices).ok()) {
+        for (const auto& slice : slices) {
+            key.append(reinterpret_cast<const char*>(slice.begin()), slice.size());
+        }
+    }
+    return key;
+}
+
+ResponseCache::Shard& ResponseCache::ShardFor(const std::string& key) {
+    // The low bits pick the bucket inside a shard's map; use the high ones here.
+    const uint64_t hash = std::hash<std::string>{}(key);
+    return shards_[((hash >> 32) ^ hash) % kNumShards];
+}
+
+void ResponseCache::EraseLocked(Shard& shard, std::list<Entry>::iterator it) {
+    shard.bytes -= it->charge;
+    shard.index.erase(std::string_view(it->key));
+    shard.lru.erase(it);
+}
+
+bool ResponseCache::Lookup(const std::string& key, grpc::ByteBuffer* response) {
+    Shard& shard = ShardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mu);
+    auto found = shard.index.find(std::string_view(key));
+    if (found == shard.index.end()) {
+        ++shard.misses;
+        return false;
+    }
+    auto it = found->second;
+    if (it->expires_ns <= NowNs()) {
+        EraseLocked(shard, it);
+        ++shard.expirations;
+        ++shard.misses;
+        return false;
+    }
+    shard.lru.splice(shard.lru.begin(), shard.lru, it);
+    *response = it->response;
+    ++shard.hits;
+    return true;
+}
+
+void ResponseCache::Insert(std::string key, const grpc::ByteBuffer& response, std::chrono::milliseconds ttl) {
+    const size_t charge = key.size() + response.Length() + kEntryOverheadBytes;
+    const size_t budget = shard_budget_.load(std::memory_order_relaxed);
+    if (charge > budget || ttl.count() <= 0) return;
+
+    Entry entry{std::move(key), response, NowNs() + std::chrono::nanoseconds(ttl).count(), charge};
+    Shard& shard = ShardFor(entry.key);
+    std::lock_guard<std::mutex> lock(shard.mu);
+    auto found = shard.index.find(std::string_view(entry.key));
+    if (found != shard.index.end()) EraseLocked(shard, found->second);
+
+    while (shard.bytes + charge > budget && !shard.lru.empty()) {
+        EraseLocked(shard, std::prev(shard.lru.end()));
+        ++shard.evictions;
+    }
+    shard.lru.push_front(std::move(entry));
+    shard.index.emplace(std::string_view(shard.lru.front().key), shard.lru.begin());
+    shard.bytes += charge;
+    ++shard.inserts;
+}
+
+void ResponseCache::SetMaxBytes(size_t max_bytes) {
+    max_bytes_.store(max_bytes, std::memory_order_relaxed);
+    const size_t budget = max_bytes / kNumShards;
+    shard_budget_.store(budget, std::memory_order_relaxed);
+    for (auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mu);
+        while (shard.bytes > budget && !shard.lru.empty()) {
+            EraseLocked(shard, std::prev(shard.lru.end()));
+            ++shard.evictions;
+        }
+    }
+}
+
+ResponseCache::Stats ResponseCache::GetStats() const {
+    Stats stats;
+    for (const auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mu);
+        stats.hits += shard.hits;
+        stats.misses += shard.misses;
+        stats.inserts += shard.inserts;
+        stats.evictions += shard.evictions;
+        stats.expirations += shard.expirations;
+        stats.entries += shard.lru.size();
+        stats.bytes += shard.bytes;
+    }
+    return stats;
+}
+
+} // namespace prodstarter
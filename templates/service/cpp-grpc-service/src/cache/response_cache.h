@@ -0,0 +1,113 @@
+// ProdStarterHub - C++ gRPC Service
+// src/cache/response_cache.h
+// Sharded LRU cache of serialized responses for idempotent unary RPCs.
+//
+// Read-only lookups with a skewed key distribution are answered from memory
+// without running the handler or serializing the response again: entries hold
+// the grpc::ByteBuffer that was sent the first time, and a hit hands the
+// transport a reference-counted copy of its slices. Keys are built from the
+// method, selected request metadata and the serialized request bytes, so two
+// requests share an entry only when they are byte-for-byte identical.
+//
+// Methods opt in when they are bound (see engine/cached_call.h); the cache is
+// shared by all of them and capped by --response-cache-bytes. Each shard is an
+// LRU list with its own lock and 1/N of the byte budget; entries expire after
+// the TTL of the method that stored them. Only OK responses are cached.
+// SetMaxBytes() changes the budget of a running cache; shrinking it evicts
+// least recently used entries right away.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <grpcpp/server_context.h>
+#include <grpcpp/support/byte_buffer.h>
+
+namespace prodstarter {
+
+// Per-method caching rules, given when the method is bound.
+struct CachePolicy {
+    std::string method; // full name, e.g. "/myproto.Example/MyRpc"; keeps methods apart in the shared cache
+    std::chrono::milliseconds ttl{1000};
+    // Request metadata that changes the response (e.g. "accept-language");
+    // every other header is ignored when building the key.
+    std::vector<std::string> metadata_keys;
+    // Longest a call waits for an identical in-flight call (see cache/singleflight.h).
+    std::chrono::milliseconds max_coalesce_wait{1000};
+};
+
+class ResponseCache {
+public:
+    static constexpr size_t kNumShards = 32;
+
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t inserts = 0;
+        uint64_t evictions = 0;   // dropped to stay under the byte budget
+        uint64_t expirations = 0; // found past their TTL
+        uint64_t entries = 0;
+        uint64_t bytes = 0;       // charged size of all entries
+    };
+
+    explicit ResponseCache(size_t max_bytes);
+
+    ResponseCache(const ResponseCache&) = delete;
+    ResponseCache& operator=(const ResponseCache&) = delete;
+
+    // Cache key for one call: method, the policy's metadata values, request bytes.
+    static std::string MakeKey(const CachePolicy& policy, const grpc::ServerContextBase& ctx,
+                               const grpc::ByteBuffer& request);
+
+    // Copies the cached response into `response` (sharing its slices).
+    bool Lookup(const std::string& key, grpc::ByteBuffer* response);
+
+    // Stores `response` for `ttl`, evicting least recently used entries of the
+    // shard as needed. Entries larger than a shard's budget are not stored.
+    void Insert(std::string key, const grpc::ByteBuffer& response, std::chrono::milliseconds ttl);
+
+    // Replaces the byte budget, evicting entries until every shard fits its new share.
+    void SetMaxBytes(size_t max_bytes);
+
+    size_t max_bytes() const { return max_bytes_.load(std::memory_order_relaxed); }
+    Stats GetStats() const;
+
+private:
+    struct Entry {
+        std::string key;
+        grpc::ByteBuffer response;
+        int64_t expires_ns;
+        size_t charge;
+    };
+
+    struct alignas(64) Shard {
+        mutable std::mutex mu;
+        std::list<Entry> lru; // most recently used first
+        std::unordered_map<std::string_view, std::list<Entry>::iterator> index; // keys point into lru entries
+        size_t bytes = 0;
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t inserts = 0;
+        uint64_t evictions = 0;
+        uint64_t expirations = 0;
+    };
+
+    Shard& ShardFor(const std::string& key);
+    static void EraseLocked(Shard& shard, std::list<Entry>::iterator it);
+
+    std::atomic<size_t> max_bytes_;
+    std::atomic<size_t> shard_budget_; // max_bytes_ / kNumShards
+    std::array<Shard, kNumShards> shards_;
+};
+
+} // namespace prodstarter
@@ -0,0 +1,97 @@
+// ProdStarterHub - C++ gRPC Service
+// src/cache/singleflight.cpp
+
+#include "cache/singleflight.h"
+
+#include <utility>
+
+#include <grpcpp/alarm.h>
+
+namespace prodstarter {
+
+struct Singleflight::Waiter {
+    grpc::ByteBuffer* response;
+    Done done;
+    std::atomic<bool> fired{false};
+    grpc::Alarm alarm; // cancelled when the waiter is destroyed with its flight
+};
+
+Singleflight::Shard& Singleflight::ShardFor(const std::string& key) {
+    const uint64_t hash = std::hash<std::string>{}(key);
+    return shards_[((hash >> 32) ^ hash) % kNumShards];
+}
+
+bool Singleflight::Join(const std::string& key, std::chrono::system_clock::time_point client_deadline,
+                        std::chrono::milliseconds max_wait, grpc::ByteBuffer* response, Done done) {
+    // Leaders never need a waiter, and building its alarm is far costlier than the lookup, so the waiter is only
+    // built once a flight was seen; the flight may have ended by the time we look again.
+    Shard& shard = ShardFor(key);
+    std::shared_ptr<Waiter> waiter;
+    for (;;) {
+        {
+            std::lock_guard<std::mutex> lock(shard.mu);
+            auto it = shard.flights.find(key);
+            if (it == shard.flights.end()) {
+                shard.flights.emplace(key, Flight{});
+                leaders_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            if (waiter) {
+                it->second.waiters.push_back(waiter);
+                break;
+            }
+        }
+        waiter = std::make_shared<Waiter>();
+        waiter->response = response;
+        waiter->done = std::move(done);
+    }
+    coalesced_.fetch_add(1, std::memory_order_relaxed);
+    waiting_.fetch_add(1, std::memory_order_relaxed);
+
+    const auto wait_until = std::chrono::system_clock::now() + max_wait;
+    const bool client_first = client_deadline <= wait_until;
+    const grpc::Status timeout =
+        client_first ? grpc::Status(grpc::StatusCode::DEADLINE_EXCEEDED, "deadline exceeded waiting for a coalesced call")
+                     : grpc::Status(grpc::StatusCode::UNAVAILABLE, "timed out waiting for a coalesced call");
+    // The flight owns the waiter; the alarm only observes it, so a finished flight never waits for its alarms.
+    std::weak_ptr<Waiter> observed = waiter;
+    waiter->alarm.Set(client_first ? client_deadline : wait_until, [this, observed, timeout](bool ok) {
+        if (!ok) return; // cancelled: the flight finished and released the waiter
+        auto waiter = observed.lock();
+        if (!waiter || waiter->fired.exchange(true)) return;
+        timeouts_.fetch_add(1, std::memory_order_relaxed);
+        waiting_.fetch_sub(1, std::memory_order_relaxed);
+        waiter->done(timeout);
+    });
+    return true;
+}
+
+void Singleflight::Finish(const std::string& key, const grpc::Status& status, const grpc::ByteBuffer& response) {
+    Flight flight;
+    {
+        Shard& shard = ShardFor(key);
+        std::lock_guard<std::mutex> lock(shard.mu);
+        auto it = shard.flights.find(key);
+        if (it == shard.flights.end()) return;
+        flight = std::move(it->second);
+        shard.flights.erase(it);
+    }
+    for (const auto& waiter : flight.waiters) {
+        if (waiter->fired.exchange(true)) continue;
+        *waiter->response = response;
+        waiting_.fetch_sub(1, std::memory_order_relaxed);
+        waiter->done(status);
+    }
+}
+
+Singleflight::Stats Singleflight::GetStats() const {
+    Stats stats;
+    stats.leaders = leaders_.load(std::memory_order_relaxed);
+    stats.coalesced = coalesced_.load(std::memory_order_relaxed);
+    stats.timeouts = timeouts_.load(std::memory_order_relaxed);
+    const int64_t waiting = waiting_.load(std::memory_order_relaxed);
+    stats.waiting = waiting > 0 ? static_cast<uint64_t>(waiting) : 0;
+    return stats;
+}
+
+} // namespace prodstarter
@@ -0,0 +1,91 @@
+// ProdStarterHub - C++ gRPC Service
+// src/cache/singleflight.h
+// Coalesces identical concurrent calls into one execution.
+//
+// When a hot cache entry expires, every request for it misses at once. With a
+// Singleflight the first call for a key leads: it runs the handler while later
+// calls for the same key join its flight instead of running their own. When
+// the leader finishes, every waiter gets its status and a reference to the
+// same serialized response.
+//
+// No thread blocks. A waiter registers a completion callback and a
+// grpc::Alarm at the earlier of its own deadline and `max_wait`. If the alarm
+// fires first, the waiter finishes alone: DEADLINE_EXCEEDED when its client's
+// deadline passed, otherwise UNAVAILABLE so the client can retry. A slow
+// leader therefore never holds its waiters past their deadlines, and on a
+// timeout they do not all fall back to the backend at once.
+//
+// Keys come from ResponseCache::MakeKey(); engine/cached_call.h joins flights
+// for methods bound with both a cache policy and a Singleflight.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <grpcpp/support/byte_buffer.h>
+#include <grpcpp/support/status.h>
+
+namespace prodstarter {
+
+class Singleflight {
+public:
+    static constexpr size_t kNumShards = 32;
+
+    // Called once per waiter, from the leader's thread or the alarm thread.
+    using Done = std::function<void(const grpc::Status& status)>;
+
+    struct Stats {
+        uint64_t leaders = 0;   // executions that had to run
+        uint64_t coalesced = 0; // calls that joined an execution instead of running their own
+        uint64_t timeouts = 0;  // waiters that gave up before their leader finished
+        uint64_t waiting = 0;   // waiters currently parked
+    };
+
+    Singleflight() = default;
+
+    Singleflight(const Singleflight&) = delete;
+    Singleflight& operator=(const Singleflight&) = delete;
+
+    // Joins the flight for `key` if one is running and returns true. `response`
+    // must stay valid until `done` runs; `done` runs exactly once, at the latest
+    // at min(client_deadline, now + max_wait).
+    //
+    // Returns false when no flight was running: the caller now leads one and
+    // must call Finish(key, ...) exactly once.
+    bool Join(const std::string& key, std::chrono::system_clock::time_point client_deadline,
+              std::chrono::milliseconds max_wait, grpc::ByteBuffer* response, Done done);
+
+    // Ends the flight for `key` and hands `status` and `response` to its waiters.
+    void Finish(const std::string& key, const grpc::Status& status, const grpc::ByteBuffer& response);
+
+    Stats GetStats() const;
+
+private:
+    struct Waiter;
+    struct Flight {
+        std::vector<std::shared_ptr<Waiter>> waiters;
+    };
+    struct alignas(64) Shard {
+        std::mutex mu;
+        std::unordered_map<std::string, Flight> flights;
+    };
+
+    Shard& ShardFor(const std::string& key);
+
+    std::array<Shard, kNumShards> shards_;
+    std::atomic<uint64_t> leaders_{0};
+    std::atomic<uint64_t> coalesced_{0};
+    std::atomic<uint64_t> timeouts_{0};
+    std::atomic<int64_t> waiting_{0};
+};
+
+} // namespace prodstarter
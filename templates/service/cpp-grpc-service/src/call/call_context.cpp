@@ -0,0 +1,88 @@
+// ProdStarterHub - C++ gRPC Service
+// src/call/call_context.cpp
+
+#include "call/call_context.h"
+
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+
+namespace prodstarter {
+
+namespace {
+
+constexpr size_t kRegistryShards = 64;
+
+struct alignas(64) RegistryShard {
+    std::mutex mu;
+    std::unordered_map<const grpc::ServerContextBase*, CallContext*> calls;
+};
+
+std::array<RegistryShard, kRegistryShards>& Shards() {
+    static std::array<RegistryShard, kRegistryShards> shards;
+    return shards;
+}
+
+// Lets FindCallContext() skip the lock entirely when nothing is registered.
+std::atomic<int64_t> registered{0};
+
+// Only abandoned calls touch these.
+std::atomic<uint64_t> skipped_expired{0};
+std::atomic<uint64_t> skipped_cancelled{0};
+std::atomic<uint64_t> cancelled_running{0};
+
+RegistryShard& ShardFor(const grpc::ServerContextBase* ctx) {
+    // Contexts are heap objects; drop the alignment bits before spreading them.
+    const size_t h = std::hash<const void*>{}(ctx) >> 4;
+    return Shards()[h % kRegistryShards];
+}
+
+} // namespace
+
+void RegisterCallContext(const grpc::ServerContextBase* ctx, CallContext* call) {
+    RegistryShard& shard = ShardFor(ctx);
+    std::lock_guard<std::mutex> lock(shard.mu);
+    shard.calls[ctx] = call;
+    registered.fetch_add(1, std::memory_order_relaxed);
+}
+
+void UnregisterCallContext(const grpc::ServerContextBase* ctx) {
+    RegistryShard& shard = ShardFor(ctx);
+    std::lock_guard<std::mutex> lock(shard.mu);
+    if (shard.calls.erase(ctx) > 0) registered.fetch_sub(1, std::memory_order_relaxed);
+}
+
+CallContext* FindCallContext(const grpc::ServerContextBase* ctx) {
+    if (registered.load(std::memory_order_relaxed) == 0) return nullptr;
+    RegistryShard& shard = ShardFor(ctx);
+    std::lock_guard<std::mutex> lock(shard.mu);
+    auto it = shard.calls.find(ctx);
+    return it != shard.calls.end() ? it->second : nullptr;
+}
+
+bool CallAbandoned(const grpc::ServerContextBase* ctx, const CallContext* call) {
+    // Deadline first: gRPC cancels a call whose deadline passed, which would otherwise count as a cancellation.
+    const auto deadline = ctx->deadline();
+    if (deadline != std::chrono::system_clock::time_point::max() && deadline <= std::chrono::system_clock::now()) {
+        skipped_expired.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    if (call != nullptr && call->cancellation().cancelled()) {
+        skipped_cancelled.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+void RecordCancelledWhileRunning() { cancelled_running.fetch_add(1, std::memory_order_relaxed); }
+
+AbandonedCallStats GetAbandonedCallStats() {
+    AbandonedCallStats stats;
+    stats.skipped_expired = skipped_expired.load(std::memory_order_relaxed);
+    stats.skipped_cancelled = skipped_cancelled.load(std::memory_order_relaxed);
+    stats.cancelled_running = cancelled_running.load(std::memory_order_relaxed);
+    return stats;
+}
+
+} // namespace prodstarter
@@ -0,0 +1,176 @@
+// ProdStarterHub - C++ gRPC Service
+// src/call/call_context.h
+// Per-call state shared between interceptors and the serving engines.
+//
+// The first server interceptor creates a CallContext for every call and
+// registers it under the call's grpc::ServerContextBase, which is the one
+// handle both interceptors (ServerRpcInfo::server_context()) and engine code
+// (the UnaryCall's ServerContext, a reactor's CallbackServerContext) can see.
+// The context lives exactly as long as the call's interceptors, i.e. until the
+// ServerContext is destroyed.
+//
+// It records a monotonic timeline of the call:
+//
+//   arrival ─ received ─ dispatched ─ handler done ─ serialized ─ written
+//      (match)  (request   (handler    (response or    (response    (send batch
+//                parsed)    invoked)    status sent)    encoded)     completed)
+//
+// Engines call BeginHandler() when a handler actually starts, so time spent in
+// an executor queue shows up as queue wait instead of handler time. It also
+// tells them whether the handler is still worth running: it is skipped when
+// admission control (overload/concurrency_limiter.h) turned the call away, when
+// the client's deadline passed while the call waited, or when the client
+// cancelled it; the call then finishes with SkippedStatus(). Cancellation after
+// that reaches the handler through the context's CancellationSource, see
+// call/cancellation.h.
+//
+// With tracing on, the context also carries the call's trace context for
+// outbound calls to continue (tracing/tracer.h).
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include <grpcpp/server_context.h>
+#include <grpcpp/support/status.h>
+
+#include "call/cancellation.h"
+#include "call/method_class.h"
+#include "tracing/trace_context.h"
+
+namespace prodstarter {
+
+class Tracer;
+
+class CallContext {
+public:
+    enum class Mark { kReceived, kDispatched, kHandlerDone, kSerialized, kWritten, kCount };
+
+    explicit CallContext(std::chrono::system_clock::time_point deadline = std::chrono::system_clock::time_point::max())
+        : arrival_ns_(NowNs()), cancellation_(deadline) {}
+
+    static int64_t NowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    // Records the current time for `mark`; the first timestamp wins.
+    void Stamp(Mark mark) {
+        int64_t expected = 0;
+        marks_[static_cast<size_t>(mark)].compare_exchange_strong(expected, NowNs(), std::memory_order_relaxed);
+    }
+
+    // Nanoseconds on the steady clock, or 0 if the mark was never reached.
+    int64_t at(Mark mark) const { return marks_[static_cast<size_t>(mark)].load(std::memory_order_relaxed); }
+    int64_t arrival() const { return arrival_ns_; }
+
+    // Set by admission control before the handler is dispatched.
+    void Reject() { rejected_.store(true, std::memory_order_relaxed); }
+    bool rejected() const { return rejected_.load(std::memory_order_relaxed); }
+
+    // Priority class of the call's method, set by the call-context interceptor before any handler runs.
+    void set_method_class(MethodClass cls) { method_class_ = cls; }
+    MethodClass method_class() const { return method_class_; }
+
+    // Set by the tracing interceptor when the call's metadata arrives, before any handler runs; tracer() is null
+    // for calls that are not traced.
+    void set_trace(Tracer* tracer, const TraceContext& trace) {
+        tracer_ = tracer;
+        trace_ = trace;
+    }
+    Tracer* tracer() const { return tracer_; }
+    const TraceContext& trace() const { return trace_; }
+
+    // Cancelled by the call-context interceptor when the client goes away before the call finished.
+    CancellationSource& cancellation() { return cancellation_; }
+    const CancellationSource& cancellation() const { return cancellation_; }
+
+private:
+    const int64_t arrival_ns_;
+    std::array<std::atomic<int64_t>, static_cast<size_t>(Mark::kCount)> marks_{};
+    std::atomic<bool> rejected_{false};
+    MethodClass method_class_ = MethodClass::kDefault;
+    Tracer* tracer_ = nullptr;
+    TraceContext trace_;
+    CancellationSource cancellation_;
+};
+
+// Registry keyed by the call's ServerContextBase; sharded so concurrent calls rarely share a lock.
+void RegisterCallContext(const grpc::ServerContextBase* ctx, CallContext* call);
+void UnregisterCallContext(const grpc::ServerContextBase* ctx);
+
+// Null when no call-context interceptor is installed or the call is unknown.
+CallContext* FindCallContext(const grpc::ServerContextBase* ctx);
+
+// Status of calls turned away by admission control.
+inline grpc::Status OverloadStatus() {
+    return grpc::Status(grpc::StatusCode::RESOURCE_EXHAUSTED, "server overloaded, retry with backoff");
+}
+
+// True when admission control rejected the call. Unlike BeginHandler() this
+// does not mark the call dispatched.
+inline bool CallRejected(const grpc::ServerContextBase* ctx) {
+    const CallContext* call = FindCallContext(ctx);
+    return call != nullptr && call->rejected();
+}
+
+// Priority class of the call; kDefault when no call-context interceptor is installed.
+inline MethodClass CallMethodClass(const grpc::ServerContextBase* ctx) {
+    const CallContext* call = FindCallContext(ctx);
+    return call != nullptr ? call->method_class() : MethodClass::kDefault;
+}
+
+// Handlers that never ran because nobody was waiting for them any more, and
+// calls whose client went away while their handler was running.
+struct AbandonedCallStats {
+    uint64_t skipped_expired = 0;   // deadline passed before dispatch
+    uint64_t skipped_cancelled = 0; // client cancelled before dispatch
+    uint64_t cancelled_running = 0; // client cancelled while the handler ran
+};
+
+AbandonedCallStats GetAbandonedCallStats();
+
+// Reported by the call-context interceptor.
+void RecordCancelledWhileRunning();
+
+// True when the client no longer waits for the call: its deadline passed, or it was cancelled (visible only
+// with a CallContext, `call` may be null). A true result is counted as a skipped handler, so engines ask once,
+// where they would skip it.
+bool CallAbandoned(const grpc::ServerContextBase* ctx, const CallContext* call);
+inline bool CallAbandoned(const grpc::ServerContextBase* ctx) { return CallAbandoned(ctx, FindCallContext(ctx)); }
+
+// Status for a call whose handler was skipped: RESOURCE_EXHAUSTED when admission control rejected it,
+// DEADLINE_EXCEEDED once its deadline passed, CANCELLED otherwise. The client of an abandoned call never sees
+// it, but interceptors and metrics do.
+inline grpc::Status SkippedStatus(const grpc::ServerContextBase* ctx) {
+    if (CallRejected(ctx)) return OverloadStatus();
+    if (ctx->deadline() <= std::chrono::system_clock::now()) {
+        return grpc::Status(grpc::StatusCode::DEADLINE_EXCEEDED, "deadline exceeded before the handler ran");
+    }
+    return grpc::Status(grpc::StatusCode::CANCELLED, "call cancelled before the handler ran");
+}
+
+// Stamps the dispatch of work that runs whatever state the call is in, without BeginHandler()'s checks.
+inline void MarkDispatched(const grpc::ServerContextBase* ctx) {
+    if (CallContext* call = FindCallContext(ctx)) call->Stamp(CallContext::Mark::kDispatched);
+}
+
+// Engine hook: the handler of `ctx` starts now. Returns false when the call was
+// rejected or abandoned; finish it with SkippedStatus() instead of running the
+// handler. Sync handlers can open with the same check to skip their work:
+//
+//   if (!prodstarter::BeginHandler(ctx)) return prodstarter::SkippedStatus(ctx);
+inline bool BeginHandler(const grpc::ServerContextBase* ctx) {
+    CallContext* call = FindCallContext(ctx);
+    if (call != nullptr) {
+        call->Stamp(CallContext::Mark::kDispatched);
+        if (call->rejected()) return false;
+    }
+    return !CallAbandoned(ctx, call);
+}
+
+} // namespace prodstarter
@@ -0,0 +1,85 @@
+// ProdStarterHub - C++ gRPC Service
+// src/call/call_interceptor.cpp
+
+#include "call/call_interceptor.h"
+
+#include <atomic>
+#include <string_view>
+
+#include "call/call_context.h"
+#include "call/method_class.h"
+#include "metrics/latency_breakdown.h"
+
+namespace prodstarter {
+
+namespace {
+
+using grpc::experimental::InterceptionHookPoints;
+
+class CallContextInterceptor final : public grpc::experimental::Interceptor {
+public:
+    CallContextInterceptor(grpc::experimental::ServerRpcInfo* info, LatencyBreakdown* latency,
+                           const MethodClassifier* classes)
+        : server_context_(info->server_context()),
+          method_(info->method() != nullptr ? info->method() : ""),
+          // Streams hold a call open for as long as the client likes; their phases would be noise.
+          latency_(info->type() == grpc::experimental::ServerRpcInfo::Type::UNARY ||
+                           info->type() == grpc::experimental::ServerRpcInfo::Type::CLIENT_STREAMING
+                       ? latency
+                       : nullptr),
+          call_(info->server_context()->deadline()) {
+        if (classes != nullptr) call_.set_method_class(classes->Classify(method_));
+        RegisterCallContext(server_context_, &call_);
+    }
+
+    ~CallContextInterceptor() override {
+        UnregisterCallContext(server_context_);
+        if (latency_ != nullptr) latency_->Record(method_, code_, call_, CallContext::NowNs());
+    }
+
+    void Intercept(grpc::experimental::InterceptorBatchMethods* methods) override {
+        if (methods->QueryInterceptionHookPoint(InterceptionHookPoints::POST_RECV_MESSAGE)) {
+            call_.Stamp(CallContext::Mark::kReceived);
+        }
+        if (methods->QueryInterceptionHookPoint(InterceptionHookPoints::PRE_SEND_MESSAGE)) {
+            call_.Stamp(CallContext::Mark::kHandlerDone);
+            if (latency_ != nullptr) {
+                methods->GetSerializedSendMessage();
+                call_.Stamp(CallContext::Mark::kSerialized);
+            }
+        }
+        if (methods->QueryInterceptionHookPoint(InterceptionHookPoints::PRE_SEND_STATUS)) {
+            call_.Stamp(CallContext::Mark::kHandlerDone);
+            code_ = methods->GetSendStatus().error_code();
+            status_sent_.store(true, std::memory_order_relaxed);
+        }
+        if (methods->QueryInterceptionHookPoint(InterceptionHookPoints::POST_RECV_CLOSE) &&
+            !status_sent_.load(std::memory_order_relaxed)) {
+            // Abandoned calls that were never dispatched are counted when their handler is skipped.
+            if (call_.cancellation().Cancel() && call_.at(CallContext::Mark::kDispatched) != 0) {
+                RecordCancelledWhileRunning();
+            }
+        }
+        if (methods->QueryInterceptionHookPoint(InterceptionHookPoints::POST_SEND_MESSAGE)) {
+            call_.Stamp(CallContext::Mark::kWritten);
+        }
+        methods->Proceed();
+    }
+
+private:
+    const grpc::ServerContextBase* server_context_;
+    std::string_view method_; // owned by the call, valid while the interceptor lives
+    LatencyBreakdown* latency_;
+    CallContext call_;
+    grpc::StatusCode code_ = grpc::StatusCode::CANCELLED; // until a status is sent
+    std::atomic<bool> status_sent_{false}; // the close may be reported on another thread
+};
+
+} // namespace
+
+grpc::experimental::Interceptor* CallContextInterceptorFactory::CreateServerInterceptor(
+    grpc::experimental::ServerRpcInfo* info) {
+    return new CallContextInterceptor(info, latency_, classes_);
+}
+
+} // namespace prodstarter
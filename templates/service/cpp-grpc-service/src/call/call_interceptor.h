@@ -0,0 +1,38 @@
+// ProdStarterHub - C++ gRPC Service
+// src/call/call_interceptor.h
+// Server interceptor that owns each call's CallContext and fills in its timeline.
+//
+// Install it first so later interceptors can look the context up in their own
+// constructors. With a LatencyBreakdown the PRE_SEND_MESSAGE hook forces the
+// response to be serialized on the spot (gRPC would do it right after anyway),
+// which is what separates serialize from write time; finished unary and
+// client-streaming calls are then recorded when the call is destroyed.
+//
+// When the call closes (POST_RECV_CLOSE) before its status was sent, the
+// client cancelled, timed out or disconnected: the interceptor cancels the
+// context's CancellationSource so handlers, queued work and outbound calls
+// holding its tokens stop early.
+
+#pragma once
+
+#include <grpcpp/support/server_interceptor.h>
+
+namespace prodstarter {
+
+class LatencyBreakdown;
+class MethodClassifier;
+
+class CallContextInterceptorFactory : public grpc::experimental::ServerInterceptorFactoryInterface {
+public:
+    // `latency` may be null to only track call contexts. With `classes` every context gets its method's class.
+    explicit CallContextInterceptorFactory(LatencyBreakdown* latency, const MethodClassifier* classes = nullptr)
+        : latency_(latency), classes_(classes) {}
+
+    grpc::experimental::Interceptor* CreateServerInterceptor(grpc::experimental::ServerRpcInfo* info) override;
+
+private:
+    LatencyBreakdown* latency_;
+    const MethodClassifier* classes_;
+};
+
+} // namespace prodstarter
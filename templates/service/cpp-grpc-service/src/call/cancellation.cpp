@@ -0,0 +1,120 @@
+// ProdStarterHub - C++ gRPC Service
+// src/call/cancellation.cpp
+
+#include "call/cancellation.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "call/call_context.h"
+
+namespace prodstarter {
+
+struct CancellationToken::Subscription::Entry {
+    std::weak_ptr<State> state;
+    std::mutex mu; // held while the callback runs, so Reset() cannot return under it
+    std::function<void()> callback;
+};
+
+struct CancellationToken::State {
+    std::atomic<bool> cancelled{false};
+    std::mutex mu;
+    std::vector<std::shared_ptr<Subscription::Entry>> entries; // until cancelled
+
+    void Cancel() {
+        std::vector<std::shared_ptr<Subscription::Entry>> run;
+        {
+            std::lock_guard<std::mutex> lock(mu);
+            if (cancelled.exchange(true, std::memory_order_acq_rel)) return;
+            run.swap(entries);
+        }
+        for (const auto& entry : run) {
+            std::lock_guard<std::mutex> lock(entry->mu);
+            if (entry->callback) std::exchange(entry->callback, nullptr)();
+        }
+    }
+};
+
+CancellationToken::Subscription& CancellationToken::Subscription::operator=(Subscription&& other) noexcept {
+    if (this != &other) {
+        Reset();
+        entry_ = std::move(other.entry_);
+    }
+    return *this;
+}
+
+void CancellationToken::Subscription::Reset() {
+    if (!entry_) return;
+    {
+        std::lock_guard<std::mutex> lock(entry_->mu);
+        entry_->callback = nullptr;
+    }
+    if (auto state = entry_->state.lock()) {
+        std::lock_guard<std::mutex> lock(state->mu);
+        auto& entries = state->entries;
+        entries.erase(std::remove(entries.begin(), entries.end(), entry_), entries.end());
+    }
+    entry_.reset();
+}
+
+bool CancellationToken::cancelled() const {
+    if (state_ && state_->cancelled.load(std::memory_order_acquire)) return true;
+    return deadline_ != Clock::time_point::max() && Clock::now() >= deadline_;
+}
+
+CancellationToken::Clock::duration CancellationToken::remaining() const {
+    if (deadline_ == Clock::time_point::max()) return Clock::duration::max();
+    return std::max(Clock::duration::zero(), deadline_ - Clock::now());
+}
+
+CancellationToken::Subscription CancellationToken::OnCancel(std::function<void()> callback) const {
+    Subscription subscription;
+    if (!state_) return subscription;
+    auto entry = std::make_shared<Subscription::Entry>();
+    entry->state = state_;
+    entry->callback = std::move(callback);
+    {
+        std::lock_guard<std::mutex> lock(state_->mu);
+        if (!state_->cancelled.load(std::memory_order_acquire)) {
+            state_->entries.push_back(entry);
+            subscription.entry_ = std::move(entry);
+            return subscription;
+        }
+    }
+    entry->callback();
+    return subscription;
+}
+
+CancellationToken::Subscription CancellationToken::Propagate(grpc::ClientContext* client) const {
+    if (deadline_ < client->deadline()) client->set_deadline(deadline_);
+    return OnCancel([client] { client->TryCancel(); });
+}
+
+bool CancellationSource::Cancel() {
+    if (cancelled_.exchange(true, std::memory_order_acq_rel)) return false;
+    std::shared_ptr<CancellationToken::State> state;
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        state = state_;
+    }
+    if (state) state->Cancel();
+    return true;
+}
+
+CancellationToken CancellationSource::token() {
+    std::lock_guard<std::mutex> lock(mu_);
+    if (!state_) {
+        state_ = std::make_shared<CancellationToken::State>();
+        // A Cancel() that ran before the state existed had nothing to notify.
+        if (cancelled()) state_->Cancel();
+    }
+    return CancellationToken(deadline_, state_);
+}
+
+CancellationToken CallCancellation(const grpc::ServerContextBase* ctx) {
+    if (CallContext* call = FindCallContext(ctx)) return call->cancellation().token();
+    return CancellationToken(ctx->deadline());
+}
+
+} // namespace prodstarter
@@ -0,0 +1,113 @@
+// ProdStarterHub - C++ gRPC Service
+// src/call/cancellation.h
+// Deadline and cancellation of one call, as a token its work can carry along.
+//
+// A CancellationToken is done once the call's deadline has passed or its
+// client went away (cancelled, timed out or disconnected). Handlers poll it
+// between steps of long work, hand it to executor tasks, and tie outbound
+// calls to it so they get the remaining time and are cancelled with the call:
+//
+//   prodstarter::CancellationToken token = prodstarter::CallCancellation(ctx);
+//   for (const auto& shard : shards) {
+//       if (token.cancelled()) return grpc::Status::CANCELLED;
+//       grpc::ClientContext downstream;
+//       auto link = token.Propagate(&downstream); // deadline + TryCancel() while it lives
+//       stubs.For(pool.Acquire()).Lookup(&downstream, shard, &partial);
+//   }
+//
+// The deadline always comes from the ServerContext. Client cancellation is
+// reported by the call-context interceptor (call/call_interceptor.h), so a
+// token only sees it when that interceptor is installed; without it a token
+// only expires. The shared state behind a token is allocated the first time
+// one is taken, so calls that never ask pay nothing.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+#include <grpcpp/client_context.h>
+#include <grpcpp/server_context.h>
+
+namespace prodstarter {
+
+class CancellationToken {
+public:
+    using Clock = std::chrono::system_clock;
+
+    // Unregisters its callback when destroyed, waiting for it if it is running right now; keep it alive while the
+    // callback may run and never destroy it from inside the callback.
+    class Subscription {
+    public:
+        Subscription() = default;
+        Subscription(Subscription&& other) noexcept = default;
+        Subscription& operator=(Subscription&& other) noexcept;
+        ~Subscription() { Reset(); }
+
+        void Reset();
+
+    private:
+        friend class CancellationToken;
+        struct Entry;
+
+        std::shared_ptr<Entry> entry_;
+    };
+
+    // Never cancelled and without a deadline.
+    CancellationToken() = default;
+    explicit CancellationToken(Clock::time_point deadline) : deadline_(deadline) {}
+
+    // True once the deadline passed or the call was cancelled.
+    bool cancelled() const;
+    Clock::time_point deadline() const { return deadline_; }
+    // Time left before the deadline, zero once it passed; Clock::duration::max() without one.
+    Clock::duration remaining() const;
+
+    // Runs `callback` once when the call is cancelled, on the thread that noticed it, or right away when it
+    // already was. Deadlines only trigger callbacks through the cancellation gRPC delivers when they pass.
+    Subscription OnCancel(std::function<void()> callback) const;
+
+    // Gives `client` the remaining deadline (unless it already has an earlier one) and cancels it with the call.
+    Subscription Propagate(grpc::ClientContext* client) const;
+
+private:
+    friend class CancellationSource;
+    struct State;
+
+    CancellationToken(Clock::time_point deadline, std::shared_ptr<State> state)
+        : deadline_(deadline), state_(std::move(state)) {}
+
+    Clock::time_point deadline_ = Clock::time_point::max();
+    std::shared_ptr<State> state_; // null: nothing can cancel this token but its deadline
+};
+
+// The cancelling side, owned by the call's CallContext.
+class CancellationSource {
+public:
+    using Clock = CancellationToken::Clock;
+
+    explicit CancellationSource(Clock::time_point deadline = Clock::time_point::max()) : deadline_(deadline) {}
+
+    // Cancels every token taken from this source and runs their callbacks; later calls do nothing.
+    // Returns true for the call that cancelled.
+    bool Cancel();
+    bool cancelled() const { return cancelled_.load(std::memory_order_acquire); }
+
+    CancellationToken token();
+
+private:
+    const Clock::time_point deadline_;
+    std::atomic<bool> cancelled_{false};
+    std::mutex mu_;
+    std::shared_ptr<CancellationToken::State> state_; // created by the first token()
+};
+
+// Token for the call behind `ctx`. Without a call-context interceptor it only carries the deadline.
+CancellationToken CallCancellation(const grpc::ServerContextBase* ctx);
+
+} // namespace prodstarter
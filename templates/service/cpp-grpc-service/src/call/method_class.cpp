@@ -0,0 +1,82 @@
+// ProdStarterHub - C++ gRPC Service
+// src/call/method_class.cpp
+
+#include "call/method_class.h"
+
+#include <algorithm>
+#include <array>
+
+namespace prodstarter {
+
+namespace {
+
+// The same services the concurrency limiter exempts.
+constexpr std::array<std::string_view, 3> kSystemPrefixes{"/grpc.health.", "/grpc.reflection.", "/prodstarter.admin."};
+
+} // namespace
+
+const char* MethodClassName(MethodClass cls) {
+    switch (cls) {
+    case MethodClass::kSystem: return "system";
+    case MethodClass::kCritical: return "critical";
+    case MethodClass::kDefault: return "default";
+    case MethodClass::kBulk: return "bulk";
+    }
+    return "default";
+}
+
+bool ParseMethodClass(std::string_view name, MethodClass* cls) {
+    if (name == "critical") *cls = MethodClass::kCritical;
+    else if (name == "default") *cls = MethodClass::kDefault;
+    else if (name == "bulk") *cls = MethodClass::kBulk;
+    else return false;
+    return true;
+}
+
+bool IsSystemMethod(std::string_view method) {
+    return std::any_of(kSystemPrefixes.begin(), kSystemPrefixes.end(),
+                       [method](std::string_view prefix) { return method.substr(0, prefix.size()) == prefix; });
+}
+
+bool MethodClassifier::AddRule(const std::string& rule, std::string* error) {
+    const size_t eq = rule.rfind('=');
+    if (eq == std::string::npos || eq == 0 || rule[0] != '/') {
+        *error = "expected /package.Service/Method=CLASS or /package.Service/*=CLASS";
+        return false;
+    }
+    MethodClass cls;
+    if (!ParseMethodClass(std::string_view(rule).substr(eq + 1), &cls)) {
+        *error = "class must be critical, default or bulk";
+        return false;
+    }
+    std::string pattern = rule.substr(0, eq);
+    const bool prefix = pattern.back() == '*';
+    if (prefix) pattern.pop_back();
+    // Broader prefixes such as "/*" are fine: Classify() checks the system services first.
+    if (IsSystemMethod(pattern)) {
+        *error = "health, reflection and admin methods always run in the system class";
+        return false;
+    }
+    if (!prefix) {
+        exact_[pattern] = cls;
+        return true;
+    }
+    prefixes_.emplace_back(std::move(pattern), cls);
+    std::stable_sort(prefixes_.begin(), prefixes_.end(),
+                     [](const auto& a, const auto& b) { return a.first.size() > b.first.size(); });
+    return true;
+}
+
+MethodClass MethodClassifier::Classify(std::string_view method) const {
+    if (IsSystemMethod(method)) return MethodClass::kSystem;
+    if (!exact_.empty()) {
+        auto found = exact_.find(std::string(method));
+        if (found != exact_.end()) return found->second;
+    }
+    for (const auto& [prefix, cls] : prefixes_) {
+        if (method.substr(0, prefix.size()) == prefix) return cls;
+    }
+    return MethodClass::kDefault;
+}
+
+} // namespace prodstarter
@@ -0,0 +1,57 @@
+// ProdStarterHub - C++ gRPC Service
+// src/call/method_class.h
+// Priority classes of RPC methods.
+//
+// Every call belongs to one class, assigned from its method name by the
+// call-context interceptor (call/call_interceptor.h) and read back by the
+// engines to pick the executor lane its handler runs on (exec/lane_executor.h):
+//
+//   system    health checking, reflection and the admin service; always, and
+//             nothing else can be put there
+//   critical  latency-sensitive methods
+//   default   everything not mapped
+//   bulk      exports, batch jobs and other long, throughput-bound work
+//
+// Rules come from --method-class PATTERN=CLASS, where PATTERN is a full method
+// name ("/myproto.Example/Lookup") or a prefix ending in '*' ("/myproto.Batch/*").
+// Exact names win over prefixes and longer prefixes over shorter ones.
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace prodstarter {
+
+enum class MethodClass { kSystem, kCritical, kDefault, kBulk };
+
+constexpr size_t kMethodClassCount = 4;
+
+// "system", "critical", "default", "bulk".
+const char* MethodClassName(MethodClass cls);
+
+// Parses an assignable class name; "system" is rejected.
+bool ParseMethodClass(std::string_view name, MethodClass* cls);
+
+// True for the methods of the services kept in the system class.
+bool IsSystemMethod(std::string_view method);
+
+class MethodClassifier {
+public:
+    // `rule` is "PATTERN=CLASS". Returns false with `error` set when it does not parse or targets a system method.
+    bool AddRule(const std::string& rule, std::string* error);
+
+    MethodClass Classify(std::string_view method) const;
+
+    bool empty() const { return exact_.empty() && prefixes_.empty(); }
+
+private:
+    std::unordered_map<std::string, MethodClass> exact_;
+    std::vector<std::pair<std::string, MethodClass>> prefixes_; // longest first
+};
+
+} // namespace prodstarter
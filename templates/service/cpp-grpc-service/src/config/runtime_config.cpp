@@ -0,0 +1,274 @@
+// ProdStarterHub - C++ gRPC Service
+// src/config/runtime_config.cpp
+
+#include "config/runtime_config.h"
+
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <utility>
+
+#include <spdlog/fmt/fmt.h>
+#include <spdlog/spdlog.h>
+
+#include "config/server_config.h"
+#include "exec/executor.h"
+
+namespace prodstarter {
+
+namespace {
+
+constexpr int kMaxConcurrencyLimit = 1000000;              // as --limiter-max
+constexpr int64_t kMinResponseCacheBytes = 1024 * 1024;    // as --response-cache-bytes
+constexpr const char* kLogLevels[] = {"trace", "debug", "info", "warn", "error", "critical", "off"};
+
+std::string Trim(const std::string& s) {
+    const size_t first = s.find_first_not_of(" \t\r");
+    if (first == std::string::npos) return {};
+    return s.substr(first, s.find_last_not_of(" \t\r") - first + 1);
+}
+
+bool ParseInt(const std::string& key, const std::string& value, int64_t min, int64_t max, int64_t* out,
+              std::string* error) {
+    size_t used = 0;
+    int64_t parsed = 0;
+    try {
+        parsed = std::stoll(value, &used);
+    } catch (const std::exception&) {
+        used = 0;
+    }
+    if (used == 0 || used != value.size() || parsed < min || parsed > max) {
+        *error = fmt::format("{}: expected an integer between {} and {}, got '{}'", key, min, max, value);
+        return false;
+    }
+    *out = parsed;
+    return true;
+}
+
+bool ParseLine(const std::string& line, RuntimeConfig* cfg, std::string* error) {
+    const size_t eq = line.find('=');
+    if (eq == std::string::npos) {
+        *error = fmt::format("expected key = value, got '{}'", line);
+        return false;
+    }
+    const std::string key = Trim(line.substr(0, eq));
+    const std::string value = Trim(line.substr(eq + 1));
+    int64_t n = 0;
+    if (key == "executor-threads") {
+        if (!ParseInt(key, value, 1, Executor::kMaxThreads, &n, error)) return false;
+        cfg->executor_threads = static_cast<int>(n);
+    } else if (key == "limiter-min" || key == "limiter-max") {
+        if (!ParseInt(key, value, 1, kMaxConcurrencyLimit, &n, error)) return false;
+        (key == "limiter-min" ? cfg->limiter_min : cfg->limiter_max) = static_cast<int>(n);
+    } else if (key == "response-cache-bytes") {
+        if (!ParseInt(key, value, kMinResponseCacheBytes, INT64_MAX, &n, error)) return false;
+        cfg->response_cache_bytes = n;
+    } else if (key == "log-level") {
+        if (std::find(std::begin(kLogLevels), std::end(kLogLevels), value) == std::end(kLogLevels)) {
+            *error = fmt::format("log-level: expected trace, debug, info, warn, error, critical or off, got '{}'",
+                                 value);
+            return false;
+        }
+        cfg->log_level = value;
+    } else if (key == "log-sample-rate") {
+        size_t used = 0;
+        double rate = 0;
+        try {
+            rate = std::stod(value, &used);
+        } catch (const std::exception&) {
+            used = 0;
+        }
+        if (used == 0 || used != value.size() || !(rate > 0 && rate <= 1)) {
+            *error = fmt::format("log-sample-rate: expected a rate in (0, 1], got '{}'", value);
+            return false;
+        }
+        cfg->log_sample_rate = rate;
+    } else {
+        *error = fmt::format("unknown key '{}'", key);
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+RuntimeConfig RuntimeConfigFromFlags(const ServerConfig& cfg) {
+    RuntimeConfig runtime;
+    runtime.executor_threads = cfg.num_executor_threads;
+    runtime.limiter_min = cfg.limiter_min;
+    runtime.limiter_max = cfg.limiter_max;
+    runtime.response_cache_bytes = cfg.response_cache_bytes;
+    runtime.log_level = cfg.verbose ? "debug" : "info";
+    runtime.log_sample_rate = cfg.log_sample_rate;
+    return runtime;
+}
+
+bool ParseRuntimeConfig(const std::string& text, const RuntimeConfig& base, RuntimeConfig* out, std::string* error) {
+    RuntimeConfig next = base;
+    std::string normalized = text;
+    std::replace(normalized.begin(), normalized.end(), ';', '\n');
+    std::istringstream lines(normalized);
+    std::string line;
+    for (int number = 1; std::getline(lines, line); ++number) {
+        line = Trim(line.substr(0, line.find('#')));
+        if (line.empty()) continue;
+        if (!ParseLine(line, &next, error)) {
+            *error = fmt::format("line {}: {}", number, *error);
+            return false;
+        }
+    }
+    if (next.limiter_min > next.limiter_max) {
+        *error = fmt::format("limiter-min {} is above limiter-max {}", next.limiter_min, next.limiter_max);
+        return false;
+    }
+    if (base.response_cache_bytes == 0 && next.response_cache_bytes != 0) {
+        *error = "response-cache-bytes: the response cache is off; enabling it needs --response-cache-bytes";
+        return false;
+    }
+    *out = std::move(next);
+    return true;
+}
+
+std::string DescribeChanges(const RuntimeConfig& from, const RuntimeConfig& to) {
+    std::string out;
+    auto add = [&out](const char* key, const auto& before, const auto& after) {
+        if (before == after) return;
+        out += fmt::format("{}{} {} -> {}", out.empty() ? "" : ", ", key, before, after);
+    };
+    add("executor-threads", from.executor_threads, to.executor_threads);
+    add("limiter-min", from.limiter_min, to.limiter_min);
+    add("limiter-max", from.limiter_max, to.limiter_max);
+    add("response-cache-bytes", from.response_cache_bytes, to.response_cache_bytes);
+    add("log-level", from.log_level, to.log_level);
+    add("log-sample-rate", from.log_sample_rate, to.log_sample_rate);
+    return out;
+}
+
+RuntimeConfigStore::RuntimeConfigStore(RuntimeConfig initial)
+    : current_(std::make_shared<const RuntimeConfig>(std::move(initial))) {}
+
+void RuntimeConfigStore::Subscribe(Check check, Apply apply) {
+    std::lock_guard<std::mutex> lock(mu_);
+    subscribers_.push_back({std::move(check), std::move(apply)});
+}
+
+bool RuntimeConfigStore::Update(const std::string& text, const std::string& source, RuntimeConfig* applied,
+                                std::string* error) {
+    std::lock_guard<std::mutex> lock(mu_);
+    // Only Update() stores current_, and it holds mu_, so this stays the current snapshot until we replace it.
+    const std::shared_ptr<const RuntimeConfig> snapshot = Current();
+    const RuntimeConfig& current = *snapshot;
+    RuntimeConfig next;
+    if (!ParseRuntimeConfig(text, current, &next, error)) return false;
+    const std::string changes = DescribeChanges(current, next);
+    if (changes.empty()) {
+        if (applied != nullptr) *applied = current;
+        return true;
+    }
+    next.version = current.version + 1;
+    next.source = source;
+    for (const auto& subscriber : subscribers_) {
+        if (subscriber.check && !subscriber.check(next, current, error)) return false;
+    }
+
+    for (const auto& subscriber : subscribers_) {
+        if (subscriber.apply) subscriber.apply(next, current);
+    }
+    auto published = std::make_shared<const RuntimeConfig>(std::move(next));
+    std::atomic_store(&current_, published);
+
+    spdlog::info("Runtime config v{} from {}: {}", published->version, source, changes);
+    if (applied != nullptr) *applied = *published;
+    return true;
+}
+
+RuntimeConfigWatcher::RuntimeConfigWatcher(RuntimeConfigStore& store, std::string path,
+                                           std::chrono::milliseconds interval)
+    : store_(store), path_(std::move(path)), interval_(interval) {}
+
+RuntimeConfigWatcher::~RuntimeConfigWatcher() {
+    Stop();
+}
+
+RuntimeConfigWatcher::FileStamp RuntimeConfigWatcher::Stat(int* error_number) const {
+    FileStamp stamp;
+    struct stat st {};
+    if (stat(path_.c_str(), &st) != 0) {
+        if (error_number != nullptr) *error_number = errno;
+        return stamp;
+    }
+    stamp.mtime_ns = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+    stamp.size = static_cast<int64_t>(st.st_size);
+    stamp.inode = static_cast<uint64_t>(st.st_ino);
+    return stamp;
+}
+
+bool RuntimeConfigWatcher::Load(FileStamp* stamp, std::string* error) {
+    int error_number = 0;
+    *stamp = Stat(&error_number);
+    if (stamp->size < 0) {
+        *error = fmt::format("cannot stat {}: {}", path_, std::strerror(error_number));
+        return false;
+    }
+
+    std::ifstream in(path_);
+    if (!in) {
+        *error = fmt::format("cannot read {}", path_);
+        return false;
+    }
+    const std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    if (!store_.Update(text, "file", nullptr, error)) {
+        *error = fmt::format("{}: {}", path_, *error);
+        return false;
+    }
+    return true;
+}
+
+bool RuntimeConfigWatcher::Start(std::string* error) {
+    if (!Load(&stamp_, error)) return false;
+    thread_ = std::thread(&RuntimeConfigWatcher::Run, this);
+    return true;
+}
+
+void RuntimeConfigWatcher::Reload() {
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        reload_ = true;
+    }
+    cv_.notify_all();
+}
+
+void RuntimeConfigWatcher::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    if (thread_.joinable()) thread_.join();
+}
+
+void RuntimeConfigWatcher::Run() {
+    std::unique_lock<std::mutex> lock(mu_);
+    for (;;) {
+        cv_.wait_for(lock, interval_, [this] { return stopping_ || reload_; });
+        if (stopping_) return;
+        const bool forced = std::exchange(reload_, false);
+        lock.unlock();
+
+        if (forced || Stat(nullptr) != stamp_) {
+            // The stamp is taken even when loading fails, so a broken file is reported once, not every poll.
+            std::string error;
+            if (!Load(&stamp_, &error)) spdlog::warn("Runtime config not applied: {}", error);
+        }
+        lock.lock();
+    }
+}
+
+} // namespace prodstarter
@@ -0,0 +1,150 @@
+// ProdStarterHub - C++ gRPC Service
+// src/config/runtime_config.h
+// Settings that can change while the server runs, as versioned snapshots.
+//
+// ServerConfig is parsed once; a restart to change a thread count or a limit
+// throws away connections, caches and every warmed-up pool. The settings below
+// can instead be changed live, from --runtime-config FILE (re-read when it
+// changes, or right away on SIGHUP) or with Admin/Reconfigure:
+//
+//   # key = value, one per line; keys not listed keep their current value
+//   executor-threads = 16        # Executor::Resize(), queued and running tasks are kept
+//   limiter-min = 8              # ConcurrencyLimiter::SetBounds()
+//   limiter-max = 2048
+//   response-cache-bytes = 268435456  # ResponseCache::SetMaxBytes(), evicts when shrinking
+//   log-level = debug            # trace | debug | info | warn | error | critical | off
+//   log-sample-rate = 0.01
+//
+// A change is all or nothing: it is parsed and validated, every subscriber's
+// check must accept it, and only then is it applied to each component and
+// published as the next snapshot. Updates are serialized; a rejected one
+// leaves the running configuration untouched.
+//
+// The hot path never reads the store. Each subscriber's Apply pushes its
+// part down into the component, e.g. Executor::Resize() or
+// ConcurrencyLimiter::SetBounds(), which keep it in their own atomics. The
+// snapshot itself is for reporting (Admin/Reconfigure, startup logs):
+// Current() returns a shared_ptr to an immutable RuntimeConfig that stays
+// valid for as long as it is held. std::atomic_load on a shared_ptr takes a
+// lock from a global pool in libstdc++, so keep Current() off per-call paths.
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace prodstarter {
+
+struct ServerConfig;
+
+struct RuntimeConfig {
+    uint64_t version = 1;             // 1 for the command line, +1 per applied change
+    std::string source = "flags";     // flags | file | admin
+    int executor_threads = 1;
+    int limiter_min = 4;
+    int limiter_max = 1024;
+    int64_t response_cache_bytes = 0; // 0: no cache; it cannot be created or removed at runtime
+    std::string log_level = "info";
+    double log_sample_rate = 1.0;
+};
+
+// The snapshot the command line describes (version 1).
+RuntimeConfig RuntimeConfigFromFlags(const ServerConfig& cfg);
+
+// Lays the "key = value" lines of `text` over `base` into `out`. Lines may also be separated by ';', and '#'
+// starts a comment. Returns false with `error` set on unknown keys and invalid values.
+bool ParseRuntimeConfig(const std::string& text, const RuntimeConfig& base, RuntimeConfig* out, std::string* error);
+
+// "key old -> new" for every setting that differs, comma separated; empty when none does.
+std::string DescribeChanges(const RuntimeConfig& from, const RuntimeConfig& to);
+
+class RuntimeConfigStore {
+public:
+    // Rejects a candidate with `error` set; a rejection by any subscriber cancels the whole update.
+    using Check = std::function<bool(const RuntimeConfig& next, const RuntimeConfig& current, std::string* error)>;
+    // Applies a candidate every subscriber accepted. Runs before the snapshot is published.
+    using Apply = std::function<void(const RuntimeConfig& next, const RuntimeConfig& current)>;
+
+    explicit RuntimeConfigStore(RuntimeConfig initial);
+
+    RuntimeConfigStore(const RuntimeConfigStore&) = delete;
+    RuntimeConfigStore& operator=(const RuntimeConfigStore&) = delete;
+
+    // Registers a component. Must be called before the first Update(); `check` may be empty.
+    void Subscribe(Check check, Apply apply);
+
+    // The current snapshot, never null. Not lock-free; for admin and reporting, not per call.
+    std::shared_ptr<const RuntimeConfig> Current() const { return std::atomic_load(&current_); }
+
+    // Parses `text` over the current snapshot and applies it. On success `applied` (may be null) receives the new
+    // snapshot, or the current one when nothing changed; no version is used up then. A rejected update returns
+    // false with `error` set and is not logged; that is up to the caller.
+    bool Update(const std::string& text, const std::string& source, RuntimeConfig* applied, std::string* error);
+
+private:
+    struct Subscriber {
+        Check check;
+        Apply apply;
+    };
+
+    std::mutex mu_; // serializes Update(); guards subscribers_
+    std::vector<Subscriber> subscribers_;
+    std::shared_ptr<const RuntimeConfig> current_; // only through std::atomic_load / std::atomic_store
+};
+
+// Applies --runtime-config FILE to the store: once at Start(), then whenever its modification time, size or inode
+// changes, and on Reload().
+class RuntimeConfigWatcher {
+public:
+    RuntimeConfigWatcher(RuntimeConfigStore& store, std::string path,
+                         std::chrono::milliseconds interval = std::chrono::seconds(2));
+    ~RuntimeConfigWatcher();
+
+    RuntimeConfigWatcher(const RuntimeConfigWatcher&) = delete;
+    RuntimeConfigWatcher& operator=(const RuntimeConfigWatcher&) = delete;
+
+    // Applies the file and starts polling it. Returns false with `error` set when the file cannot be read or is
+    // rejected; the watcher is not started then.
+    bool Start(std::string* error);
+
+    // Re-reads the file on the watcher thread now, e.g. from a SIGHUP handler.
+    void Reload();
+
+    void Stop();
+
+    const std::string& path() const { return path_; }
+
+private:
+    struct FileStamp {
+        int64_t mtime_ns = -1;
+        int64_t size = -1;
+        uint64_t inode = 0;
+        bool operator!=(const FileStamp& other) const {
+            return mtime_ns != other.mtime_ns || size != other.size || inode != other.inode;
+        }
+    };
+
+    FileStamp Stat(int* error_number) const; // size -1 when the file cannot be stat'ed
+    bool Load(FileStamp* stamp, std::string* error);
+    void Run();
+
+    RuntimeConfigStore& store_;
+    const std::string path_;
+    const std::chrono::milliseconds interval_;
+    FileStamp stamp_; // of the last version read; owned by the watcher thread after Start()
+
+    std::mutex mu_;
+    std::condition_variable cv_;
+    bool reload_ = false;
+    bool stopping_ = false;
+    std::thread thread_;
+};
+
+} // namespace prodstarter
@@ -0,0 +1,488 @@
+// ProdStarterHub - C++ gRPC Service
+// src/config/server_config.cpp
+
+#include "config/server_config.h"
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <exception>
+#include <iterator>
+#include <optional>
+#include <utility>
+
+#include <spdlog/fmt/fmt.h>
+
+#include "call/method_class.h"
+#include "exec/cpu_topology.h"
+#include "exec/executor.h"
+#include "lifecycle/warmup.h"
+#include "server/compression_policy.h"
+
+namespace prodstarter {
+
+namespace {
+
+constexpr int kMaxShards = 256;
+constexpr int64_t kMinArenaBlockBytes = 256;
+constexpr int64_t kMaxArenaBlockBytes = 64 * 1024 * 1024;
+constexpr int kMaxLogQueueSize = 1 << 20;
+constexpr int kMaxSlowCalls = 1024;
+constexpr int64_t kMinSlowCallWindowSeconds = 5; // one second per LatencyBreakdown interval
+constexpr int64_t kMaxSlowCallWindowSeconds = 24 * 3600;
+constexpr int kMaxConcurrencyLimit = 1000000;
+constexpr int64_t kMinResponseCacheBytes = 1024 * 1024;
+constexpr int64_t kMaxTlsReloadSeconds = 24 * 3600;
+constexpr int kMaxChannelPoolSize = 64;
+constexpr int64_t kMinStreamQueueBytes = 4 * 1024;
+constexpr int kMaxStreamFlushDelayUs = 100000;
+constexpr int kMaxLaneThreads = 1024;
+constexpr int kMaxLaneWeight = 1000;
+constexpr int kMaxReservedThreads = 64;
+constexpr int64_t kMaxCompressionMinBytes = 64 * 1024 * 1024;
+constexpr int kMaxProfileSeconds = 300;
+constexpr int64_t kMaxWarmupTimeoutMs = 600 * 1000;
+constexpr int kMaxTraceSlowMs = 600 * 1000;
+constexpr int kMinWatchdogIntervalMs = 10;
+constexpr int kMaxWatchdogIntervalMs = 60 * 1000;
+
+// Per-field tuning flags win over the preset regardless of argument order.
+struct TuningOverrides {
+    std::optional<int64_t> resource_quota_bytes;
+    std::optional<int> max_threads;
+    std::optional<int> max_concurrent_streams;
+    std::optional<bool> bdp_probe;
+    std::optional<int> keepalive_time_ms;
+    std::optional<int> keepalive_timeout_ms;
+    std::optional<int> max_connection_age_ms;
+    std::optional<int> max_connection_age_grace_ms;
+    std::optional<int> max_connection_idle_ms;
+    std::optional<int> min_recv_ping_interval_ms;
+    std::optional<int> max_ping_strikes;
+    std::optional<int> max_receive_message_bytes;
+    std::optional<int> max_send_message_bytes;
+};
+
+bool ParseBool(const std::string& value) {
+    if (value == "on" || value == "true" || value == "1") return true;
+    if (value == "off" || value == "false" || value == "0") return false;
+    throw std::invalid_argument("expected on|off");
+}
+
+std::string JoinProfiles() {
+    std::string joined;
+    for (const auto& name : TuningProfileNames()) {
+        if (!joined.empty()) joined += "|";
+        joined += name;
+    }
+    return joined;
+}
+
+} // namespace
+
+ParseOutcome ParseArgs(int argc, char** argv, ServerConfig& cfg, std::string& error) {
+    std::string profile = cfg.tuning.profile;
+    TuningOverrides overrides;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        std::optional<std::string> inline_value;
+        const auto eq = arg.find('=');
+        if (arg.rfind("--", 0) == 0 && eq != std::string::npos) {
+            inline_value = arg.substr(eq + 1);
+            arg.resize(eq);
+        }
+        // Value of the current flag: `--flag=value` or the next argument.
+        auto value = [&]() -> std::string {
+            if (inline_value) return *inline_value;
+            if (i + 1 >= argc) throw std::invalid_argument("missing value");
+            return argv[++i];
+        };
+
+        try {
+            if (arg == "--bind") { cfg.bind_address = value(); }
+            else if (arg == "--unix-listen") { cfg.unix_listeners.push_back(value()); }
+            else if (arg == "--tls") { cfg.enable_tls = true; }
+            else if (arg == "--cert") { cfg.cert_chain_file = value(); }
+            else if (arg == "--key") { cfg.private_key_file = value(); }
+            else if (arg == "--root") { cfg.root_cert_file = value(); }
+            else if (arg == "--tls-reload-interval") {
+                cfg.tls_reload_interval = std::chrono::seconds(std::stoll(value()));
+            }
+            else if (arg == "--no-reflection") { cfg.enable_reflection = false; }
+            else if (arg == "--no-admin") { cfg.enable_admin = false; }
+            else if (arg == "--slow-calls") { cfg.slow_call_capacity = std::stoi(value()); }
+            else if (arg == "--slow-call-window") {
+                cfg.slow_call_window = std::chrono::seconds(std::stoll(value()));
+            }
+            else if (arg == "--admin-token-file") { cfg.admin_token_file = value(); }
+            else if (arg == "--profile-dir") { cfg.profile_dir = value(); }
+            else if (arg == "--runtime-config") { cfg.runtime_config_file = value(); }
+            else if (arg == "--profile-seconds") { cfg.profile_seconds = std::stoi(value()); }
+            else if (arg == "--prometheus") { cfg.enable_prometheus = true; }
+            else if (arg == "--metrics-bind") { cfg.metrics_bind_address = value(); }
+            else if (arg == "--otlp-endpoint") { cfg.otlp_endpoint = value(); }
+            else if (arg == "--service-name") { cfg.service_name = value(); }
+            else if (arg == "--trace-sample-rate") { cfg.trace_sample_rate = std::stod(value()); }
+            else if (arg == "--trace-slow-ms") { cfg.trace_slow_ms = std::stoi(value()); }
+            else if (arg == "--threads") { cfg.num_worker_threads = std::stoi(value()); }
+            else if (arg == "--executor-threads") { cfg.num_executor_threads = std::stoi(value()); }
+            else if (arg == "--cpu-set") {
+                std::string cpu_error;
+                if (!ParseCpuList(value(), &cfg.cpu_set, &cpu_error)) throw std::invalid_argument(cpu_error);
+            }
+            else if (arg == "--numa-policy") { cfg.numa_policy = value(); }
+            else if (arg == "--engine") { cfg.engine = value(); }
+            else if (arg == "--passthrough-upstream") { cfg.passthrough_upstream = value(); }
+            else if (arg == "--channel-pool-size") { cfg.channel_pool_size = std::stoi(value()); }
+            else if (arg == "--channel-pool-pick") { cfg.channel_pool_pick = value(); }
+            else if (arg == "--lane-threads") { cfg.lane_threads = std::stoi(value()); }
+            else if (arg == "--method-class") { cfg.method_classes.push_back(value()); }
+            else if (arg == "--critical-weight") { cfg.critical_weight = std::stoi(value()); }
+            else if (arg == "--default-weight") { cfg.default_weight = std::stoi(value()); }
+            else if (arg == "--bulk-weight") { cfg.bulk_weight = std::stoi(value()); }
+            else if (arg == "--bulk-max-threads") { cfg.bulk_max_threads = std::stoi(value()); }
+            else if (arg == "--reserved-threads") { cfg.reserved_threads = std::stoi(value()); }
+            else if (arg == "--shards") { cfg.num_shards = std::stoi(value()); }
+            else if (arg == "--drain-timeout") {
+                cfg.drain_timeout = std::chrono::milliseconds(static_cast<int64_t>(std::stod(value()) * 1000));
+            }
+            else if (arg == "--warmup-timeout") {
+                cfg.warmup_timeout = std::chrono::milliseconds(static_cast<int64_t>(std::stod(value()) * 1000));
+            }
+            else if (arg == "--warmup-call") { cfg.warmup_calls.push_back(value()); }
+            else if (arg == "--track-cancellation") { cfg.track_cancellation = ParseBool(value()); }
+            else if (arg == "--arenas") { cfg.arenas = ParseBool(value()); }
+            else if (arg == "--arena-initial-block-bytes") { cfg.arena_initial_block_bytes = std::stoll(value()); }
+            else if (arg == "--arena-max-block-bytes") { cfg.arena_max_block_bytes = std::stoll(value()); }
+            else if (arg == "--response-cache-bytes") { cfg.response_cache_bytes = std::stoll(value()); }
+            else if (arg == "--coalesce") { cfg.coalesce = ParseBool(value()); }
+            else if (arg == "--stream-max-queued-bytes") { cfg.stream_max_queued_bytes = std::stoll(value()); }
+            else if (arg == "--stream-flush-bytes") { cfg.stream_flush_bytes = std::stoll(value()); }
+            else if (arg == "--stream-flush-delay-us") { cfg.stream_flush_delay_us = std::stoi(value()); }
+            else if (arg == "--compression") { cfg.compression = value(); }
+            else if (arg == "--compression-method") { cfg.compression_methods.push_back(value()); }
+            else if (arg == "--compression-min-bytes") { cfg.compression_min_bytes = std::stoll(value()); }
+            else if (arg == "--tuning") { profile = value(); }
+            else if (arg == "--resource-quota-bytes") { overrides.resource_quota_bytes = std::stoll(value()); }
+            else if (arg == "--max-threads") { overrides.max_threads = std::stoi(value()); }
+            else if (arg == "--max-concurrent-streams") { overrides.max_concurrent_streams = std::stoi(value()); }
+            else if (arg == "--bdp-probe") { overrides.bdp_probe = ParseBool(value()); }
+            else if (arg == "--keepalive-time-ms") { overrides.keepalive_time_ms = std::stoi(value()); }
+            else if (arg == "--keepalive-timeout-ms") { overrides.keepalive_timeout_ms = std::stoi(value()); }
+            else if (arg == "--max-connection-age-ms") { overrides.max_connection_age_ms = std::stoi(value()); }
+            else if (arg == "--max-connection-age-grace-ms") {
+                overrides.max_connection_age_grace_ms = std::stoi(value());
+            }
+            else if (arg == "--max-connection-idle-ms") { overrides.max_connection_idle_ms = std::stoi(value()); }
+            else if (arg == "--min-recv-ping-interval-ms") { overrides.min_recv_ping_interval_ms = std::stoi(value()); }
+            else if (arg == "--max-ping-strikes") { overrides.max_ping_strikes = std::stoi(value()); }
+            else if (arg == "--max-recv-message-bytes") { overrides.max_receive_message_bytes = std::stoi(value()); }
+            else if (arg == "--max-send-message-bytes") { overrides.max_send_message_bytes = std::stoi(value()); }
+            else if (arg == "--limiter") { cfg.limiter = value(); }
+            else if (arg == "--limiter-scope") { cfg.limiter_scope = value(); }
+            else if (arg == "--limiter-initial") { cfg.limiter_initial = std::stoi(value()); }
+            else if (arg == "--limiter-min") { cfg.limiter_min = std::stoi(value()); }
+            else if (arg == "--limiter-max") { cfg.limiter_max = std::stoi(value()); }
+            else if (arg == "--limiter-latency-ms") { cfg.limiter_latency_ms = std::stoi(value()); }
+            else if (arg == "--overload-health-service") { cfg.overload_health_service = value(); }
+            else if (arg == "--overload-after-ms") { cfg.overload_after_ms = std::stoi(value()); }
+            else if (arg == "--watchdog-interval-ms") { cfg.watchdog_interval_ms = std::stoi(value()); }
+            else if (arg == "--saturation-lag-ms") { cfg.saturation_lag_ms = std::stoi(value()); }
+            else if (arg == "--saturation-after-ms") { cfg.saturation_after_ms = std::stoi(value()); }
+            else if (arg == "--saturation-health-service") { cfg.saturation_health_service = value(); }
+            else if (arg == "--verbose") { cfg.verbose = true; }
+            else if (arg == "--log-mode") { cfg.log_mode = value(); }
+            else if (arg == "--log-queue-size") { cfg.log_queue_size = std::stoi(value()); }
+            else if (arg == "--log-sample-rate") { cfg.log_sample_rate = std::stod(value()); }
+            else if (arg == "--help") { return ParseOutcome::kHelp; }
+        } catch (const std::exception& ex) {
+            error = fmt::format("invalid value for {}: {}", arg, ex.what());
+            return ParseOutcome::kError;
+        }
+    }
+
+    // Thread counts left at 0 follow the CPUs this process may actually use, not the host's core count.
+    const int usable_cpus = DetectCpuTopology(cfg.cpu_set).usable_cpus();
+    if (cfg.num_worker_threads == 0) cfg.num_worker_threads = usable_cpus;
+    if (cfg.num_executor_threads == 0) cfg.num_executor_threads = usable_cpus;
+
+    if (!TuningForProfile(profile, usable_cpus, cfg.tuning)) {
+        error = fmt::format("unknown tuning profile '{}' (expected {})", profile, JoinProfiles());
+        return ParseOutcome::kError;
+    }
+    TuningConfig& t = cfg.tuning;
+    if (overrides.resource_quota_bytes) t.resource_quota_bytes = *overrides.resource_quota_bytes;
+    if (overrides.max_threads) t.max_threads = *overrides.max_threads;
+    if (overrides.max_concurrent_streams) t.max_concurrent_streams = *overrides.max_concurrent_streams;
+    if (overrides.bdp_probe) t.bdp_probe = *overrides.bdp_probe;
+    if (overrides.keepalive_time_ms) t.keepalive_time_ms = *overrides.keepalive_time_ms;
+    if (overrides.keepalive_timeout_ms) t.keepalive_timeout_ms = *overrides.keepalive_timeout_ms;
+    if (overrides.max_connection_age_ms) t.max_connection_age_ms = *overrides.max_connection_age_ms;
+    if (overrides.max_connection_age_grace_ms) t.max_connection_age_grace_ms = *overrides.max_connection_age_grace_ms;
+    if (overrides.max_connection_idle_ms) t.max_connection_idle_ms = *overrides.max_connection_idle_ms;
+    if (overrides.min_recv_ping_interval_ms) t.min_recv_ping_interval_ms = *overrides.min_recv_ping_interval_ms;
+    if (overrides.max_ping_strikes) t.max_ping_strikes = *overrides.max_ping_strikes;
+    if (overrides.max_receive_message_bytes) t.max_receive_message_bytes = *overrides.max_receive_message_bytes;
+    if (overrides.max_send_message_bytes) t.max_send_message_bytes = *overrides.max_send_message_bytes;
+    return ParseOutcome::kRun;
+}
+
+std::vector<std::string> ValidateConfig(ServerConfig& cfg) {
+    std::vector<std::string> errors;
+    for (const auto& address : cfg.unix_listeners) {
+        const bool unix_path = address.rfind("unix:", 0) == 0 && address.size() > 5;
+        const bool unix_abstract = address.rfind("unix-abstract:", 0) == 0 && address.size() > 14;
+        if (!unix_path && !unix_abstract) {
+            errors.push_back(fmt::format("--unix-listen {}: expected unix:PATH or unix-abstract:NAME", address));
+        }
+    }
+    if (cfg.engine != "sync" && cfg.engine != "async" && cfg.engine != "callback" && cfg.engine != "generic") {
+        errors.push_back(fmt::format("unknown engine '{}' (expected sync, async, callback or generic)", cfg.engine));
+    }
+    if (!cfg.passthrough_upstream.empty() && cfg.engine != "generic") {
+        errors.push_back("--passthrough-upstream requires --engine generic");
+    }
+    if (cfg.channel_pool_size < 1 || cfg.channel_pool_size > kMaxChannelPoolSize) {
+        errors.push_back(fmt::format("channel pool size must be between 1 and {}, got {}", kMaxChannelPoolSize,
+                                     cfg.channel_pool_size));
+    }
+    if (cfg.channel_pool_pick != "round-robin" && cfg.channel_pool_pick != "least-loaded") {
+        errors.push_back(fmt::format("unknown channel pool pick '{}' (expected round-robin or least-loaded)",
+                                     cfg.channel_pool_pick));
+    }
+    if (cfg.lane_threads < 0 || cfg.lane_threads > kMaxLaneThreads) {
+        errors.push_back(fmt::format("lane threads must be between 0 and {}, got {}", kMaxLaneThreads,
+                                     cfg.lane_threads));
+    }
+    if (cfg.lane_threads > 0 && cfg.engine == "sync") {
+        // Sync handlers run on gRPC's own pool; there is no point at which they could be queued on a lane.
+        errors.push_back("--lane-threads requires --engine async, callback or generic");
+    }
+    if (!cfg.method_classes.empty() && cfg.lane_threads == 0) {
+        errors.push_back("--method-class requires --lane-threads");
+    }
+    MethodClassifier classifier;
+    for (const auto& rule : cfg.method_classes) {
+        std::string error;
+        if (!classifier.AddRule(rule, &error)) errors.push_back(fmt::format("--method-class {}: {}", rule, error));
+    }
+    for (const auto& [flag, weight] : {std::pair<const char*, int>{"--critical-weight", cfg.critical_weight},
+                                       {"--default-weight", cfg.default_weight},
+                                       {"--bulk-weight", cfg.bulk_weight}}) {
+        if (weight < 1 || weight > kMaxLaneWeight) {
+            errors.push_back(fmt::format("{} must be between 1 and {}, got {}", flag, kMaxLaneWeight, weight));
+        }
+    }
+    if (cfg.bulk_max_threads < 0 || (cfg.lane_threads > 0 && cfg.bulk_max_threads > cfg.lane_threads)) {
+        errors.push_back(fmt::format("bulk max threads must be between 0 and the lane threads ({}), got {}",
+                                     cfg.lane_threads, cfg.bulk_max_threads));
+    }
+    if (cfg.reserved_threads < 0 || cfg.reserved_threads > kMaxReservedThreads) {
+        errors.push_back(fmt::format("reserved threads must be between 0 and {}, got {}", kMaxReservedThreads,
+                                     cfg.reserved_threads));
+    }
+    if (cfg.num_shards < 1 || cfg.num_shards > kMaxShards) {
+        errors.push_back(fmt::format("shards must be between 1 and {}, got {}", kMaxShards, cfg.num_shards));
+    }
+    // Anything smaller cannot hold the arena's own block header and would be ignored.
+    if (cfg.arena_initial_block_bytes != 0 &&
+        (cfg.arena_initial_block_bytes < kMinArenaBlockBytes || cfg.arena_initial_block_bytes > kMaxArenaBlockBytes)) {
+        errors.push_back(fmt::format("arena initial block must be 0 or between {} and {} bytes, got {}",
+                                     kMinArenaBlockBytes, kMaxArenaBlockBytes, cfg.arena_initial_block_bytes));
+    }
+    if (cfg.arena_max_block_bytes < kMinArenaBlockBytes || cfg.arena_max_block_bytes > kMaxArenaBlockBytes) {
+        errors.push_back(fmt::format("arena max block must be between {} and {} bytes, got {}", kMinArenaBlockBytes,
+                                     kMaxArenaBlockBytes, cfg.arena_max_block_bytes));
+    }
+    if (cfg.response_cache_bytes != 0 && cfg.response_cache_bytes < kMinResponseCacheBytes) {
+        errors.push_back(fmt::format("response cache must be 0 (disabled) or at least {} bytes, got {}",
+                                     kMinResponseCacheBytes, cfg.response_cache_bytes));
+    }
+    if (cfg.stream_max_queued_bytes < kMinStreamQueueBytes) {
+        errors.push_back(fmt::format("stream queue budget must be at least {} bytes, got {}", kMinStreamQueueBytes,
+                                     cfg.stream_max_queued_bytes));
+    }
+    if (cfg.stream_flush_bytes < 0 || cfg.stream_flush_bytes > cfg.stream_max_queued_bytes) {
+        errors.push_back(fmt::format("stream flush size must be between 0 and the queue budget ({}), got {}",
+                                     cfg.stream_max_queued_bytes, cfg.stream_flush_bytes));
+    }
+    if (cfg.stream_flush_delay_us < 0 || cfg.stream_flush_delay_us > kMaxStreamFlushDelayUs) {
+        errors.push_back(fmt::format("stream flush delay must be between 0 and {} us, got {}", kMaxStreamFlushDelayUs,
+                                     cfg.stream_flush_delay_us));
+    }
+    grpc_compression_level level = GRPC_COMPRESS_LEVEL_NONE;
+    if (!ParseCompressionLevel(cfg.compression, &level)) {
+        errors.push_back(fmt::format("unknown compression '{}' (expected none, low, medium, high, gzip or deflate)",
+                                     cfg.compression));
+    }
+    CompressionPolicy compression_rules({});
+    for (const auto& rule : cfg.compression_methods) {
+        std::string error;
+        if (!compression_rules.AddRule(rule, &error)) {
+            errors.push_back(fmt::format("--compression-method {}: {}", rule, error));
+        }
+    }
+    if (cfg.compression_min_bytes < 0 || cfg.compression_min_bytes > kMaxCompressionMinBytes) {
+        errors.push_back(fmt::format("compression min bytes must be between 0 and {}, got {}",
+                                     kMaxCompressionMinBytes, cfg.compression_min_bytes));
+    }
+    if (cfg.warmup_timeout.count() < 0 || cfg.warmup_timeout.count() > kMaxWarmupTimeoutMs) {
+        errors.push_back(fmt::format("warm-up timeout must be between 0 and {} seconds, got {:.3f}",
+                                     kMaxWarmupTimeoutMs / 1000, cfg.warmup_timeout.count() / 1000.0));
+    }
+    for (const auto& call : cfg.warmup_calls) {
+        std::string method;
+        int count = 0;
+        std::string error;
+        if (!ParseWarmupCall(call, &method, &count, &error)) {
+            errors.push_back(fmt::format("--warmup-call {}: {}", call, error));
+        }
+    }
+    if (cfg.slow_call_capacity < 0 || cfg.slow_call_capacity > kMaxSlowCalls) {
+        errors.push_back(fmt::format("slow calls must be between 0 and {}, got {}", kMaxSlowCalls,
+                                     cfg.slow_call_capacity));
+    }
+    if (cfg.slow_call_window.count() < kMinSlowCallWindowSeconds ||
+        cfg.slow_call_window.count() > kMaxSlowCallWindowSeconds) {
+        errors.push_back(fmt::format("slow call window must be between {} and {} seconds, got {}",
+                                     kMinSlowCallWindowSeconds, kMaxSlowCallWindowSeconds,
+                                     cfg.slow_call_window.count()));
+    }
+    if (!cfg.profile_dir.empty()) {
+        struct stat st {};
+        if (stat(cfg.profile_dir.c_str(), &st) != 0 || !S_ISDIR(st.st_mode)) {
+            errors.push_back(fmt::format("profile directory '{}' does not exist", cfg.profile_dir));
+        } else if (access(cfg.profile_dir.c_str(), W_OK) != 0) {
+            errors.push_back(fmt::format("profile directory '{}' is not writable", cfg.profile_dir));
+        }
+    }
+    if (cfg.profile_seconds < 1 || cfg.profile_seconds > kMaxProfileSeconds) {
+        errors.push_back(fmt::format("profile seconds must be between 1 and {}, got {}", kMaxProfileSeconds,
+                                     cfg.profile_seconds));
+    }
+    if (cfg.limiter != "off" && cfg.limiter != "aimd" && cfg.limiter != "gradient") {
+        errors.push_back(fmt::format("unknown limiter '{}' (expected off, aimd or gradient)", cfg.limiter));
+    }
+    if (cfg.limiter_scope != "global" && cfg.limiter_scope != "method") {
+        errors.push_back(fmt::format("unknown limiter scope '{}' (expected global or method)", cfg.limiter_scope));
+    }
+    if (cfg.limiter_min < 1 || cfg.limiter_min > cfg.limiter_max || cfg.limiter_max > kMaxConcurrencyLimit ||
+        cfg.limiter_initial < cfg.limiter_min || cfg.limiter_initial > cfg.limiter_max) {
+        errors.push_back(fmt::format("limiter limits must satisfy 1 <= min <= initial <= max <= {}, got min={} "
+                                     "initial={} max={}",
+                                     kMaxConcurrencyLimit, cfg.limiter_min, cfg.limiter_initial, cfg.limiter_max));
+    }
+    if (cfg.limiter_latency_ms < 0) {
+        errors.push_back(fmt::format("limiter latency must be >= 0 ms, got {}", cfg.limiter_latency_ms));
+    }
+    if (cfg.overload_after_ms < 100) {
+        errors.push_back(fmt::format("overload period must be at least 100 ms, got {}", cfg.overload_after_ms));
+    }
+    if (cfg.watchdog_interval_ms != 0 &&
+        (cfg.watchdog_interval_ms < kMinWatchdogIntervalMs || cfg.watchdog_interval_ms > kMaxWatchdogIntervalMs)) {
+        errors.push_back(fmt::format("watchdog interval must be 0 (off) or between {} and {} ms, got {}",
+                                     kMinWatchdogIntervalMs, kMaxWatchdogIntervalMs, cfg.watchdog_interval_ms));
+    }
+    if (cfg.saturation_lag_ms < 1) {
+        errors.push_back(fmt::format("saturation lag threshold must be at least 1 ms, got {}", cfg.saturation_lag_ms));
+    }
+    if (cfg.saturation_after_ms < std::max(100, cfg.watchdog_interval_ms)) {
+        errors.push_back(fmt::format("saturation period must be at least 100 ms and one watchdog interval, got {}",
+                                     cfg.saturation_after_ms));
+    }
+    if (!cfg.saturation_health_service.empty() && cfg.watchdog_interval_ms == 0) {
+        errors.push_back("--saturation-health-service needs the watchdog (--watchdog-interval-ms > 0)");
+    }
+    if (!(cfg.trace_sample_rate >= 0 && cfg.trace_sample_rate <= 1)) {
+        errors.push_back(fmt::format("trace sample rate must be in [0, 1], got {}", cfg.trace_sample_rate));
+    }
+    if (cfg.trace_slow_ms < 1 || cfg.trace_slow_ms > kMaxTraceSlowMs) {
+        errors.push_back(fmt::format("trace slow threshold must be between 1 and {} ms, got {}", kMaxTraceSlowMs,
+                                     cfg.trace_slow_ms));
+    }
+    if (!cfg.otlp_endpoint.empty() && cfg.service_name.empty()) {
+        errors.push_back("service name must not be empty when tracing is enabled");
+    }
+    if (cfg.log_mode != "console" && cfg.log_mode != "async-json") {
+        errors.push_back(fmt::format("unknown log mode '{}' (expected console or async-json)", cfg.log_mode));
+    }
+    if (cfg.log_queue_size < 64 || cfg.log_queue_size > kMaxLogQueueSize) {
+        errors.push_back(fmt::format("log queue size must be between 64 and {}, got {}", kMaxLogQueueSize,
+                                     cfg.log_queue_size));
+    }
+    if (!(cfg.log_sample_rate > 0 && cfg.log_sample_rate <= 1)) {
+        errors.push_back(fmt::format("log sample rate must be in (0, 1], got {}", cfg.log_sample_rate));
+    }
+    if (cfg.enable_tls && (cfg.cert_chain_file.empty() || cfg.private_key_file.empty())) {
+        errors.push_back("TLS enabled but cert or key file not provided");
+    }
+    if (cfg.tls_reload_interval.count() < 0 || cfg.tls_reload_interval.count() > kMaxTlsReloadSeconds) {
+        errors.push_back(fmt::format("TLS reload interval must be between 0 and {} seconds, got {}",
+                                     kMaxTlsReloadSeconds, cfg.tls_reload_interval.count()));
+    }
+    if (cfg.numa_policy != "off" && cfg.numa_policy != "shard") {
+        errors.push_back(fmt::format("unknown NUMA policy '{}' (expected off or shard)", cfg.numa_policy));
+    }
+    if (!cfg.cpu_set.empty()) {
+        const CpuTopology topology = DetectCpuTopology(cfg.cpu_set);
+        std::vector<int> outside;
+        std::set_difference(cfg.cpu_set.begin(), cfg.cpu_set.end(), topology.allowed.begin(), topology.allowed.end(),
+                            std::back_inserter(outside));
+        if (!outside.empty()) {
+            errors.push_back(fmt::format("CPU set includes CPUs {} outside the process affinity mask {}",
+                                         FormatCpuList(outside), FormatCpuList(topology.allowed)));
+        }
+    }
+    if (cfg.num_executor_threads > Executor::kMaxThreads) {
+        errors.push_back(fmt::format("executor threads must be at most {}, got {}", Executor::kMaxThreads,
+                                     cfg.num_executor_threads));
+    }
+    // Never run with fewer than one thread.
+    if (cfg.num_worker_threads < 1) cfg.num_worker_threads = 1;
+    if (cfg.num_executor_threads < 1) cfg.num_executor_threads = 1;
+    if (cfg.drain_timeout.count() < 0) cfg.drain_timeout = std::chrono::milliseconds(0);
+    ValidateTuning(cfg.tuning, errors);
+    return errors;
+}
+
+std::string Usage(const char* argv0) {
+    return fmt::format(
+        "Usage: {} [--bind host:port] [--unix-listen unix:PATH|unix-abstract:NAME]...\n"
+        "          [--tls --cert cert.pem --key key.pem [--root ca.pem]]\n"
+        "          [--tls-reload-interval SECONDS] [--no-reflection] [--no-admin] [--slow-calls N]\n"
+        "          [--slow-call-window SECONDS] [--admin-token-file PATH]\n"
+        "          [--profile-dir DIR [--profile-seconds N]] [--runtime-config PATH]\n"
+        "          [--prometheus [--metrics-bind host:port]]\n"
+        "          [--otlp-endpoint host:port [--service-name NAME] [--trace-sample-rate R]\n"
+        "           [--trace-slow-ms N]]\n"
+        "          [--threads N] [--executor-threads N] [--engine sync|async|callback|generic]\n"
+        "          [--cpu-set LIST] [--numa-policy off|shard]\n"
+        "          [--passthrough-upstream host:port] [--channel-pool-size N]\n"
+        "          [--channel-pool-pick round-robin|least-loaded] [--shards N] [--drain-timeout SECONDS]\n"
+        "          [--track-cancellation on|off] [--warmup-timeout SECONDS] [--warmup-call METHOD[=COUNT]]...\n"
+        "          [--verbose]\n"
+        "          [--lane-threads N [--method-class PATTERN=critical|default|bulk]... [--critical-weight N]\n"
+        "           [--default-weight N] [--bulk-weight N] [--bulk-max-threads N] [--reserved-threads N]]\n"
+        "          [--log-mode console|async-json] [--log-queue-size N] [--log-sample-rate R]\n"
+        "          [--arenas on|off] [--arena-initial-block-bytes N] [--arena-max-block-bytes N]\n"
+        "          [--response-cache-bytes N] [--coalesce on|off]\n"
+        "          [--stream-max-queued-bytes N] [--stream-flush-bytes N] [--stream-flush-delay-us N]\n"
+        "          [--compression none|low|medium|high|gzip|deflate]\n"
+        "          [--compression-method PATTERN=LEVEL]... [--compression-min-bytes N]\n"
+        "          [--limiter off|aimd|gradient] [--limiter-scope global|method] [--limiter-initial N]\n"
+        "          [--limiter-min N] [--limiter-max N] [--limiter-latency-ms N]\n"
+        "          [--overload-health-service NAME] [--overload-after-ms N]\n"
+        "          [--watchdog-interval-ms N] [--saturation-lag-ms N] [--saturation-after-ms N]\n"
+        "          [--saturation-health-service NAME]\n"
+        "          [--tuning {}] [--resource-quota-bytes N] [--max-threads N]\n"
+        "          [--max-concurrent-streams N] [--bdp-probe on|off] [--keepalive-time-ms N]\n"
+        "          [--keepalive-timeout-ms N] [--max-recv-message-bytes N] [--max-send-message-bytes N]\n"
+        "          [--max-connection-age-ms N] [--max-connection-age-grace-ms N] [--max-connection-idle-ms N]\n"
+        "          [--min-recv-ping-interval-ms N] [--max-ping-strikes N]",
+        argv0, JoinProfiles());
+}
+
+} // namespace prodstarter
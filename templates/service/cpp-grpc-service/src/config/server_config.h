@@ -0,0 +1,99 @@
+// ProdStarterHub - C++ gRPC Service
+// src/config/server_config.h
+// Typed server configuration, command-line parsing and validation.
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "config/tuning.h"
+
+namespace prodstarter {
+
+struct ServerConfig {
+    std::string bind_address = "0.0.0.0:50051";
+    std::vector<std::string> unix_listeners; // --unix-listen unix:PATH|unix-abstract:NAME, plaintext, extra listeners
+    bool enable_tls = false;
+    std::string cert_chain_file;
+    std::string private_key_file;
+    std::string root_cert_file; // optional
+    std::chrono::seconds tls_reload_interval{0}; // re-read cert, key and root this often; 0 reads them once
+    bool enable_reflection = true;
+    bool enable_admin = true;      // prodstarter.admin.v1.Admin debug service
+    int slow_call_capacity = 32;   // slowest calls kept for Admin/SlowCalls; 0 disables
+    std::chrono::seconds slow_call_window{300}; // ...out of the calls that finished this recently
+    std::string admin_token_file;  // bearer token required by every Admin call; profiling RPCs need one
+    std::string profile_dir;       // CPU and heap profiles (Admin/CpuProfile, SIGUSR2) go here; empty disables
+    int profile_seconds = 30;      // CPU capture length of SIGUSR2 and of requests that give none
+    std::string runtime_config_file; // live settings (config/runtime_config.h), re-read on change and SIGHUP
+    bool enable_prometheus = false;
+    std::string metrics_bind_address = "0.0.0.0:9090"; // prometheus /metrics endpoint
+    std::string otlp_endpoint;       // OTLP/gRPC collector for traces (tracing/tracer.h); empty disables tracing
+    std::string service_name = "cpp-grpc-service"; // service.name of exported traces
+    double trace_sample_rate = 0.01; // share of fast, successful traces kept; slow and failed ones always are
+    int trace_slow_ms = 500;         // traces whose local root took at least this long are always kept
+    bool verbose = false;
+    std::string log_mode = "console"; // console | async-json
+    int log_queue_size = 8192;        // async-json queue; the oldest messages are dropped when full
+    double log_sample_rate = 1.0;     // fraction of per-request debug lines kept
+    int num_worker_threads = 0;  // 0: one per usable CPU (affinity mask, --cpu-set, cgroup CPU quota)
+    std::string engine = "sync"; // sync | async | callback | generic
+    std::string passthrough_upstream; // generic engine: forward unclaimed methods to this address
+    int channel_pool_size = 4;        // connections per outbound ChannelPool (passthrough upstream, downstreams)
+    std::string channel_pool_pick = "round-robin"; // round-robin | least-loaded
+    int num_shards = 1;          // independent servers sharing bind_address via SO_REUSEPORT
+    int num_executor_threads = 0; // 0: one per usable CPU
+    std::vector<int> cpu_set;      // --cpu-set 0-7,16-23: run on and pin threads to these CPUs; empty: inherited mask
+    std::string numa_policy = "off"; // off | shard: each shard's polling threads and memory on one NUMA node
+    int lane_threads = 0;          // shared workers of the priority lanes (async engines); 0 disables the lanes
+    std::vector<std::string> method_classes; // --method-class PATTERN=CLASS rules (critical | default | bulk)
+    int critical_weight = 8;       // lane weights while classes compete for the shared workers
+    int default_weight = 4;
+    int bulk_weight = 1;
+    int bulk_max_threads = 0;      // bulk handlers running at once; 0: half the lane threads
+    int reserved_threads = 1;      // lane workers that only serve health, reflection and admin
+    bool arenas = true;                             // per-call protobuf arenas (async and callback engines)
+    int64_t arena_initial_block_bytes = 16 * 1024;  // first block of each pooled arena, reused across calls
+    int64_t arena_max_block_bytes = 256 * 1024;     // cap for the blocks an arena grows into
+    int64_t response_cache_bytes = 64 * 1024 * 1024; // shared by methods bound with a CachePolicy; 0 disables
+    bool coalesce = true;                           // identical concurrent cached calls share one execution
+    int64_t stream_max_queued_bytes = 1024 * 1024;  // per server stream; producers see backpressure beyond it
+    int64_t stream_flush_bytes = 16 * 1024;         // small stream messages are corked into batches this large
+    int stream_flush_delay_us = 1000;               // ...or flushed this long after the first one; 0 never corks
+    std::string compression = "none";               // none | low | medium | high (gzip = low, deflate = high)
+    std::vector<std::string> compression_methods;   // --compression-method PATTERN=LEVEL per-method overrides
+    int64_t compression_min_bytes = 1024;           // methods averaging smaller responses stay uncompressed
+    std::chrono::milliseconds warmup_timeout{30000}; // NOT_SERVING until warm-up tasks finish or this passes; 0 skips
+    std::vector<std::string> warmup_calls;          // --warmup-call METHOD[=COUNT] in-process self-calls
+    std::chrono::milliseconds drain_timeout{30000}; // in-flight RPCs still running after this are cancelled
+    bool track_cancellation = true;                 // client cancellation reaches CancellationTokens
+    std::string limiter = "off";                    // off | aimd | gradient adaptive concurrency limit
+    std::string limiter_scope = "global";           // global | method
+    int limiter_initial = 64;
+    int limiter_min = 4;
+    int limiter_max = 1024;
+    int limiter_latency_ms = 0;                     // aimd: slower calls shrink the limit; 0 disables
+    std::string overload_health_service;            // NOT_SERVING under sustained overload; empty disables
+    int overload_after_ms = 5000;                   // rejections for this long count as sustained overload
+    int watchdog_interval_ms = 100;                 // queue and executor lag probes (saturation_watchdog.h); 0 disables
+    int saturation_lag_ms = 50;                     // probe lag above this counts towards saturation
+    int saturation_after_ms = 5000;                 // ...when it lasts this long
+    std::string saturation_health_service;          // NAME, NAME/shard-<i> NOT_SERVING when saturated; empty: off
+    TuningConfig tuning;
+};
+
+enum class ParseOutcome { kRun, kHelp, kError };
+
+// Parses `--flag value` and `--flag=value` arguments into `cfg`. On kError,
+// `error` describes the offending argument.
+ParseOutcome ParseArgs(int argc, char** argv, ServerConfig& cfg, std::string& error);
+
+// Clamps soft limits and returns one message per invalid setting.
+std::vector<std::string> ValidateConfig(ServerConfig& cfg);
+
+std::string Usage(const char* argv0);
+
+} // namespace prodstarter
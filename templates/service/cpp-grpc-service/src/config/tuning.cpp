@@ -0,0 +1,187 @@
+// ProdStarterHub - C++ gRPC Service
+// src/config/tuning.cpp
+
+#include "config/tuning.h"
+
+#include <algorithm>
+
+#include <grpcpp/resource_quota.h>
+#include <spdlog/fmt/fmt.h>
+
+namespace prodstarter {
+
+namespace {
+constexpr int64_t kMiB = 1024 * 1024;
+} // namespace
+
+const std::vector<std::string>& TuningProfileNames() {
+    static const std::vector<std::string> names{"default", "low-latency", "high-throughput", "memory-constrained"};
+    return names;
+}
+
+bool TuningForProfile(const std::string& profile, int hardware_threads, TuningConfig& out) {
+    const int cores = std::max(1, hardware_threads);
+    TuningConfig t;
+    t.profile = profile;
+
+    if (profile == "default") {
+        // gRPC defaults
+    } else if (profile == "low-latency") {
+        // Keep connections and flow-control windows warm so requests never wait for a ping round trip
+        // or a window update; keep enough sync pollers that a request does not wait for a thread.
+        t.bdp_probe = true;
+        t.keepalive_time_ms = 20000;
+        t.keepalive_timeout_ms = 5000;
+        t.keepalive_permit_without_calls = true;
+        t.min_recv_ping_interval_ms = 10000; // clients may keep their connections as warm as we do
+        t.max_connection_age_ms = 300000;
+        t.max_connection_age_grace_ms = 30000;
+        t.max_concurrent_streams = 256;
+        t.sync_min_pollers = std::max(2, cores / 2);
+        t.sync_max_pollers = std::max(4, cores);
+    } else if (profile == "high-throughput") {
+        // Let many streams share a connection and let BDP probing grow the windows on fat pipes.
+        t.bdp_probe = true;
+        t.keepalive_time_ms = 60000;
+        t.keepalive_timeout_ms = 20000;
+        t.min_recv_ping_interval_ms = 30000;
+        t.max_connection_age_ms = 600000;
+        t.max_connection_age_grace_ms = 60000; // long uploads get a minute to finish on the old connection
+        t.max_concurrent_streams = 4096;
+        t.max_receive_message_bytes = 16 * kMiB;
+        t.sync_min_pollers = 1;
+        t.sync_max_pollers = std::max(2, cores);
+    } else if (profile == "memory-constrained") {
+        // Bound what a burst can allocate: the quota makes gRPC push back instead of growing,
+        // BDP probing is off so windows stay small, and fewer streams are accepted per connection.
+        t.resource_quota_bytes = 64 * kMiB;
+        t.max_threads = std::max(4, std::min(cores * 2, 32));
+        t.bdp_probe = false;
+        t.keepalive_time_ms = 30000;
+        t.keepalive_timeout_ms = 10000;
+        t.min_recv_ping_interval_ms = 30000;
+        t.max_connection_age_ms = 600000;
+        t.max_connection_age_grace_ms = 30000;
+        t.max_connection_idle_ms = 300000; // idle connections still hold transport buffers
+        t.max_concurrent_streams = 64;
+        t.max_receive_message_bytes = 1 * kMiB;
+        t.max_send_message_bytes = 4 * kMiB;
+        t.sync_min_pollers = 1;
+        t.sync_max_pollers = 2;
+    } else {
+        return false;
+    }
+
+    out = t;
+    return true;
+}
+
+void ValidateTuning(const TuningConfig& t, std::vector<std::string>& errors) {
+    if (t.resource_quota_bytes < 0 || (t.resource_quota_bytes > 0 && t.resource_quota_bytes < kMiB)) {
+        errors.push_back(fmt::format("resource quota must be 0 (unset) or at least {} bytes, got {}", kMiB,
+                                     t.resource_quota_bytes));
+    }
+    if (t.max_threads < 0 || t.max_threads == 1) {
+        errors.push_back(fmt::format("max threads must be 0 (unset) or at least 2, got {}", t.max_threads));
+    }
+    if (t.max_concurrent_streams < 0) {
+        errors.push_back(fmt::format("max concurrent streams must be >= 0, got {}", t.max_concurrent_streams));
+    }
+    if (t.keepalive_time_ms < 0 || (t.keepalive_time_ms > 0 && t.keepalive_time_ms < 1000)) {
+        errors.push_back(fmt::format("keepalive time must be 0 (unset) or at least 1000 ms, got {}", t.keepalive_time_ms));
+    }
+    if (t.keepalive_timeout_ms < 0) {
+        errors.push_back(fmt::format("keepalive timeout must be >= 0, got {}", t.keepalive_timeout_ms));
+    }
+    if (t.max_connection_age_ms < 0 || (t.max_connection_age_ms > 0 && t.max_connection_age_ms < 1000)) {
+        errors.push_back(fmt::format("max connection age must be 0 (unset) or at least 1000 ms, got {}",
+                                     t.max_connection_age_ms));
+    }
+    if (t.max_connection_age_grace_ms < 0) {
+        errors.push_back(fmt::format("max connection age grace must be >= 0, got {}", t.max_connection_age_grace_ms));
+    }
+    if (t.max_connection_age_grace_ms > 0 && t.max_connection_age_ms == 0) {
+        errors.push_back("max connection age grace requires a max connection age");
+    }
+    if (t.max_connection_idle_ms < 0 || (t.max_connection_idle_ms > 0 && t.max_connection_idle_ms < 1000)) {
+        errors.push_back(fmt::format("max connection idle must be 0 (unset) or at least 1000 ms, got {}",
+                                     t.max_connection_idle_ms));
+    }
+    if (t.min_recv_ping_interval_ms < 0) {
+        errors.push_back(fmt::format("min receive ping interval must be >= 0, got {}", t.min_recv_ping_interval_ms));
+    }
+    if (t.max_ping_strikes < -1) {
+        errors.push_back(fmt::format("max ping strikes must be -1 (unset) or >= 0, got {}", t.max_ping_strikes));
+    }
+    if (t.max_receive_message_bytes == 0 || t.max_receive_message_bytes < -1) {
+        errors.push_back(fmt::format("max receive message size must be -1 (unlimited) or positive, got {}",
+                                     t.max_receive_message_bytes));
+    }
+    if (t.max_send_message_bytes == 0 || t.max_send_message_bytes < -1) {
+        errors.push_back(fmt::format("max send message size must be -1 (unlimited) or positive, got {}",
+                                     t.max_send_message_bytes));
+    }
+    if (t.sync_min_pollers < 0 || t.sync_max_pollers < 0 ||
+        (t.sync_max_pollers > 0 && t.sync_min_pollers > t.sync_max_pollers)) {
+        errors.push_back(fmt::format("sync pollers must satisfy 0 <= min <= max, got min={} max={}",
+                                     t.sync_min_pollers, t.sync_max_pollers));
+    }
+}
+
+std::string DescribeTuning(const TuningConfig& t) {
+    return fmt::format("profile={}, resource_quota_bytes={}, max_threads={}, max_concurrent_streams={}, bdp_probe={}, "
+                       "keepalive_time_ms={}, keepalive_timeout_ms={}, keepalive_permit_without_calls={}, "
+                       "max_connection_age_ms={} (grace {}), max_connection_idle_ms={}, min_recv_ping_interval_ms={}, "
+                       "max_ping_strikes={}, max_receive_message_bytes={}, max_send_message_bytes={}, "
+                       "sync_pollers={}..{}",
+                       t.profile, t.resource_quota_bytes, t.max_threads, t.max_concurrent_streams, t.bdp_probe,
+                       t.keepalive_time_ms, t.keepalive_timeout_ms, t.keepalive_permit_without_calls,
+                       t.max_connection_age_ms, t.max_connection_age_grace_ms, t.max_connection_idle_ms,
+                       t.min_recv_ping_interval_ms, t.max_ping_strikes,
+                       t.max_receive_message_bytes, t.max_send_message_bytes, t.sync_min_pollers, t.sync_max_pollers);
+}
+
+void ApplyTuning(const TuningConfig& t, grpc::ServerBuilder& builder) {
+    if (t.resource_quota_bytes > 0 || t.max_threads > 0) {
+        grpc::ResourceQuota quota("prodstarter-server");
+        if (t.resource_quota_bytes > 0) quota.Resize(static_cast<size_t>(t.resource_quota_bytes));
+        if (t.max_threads > 0) quota.SetMaxThreads(t.max_threads);
+        builder.SetResourceQuota(quota);
+    }
+
+    if (t.max_concurrent_streams > 0) {
+        builder.AddChannelArgument(GRPC_ARG_MAX_CONCURRENT_STREAMS, t.max_concurrent_streams);
+    }
+    builder.AddChannelArgument(GRPC_ARG_HTTP2_BDP_PROBE, t.bdp_probe ? 1 : 0);
+    if (t.keepalive_time_ms > 0) {
+        builder.AddChannelArgument(GRPC_ARG_KEEPALIVE_TIME_MS, t.keepalive_time_ms);
+        if (t.keepalive_timeout_ms > 0) builder.AddChannelArgument(GRPC_ARG_KEEPALIVE_TIMEOUT_MS, t.keepalive_timeout_ms);
+        builder.AddChannelArgument(GRPC_ARG_KEEPALIVE_PERMIT_WITHOUT_CALLS, t.keepalive_permit_without_calls ? 1 : 0);
+    }
+
+    if (t.max_connection_age_ms > 0) {
+        builder.AddChannelArgument(GRPC_ARG_MAX_CONNECTION_AGE_MS, t.max_connection_age_ms);
+        if (t.max_connection_age_grace_ms > 0) {
+            builder.AddChannelArgument(GRPC_ARG_MAX_CONNECTION_AGE_GRACE_MS, t.max_connection_age_grace_ms);
+        }
+    }
+    if (t.max_connection_idle_ms > 0) {
+        builder.AddChannelArgument(GRPC_ARG_MAX_CONNECTION_IDLE_MS, t.max_connection_idle_ms);
+    }
+    if (t.min_recv_ping_interval_ms > 0) {
+        builder.AddChannelArgument(GRPC_ARG_HTTP2_MIN_RECV_PING_INTERVAL_WITHOUT_DATA_MS, t.min_recv_ping_interval_ms);
+    }
+    if (t.max_ping_strikes >= 0) builder.AddChannelArgument(GRPC_ARG_HTTP2_MAX_PING_STRIKES, t.max_ping_strikes);
+
+    builder.SetMaxReceiveMessageSize(t.max_receive_message_bytes);
+    builder.SetMaxSendMessageSize(t.max_send_message_bytes);
+
+    if (t.sync_min_pollers > 0) {
+        builder.SetSyncServerOption(grpc::ServerBuilder::SyncServerOption::MIN_POLLERS, t.sync_min_pollers);
+    }
+    if (t.sync_max_pollers > 0) {
+        builder.SetSyncServerOption(grpc::ServerBuilder::SyncServerOption::MAX_POLLERS, t.sync_max_pollers);
+    }
+}
+
+} // namespace prodstarter
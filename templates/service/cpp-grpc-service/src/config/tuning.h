@@ -0,0 +1,79 @@
+// ProdStarterHub - C++ gRPC Service
+// src/config/tuning.h
+// Typed ServerBuilder tuning: resource quota, HTTP/2 flow control, keepalive,
+// connection lifecycle, message limits and sync poller counts, with named presets.
+//
+//   default            gRPC defaults, nothing is overridden
+//   low-latency        BDP probing, warm keepalives, more sync pollers
+//   high-throughput    BDP probing, many concurrent streams, larger messages
+//   memory-constrained bounded resource quota and threads, few streams, no BDP growth
+//
+// Every preset but default also bounds connection age, so that clients behind
+// a long-lived HTTP/2 connection reconnect, and get re-balanced onto new
+// replicas, within minutes of a scale-out.
+//
+// A preset is selected with --tuning and individual fields can be overridden
+// with their own flags (see ServerConfig).
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <grpcpp/server_builder.h>
+
+namespace prodstarter {
+
+struct TuningConfig {
+    std::string profile = "default";
+
+    // grpc::ResourceQuota; 0 leaves the limit unset.
+    int64_t resource_quota_bytes = 0;
+    int max_threads = 0;
+
+    // HTTP/2 transport; 0 leaves the gRPC default.
+    int max_concurrent_streams = 0;
+    bool bdp_probe = true;
+    int keepalive_time_ms = 0;
+    int keepalive_timeout_ms = 0;
+    bool keepalive_permit_without_calls = false;
+
+    // Connection lifecycle; 0 leaves the gRPC default (unbounded). gRPC jitters each connection's max age by +-10%
+    // so connections opened together do not all reconnect together; once it is reached the server sends GOAWAY and
+    // gives in-flight calls the grace period before closing.
+    int max_connection_age_ms = 0;
+    int max_connection_age_grace_ms = 0;
+    int max_connection_idle_ms = 0;
+
+    // Keepalive enforcement: client pings closer together than the interval (without data in between) are strikes,
+    // and more than max_ping_strikes of them get the connection a GOAWAY. 0 / -1 leave the gRPC defaults (5 min, 2);
+    // max_ping_strikes = 0 allows any number.
+    int min_recv_ping_interval_ms = 0;
+    int max_ping_strikes = -1;
+
+    // Message limits in bytes; -1 means unlimited.
+    int max_receive_message_bytes = 4 * 1024 * 1024;
+    int max_send_message_bytes = -1;
+
+    // Sync engine pollers; 0 leaves the gRPC default.
+    int sync_min_pollers = 0;
+    int sync_max_pollers = 0;
+};
+
+// Returns the preset for `profile`; false if the name is unknown.
+bool TuningForProfile(const std::string& profile, int hardware_threads, TuningConfig& out);
+
+// Names accepted by TuningForProfile, for usage text and error messages.
+const std::vector<std::string>& TuningProfileNames();
+
+// Appends a message to `errors` for every out-of-range field.
+void ValidateTuning(const TuningConfig& tuning, std::vector<std::string>& errors);
+
+// Single-line summary for the startup log.
+std::string DescribeTuning(const TuningConfig& tuning);
+
+// Applies the tuning to a builder before BuildAndStart().
+void ApplyTuning(const TuningConfig& tuning, grpc::ServerBuilder& builder);
+
+} // namespace prodstarter
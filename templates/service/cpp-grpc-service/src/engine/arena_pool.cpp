@@ -0,0 +1,110 @@
+// ProdStarterHub - C++ gRPC Service
+// src/engine/arena_pool.cpp
+
+#include "engine/arena_pool.h"
+
+#include <algorithm>
+#include <atomic>
+
+namespace prodstarter {
+
+namespace {
+std::atomic<uint64_t> next_pool_id{1};
+
+google::protobuf::ArenaOptions MakeArenaOptions(const ArenaPoolOptions& options, char* block) {
+    google::protobuf::ArenaOptions arena_options;
+    arena_options.max_block_size = std::max(options.max_block_bytes, options.initial_block_bytes);
+    arena_options.start_block_size = std::min(arena_options.max_block_size, std::max<size_t>(options.initial_block_bytes, 256));
+    arena_options.initial_block = block;
+    arena_options.initial_block_size = block != nullptr ? options.initial_block_bytes : 0;
+    return arena_options;
+}
+} // namespace
+
+struct ArenaPool::PooledArena {
+    explicit PooledArena(const ArenaPoolOptions& options)
+        : block(options.initial_block_bytes > 0 ? new char[options.initial_block_bytes] : nullptr),
+          arena(MakeArenaOptions(options, block.get())) {}
+
+    std::unique_ptr<char[]> block; // declared first: must outlive the arena
+    google::protobuf::Arena arena;
+};
+
+struct ArenaPool::ThreadCache {
+    uint64_t pool_id = 0;
+    std::vector<std::unique_ptr<PooledArena>> free;
+};
+
+google::protobuf::Arena* ArenaPool::Lease::get() const {
+    return arena_ != nullptr ? &arena_->arena : nullptr;
+}
+
+void ArenaPool::Lease::Reset() {
+    if (arena_ != nullptr) {
+        pool_->Release(arena_);
+        arena_ = nullptr;
+        pool_ = nullptr;
+    }
+}
+
+ArenaPool::ArenaPool(ArenaPoolOptions options)
+    : id_(next_pool_id.fetch_add(1, std::memory_order_relaxed)), options_(options) {
+    if (options_.max_cached_per_thread < 0) options_.max_cached_per_thread = 0;
+}
+
+// Arenas cached by other threads are self-contained and freed when those threads exit.
+ArenaPool::~ArenaPool() {
+    ThreadCache& cache = LocalCache();
+    if (cache.pool_id == id_) {
+        cache.free.clear();
+        cache.pool_id = 0;
+    }
+}
+
+ArenaPool::ThreadCache& ArenaPool::LocalCache() {
+    thread_local ThreadCache cache;
+    return cache;
+}
+
+ArenaPool::Lease ArenaPool::Acquire() {
+    acquired_.Add(1);
+    ThreadCache& cache = LocalCache();
+    if (cache.pool_id == id_ && !cache.free.empty()) {
+        PooledArena* arena = cache.free.back().release();
+        cache.free.pop_back();
+        recycled_.Add(1);
+        return Lease(this, arena);
+    }
+    created_.Add(1);
+    return Lease(this, new PooledArena(options_));
+}
+
+void ArenaPool::Release(PooledArena* arena) {
+    std::unique_ptr<PooledArena> owned(arena);
+    // Reset() destroys the messages and frees every block but the owned first one.
+    bytes_used_.Add(static_cast<int64_t>(owned->arena.Reset()));
+
+    ThreadCache& cache = LocalCache();
+    if (cache.pool_id != id_) {
+        // A thread caches arenas for one pool at a time; the process normally has a single pool.
+        cache.free.clear();
+        cache.pool_id = id_;
+    }
+    if (static_cast<int>(cache.free.size()) >= options_.max_cached_per_thread) {
+        discarded_.Add(1);
+        return;
+    }
+    cache.free.push_back(std::move(owned));
+}
+
+ArenaPool::Stats ArenaPool::GetStats() const {
+    Stats stats;
+    stats.acquired = static_cast<uint64_t>(acquired_.Sum());
+    stats.recycled = static_cast<uint64_t>(recycled_.Sum());
+    stats.created = static_cast<uint64_t>(created_.Sum());
+    stats.discarded = static_cast<uint64_t>(discarded_.Sum());
+    stats.bytes_used = static_cast<uint64_t>(bytes_used_.Sum());
+    return stats;
+}
+
+} // namespace prodstarter
@@ -0,0 +1,82 @@
+// ProdStarterHub - C++ gRPC Service
+// src/engine/async_engine.cpp
+
+#include "engine/async_engine.h"
+
+#include <utility>
+
+#include <spdlog/spdlog.h>
+
+namespace prodstarter {
+
+AsyncEngine::AsyncEngine(int num_threads, ThreadPlacement placement)
+    : num_threads_(num_threads > 0 ? num_threads : 1), placement_(std::move(placement)) {}
+
+AsyncEngine::~AsyncEngine() {
+    Shutdown();
+}
+
+void AsyncEngine::AddCompletionQueues(grpc::ServerBuilder& builder) {
+    cqs_.reserve(num_threads_);
+    for (int i = 0; i < num_threads_; ++i) {
+        cqs_.push_back(builder.AddCompletionQueue());
+    }
+}
+
+void AsyncEngine::AddMethod(MethodSpawner spawner) {
+    spawners_.push_back(std::move(spawner));
+}
+
+void AsyncEngine::Start() {
+    if (started_) return;
+    started_ = true;
+
+    for (auto& cq : cqs_) {
+        for (const auto& spawn : spawners_) {
+            spawn(cq.get());
+        }
+    }
+
+    threads_.reserve(cqs_.size());
+    for (size_t i = 0; i < cqs_.size(); ++i) {
+        threads_.emplace_back(&AsyncEngine::Poll, this, cqs_[i].get(), static_cast<int>(i));
+    }
+    spdlog::info("Async engine started: {} completion queues, {} methods", cqs_.size(), spawners_.size());
+}
+
+void AsyncEngine::Shutdown() {
+    if (stopped_) return;
+    stopped_ = true;
+
+    for (auto& cq : cqs_) {
+        cq->Shutdown();
+    }
+    for (auto& t : threads_) {
+        if (t.joinable()) t.join();
+    }
+    // Queues that were never polled (Start() not called) still have to be drained
+    // before they are destroyed.
+    if (!started_) {
+        void* tag = nullptr;
+        bool ok = false;
+        for (auto& cq : cqs_) {
+            while (cq->Next(&tag, &ok)) {
+                static_cast<CallTag*>(tag)->Proceed(false);
+            }
+        }
+    }
+}
+
+void AsyncEngine::Poll(grpc::ServerCompletionQueue* cq, int index) {
+    placement_.Apply(index);
+    spdlog::debug("Completion queue thread {} started", index);
+    void* tag = nullptr;
+    bool ok = false;
+    // Next() returns false only once the queue is shut down and fully drained.
+    while (cq->Next(&tag, &ok)) {
+        static_cast<CallTag*>(tag)->Proceed(ok);
+    }
+    spdlog::debug("Completion queue thread {} exiting", index);
+}
+
+} // namespace prodstarter
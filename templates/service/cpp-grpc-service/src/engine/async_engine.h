@@ -0,0 +1,108 @@
+// ProdStarterHub - C++ gRPC Service
+// src/engine/async_engine.h
+// Completion-queue based serving engine (selected with --engine=async).
+//
+// The engine owns one grpc::ServerCompletionQueue per polling thread. Every
+// method bound to the engine keeps a pending call armed on each queue, so an
+// incoming RPC is always picked up by the thread that owns the queue it was
+// matched on and never hops between threads. Calls are small tag-driven state
+// machines (see engine/unary_call.h); each completion is dispatched through
+// CallTag::Proceed().
+//
+// Lifecycle:
+//   AsyncEngine engine(cfg.num_worker_threads);
+//   engine.AddCompletionQueues(builder);   // before BuildAndStart()
+//   AddUnaryMethod(engine, &service, ...); // before Start()
+//   auto server = builder.BuildAndStart();
+//   engine.Start();
+//   ...
+//   server->Shutdown();                    // pending calls complete with ok=false
+//   engine.Shutdown();                     // drains and joins the polling threads
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <grpcpp/grpcpp.h>
+
+#include "exec/cpu_topology.h"
+
+namespace prodstarter {
+
+class ArenaPool;
+class LaneExecutor;
+
+// Base class for every tag handed to an AsyncEngine completion queue.
+class CallTag {
+public:
+    virtual ~CallTag() = default;
+
+    // Invoked on the polling thread that owns the queue once the operation
+    // tagged with this object completes. `ok` is false when the operation was
+    // cancelled or the queue is shutting down.
+    virtual void Proceed(bool ok) = 0;
+};
+
+class AsyncEngine {
+public:
+    // Arms the first pending call of a method on the given queue.
+    using MethodSpawner = std::function<void(grpc::ServerCompletionQueue*)>;
+
+    // Polling thread i is placed by `placement` (exec/cpu_topology.h); by default the threads float.
+    explicit AsyncEngine(int num_threads, ThreadPlacement placement = {});
+    ~AsyncEngine();
+
+    AsyncEngine(const AsyncEngine&) = delete;
+    AsyncEngine& operator=(const AsyncEngine&) = delete;
+
+    // Creates one completion queue per polling thread. Must be called before
+    // ServerBuilder::BuildAndStart().
+    void AddCompletionQueues(grpc::ServerBuilder& builder);
+
+    // Registers a method spawner; it is invoked once per queue on Start().
+    void AddMethod(MethodSpawner spawner);
+
+    // Arena pool for the request and response messages of calls bound after
+    // this; without one they are heap-allocated.
+    void SetArenaPool(ArenaPool* pool) { arena_pool_ = pool; }
+    ArenaPool* arena_pool() const { return arena_pool_; }
+
+    // Priority lanes for the handlers of methods bound after this without an
+    // executor of their own; each call runs on the lane of its MethodClass.
+    // Without lanes such handlers run on the polling thread.
+    void SetLanes(LaneExecutor* lanes) { lanes_ = lanes; }
+    LaneExecutor* lanes() const { return lanes_; }
+
+    // Arms every registered method on every queue and starts the polling threads.
+    void Start();
+
+    // Shuts the queues down and joins the polling threads. Call only after
+    // grpc::Server::Shutdown() so no new calls can be matched.
+    void Shutdown();
+
+    int num_threads() const { return num_threads_; }
+
+    // Queue of polling thread `index` once AddCompletionQueues() ran, e.g. for the saturation watchdog's probes;
+    // null otherwise.
+    grpc::ServerCompletionQueue* completion_queue(int index) const {
+        return index >= 0 && static_cast<size_t>(index) < cqs_.size() ? cqs_[index].get() : nullptr;
+    }
+
+private:
+    void Poll(grpc::ServerCompletionQueue* cq, int index);
+
+    int num_threads_;
+    ThreadPlacement placement_;
+    bool started_ = false;
+    bool stopped_ = false;
+    ArenaPool* arena_pool_ = nullptr;
+    LaneExecutor* lanes_ = nullptr;
+    std::vector<std::unique_ptr<grpc::ServerCompletionQueue>> cqs_;
+    std::vector<MethodSpawner> spawners_;
+    std::vector<std::thread> threads_;
+};
+
+} // namespace prodstarter
@@ -0,0 +1,280 @@
+// ProdStarterHub - C++ gRPC Service
+// src/engine/cached_call.h
+// Unary methods answered from the ResponseCache when possible (see cache/response_cache.h).
+//
+// A cached method is registered as a raw method (the generated
+// WithRawMethod_Xxx / WithRawCallbackMethod_Xxx bases), so requests arrive as
+// serialized bytes. The bytes are looked up first; on a hit the stored
+// ByteBuffer is sent as-is and neither parsing, the handler nor serialization
+// runs. On a miss the request is parsed (on a pooled arena), the handler runs
+// and its OK response is serialized once, sent and stored. With a Singleflight,
+// misses that arrive while an identical call is running wait for its result
+// (bounded by CachePolicy::max_coalesce_wait) instead of running the handler.
+//
+// Async engine:
+//
+//   prodstarter::CachePolicy policy{"/myproto.Example/MyRpc", std::chrono::seconds(5), {"accept-language"}};
+//   auto my_rpc = prodstarter::MakeCachedUnaryMethod<myproto::Request, myproto::Response>(
+//       response_cache.get(), singleflight.get(), policy, arena_pool.get(),
+//       [](grpc::ServerContextBase* ctx, const myproto::Request& req, myproto::Response* resp) {
+//           return grpc::Status::OK;
+//       });
+//   using RawService = myproto::Example::WithRawMethod_MyRpc<myproto::Example::Service>;
+//   auto& raw_service = shard.Emplace<RawService>();
+//   builder.RegisterService(&raw_service);
+//   prodstarter::AddCachedUnaryMethod(*shard.engine(), &raw_service, &RawService::RequestMyRpc, my_rpc);
+//
+// Callback engine (in the CallbackService built on WithRawCallbackMethod_MyRpc):
+//
+//   grpc::ServerUnaryReactor* MyRpc(grpc::CallbackServerContext* ctx, const grpc::ByteBuffer* req,
+//                                   grpc::ByteBuffer* resp) override {
+//       return my_rpc->Serve(ctx, req, resp);
+//   }
+//
+// Only cache methods whose response is a function of the request bytes and
+// the policy's metadata keys. With a null cache the method still works, it
+// just never hits; with a null Singleflight identical misses all run.
+
+#pragma once
+
+#include <exception>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include <google/protobuf/arena.h>
+#include <grpcpp/grpcpp.h>
+#include <grpcpp/impl/codegen/proto_utils.h>
+#include <grpcpp/support/async_unary_call.h>
+#include <grpcpp/support/byte_buffer.h>
+#include <grpcpp/support/server_callback.h>
+#include <spdlog/spdlog.h>
+
+#include "cache/response_cache.h"
+#include "cache/singleflight.h"
+#include "call/call_context.h"
+#include "engine/arena_pool.h"
+#include "engine/async_engine.h"
+#include "exec/executor.h"
+#include "exec/lane_executor.h"
+
+namespace prodstarter {
+
+template <class Request, class Response>
+class CachedUnaryMethod {
+public:
+    using Handler = std::function<grpc::Status(grpc::ServerContextBase*, const Request&, Response*)>;
+
+    // How Admit() resolved a call.
+    enum class Admission {
+        kHit,    // `response` holds the cached reply
+        kJoined, // an identical call is running; `done` finishes this one
+        kLead,   // run Execute()
+    };
+
+    // `cache`, `flights` and `arenas` may each be null.
+    CachedUnaryMethod(ResponseCache* cache, Singleflight* flights, CachePolicy policy, ArenaPool* arenas,
+                      Handler handler)
+        : cache_(cache), flights_(flights), policy_(std::move(policy)), arenas_(arenas), handler_(std::move(handler)) {}
+
+    // Looks the call up in the cache, then in the running flights. On kLead
+    // `key` is set for Execute(); on kJoined `done` may run before Admit() returns.
+    Admission Admit(const grpc::ServerContextBase& ctx, const grpc::ByteBuffer& request, std::string* key,
+                    grpc::ByteBuffer* response, Singleflight::Done done) const {
+        if (cache_ == nullptr && flights_ == nullptr) return Admission::kLead;
+        *key = ResponseCache::MakeKey(policy_, ctx, request);
+        if (cache_ != nullptr && cache_->Lookup(*key, response)) return Admission::kHit;
+        if (flights_ != nullptr &&
+            flights_->Join(*key, ctx.deadline(), policy_.max_coalesce_wait, response, std::move(done))) {
+            return Admission::kJoined;
+        }
+        return Admission::kLead;
+    }
+
+    // Parses `request` (ByteBuffer copies only reference the slices), runs the handler and serializes its
+    // response into `response`. OK responses are stored under `key`, and the calls that joined this one get
+    // the same result.
+    grpc::Status Execute(grpc::ServerContextBase* ctx, grpc::ByteBuffer request, std::string key,
+                         grpc::ByteBuffer* response) const {
+        grpc::Status status = Run(ctx, &request, response);
+        if (key.empty()) return status;
+        if (status.ok() && cache_ != nullptr) cache_->Insert(key, *response, policy_.ttl);
+        if (flights_ != nullptr) flights_->Finish(key, status, *response);
+        return status;
+    }
+
+    // Callback API entry point: serves the whole call on the calling thread.
+    grpc::ServerUnaryReactor* Serve(grpc::CallbackServerContext* ctx, const grpc::ByteBuffer* request,
+                                    grpc::ByteBuffer* response) const {
+        grpc::ServerUnaryReactor* reactor = ctx->DefaultReactor();
+        if (!BeginHandler(ctx)) {
+            reactor->Finish(SkippedStatus(ctx));
+            return reactor;
+        }
+        std::string key;
+        auto done = [reactor](const grpc::Status& status) { reactor->Finish(status); };
+        switch (Admit(*ctx, *request, &key, response, std::move(done))) {
+        case Admission::kHit:
+            reactor->Finish(grpc::Status::OK);
+            break;
+        case Admission::kJoined:
+            break;
+        case Admission::kLead:
+            reactor->Finish(Execute(ctx, *request, std::move(key), response));
+            break;
+        }
+        return reactor;
+    }
+
+private:
+    grpc::Status Run(grpc::ServerContextBase* ctx, grpc::ByteBuffer* request, grpc::ByteBuffer* response) const {
+        ArenaPool::Lease arena = arenas_ != nullptr ? arenas_->Acquire() : ArenaPool::Lease();
+        std::unique_ptr<Request> heap_request;
+        std::unique_ptr<Response> heap_response;
+        Request* req = google::protobuf::Arena::CreateMessage<Request>(arena.get());
+        Response* resp = google::protobuf::Arena::CreateMessage<Response>(arena.get());
+        if (!arena) {
+            heap_request.reset(req);
+            heap_response.reset(resp);
+        }
+
+        if (!grpc::GenericDeserialize<grpc::ProtoBufferReader, Request>(request, req).ok()) {
+            return grpc::Status(grpc::StatusCode::INTERNAL, "failed to parse request");
+        }
+        grpc::Status status;
+        try {
+            status = handler_(ctx, *req, resp);
+        } catch (const std::exception& ex) {
+            spdlog::error("Unhandled exception in cached handler: {}", ex.what());
+            return grpc::Status(grpc::StatusCode::INTERNAL, "internal error");
+        }
+        if (!status.ok()) return status;
+        bool own_buffer = false;
+        return grpc::GenericSerialize<grpc::ProtoBufferWriter, Response>(*resp, response, &own_buffer);
+    }
+
+    ResponseCache* cache_;
+    Singleflight* flights_;
+    const CachePolicy policy_;
+    ArenaPool* arenas_;
+    Handler handler_;
+};
+
+template <class Request, class Response, class Handler>
+std::shared_ptr<const CachedUnaryMethod<Request, Response>> MakeCachedUnaryMethod(ResponseCache* cache,
+                                                                                  Singleflight* flights,
+                                                                                  CachePolicy policy,
+                                                                                  ArenaPool* arenas,
+                                                                                  Handler handler) {
+    return std::make_shared<const CachedUnaryMethod<Request, Response>>(cache, flights, std::move(policy), arenas,
+                                                                        std::move(handler));
+}
+
+// Tag-driven state machine for a raw unary method served through a CachedUnaryMethod.
+template <class Service, class Request, class Response>
+class CachedUnaryCall final : public CallTag {
+public:
+    // Signature of the generated WithRawMethod_Xxx::RequestXxx methods.
+    using RequestMethod = void (Service::*)(grpc::ServerContext*, grpc::ByteBuffer*,
+                                            grpc::ServerAsyncResponseWriter<grpc::ByteBuffer>*,
+                                            grpc::CompletionQueue*, grpc::ServerCompletionQueue*, void*);
+
+    struct Binding {
+        Service* service;
+        RequestMethod method;
+        std::shared_ptr<const CachedUnaryMethod<Request, Response>> cached;
+        Executor* offload; // optional; misses run on the polling thread when null
+        LaneExecutor* lanes; // optional; misses run on their class's lane when `offload` is null
+    };
+
+    static void Arm(std::shared_ptr<const Binding> binding, grpc::ServerCompletionQueue* cq) {
+        new CachedUnaryCall(std::move(binding), cq);
+    }
+
+    void Proceed(bool ok) override {
+        switch (state_) {
+        case State::kRequested: {
+            if (!ok) {
+                delete this;
+                return;
+            }
+            Arm(binding_, cq_);
+            state_ = State::kFinishing;
+            if (CallRejected(&ctx_) || CallAbandoned(&ctx_)) {
+                responder_.Finish(response_, SkippedStatus(&ctx_), this);
+                break;
+            }
+            // Hits and joined calls are settled on the polling thread; only a leader is worth an executor hop.
+            // A joined call may be finished (and deleted) from another thread before Admit() returns.
+            auto done = [this](const grpc::Status& status) { responder_.Finish(response_, status, this); };
+            switch (binding_->cached->Admit(ctx_, request_, &key_, &response_, std::move(done))) {
+            case Admission::kHit:
+                MarkDispatched(&ctx_);
+                responder_.Finish(response_, grpc::Status::OK, this);
+                break;
+            case Admission::kJoined:
+                break;
+            case Admission::kLead:
+                if (!Offload()) Reply();
+                break;
+            }
+            break;
+        }
+        case State::kFinishing:
+            delete this;
+            break;
+        }
+    }
+
+private:
+    using Admission = typename CachedUnaryMethod<Request, Response>::Admission;
+    enum class State { kRequested, kFinishing };
+
+    CachedUnaryCall(std::shared_ptr<const Binding> binding, grpc::ServerCompletionQueue* cq)
+        : binding_(std::move(binding)), cq_(cq), responder_(&ctx_) {
+        (binding_->service->*binding_->method)(&ctx_, &request_, &responder_, cq_, cq_, this);
+    }
+
+    // Hands a leader to the executor, or to its class's lane; false to run it here.
+    bool Offload() {
+        if (binding_->offload != nullptr) return binding_->offload->Post([this] { Reply(); });
+        return binding_->lanes != nullptr &&
+               binding_->lanes->Post(static_cast<size_t>(CallMethodClass(&ctx_)), [this] { Reply(); });
+    }
+
+    void Reply() {
+        // Rejected calls never get here. A leader whose own client left while it was queued still runs: the
+        // calls that joined it are waiting for its result.
+        MarkDispatched(&ctx_);
+        const grpc::Status status = binding_->cached->Execute(&ctx_, request_, std::move(key_), &response_);
+        responder_.Finish(response_, status, this);
+    }
+
+    std::shared_ptr<const Binding> binding_;
+    grpc::ServerCompletionQueue* cq_;
+    State state_ = State::kRequested;
+
+    grpc::ServerContext ctx_;
+    grpc::ByteBuffer request_;
+    grpc::ByteBuffer response_;
+    std::string key_;
+    grpc::ServerAsyncResponseWriter<grpc::ByteBuffer> responder_;
+};
+
+// Binds a raw unary method on every engine queue. `Owner` is the generated
+// WithRawMethod_Xxx base that declares RequestXxx.
+template <class Service, class Owner, class Request, class Response>
+void AddCachedUnaryMethod(AsyncEngine& engine, Service* service,
+                          void (Owner::*method)(grpc::ServerContext*, grpc::ByteBuffer*,
+                                                grpc::ServerAsyncResponseWriter<grpc::ByteBuffer>*,
+                                                grpc::CompletionQueue*, grpc::ServerCompletionQueue*, void*),
+                          std::shared_ptr<const CachedUnaryMethod<Request, Response>> cached,
+                          Executor* offload = nullptr) {
+    using Call = CachedUnaryCall<Owner, Request, Response>;
+    auto binding = std::make_shared<const typename Call::Binding>(
+        typename Call::Binding{service, method, std::move(cached), offload, engine.lanes()});
+    engine.AddMethod([binding](grpc::ServerCompletionQueue* cq) { Call::Arm(binding, cq); });
+}
+
+} // namespace prodstarter
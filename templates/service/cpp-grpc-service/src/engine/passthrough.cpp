@@ -0,0 +1,182 @@
+// ProdStarterHub - C++ gRPC Service
+// src/engine/passthrough.cpp
+
+#include "engine/passthrough.h"
+
+#include <algorithm>
+#include <exception>
+
+#include <grpcpp/generic/generic_stub.h>
+#include <grpcpp/impl/codegen/proto_utils.h>
+#include <spdlog/spdlog.h>
+
+#include "call/call_context.h"
+#include "tracing/tracer.h"
+
+namespace prodstarter {
+
+namespace {
+
+// Request metadata the client channel sets itself rather than forwarding.
+bool IsTransportMetadata(grpc::string_ref key) {
+    return key.starts_with("grpc-") || key.starts_with(":") || key == "user-agent";
+}
+
+// Sends `call` upstream on `stub` and replies with whatever comes back. `lease` is held until then.
+void Forward(grpc::GenericStub& stub, PassthroughCall& call, ChannelPool::Lease lease) {
+    struct Upstream {
+        std::unique_ptr<grpc::ClientContext> ctx;
+        grpc::ByteBuffer response;
+        ChannelPool::Lease lease;
+        ClientSpan span;
+    };
+    auto* upstream = new Upstream;
+    upstream->lease = std::move(lease);
+    // Carries the deadline over and cancels the upstream call when the caller goes away.
+    upstream->ctx = grpc::ClientContext::FromServerContext(call.context());
+    // A traced call sends its own span as the upstream's parent instead of the caller's traceparent.
+    upstream->span = TraceOutbound(&call.context(), upstream->ctx.get(), call.method());
+    for (const auto& [key, value] : call.metadata()) {
+        if (IsTransportMetadata(key) || (upstream->span && key == kTraceparentHeader.data())) continue;
+        upstream->ctx->AddMetadata(std::string(key.data(), key.size()), std::string(value.data(), value.size()));
+    }
+    stub.UnaryCall(upstream->ctx.get(), call.method(), grpc::StubOptions(), &call.request(), &upstream->response,
+                   [upstream, &call](grpc::Status status) {
+                       upstream->span.End(status);
+                       call.Reply(status, upstream->response);
+                       delete upstream;
+                   });
+}
+
+} // namespace
+
+void PassthroughCall::Arm(std::shared_ptr<const Binding> binding, grpc::ServerCompletionQueue* cq) {
+    new PassthroughCall(std::move(binding), cq);
+}
+
+PassthroughCall::PassthroughCall(std::shared_ptr<const Binding> binding, grpc::ServerCompletionQueue* cq)
+    : binding_(std::move(binding)), cq_(cq), stream_(&ctx_) {
+    binding_->service->RequestCall(&ctx_, &stream_, cq_, cq_, this);
+}
+
+void PassthroughCall::Proceed(bool ok) {
+    switch (state_) {
+    case State::kRequested:
+        if (!ok) {
+            delete this;
+            return;
+        }
+        Arm(binding_, cq_);
+        state_ = State::kReading;
+        stream_.Read(&request_, this);
+        break;
+    case State::kReading:
+        // Reply() may complete and delete the call on another thread, so the state is final before dispatching.
+        state_ = State::kFinishing;
+        if (!ok) {
+            Reply(grpc::Status(grpc::StatusCode::INTERNAL, "missing request message"));
+            break;
+        }
+        Dispatch();
+        break;
+    case State::kFinishing:
+        delete this;
+        break;
+    }
+}
+
+void PassthroughCall::Dispatch() {
+    if (!BeginHandler(&ctx_)) {
+        Reply(SkippedStatus(&ctx_));
+        return;
+    }
+    const PassthroughHandler* handler = binding_->router->Find(ctx_.method(), ctx_.client_metadata());
+    if (handler == nullptr) {
+        Reply(grpc::Status(grpc::StatusCode::UNIMPLEMENTED, "unknown method " + ctx_.method()));
+        return;
+    }
+    try {
+        (*handler)(*this);
+    } catch (const std::exception& ex) {
+        // Handlers reply last, so one that throws has not replied yet.
+        spdlog::error("Unhandled exception in passthrough handler for {}: {}", ctx_.method(), ex.what());
+        Reply(grpc::Status(grpc::StatusCode::INTERNAL, "internal error"));
+    }
+}
+
+void PassthroughCall::Reply(const grpc::Status& status, const grpc::ByteBuffer& response) {
+    if (status.ok() && !response.Valid()) {
+        spdlog::error("Passthrough handler for {} replied OK without a response", ctx_.method());
+        stream_.Finish(grpc::Status(grpc::StatusCode::INTERNAL, "missing response message"), this);
+    } else if (status.ok()) {
+        stream_.WriteAndFinish(response, grpc::WriteOptions(), status, this);
+    } else {
+        stream_.Finish(status, this);
+    }
+}
+
+void PassthroughRouter::Handle(std::string method, PassthroughHandler handler) {
+    methods_[std::move(method)] = std::move(handler);
+}
+
+void PassthroughRouter::HandlePrefix(std::string prefix, PassthroughHandler handler) {
+    prefixes_.emplace_back(std::move(prefix), std::move(handler));
+    std::stable_sort(prefixes_.begin(), prefixes_.end(),
+                     [](const auto& a, const auto& b) { return a.first.size() > b.first.size(); });
+}
+
+const PassthroughHandler* PassthroughRouter::Find(const std::string& method,
+                                                  const PassthroughCall::ClientMetadata& metadata) const {
+    if (route_) {
+        if (const PassthroughHandler* handler = route_(method, metadata)) return handler;
+    }
+    auto found = methods_.find(method);
+    if (found != methods_.end()) return &found->second;
+    for (const auto& [prefix, handler] : prefixes_) {
+        if (method.compare(0, prefix.size(), prefix) == 0) return &handler;
+    }
+    return nullptr;
+}
+
+void AddPassthroughService(AsyncEngine& engine, grpc::AsyncGenericService* service, const PassthroughRouter* router) {
+    auto binding = std::make_shared<const PassthroughCall::Binding>(PassthroughCall::Binding{service, router});
+    engine.AddMethod([binding](grpc::ServerCompletionQueue* cq) { PassthroughCall::Arm(binding, cq); });
+}
+
+PassthroughHandler ForwardTo(std::shared_ptr<grpc::Channel> channel) {
+    auto stub = std::make_shared<grpc::GenericStub>(std::move(channel));
+    return [stub](PassthroughCall& call) { Forward(*stub, call, ChannelPool::Lease()); };
+}
+
+PassthroughHandler ForwardTo(ChannelPool& pool) {
+    auto stubs = std::make_shared<std::vector<std::unique_ptr<grpc::GenericStub>>>();
+    for (int i = 0; i < pool.size(); ++i) stubs->push_back(std::make_unique<grpc::GenericStub>(pool.channel(i)));
+    return [stubs, &pool](PassthroughCall& call) {
+        ChannelPool::Lease lease = pool.Acquire();
+        grpc::GenericStub& stub = *(*stubs)[lease.index()];
+        Forward(stub, call, std::move(lease));
+    };
+}
+
+PassthroughHandler ReplyWith(std::optional<grpc::ByteBuffer> payload) {
+    if (!payload) {
+        return [](PassthroughCall& call) {
+            call.Reply(grpc::Status(grpc::StatusCode::INTERNAL, "response payload could not be serialized"));
+        };
+    }
+    return [payload = std::move(*payload)](PassthroughCall& call) { call.Reply(grpc::Status::OK, payload); };
+}
+
+std::optional<grpc::ByteBuffer> SerializePayload(const google::protobuf::MessageLite& message) {
+    grpc::ByteBuffer buffer;
+    bool own_buffer = false;
+    const grpc::Status status =
+        grpc::GenericSerialize<grpc::ProtoBufferWriter, google::protobuf::MessageLite>(message, &buffer, &own_buffer);
+    if (!status.ok()) {
+        spdlog::error("Failed to serialize passthrough payload: {}", status.error_message());
+        return std::nullopt;
+    }
+    return buffer;
+}
+
+} // namespace prodstarter
@@ -0,0 +1,139 @@
+// ProdStarterHub - C++ gRPC Service
+// src/engine/passthrough.h
+// Generic passthrough engine (selected with --engine=generic).
+//
+// Every method that no registered service claims is accepted by a
+// grpc::AsyncGenericService as raw grpc::ByteBuffer. A PassthroughRouter picks
+// a handler from the method name and request metadata alone, and the handler
+// answers with a ByteBuffer: the bytes are forwarded or returned in the slices
+// they arrived in, and protobuf never parses or serializes them. Health,
+// reflection and admin still answer through their own services.
+//
+//   prodstarter::PassthroughRouter router;
+//   router.HandlePrefix("/myproto.Example/", prodstarter::ForwardTo(backend_pool));
+//   router.Handle("/myproto.Example/Version", prodstarter::ReplyWith(prodstarter::SerializePayload(version)));
+//   ...
+//   auto& generic = shard.Emplace<grpc::AsyncGenericService>();
+//   builder.RegisterAsyncGenericService(&generic);
+//   prodstarter::AddPassthroughService(*shard.engine(), &generic, &router);
+//
+// Calls are treated as unary: one request message is read and one response
+// written. Handlers run on the polling thread that matched the call and must
+// not block; they finish the call with PassthroughCall::Reply(), possibly later
+// and from another thread.
+
+#pragma once
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <google/protobuf/message_lite.h>
+#include <grpcpp/generic/async_generic_service.h>
+#include <grpcpp/grpcpp.h>
+#include <grpcpp/support/byte_buffer.h>
+
+#include "engine/async_engine.h"
+#include "infra/channel_pool.h"
+
+namespace prodstarter {
+
+class PassthroughRouter;
+
+// One call accepted by the passthrough engine.
+class PassthroughCall final : public CallTag {
+public:
+    using ClientMetadata = std::multimap<grpc::string_ref, grpc::string_ref>;
+
+    struct Binding {
+        grpc::AsyncGenericService* service;
+        const PassthroughRouter* router;
+    };
+
+    static void Arm(std::shared_ptr<const Binding> binding, grpc::ServerCompletionQueue* cq);
+
+    void Proceed(bool ok) override;
+
+    // Full method name, e.g. "/myproto.Example/MyRpc".
+    const std::string& method() const { return ctx_.method(); }
+    const ClientMetadata& metadata() const { return ctx_.client_metadata(); }
+    grpc::GenericServerContext& context() { return ctx_; }
+
+    // The serialized request as received.
+    const grpc::ByteBuffer& request() const { return request_; }
+
+    // Finishes the call. `response` is only sent with an OK status; its slices
+    // are referenced, not copied. An OK status without a valid response (e.g.
+    // a failed serialization) finishes with INTERNAL instead. Call exactly once,
+    // from any thread; the call may be destroyed as soon as this returns.
+    void Reply(const grpc::Status& status, const grpc::ByteBuffer& response = grpc::ByteBuffer());
+
+private:
+    enum class State { kRequested, kReading, kFinishing };
+
+    PassthroughCall(std::shared_ptr<const Binding> binding, grpc::ServerCompletionQueue* cq);
+
+    void Dispatch();
+
+    std::shared_ptr<const Binding> binding_;
+    grpc::ServerCompletionQueue* cq_;
+    State state_ = State::kRequested;
+
+    grpc::GenericServerContext ctx_;
+    grpc::GenericServerAsyncReaderWriter stream_;
+    grpc::ByteBuffer request_;
+};
+
+using PassthroughHandler = std::function<void(PassthroughCall& call)>;
+
+// Maps method names to handlers. Configure before the server starts; lookups
+// are read-only afterwards and shared by all shards.
+class PassthroughRouter {
+public:
+    // Routing hook consulted before the tables; returns null to fall through.
+    using Route = std::function<const PassthroughHandler*(const std::string& method,
+                                                          const PassthroughCall::ClientMetadata& metadata)>;
+
+    // Handles one fully qualified method.
+    void Handle(std::string method, PassthroughHandler handler);
+
+    // Handles every method starting with `prefix`, e.g. "/myproto.Example/".
+    // The longest matching prefix wins.
+    void HandlePrefix(std::string prefix, PassthroughHandler handler);
+
+    void SetRoute(Route route) { route_ = std::move(route); }
+
+    // Null when nothing matches; the call then fails with UNIMPLEMENTED.
+    const PassthroughHandler* Find(const std::string& method, const PassthroughCall::ClientMetadata& metadata) const;
+
+private:
+    Route route_;
+    std::unordered_map<std::string, PassthroughHandler> methods_;
+    std::vector<std::pair<std::string, PassthroughHandler>> prefixes_; // longest first
+};
+
+// Keeps a PassthroughCall armed on every queue of `engine`. `service` must be
+// registered with the shard's builder and, like `router`, outlive the server.
+void AddPassthroughService(AsyncEngine& engine, grpc::AsyncGenericService* service, const PassthroughRouter* router);
+
+// Forwards calls as-is to the same method on `channel`, carrying over the
+// caller's metadata, deadline and cancellation. The upstream status and
+// response bytes are returned unchanged.
+PassthroughHandler ForwardTo(std::shared_ptr<grpc::Channel> channel);
+
+// Same, spread over the channels of `pool`, which must outlive the server.
+PassthroughHandler ForwardTo(ChannelPool& pool);
+
+// Answers every call with `payload`, serialized once up front. Without a payload (SerializePayload() failed) every
+// call fails with INTERNAL.
+PassthroughHandler ReplyWith(std::optional<grpc::ByteBuffer> payload);
+
+// Serializes `message` into a ByteBuffer for ReplyWith(); nullopt, logged, when serialization fails.
+std::optional<grpc::ByteBuffer> SerializePayload(const google::protobuf::MessageLite& message);
+
+} // namespace prodstarter
@@ -0,0 +1,242 @@
+// ProdStarterHub - C++ gRPC Service
+// src/engine/reactors.h
+// Reusable reactor bases for the callback API (selected with --engine=callback).
+//
+// Callback handlers return a reactor instead of blocking a thread for the whole
+// RPC, so thousands of long-poll or streaming calls can be held by the few
+// threads gRPC runs its callbacks on. The bases below take care of the parts
+// every reactor repeats: finishing exactly once, finishing on cancellation,
+// serialising writes and deleting the reactor when the call is done.
+//
+//   class MyRpcReactor final : public prodstarter::UnaryReactor<myproto::Request, myproto::Response> {
+//   public:
+//       using UnaryReactor::UnaryReactor;
+//   protected:
+//       void OnStart() override { response()->set_value(request()->value()); Complete(grpc::Status::OK); }
+//   };
+//
+//   grpc::ServerUnaryReactor* MyRpc(grpc::CallbackServerContext* ctx, const myproto::Request* req,
+//                                   myproto::Response* resp) override {
+//       return prodstarter::StartReactor<MyRpcReactor>(ctx, req, resp);
+//   }
+
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <utility>
+
+#include <grpcpp/grpcpp.h>
+#include <grpcpp/support/server_callback.h>
+
+#include "call/call_context.h"
+
+namespace prodstarter {
+
+// Constructs a reactor and kicks it off. Use as the return value of the
+// CallbackService override.
+template <class Reactor, class... Args>
+Reactor* StartReactor(Args&&... args) {
+    auto* reactor = new Reactor(std::forward<Args>(args)...);
+    reactor->Begin();
+    return reactor;
+}
+
+// Base for unary reactors. Derived classes implement OnStart() and call
+// Complete() once, from any thread, when the response is ready.
+template <class Request, class Response>
+class UnaryReactor : public grpc::ServerUnaryReactor {
+public:
+    UnaryReactor(grpc::CallbackServerContext* ctx, const Request* request, Response* response)
+        : ctx_(ctx), request_(request), response_(response) {}
+
+    // Called by StartReactor() once the object is fully constructed.
+    void Begin() {
+        if (!BeginHandler(ctx_)) {
+            Complete(SkippedStatus(ctx_));
+            return;
+        }
+        OnStart();
+    }
+
+protected:
+    virtual void OnStart() = 0;
+
+    // Invoked when the client cancels or the deadline expires. The default
+    // finishes the call so a pending long-poll does not outlive its client.
+    virtual void OnCancelled() { Complete(grpc::Status::CANCELLED); }
+
+    // Finishes the call; later calls are ignored.
+    void Complete(const grpc::Status& status) {
+        if (finished_.exchange(true)) return;
+        Finish(status);
+    }
+
+    bool cancelled() const { return cancelled_.load(std::memory_order_acquire); }
+    grpc::CallbackServerContext* context() const { return ctx_; }
+    const Request* request() const { return request_; }
+    Response* response() const { return response_; }
+
+private:
+    void OnCancel() final {
+        cancelled_.store(true, std::memory_order_release);
+        OnCancelled();
+    }
+    void OnDone() final { delete this; }
+
+    grpc::CallbackServerContext* ctx_;
+    const Request* request_;
+    Response* response_;
+    std::atomic<bool> finished_{false};
+    std::atomic<bool> cancelled_{false};
+};
+
+// Base for bidirectional streaming reactors. Incoming messages are delivered
+// one at a time to OnMessage(); Send() may be called from any thread and
+// queues writes so that only one is outstanding at a time, as the API requires.
+template <class Request, class Response>
+class BidiReactor : public grpc::ServerBidiReactor<Request, Response> {
+public:
+    explicit BidiReactor(grpc::CallbackServerContext* ctx) : ctx_(ctx) {}
+
+    // Called by StartReactor() once the object is fully constructed.
+    void Begin() {
+        if (!BeginHandler(ctx_)) {
+            Complete(SkippedStatus(ctx_));
+            return;
+        }
+        OnStart();
+        ReadNext();
+    }
+
+protected:
+    virtual void OnStart() {}
+    virtual void OnMessage(const Request& request) = 0;
+
+    // Invoked after the client half-closes. The default finishes with OK once
+    // all queued writes have been flushed.
+    virtual void OnReadsComplete() { Complete(grpc::Status::OK); }
+    virtual void OnCancelled() {}
+
+    // Queues a message for the client. Ignored once Complete() was called.
+    void Send(Response message) {
+        Step step;
+        {
+            std::lock_guard<std::mutex> lock(mu_);
+            if (finish_requested_) return;
+            pending_.push_back(std::move(message));
+            step = NextStepLocked();
+        }
+        Take(step);
+    }
+
+    // Finishes the stream after the queued writes; later calls are ignored.
+    void Complete(const grpc::Status& status) {
+        Step step;
+        {
+            std::lock_guard<std::mutex> lock(mu_);
+            if (finish_requested_) return;
+            finish_requested_ = true;
+            finish_status_ = status;
+            step = NextStepLocked();
+        }
+        Take(step);
+    }
+
+    bool cancelled() const { return cancelled_.load(std::memory_order_acquire); }
+    grpc::CallbackServerContext* context() const { return ctx_; }
+
+private:
+    // The write or finish a state change calls for. It is decided under mu_ and started after releasing it: gRPC may
+    // run OnWriteDone(), which takes mu_, inline, and an inline OnDone() deletes the reactor together with mu_.
+    struct Step {
+        const Response* write = nullptr;
+        bool finish = false;
+        grpc::Status status;
+    };
+
+    void OnReadDone(bool ok) final {
+        if (!ok) {
+            OnReadsComplete();
+            return;
+        }
+        OnMessage(request_);
+        ReadNext();
+    }
+
+    // Reads the next message unless OnStart() or OnMessage() already completed the stream. The read is started
+    // outside mu_, since gRPC may run its reaction inline.
+    void ReadNext() {
+        {
+            std::lock_guard<std::mutex> lock(mu_);
+            if (finish_requested_) return;
+        }
+        this->StartRead(&request_);
+    }
+
+    void OnWriteDone(bool ok) final {
+        Step step;
+        {
+            std::lock_guard<std::mutex> lock(mu_);
+            writing_ = false;
+            pending_.pop_front();
+            if (!ok) {
+                // The stream is broken; drop what is left and finish.
+                pending_.clear();
+                if (!finish_requested_) {
+                    finish_requested_ = true;
+                    finish_status_ = grpc::Status(grpc::StatusCode::UNAVAILABLE, "stream write failed");
+                }
+            }
+            step = NextStepLocked();
+        }
+        Take(step);
+    }
+
+    void OnCancel() final {
+        cancelled_.store(true, std::memory_order_release);
+        OnCancelled();
+        Complete(grpc::Status::CANCELLED);
+    }
+
+    void OnDone() final { delete this; }
+
+    // Claims the next write, or the finish once nothing is queued. pending_.front() stays put until its
+    // OnWriteDone(), as a deque keeps references across push_back().
+    Step NextStepLocked() {
+        Step step;
+        if (writing_) return step;
+        if (!pending_.empty()) {
+            writing_ = true;
+            step.write = &pending_.front();
+        } else if (finish_requested_ && !finished_) {
+            finished_ = true;
+            step.finish = true;
+            step.status = finish_status_;
+        }
+        return step;
+    }
+
+    // Must be the last thing the caller does with the reactor: Finish() may delete it.
+    void Take(const Step& step) {
+        if (step.write != nullptr) {
+            this->StartWrite(step.write);
+        } else if (step.finish) {
+            this->Finish(step.status);
+        }
+    }
+
+    grpc::CallbackServerContext* ctx_;
+    Request request_;
+    std::atomic<bool> cancelled_{false};
+
+    std::mutex mu_;
+    std::deque<Response> pending_; // front() is the write in flight while writing_ is set
+    bool writing_ = false;
+    bool finish_requested_ = false;
+    bool finished_ = false;
+    grpc::Status finish_status_;
+};
+
+} // namespace prodstarter
@@ -0,0 +1,379 @@
+// ProdStarterHub - C++ gRPC Service
+// src/engine/stream_writer.h
+// Coalescing, flow-controlled writers for server-streaming RPCs on the
+// callback and async engines.
+//
+// Every unhinted write is flushed to the transport on its own, so a stream of
+// small messages becomes a stream of small frames and syscalls. The writers
+// here cork instead: messages queue until flush_bytes are waiting or
+// flush_delay has passed since the first one, and are then written back to
+// back with WriteOptions::set_buffer_hint() on all but the last, so gRPC sends
+// the whole batch in one flush.
+//
+// The queue is bounded by max_queued_bytes per stream. Once it is full Send()
+// returns kFull without taking the message; the producer stops and resumes
+// from OnWritable(), which runs when the queue has drained to half the budget.
+// A slow consumer therefore holds at most one budget of memory instead of
+// everything produced for it. One message is always accepted into an empty
+// queue, however large.
+//
+//   class TailReactor final : public prodstarter::ServerStreamReactor<myproto::TailRequest, myproto::Line> {
+//   public:
+//       using ServerStreamReactor::ServerStreamReactor;
+//   protected:
+//       void OnStart() override { Produce(); }
+//       void OnWritable() override { Produce(); }
+//   private:
+//       void Produce() {
+//           while (has_more()) {
+//               if (Send(next_line()) == SendResult::kFull) return; // resumed by OnWritable()
+//           }
+//           Complete(grpc::Status::OK);
+//       }
+//   };
+//
+//   grpc::ServerWriteReactor<myproto::Line>* Tail(grpc::CallbackServerContext* ctx,
+//                                                 const myproto::TailRequest* req) override {
+//       return prodstarter::StartReactor<TailReactor>(ctx, req, stream_options);
+//   }
+//
+// On the async engine AsyncStreamWriter wraps the call's ServerAsyncWriter in
+// the same way; its completions are delivered on the call's queue.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <utility>
+
+#include <google/protobuf/message_lite.h>
+#include <grpcpp/alarm.h>
+#include <grpcpp/grpcpp.h>
+#include <grpcpp/support/server_callback.h>
+
+#include "call/call_context.h"
+#include "engine/async_engine.h"
+
+namespace prodstarter {
+
+// Totals over every stream that reports to it; shared by all writers.
+class StreamWriterStats {
+public:
+    struct Stats {
+        uint64_t streams = 0;      // streams currently open
+        uint64_t queued_bytes = 0; // bytes waiting in their queues
+        uint64_t messages = 0;     // messages handed to gRPC
+        uint64_t flushes = 0;      // unhinted writes, each ending one flushed batch
+        uint64_t backpressure = 0; // Send() calls refused because the queue was full
+    };
+
+    Stats GetStats() const {
+        Stats stats;
+        stats.streams = static_cast<uint64_t>(std::max<int64_t>(0, streams_.load(std::memory_order_relaxed)));
+        stats.queued_bytes = static_cast<uint64_t>(std::max<int64_t>(0, queued_bytes_.load(std::memory_order_relaxed)));
+        stats.messages = messages_.load(std::memory_order_relaxed);
+        stats.flushes = flushes_.load(std::memory_order_relaxed);
+        stats.backpressure = backpressure_.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+private:
+    template <class Message>
+    friend class WriteCoalescer;
+
+    std::atomic<int64_t> streams_{0};
+    std::atomic<int64_t> queued_bytes_{0};
+    std::atomic<uint64_t> messages_{0};
+    std::atomic<uint64_t> flushes_{0};
+    std::atomic<uint64_t> backpressure_{0};
+};
+
+struct StreamWriterOptions {
+    int64_t max_queued_bytes = 1024 * 1024;      // per stream
+    int64_t flush_bytes = 16 * 1024;             // a batch this large is written without waiting
+    std::chrono::microseconds flush_delay{1000}; // longest a queued message waits for company; 0 never corks
+    int64_t min_compress_bytes = 0;              // smaller messages skip the call's compression
+    StreamWriterStats* stats = nullptr;          // optional
+};
+
+inline int64_t MessageBytes(const google::protobuf::MessageLite& message) {
+    return static_cast<int64_t>(message.ByteSizeLong());
+}
+inline int64_t MessageBytes(const grpc::ByteBuffer& buffer) { return static_cast<int64_t>(buffer.Length()); }
+
+// Queueing, corking and budget logic shared by the callback and async writers.
+// Subclasses start the actual operations; exactly one write is outstanding at
+// a time, and the stream is finished only once the queue is empty.
+template <class Message>
+class WriteCoalescer {
+public:
+    enum class SendResult {
+        kQueued,
+        kFull,   // over budget; nothing was queued, retry from OnWritable()
+        kClosed, // Complete() was called or the stream broke
+    };
+
+    explicit WriteCoalescer(StreamWriterOptions options) : options_(options) {
+        if (options_.stats != nullptr) options_.stats->streams_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    virtual ~WriteCoalescer() {
+        if (options_.stats == nullptr) return;
+        options_.stats->streams_.fetch_sub(1, std::memory_order_relaxed);
+        options_.stats->queued_bytes_.fetch_sub(queued_bytes_, std::memory_order_relaxed);
+    }
+
+    WriteCoalescer(const WriteCoalescer&) = delete;
+    WriteCoalescer& operator=(const WriteCoalescer&) = delete;
+
+    // Queues a message for the client; safe from any thread.
+    SendResult Send(Message message) {
+        const int64_t bytes = MessageBytes(message);
+        std::unique_lock<std::mutex> lock(mu_);
+        if (finish_requested_) return SendResult::kClosed;
+        if (!pending_.empty() && queued_bytes_ + bytes > options_.max_queued_bytes) {
+            blocked_ = true;
+            if (options_.stats != nullptr) options_.stats->backpressure_.fetch_add(1, std::memory_order_relaxed);
+            return SendResult::kFull;
+        }
+        pending_.push_back(Pending{std::move(message), bytes});
+        queued_bytes_ += bytes;
+        if (options_.stats != nullptr) options_.stats->queued_bytes_.fetch_add(bytes, std::memory_order_relaxed);
+        Pump(lock);
+        return SendResult::kQueued;
+    }
+
+    // Finishes the stream once the queued messages are written; later calls
+    // are ignored.
+    void Complete(const grpc::Status& status) {
+        std::unique_lock<std::mutex> lock(mu_);
+        if (finish_requested_) return;
+        finish_requested_ = true;
+        finish_status_ = status;
+        flush_due_ = true;
+        if (alarm_armed_) alarm_.Cancel(); // Pump() finishes once the alarm callback has run
+        Pump(lock);
+    }
+
+    // Bytes queued on this stream and not yet handed to gRPC.
+    int64_t queued_bytes() const {
+        std::lock_guard<std::mutex> lock(mu_);
+        return queued_bytes_;
+    }
+
+protected:
+    // Starts one write, without the lock; the transport reports it back through WriteDone().
+    virtual void WriteMessage(const Message& message, grpc::WriteOptions options) = 0;
+
+    // Starts finishing the call. Runs without the lock as the writer's last
+    // action; the object may be destroyed as soon as the finish completes.
+    virtual void FinishStream(const grpc::Status& status) = 0;
+
+    // The queue drained after a Send() was refused with kFull.
+    virtual void OnWritable() {}
+
+    void WriteDone(bool ok) {
+        bool writable = false;
+        {
+            std::unique_lock<std::mutex> lock(mu_);
+            writing_ = false;
+            Release(pending_.front().bytes);
+            pending_.pop_front();
+            if (!ok) {
+                // The stream is broken; drop what is left and finish.
+                for (const auto& dropped : pending_) Release(dropped.bytes);
+                pending_.clear();
+                if (!finish_requested_) {
+                    finish_requested_ = true;
+                    finish_status_ = grpc::Status(grpc::StatusCode::UNAVAILABLE, "stream write failed");
+                }
+                if (alarm_armed_) alarm_.Cancel();
+            }
+            writable = blocked_ && !finish_requested_ && queued_bytes_ <= options_.max_queued_bytes / 2;
+            if (writable) blocked_ = false;
+            Pump(lock);
+        }
+        if (writable) OnWritable();
+    }
+
+private:
+    struct Pending {
+        Message message;
+        int64_t bytes;
+    };
+
+    // Starts the next write or the finish if nothing is outstanding. Called
+    // with `lock` held; returns with it released when it started either. Both
+    // are started unlocked, since gRPC may run WriteDone() inline.
+    void Pump(std::unique_lock<std::mutex>& lock) {
+        if (writing_) return;
+        if (pending_.empty()) {
+            flush_due_ = finish_requested_;
+            if (finish_requested_ && !alarm_armed_ && !finished_) {
+                finished_ = true;
+                const grpc::Status status = finish_status_;
+                lock.unlock();
+                FinishStream(status);
+            }
+            return;
+        }
+        if (!flush_due_ && queued_bytes_ < options_.flush_bytes && options_.flush_delay.count() > 0) {
+            if (!alarm_armed_) {
+                alarm_armed_ = true;
+                alarm_.Set(std::chrono::system_clock::now() + options_.flush_delay, [this](bool) { FlushTimer(); });
+            }
+            return;
+        }
+        // Drain the batch: every message but the last lets gRPC hold it back, the last one flushes them all. The
+        // first write carries the initial metadata and a hinted one is held until something else flushes, so it
+        // always goes out on its own; long batches are flushed every flush_bytes.
+        const Pending& next = pending_.front();
+        flush_due_ = pending_.size() > 1;
+        grpc::WriteOptions write_options;
+        if (flush_due_ && started_ && hinted_bytes_ + next.bytes < options_.flush_bytes) {
+            write_options.set_buffer_hint();
+            hinted_bytes_ += next.bytes;
+        } else {
+            hinted_bytes_ = 0;
+            if (options_.stats != nullptr) options_.stats->flushes_.fetch_add(1, std::memory_order_relaxed);
+        }
+        if (next.bytes < options_.min_compress_bytes) write_options.set_no_compression();
+        started_ = true;
+        if (options_.stats != nullptr) options_.stats->messages_.fetch_add(1, std::memory_order_relaxed);
+        writing_ = true;
+        // front() stays put until its WriteDone(): a deque keeps references across push_back().
+        lock.unlock();
+        WriteMessage(next.message, write_options);
+    }
+
+    void FlushTimer() {
+        std::unique_lock<std::mutex> lock(mu_);
+        alarm_armed_ = false;
+        flush_due_ = true;
+        Pump(lock);
+    }
+
+    void Release(int64_t bytes) {
+        queued_bytes_ -= bytes;
+        if (options_.stats != nullptr) options_.stats->queued_bytes_.fetch_sub(bytes, std::memory_order_relaxed);
+    }
+
+    const StreamWriterOptions options_;
+
+    mutable std::mutex mu_;
+    std::deque<Pending> pending_; // front() is the write in flight while writing_ is set
+    int64_t queued_bytes_ = 0;
+    bool writing_ = false;
+    bool flush_due_ = false; // the corked batch is being drained
+    bool started_ = false;   // the first write, with the initial metadata, was sent
+    int64_t hinted_bytes_ = 0; // written with buffer_hint since the last flush
+    bool blocked_ = false;   // a Send() was refused; OnWritable() is owed
+    bool finish_requested_ = false;
+    bool finished_ = false;
+    grpc::Status finish_status_;
+
+    grpc::Alarm alarm_; // flush timer; the stream never finishes while it is armed
+    bool alarm_armed_ = false;
+};
+
+// Base for server-streaming callback reactors. Derived classes implement
+// OnStart() and produce with Send(), finishing with Complete().
+template <class Request, class Response>
+class ServerStreamReactor : public grpc::ServerWriteReactor<Response>, public WriteCoalescer<Response> {
+public:
+    using SendResult = typename WriteCoalescer<Response>::SendResult;
+
+    ServerStreamReactor(grpc::CallbackServerContext* ctx, const Request* request, StreamWriterOptions options = {})
+        : WriteCoalescer<Response>(options), ctx_(ctx), request_(request) {}
+
+    // Called by StartReactor() once the object is fully constructed.
+    void Begin() {
+        if (!BeginHandler(ctx_)) {
+            this->Complete(SkippedStatus(ctx_));
+            return;
+        }
+        OnStart();
+    }
+
+protected:
+    virtual void OnStart() = 0;
+    virtual void OnCancelled() {}
+
+    bool cancelled() const { return cancelled_.load(std::memory_order_acquire); }
+    grpc::CallbackServerContext* context() const { return ctx_; }
+    const Request* request() const { return request_; }
+
+private:
+    void WriteMessage(const Response& message, grpc::WriteOptions options) final {
+        this->StartWrite(&message, options);
+    }
+    void FinishStream(const grpc::Status& status) final { this->Finish(status); }
+
+    void OnWriteDone(bool ok) final { this->WriteDone(ok); }
+
+    void OnCancel() final {
+        cancelled_.store(true, std::memory_order_release);
+        OnCancelled();
+        this->Complete(grpc::Status::CANCELLED);
+    }
+
+    void OnDone() final { delete this; }
+
+    grpc::CallbackServerContext* ctx_;
+    const Request* request_;
+    std::atomic<bool> cancelled_{false};
+};
+
+// Coalescing writer over an async engine ServerAsyncWriter (or the writing
+// side of a ServerAsyncReaderWriter, e.g. a generic stream). The owning call
+// creates it once the call is matched; `on_writable` resumes a refused
+// producer and `on_finished` runs when Finish() completes, after which the
+// call may delete itself and the writer. Both run on a polling thread or an
+// alarm thread and must not block.
+template <class Response, class Writer = grpc::ServerAsyncWriter<Response>>
+class AsyncStreamWriter final : public WriteCoalescer<Response> {
+public:
+    AsyncStreamWriter(Writer* writer, StreamWriterOptions options,
+                      std::function<void()> on_writable, std::function<void(bool ok)> on_finished)
+        : WriteCoalescer<Response>(options), writer_(writer), on_writable_(std::move(on_writable)),
+          write_tag_(this), finish_tag_(std::move(on_finished)) {}
+
+private:
+    class WriteTag final : public CallTag {
+    public:
+        explicit WriteTag(AsyncStreamWriter* writer) : writer_(writer) {}
+        void Proceed(bool ok) override { writer_->WriteDone(ok); }
+
+    private:
+        AsyncStreamWriter* writer_;
+    };
+
+    class FinishTag final : public CallTag {
+    public:
+        explicit FinishTag(std::function<void(bool ok)> done) : done_(std::move(done)) {}
+        void Proceed(bool ok) override { done_(ok); }
+
+    private:
+        std::function<void(bool ok)> done_;
+    };
+
+    void WriteMessage(const Response& message, grpc::WriteOptions options) override {
+        writer_->Write(message, options, &write_tag_);
+    }
+    void FinishStream(const grpc::Status& status) override { writer_->Finish(status, &finish_tag_); }
+    void OnWritable() override {
+        if (on_writable_) on_writable_();
+    }
+
+    Writer* writer_;
+    std::function<void()> on_writable_;
+    WriteTag write_tag_;
+    FinishTag finish_tag_;
+};
+
+} // namespace prodstarter
@@ -0,0 +1,157 @@
+// ProdStarterHub - C++ gRPC Service
+// src/engine/unary_call.h
+// Tag-driven state machine for unary RPCs served by the AsyncEngine.
+//
+// Bind a generated AsyncService method to a plain handler:
+//
+//   myproto::Example::AsyncService async_service;
+//   builder.RegisterService(&async_service);
+//   prodstarter::AddUnaryMethod(engine, &async_service,
+//       &myproto::Example::AsyncService::RequestMyRpc,
+//       [](grpc::ServerContext* ctx, const myproto::Request& req, myproto::Response* resp) {
+//           return grpc::Status::OK;
+//       });
+//
+// Request and response live on an arena from the engine's ArenaPool when one
+// is set (see engine/arena_pool.h) and are released with the call.
+//
+// The handler runs on the completion queue thread that matched the call, so it
+// must not block. Pass an Executor as the last argument to run CPU-heavy
+// handlers on its workers instead and keep the polling threads free. When the
+// engine has priority lanes (AsyncEngine::SetLanes()) handlers without an
+// Executor run on the lane of their method's class.
+
+#pragma once
+
+#include <exception>
+#include <functional>
+#include <memory>
+#include <utility>
+
+#include <grpcpp/grpcpp.h>
+#include <grpcpp/support/async_unary_call.h>
+#include <spdlog/spdlog.h>
+
+#include "call/call_context.h"
+#include "engine/arena_pool.h"
+#include "engine/async_engine.h"
+#include "exec/executor.h"
+#include "exec/lane_executor.h"
+
+namespace prodstarter {
+
+template <class Service, class Request, class Response>
+class UnaryCall final : public CallTag {
+public:
+    // Signature of the generated AsyncService::RequestXxx methods.
+    using RequestMethod = void (Service::*)(grpc::ServerContext*, Request*,
+                                            grpc::ServerAsyncResponseWriter<Response>*,
+                                            grpc::CompletionQueue*, grpc::ServerCompletionQueue*, void*);
+    using Handler = std::function<grpc::Status(grpc::ServerContext*, const Request&, Response*)>;
+
+    // Everything a call needs to know about its method; shared by all calls.
+    struct Binding {
+        Service* service;
+        RequestMethod method;
+        Handler handler;
+        Executor* offload; // optional; handler runs on the polling thread when null
+        ArenaPool* arenas; // optional; messages are heap-allocated when null
+        LaneExecutor* lanes; // optional; used when `offload` is null
+    };
+
+    // Arms one pending call on `cq`. The call arms its successor as soon as it is
+    // matched, so exactly one call per method is always waiting on each queue.
+    static void Arm(std::shared_ptr<const Binding> binding, grpc::ServerCompletionQueue* cq) {
+        new UnaryCall(std::move(binding), cq);
+    }
+
+    void Proceed(bool ok) override {
+        switch (state_) {
+        case State::kRequested:
+            if (!ok) {
+                // The server is shutting down; no call was matched.
+                delete this;
+                return;
+            }
+            Arm(binding_, cq_);
+            state_ = State::kFinishing;
+            if (binding_->offload != nullptr && binding_->offload->Post([this] { Reply(); })) {
+                break;
+            }
+            if (binding_->lanes != nullptr && binding_->offload == nullptr &&
+                binding_->lanes->Post(static_cast<size_t>(CallMethodClass(&ctx_)), [this] { Reply(); })) {
+                break;
+            }
+            Reply();
+            break;
+        case State::kFinishing:
+            delete this;
+            break;
+        }
+    }
+
+private:
+    enum class State { kRequested, kFinishing };
+
+    UnaryCall(std::shared_ptr<const Binding> binding, grpc::ServerCompletionQueue* cq)
+        : binding_(std::move(binding)),
+          cq_(cq),
+          arena_(binding_->arenas != nullptr ? binding_->arenas->Acquire() : ArenaPool::Lease()),
+          request_(google::protobuf::Arena::CreateMessage<Request>(arena_.get())),
+          response_(google::protobuf::Arena::CreateMessage<Response>(arena_.get())),
+          responder_(&ctx_) {
+        (binding_->service->*binding_->method)(&ctx_, request_, &responder_, cq_, cq_, this);
+    }
+
+    ~UnaryCall() override {
+        // Arena-owned messages are destroyed when the lease is returned.
+        if (!arena_) {
+            delete request_;
+            delete response_;
+        }
+    }
+
+    // Finish() may be called from any thread; its completion comes back on cq_.
+    void Reply() {
+        responder_.Finish(*response_, Invoke(), this);
+    }
+
+    grpc::Status Invoke() {
+        // Time spent waiting for an executor worker counts as queue wait; a call that expired or was cancelled
+        // meanwhile is answered without running the handler.
+        if (!BeginHandler(&ctx_)) return SkippedStatus(&ctx_);
+        try {
+            return binding_->handler(&ctx_, *request_, response_);
+        } catch (const std::exception& ex) {
+            spdlog::error("Unhandled exception in async handler: {}", ex.what());
+            return grpc::Status(grpc::StatusCode::INTERNAL, "internal error");
+        }
+    }
+
+    std::shared_ptr<const Binding> binding_;
+    grpc::ServerCompletionQueue* cq_;
+    State state_ = State::kRequested;
+
+    ArenaPool::Lease arena_; // declared before the messages it owns
+    grpc::ServerContext ctx_;
+    Request* request_;
+    Response* response_;
+    grpc::ServerAsyncResponseWriter<Response> responder_;
+};
+
+// Binds a unary method of an AsyncService to `handler` on every engine queue.
+// `Owner` is the generated WithAsyncMethod_Xxx base that declares RequestXxx.
+// With `offload` set the handler runs on that executor instead of the polling thread.
+template <class Service, class Owner, class Request, class Response, class Handler>
+void AddUnaryMethod(AsyncEngine& engine, Service* service,
+                    void (Owner::*method)(grpc::ServerContext*, Request*,
+                                          grpc::ServerAsyncResponseWriter<Response>*,
+                                          grpc::CompletionQueue*, grpc::ServerCompletionQueue*, void*),
+                    Handler handler, Executor* offload = nullptr) {
+    using Call = UnaryCall<Owner, Request, Response>;
+    auto binding = std::make_shared<const typename Call::Binding>(
+        typename Call::Binding{service, method, std::move(handler), offload, engine.arena_pool(), engine.lanes()});
+    engine.AddMethod([binding](grpc::ServerCompletionQueue* cq) { Call::Arm(binding, cq); });
+}
+
+} // namespace prodstarter
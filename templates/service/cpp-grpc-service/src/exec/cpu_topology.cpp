@@ -0,0 +1,302 @@
+// ProdStarterHub - C++ gRPC Service
+// src/exec/cpu_topology.cpp
+
+#include "exec/cpu_topology.h"
+
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <set>
+#include <sstream>
+
+#include <spdlog/fmt/fmt.h>
+#include <spdlog/spdlog.h>
+
+namespace prodstarter {
+
+namespace {
+
+constexpr int kMpolPreferred = 1; // <numaif.h>, which needs libnuma for nothing but this constant
+
+std::string ReadFirstLine(const std::string& path) {
+    std::ifstream in(path);
+    std::string line;
+    std::getline(in, line);
+    return line;
+}
+
+cpu_set_t ToMask(const std::vector<int>& cpus) {
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    for (int cpu : cpus) CPU_SET(cpu, &mask);
+    return mask;
+}
+
+// Path of this process's cgroup on the v2 unified hierarchy ("0::/path"); empty on v1.
+std::string CgroupV2Path() {
+    std::ifstream in("/proc/self/cgroup");
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.rfind("0::", 0) == 0) return line.substr(3);
+    }
+    return {};
+}
+
+// CPUs the quota allows, from cpu.max ("max 100000" or "400000 100000") or cpu.cfs_quota_us / cpu.cfs_period_us.
+// Inside a container the hierarchy is usually namespaced, so the cgroup's own files are at the root.
+double ReadCgroupQuota() {
+    const std::string v2_path = CgroupV2Path();
+    for (const std::string& dir : {"/sys/fs/cgroup" + v2_path, std::string("/sys/fs/cgroup")}) {
+        std::istringstream max(ReadFirstLine(dir + "/cpu.max"));
+        std::string quota;
+        double period = 0;
+        if (max >> quota >> period) return quota == "max" || period <= 0 ? 0 : std::stod(quota) / period;
+    }
+    for (const char* dir : {"/sys/fs/cgroup/cpu", "/sys/fs/cgroup/cpu,cpuacct"}) {
+        const std::string quota = ReadFirstLine(std::string(dir) + "/cpu.cfs_quota_us");
+        const std::string period = ReadFirstLine(std::string(dir) + "/cpu.cfs_period_us");
+        if (quota.empty() || period.empty()) continue;
+        const double quota_us = std::stod(quota);
+        const double period_us = std::stod(period);
+        return quota_us <= 0 || period_us <= 0 ? 0 : quota_us / period_us;
+    }
+    return 0;
+}
+
+} // namespace
+
+int CpuTopology::usable_cpus() const {
+    int count = static_cast<int>(cpus.size());
+    if (cgroup_quota > 0) count = std::min(count, static_cast<int>(std::ceil(cgroup_quota)));
+    return std::max(1, count);
+}
+
+bool ParseCpuList(std::string_view text, std::vector<int>* cpus, std::string* error) {
+    std::set<int> parsed;
+    size_t start = 0;
+    while (start <= text.size()) {
+        const size_t comma = std::min(text.find(',', start), text.size());
+        const std::string_view item = text.substr(start, comma - start);
+        start = comma + 1;
+
+        const size_t dash = item.find('-');
+        int first = 0;
+        int last = 0;
+        auto number = [](std::string_view digits, int* out) {
+            if (digits.empty() || digits.size() > 6) return false;
+            int value = 0;
+            for (char c : digits) {
+                if (c < '0' || c > '9') return false;
+                value = value * 10 + (c - '0');
+            }
+            *out = value;
+            return true;
+        };
+        bool ok = false;
+        if (dash == std::string_view::npos) {
+            ok = number(item, &first);
+            last = first;
+        } else {
+            ok = number(item.substr(0, dash), &first) && number(item.substr(dash + 1), &last);
+        }
+        if (!ok || first > last) {
+            *error = fmt::format("'{}' is not a CPU or a range of CPUs (expected e.g. 0-7,16-23)", item);
+            return false;
+        }
+        if (last >= CPU_SETSIZE) {
+            *error = fmt::format("CPU {} is beyond the highest supported CPU {}", last, CPU_SETSIZE - 1);
+            return false;
+        }
+        for (int cpu = first; cpu <= last; ++cpu) parsed.insert(cpu);
+    }
+    cpus->assign(parsed.begin(), parsed.end());
+    return true;
+}
+
+std::string FormatCpuList(const std::vector<int>& cpus) {
+    std::string out;
+    for (size_t i = 0; i < cpus.size();) {
+        size_t j = i;
+        while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1) ++j;
+        if (!out.empty()) out += ',';
+        out += j == i ? std::to_string(cpus[i]) : fmt::format("{}-{}", cpus[i], cpus[j]);
+        i = j + 1;
+    }
+    return out.empty() ? "none" : out;
+}
+
+CpuTopology DetectCpuTopology(const std::vector<int>& cpu_set) {
+    CpuTopology topology;
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    if (sched_getaffinity(0, sizeof(mask), &mask) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &mask)) topology.allowed.push_back(cpu);
+        }
+    }
+    if (topology.allowed.empty()) {
+        const long online = sysconf(_SC_NPROCESSORS_ONLN);
+        for (int cpu = 0; cpu < std::max(1L, online); ++cpu) topology.allowed.push_back(cpu);
+    }
+
+    if (cpu_set.empty()) {
+        topology.cpus = topology.allowed;
+    } else {
+        std::set_intersection(topology.allowed.begin(), topology.allowed.end(), cpu_set.begin(), cpu_set.end(),
+                              std::back_inserter(topology.cpus));
+    }
+
+    std::vector<int> node_ids;
+    std::string ignored;
+    const std::string online = ReadFirstLine("/sys/devices/system/node/online");
+    if (!online.empty() && ParseCpuList(online, &node_ids, &ignored)) {
+        for (int id : node_ids) {
+            std::vector<int> node_cpus;
+            const std::string list = ReadFirstLine(fmt::format("/sys/devices/system/node/node{}/cpulist", id));
+            if (list.empty() || !ParseCpuList(list, &node_cpus, &ignored)) continue;
+            NumaNode node;
+            node.id = id;
+            std::set_intersection(node_cpus.begin(), node_cpus.end(), topology.cpus.begin(), topology.cpus.end(),
+                                  std::back_inserter(node.cpus));
+            if (!node.cpus.empty()) topology.nodes.push_back(std::move(node));
+        }
+    }
+    if (topology.nodes.empty() && !topology.cpus.empty()) {
+        NumaNode node;
+        node.cpus = topology.cpus;
+        topology.nodes.push_back(std::move(node));
+    }
+
+    try {
+        topology.cgroup_quota = ReadCgroupQuota();
+    } catch (const std::exception&) {
+        topology.cgroup_quota = 0; // unreadable quota files: treat as unlimited
+    }
+    return topology;
+}
+
+std::string DescribeCpuTopology(const CpuTopology& topology) {
+    std::string nodes;
+    for (const auto& node : topology.nodes) {
+        if (!nodes.empty()) nodes += ", ";
+        nodes += node.id < 0 ? FormatCpuList(node.cpus) : fmt::format("node{}: {}", node.id, FormatCpuList(node.cpus));
+    }
+    const std::string quota = topology.cgroup_quota > 0 ? fmt::format("{:.2f} CPUs", topology.cgroup_quota) : "none";
+    return fmt::format("{} usable CPUs ({} of affinity {}), cgroup quota {}, {} NUMA node(s) [{}]",
+                       topology.usable_cpus(), FormatCpuList(topology.cpus), FormatCpuList(topology.allowed), quota,
+                       topology.nodes.size(), nodes);
+}
+
+bool RestrictProcessToCpus(const std::vector<int>& cpus, std::string* error) {
+    const cpu_set_t mask = ToMask(cpus);
+    DIR* tasks = opendir("/proc/self/task");
+    if (tasks == nullptr) {
+        *error = fmt::format("cannot list /proc/self/task: {}", std::strerror(errno));
+        return false;
+    }
+    bool ok = true;
+    while (const dirent* entry = readdir(tasks)) {
+        if (entry->d_name[0] == '.') continue;
+        const pid_t tid = static_cast<pid_t>(std::atol(entry->d_name));
+        // A thread that exited since the listing (ESRCH) no longer matters.
+        if (sched_setaffinity(tid, sizeof(mask), &mask) != 0 && errno != ESRCH) {
+            *error = fmt::format("sched_setaffinity({}) on thread {}: {}", FormatCpuList(cpus), tid,
+                                 std::strerror(errno));
+            ok = false;
+            break;
+        }
+    }
+    closedir(tasks);
+    return ok;
+}
+
+void ThreadPlacement::Apply(int index) const {
+    if (slots.empty()) return;
+    const Slot& slot = slots[static_cast<size_t>(index) % slots.size()];
+    static std::atomic<bool> warned{false};
+    auto warn_once = [](const std::string& message) {
+        if (!warned.exchange(true)) spdlog::warn("Thread placement: {}", message);
+    };
+
+    const cpu_set_t mask = ToMask(slot.cpus);
+    const int rc = pthread_setaffinity_np(pthread_self(), sizeof(mask), &mask);
+    if (rc != 0) warn_once(fmt::format("pinning to CPUs {} failed: {}", FormatCpuList(slot.cpus), std::strerror(rc)));
+
+    if (slot.node >= 0) {
+        constexpr int kBitsPerWord = 8 * sizeof(unsigned long);
+        std::vector<unsigned long> nodes(static_cast<size_t>(slot.node / kBitsPerWord) + 1, 0);
+        nodes[slot.node / kBitsPerWord] |= 1UL << (slot.node % kBitsPerWord);
+        if (syscall(SYS_set_mempolicy, kMpolPreferred, nodes.data(), nodes.size() * kBitsPerWord) != 0) {
+            warn_once(fmt::format("preferring memory of node {} failed: {}", slot.node, std::strerror(errno)));
+        }
+    }
+}
+
+std::string ThreadPlacement::Describe() const {
+    if (slots.empty()) return "floating";
+    std::set<int> cpus;
+    std::set<int> nodes;
+    for (const auto& slot : slots) {
+        cpus.insert(slot.cpus.begin(), slot.cpus.end());
+        if (slot.node >= 0) nodes.insert(slot.node);
+    }
+    std::string out = "CPUs " + FormatCpuList({cpus.begin(), cpus.end()});
+    if (!nodes.empty()) {
+        out += nodes.size() == 1 ? " on node " : " on nodes ";
+        out += FormatCpuList({nodes.begin(), nodes.end()});
+    }
+    return out;
+}
+
+ThreadPlacement PlaceOnCpus(const std::vector<int>& cpus, int node) {
+    ThreadPlacement placement;
+    placement.slots.reserve(cpus.size());
+    for (int cpu : cpus) placement.slots.push_back({{cpu}, node});
+    return placement;
+}
+
+ThreadPlacement PlaceAcrossNodes(const CpuTopology& topology) {
+    ThreadPlacement placement;
+    size_t widest = 0;
+    for (const auto& node : topology.nodes) widest = std::max(widest, node.cpus.size());
+    for (size_t k = 0; k < widest; ++k) {
+        for (const auto& node : topology.nodes) {
+            if (k < node.cpus.size()) placement.slots.push_back({{node.cpus[k]}, node.id});
+        }
+    }
+    return placement;
+}
+
+std::vector<ThreadPlacement> PlaceShards(const CpuTopology& topology, int num_shards, int threads_per_shard,
+                                         bool per_node) {
+    std::vector<ThreadPlacement> placements;
+    if (topology.nodes.empty()) return placements;
+    const int groups = per_node ? static_cast<int>(topology.nodes.size()) : 1;
+    for (int i = 0; i < num_shards; ++i) {
+        ThreadPlacement placement = per_node
+            ? PlaceOnCpus(topology.nodes[i % groups].cpus, topology.nodes[i % groups].id)
+            : PlaceOnCpus(topology.cpus);
+        if (placement.empty()) {
+            placements.push_back(std::move(placement));
+            continue;
+        }
+        // The shards sharing these CPUs so far occupy the first slots; start after them.
+        const size_t skip = static_cast<size_t>(i / groups) * std::max(1, threads_per_shard) % placement.slots.size();
+        std::rotate(placement.slots.begin(), placement.slots.begin() + skip, placement.slots.end());
+        placements.push_back(std::move(placement));
+    }
+    return placements;
+}
+
+} // namespace prodstarter
@@ -0,0 +1,86 @@
+// ProdStarterHub - C++ gRPC Service
+// src/exec/cpu_topology.h
+// CPUs and NUMA nodes this process may use, and placement of its threads on them.
+//
+// Default thread counts follow the CPUs the process can really use: its
+// affinity mask, narrowed by --cpu-set, and no more than the cgroup CPU quota
+// allows, so a 4-CPU container on a 64-core host starts 4 threads, not 64.
+//
+// With --cpu-set or --numa-policy=shard the polling threads and executor
+// workers are pinned one CPU each, thread i taking slot i of its pool's
+// ThreadPlacement (round-robin when there are more threads than slots):
+//
+//   const CpuTopology topology = DetectCpuTopology(cfg.cpu_set);
+//   const ThreadPlacement placement = PlaceOnCpus(topology.nodes[0].cpus, topology.nodes[0].id);
+//   std::thread([placement] { placement.Apply(0); Serve(); });
+//
+// A slot on a known node also makes its thread prefer that node for memory
+// (set_mempolicy(MPOL_PREFERRED)), so the arenas and call state it first
+// touches stay local. Linux only.
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace prodstarter {
+
+struct NumaNode {
+    int id = -1;           // -1: the kernel exposes no NUMA information
+    std::vector<int> cpus; // usable CPUs of the node, ascending
+};
+
+struct CpuTopology {
+    std::vector<int> allowed;    // the affinity mask the process started with
+    std::vector<int> cpus;       // usable CPUs: `allowed` narrowed by --cpu-set
+    std::vector<NumaNode> nodes; // nodes with at least one usable CPU
+    double cgroup_quota = 0;     // CPUs the cgroup may use (cpu.max, cpu.cfs_quota_us); 0: unlimited
+
+    // Thread count to default to: usable CPUs, capped by the quota; at least 1.
+    int usable_cpus() const;
+};
+
+// Parses a kernel-style CPU list ("0-7,16-23"). Returns false with `error` set when it does not parse.
+bool ParseCpuList(std::string_view text, std::vector<int>* cpus, std::string* error);
+std::string FormatCpuList(const std::vector<int>& cpus);
+
+// Reads the affinity mask, /sys/devices/system/node and the cgroup CPU quota. A non-empty `cpu_set` narrows the
+// usable CPUs to the ones it shares with the affinity mask.
+CpuTopology DetectCpuTopology(const std::vector<int>& cpu_set = {});
+std::string DescribeCpuTopology(const CpuTopology& topology);
+
+// Moves every thread of the process, and so every thread created later, onto `cpus`.
+bool RestrictProcessToCpus(const std::vector<int>& cpus, std::string* error);
+
+// Where the threads of one pool run.
+struct ThreadPlacement {
+    struct Slot {
+        std::vector<int> cpus;
+        int node = -1; // memory preferred from this node; -1: the default policy
+    };
+
+    std::vector<Slot> slots; // empty: threads float
+
+    bool empty() const { return slots.empty(); }
+
+    // Places the calling thread as the pool's thread `index`. Does nothing for an empty placement.
+    void Apply(int index) const;
+
+    // "CPUs 0-3", "CPUs 0-3 on node 0".
+    std::string Describe() const;
+};
+
+// One slot per CPU of `cpus`, all preferring `node`'s memory.
+ThreadPlacement PlaceOnCpus(const std::vector<int>& cpus, int node = -1);
+
+// One slot per usable CPU, alternating between the nodes so that N threads spread evenly across them.
+ThreadPlacement PlaceAcrossNodes(const CpuTopology& topology);
+
+// Placement of the polling threads of `num_shards` servers with `threads_per_shard` threads each. With `per_node`
+// shard i keeps its threads and memory on node i % nodes, otherwise every shard shares the usable CPUs. Shards on
+// the same CPUs start at different ones.
+std::vector<ThreadPlacement> PlaceShards(const CpuTopology& topology, int num_shards, int threads_per_shard,
+                                         bool per_node);
+
+} // namespace prodstarter
@@ -0,0 +1,206 @@
+// ProdStarterHub - C++ gRPC Service
+// src/exec/executor.cpp
+
+#include "exec/executor.h"
+
+#include <algorithm>
+#include <exception>
+#include <utility>
+
+#include <spdlog/spdlog.h>
+
+namespace prodstarter {
+
+namespace {
+// Worker identity of the calling thread, used to route Post() to the local deque.
+thread_local const Executor* tls_executor = nullptr;
+thread_local int tls_worker_index = -1;
+} // namespace
+
+Executor::Executor(int num_threads, std::string name, ThreadPlacement placement)
+    : name_(std::move(name)), placement_(std::move(placement)) {
+    num_threads = std::clamp(num_threads, 1, kMaxThreads);
+    workers_.reserve(kMaxThreads);
+    for (int i = 0; i < kMaxThreads; ++i) {
+        workers_.push_back(std::make_unique<Worker>());
+    }
+    active_.store(num_threads, std::memory_order_relaxed);
+    started_.store(num_threads, std::memory_order_relaxed);
+    for (int i = 0; i < num_threads; ++i) {
+        workers_[i]->thread = std::thread(&Executor::Run, this, i);
+    }
+}
+
+Executor::~Executor() {
+    Shutdown();
+}
+
+bool Executor::Post(Task task) {
+    if (stopping_.load(std::memory_order_acquire)) {
+        return false;
+    }
+
+    const int count = active_.load(std::memory_order_acquire);
+    const int target = (tls_executor == this)
+        ? tls_worker_index
+        : static_cast<int>(next_worker_.fetch_add(1, std::memory_order_relaxed) % count);
+
+    Worker& worker = *workers_[target];
+    {
+        std::lock_guard<std::mutex> lock(worker.mu);
+        worker.tasks.push_back(std::move(task));
+        worker.depth.store(worker.tasks.size(), std::memory_order_relaxed);
+    }
+    submitted_.fetch_add(1, std::memory_order_relaxed);
+
+    // Paired with the sleepers_ increment in Run(): either the sleeper sees the
+    // new pending count or we see the sleeper and wake it under the lock.
+    pending_.fetch_add(1);
+    if (sleepers_.load() > 0) {
+        std::lock_guard<std::mutex> lock(idle_mu_);
+        idle_cv_.notify_one();
+    }
+    return true;
+}
+
+void Executor::Shutdown() {
+    std::lock_guard<std::mutex> resize_lock(resize_mu_);
+    if (stopping_.exchange(true)) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(idle_mu_);
+        idle_cv_.notify_all();
+    }
+    const int started = started_.load(std::memory_order_acquire);
+    for (int i = 0; i < started; ++i) {
+        if (workers_[i]->thread.joinable()) workers_[i]->thread.join();
+    }
+    // A Post() that raced with the stop flag, or with a Resize(), may have queued after the workers exited.
+    for (int i = 0; i < started; ++i) {
+        auto& worker = workers_[i];
+        for (auto& task : worker->tasks) {
+            // As in Run(): a throwing task must not escape Shutdown(), which the destructor calls.
+            try {
+                task();
+            } catch (const std::exception& ex) {
+                spdlog::error("Executor '{}' task threw: {}", name_, ex.what());
+            }
+            executed_.fetch_add(1, std::memory_order_relaxed);
+        }
+        worker->tasks.clear();
+        worker->depth.store(0, std::memory_order_relaxed);
+    }
+    spdlog::debug("Executor '{}' stopped", name_);
+}
+
+void Executor::Resize(int num_threads) {
+    std::lock_guard<std::mutex> resize_lock(resize_mu_);
+    if (stopping_.load()) return;
+    num_threads = std::clamp(num_threads, 1, kMaxThreads);
+    const int previous = active_.load(std::memory_order_relaxed);
+    if (num_threads == previous) return;
+    if (num_threads < previous) {
+        active_.store(num_threads, std::memory_order_release);
+        std::lock_guard<std::mutex> lock(idle_mu_);
+        idle_cv_.notify_all(); // sleeping retirees exit now; busy ones after their deque is empty
+    } else {
+        // A slot retired earlier may still be finishing its last task; its deque is picked up by the new thread.
+        for (int i = previous; i < num_threads; ++i) {
+            if (workers_[i]->thread.joinable()) workers_[i]->thread.join();
+        }
+        started_.store(std::max(started_.load(std::memory_order_relaxed), num_threads), std::memory_order_release);
+        active_.store(num_threads, std::memory_order_release);
+        for (int i = previous; i < num_threads; ++i) {
+            workers_[i]->thread = std::thread(&Executor::Run, this, i);
+        }
+    }
+    spdlog::info("Executor '{}' resized from {} to {} workers", name_, previous, num_threads);
+}
+
+Executor::Stats Executor::GetStats() const {
+    Stats stats;
+    stats.submitted = submitted_.load(std::memory_order_relaxed);
+    stats.executed = executed_.load(std::memory_order_relaxed);
+    stats.stolen = stolen_.load(std::memory_order_relaxed);
+    const int active = active_.load(std::memory_order_relaxed);
+    const int started = started_.load(std::memory_order_acquire);
+    stats.queue_depths.reserve(active);
+    for (int i = 0; i < started; ++i) {
+        const uint64_t depth = workers_[i]->depth.load(std::memory_order_relaxed);
+        if (i < active) stats.queue_depths.push_back(depth);
+        stats.queued += depth; // retired workers' leftovers too, until they are stolen
+    }
+    return stats;
+}
+
+bool Executor::TryPop(int index, Task& task) {
+    Worker& worker = *workers_[index];
+    std::lock_guard<std::mutex> lock(worker.mu);
+    if (worker.tasks.empty()) return false;
+    task = std::move(worker.tasks.back());
+    worker.tasks.pop_back();
+    worker.depth.store(worker.tasks.size(), std::memory_order_relaxed);
+    return true;
+}
+
+bool Executor::TrySteal(int thief, Task& task) {
+    const int count = started_.load(std::memory_order_acquire);
+    for (int offset = 1; offset < count; ++offset) {
+        Worker& victim = *workers_[(thief + offset) % count];
+        std::unique_lock<std::mutex> lock(victim.mu, std::try_to_lock);
+        if (!lock.owns_lock() || victim.tasks.empty()) continue;
+        task = std::move(victim.tasks.front());
+        victim.tasks.pop_front();
+        victim.depth.store(victim.tasks.size(), std::memory_order_relaxed);
+        stolen_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+void Executor::Run(int index) {
+    placement_.Apply(index);
+    tls_executor = this;
+    tls_worker_index = index;
+    spdlog::debug("Executor '{}' worker {} started", name_, index);
+
+    Task task;
+    for (;;) {
+        const bool retired = index >= active_.load(std::memory_order_acquire);
+        if (TryPop(index, task) || (!retired && TrySteal(index, task))) {
+            pending_.fetch_sub(1);
+            try {
+                task();
+            } catch (const std::exception& ex) {
+                spdlog::error("Executor '{}' task threw: {}", name_, ex.what());
+            }
+            task = nullptr;
+            executed_.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(idle_mu_);
+        if (retired || index >= active_.load(std::memory_order_acquire)) {
+            // Own deque is empty. Tasks still pending elsewhere belong to the active workers; pass on a
+            // wake-up this worker may have taken from them.
+            if (pending_.load() > 0) idle_cv_.notify_one();
+            break;
+        }
+        // A try_lock miss in TrySteal can leave work queued; only sleep when
+        // nothing is pending, and only exit once the queues are drained.
+        if (pending_.load() > 0) continue;
+        if (stopping_.load()) break;
+        sleepers_.fetch_add(1);
+        idle_cv_.wait(lock, [this, index] {
+            return pending_.load() > 0 || stopping_.load() || index >= active_.load(std::memory_order_acquire);
+        });
+        sleepers_.fetch_sub(1);
+    }
+
+    spdlog::debug("Executor '{}' worker {} exiting", name_, index);
+    tls_executor = nullptr;
+    tls_worker_index = -1;
+}
+
+} // namespace prodstarter
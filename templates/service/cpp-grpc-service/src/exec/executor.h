@@ -0,0 +1,133 @@
+// ProdStarterHub - C++ gRPC Service
+// src/exec/executor.h
+// Work-stealing executor for background and CPU-heavy work.
+//
+// Each worker owns a deque. Tasks posted from a worker go to the back of its
+// own deque and are popped LIFO (hot in cache); tasks posted from any other
+// thread are spread round-robin across the workers. An idle worker steals from
+// the front of its siblings' deques before going to sleep, so a burst that
+// lands on one worker is spread across the pool without a shared queue.
+//
+// RPC handlers use it to get CPU-heavy work off the gRPC polling threads:
+//   executor.Post([=] { ...; responder.Finish(resp, status, tag); });
+//   auto digest = executor.Submit([&] { return Hash(payload); });          // std::future
+//   executor.Submit([=] { return Render(req); }, [=](Page p) { Reply(p); }); // continuation
+//
+// Resize() changes the worker count while the executor runs (see
+// config/runtime_config.h). All kMaxThreads worker slots exist from the start,
+// so Post() and stealing never see the slot vector change; only the number of
+// active workers moves. A retired worker stops receiving new tasks, finishes
+// its own deque and exits, and whatever else lands on it is stolen by the
+// active workers, so no queued or running task is dropped.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "exec/cpu_topology.h"
+
+namespace prodstarter {
+
+class Executor {
+public:
+    using Task = std::function<void()>;
+
+    static constexpr int kMaxThreads = 256;
+
+    struct Stats {
+        uint64_t submitted = 0;
+        uint64_t executed = 0;
+        uint64_t stolen = 0;
+        uint64_t queued = 0;                // tasks waiting across all workers
+        std::vector<uint64_t> queue_depths; // per worker
+    };
+
+    // Worker i is placed by `placement` (exec/cpu_topology.h); by default the workers float.
+    Executor(int num_threads, std::string name = "worker", ThreadPlacement placement = {});
+    ~Executor();
+
+    Executor(const Executor&) = delete;
+    Executor& operator=(const Executor&) = delete;
+
+    // Queues a task. Returns false if the executor is shutting down.
+    bool Post(Task task);
+
+    // Runs `fn` on a worker and returns its result through a future. The future
+    // reports std::future_error (broken promise) if the executor was stopped.
+    template <class F>
+    auto Submit(F&& fn) -> std::future<std::invoke_result_t<std::decay_t<F>>> {
+        using Result = std::invoke_result_t<std::decay_t<F>>;
+        auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(fn));
+        auto future = task->get_future();
+        Post([task] { (*task)(); });
+        return future;
+    }
+
+    // Runs `fn` on a worker and hands its result to `on_done` on the same worker.
+    template <class F, class Callback>
+    bool Submit(F&& fn, Callback&& on_done) {
+        return Post([fn = std::forward<F>(fn), on_done = std::forward<Callback>(on_done)]() mutable {
+            if constexpr (std::is_void_v<std::invoke_result_t<decltype(fn)&>>) {
+                fn();
+                on_done();
+            } else {
+                on_done(fn());
+            }
+        });
+    }
+
+    // Stops accepting tasks, runs everything already queued and joins the workers.
+    void Shutdown();
+
+    // Sets the number of workers (1..kMaxThreads). New workers start at once; retired ones finish their current
+    // task and their own deque first. Waits for workers retired by an earlier call that it has to restart.
+    void Resize(int num_threads);
+
+    Stats GetStats() const;
+    int num_threads() const { return active_.load(std::memory_order_relaxed); }
+    const std::string& name() const { return name_; }
+
+private:
+    struct Worker {
+        std::mutex mu;
+        std::deque<Task> tasks;
+        std::atomic<uint64_t> depth{0};
+        std::thread thread; // joinable from start until Resize() or Shutdown() joins it after retirement
+    };
+
+    void Run(int index);
+    bool TryPop(int index, Task& task);
+    bool TrySteal(int thief, Task& task);
+
+    std::string name_;
+    ThreadPlacement placement_;
+    std::vector<std::unique_ptr<Worker>> workers_; // kMaxThreads slots, never resized
+    std::atomic<int> active_{0};                   // workers [0, active_) receive Post()s
+    std::atomic<int> started_{0};                  // highest slot ever started + 1; stealing scans [0, started_)
+    std::mutex resize_mu_;                         // serializes Resize() and Shutdown()
+
+    std::atomic<uint64_t> next_worker_{0};
+    std::atomic<int64_t> pending_{0}; // may dip below zero while a Post() is in flight
+    std::atomic<int> sleepers_{0};
+    std::atomic<bool> stopping_{false};
+    std::mutex idle_mu_;
+    std::condition_variable idle_cv_;
+
+    std::atomic<uint64_t> submitted_{0};
+    std::atomic<uint64_t> executed_{0};
+    std::atomic<uint64_t> stolen_{0};
+};
+
+} // namespace prodstarter
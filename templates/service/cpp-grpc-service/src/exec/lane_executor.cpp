@@ -0,0 +1,153 @@
+// ProdStarterHub - C++ gRPC Service
+// src/exec/lane_executor.cpp
+
+#include "exec/lane_executor.h"
+
+#include <algorithm>
+#include <exception>
+#include <utility>
+
+#include <spdlog/spdlog.h>
+
+namespace prodstarter {
+
+namespace {
+// Pass advance of a weight-1 lane; heavier lanes advance proportionally less per task.
+constexpr uint64_t kBaseStride = uint64_t{1} << 20;
+} // namespace
+
+LaneExecutor::LaneExecutor(int shared_threads, std::vector<LaneOptions> lanes, ThreadPlacement placement)
+    : placement_(std::move(placement)) {
+    if (lanes.empty()) lanes.push_back(LaneOptions{"default"});
+    int reserved = 0;
+    for (auto& options : lanes) {
+        auto lane = std::make_unique<Lane>();
+        options.weight = std::max(1, options.weight);
+        options.max_threads = std::max(0, options.max_threads);
+        options.reserved_threads = std::max(0, options.reserved_threads);
+        reserved += options.reserved_threads;
+        lane->stride = kBaseStride / static_cast<uint64_t>(options.weight);
+        lane->options = std::move(options);
+        lanes_.push_back(std::move(lane));
+    }
+    // Lanes without reserved threads need at least one shared worker.
+    if (shared_threads < 1 && (reserved == 0 || std::any_of(lanes_.begin(), lanes_.end(), [](const auto& lane) {
+                                   return lane->options.reserved_threads == 0;
+                               }))) {
+        shared_threads = 1;
+    }
+    for (int i = 0; i < shared_threads; ++i) {
+        threads_.emplace_back(&LaneExecutor::Run, this, -1, static_cast<int>(threads_.size()));
+    }
+    for (size_t i = 0; i < lanes_.size(); ++i) {
+        for (int j = 0; j < lanes_[i]->options.reserved_threads; ++j) {
+            threads_.emplace_back(&LaneExecutor::Run, this, static_cast<int>(i), static_cast<int>(threads_.size()));
+        }
+    }
+}
+
+LaneExecutor::~LaneExecutor() {
+    Shutdown();
+}
+
+bool LaneExecutor::Post(size_t lane, Task task) {
+    lane = std::min(lane, lanes_.size() - 1);
+    std::lock_guard<std::mutex> lock(mu_);
+    if (stopping_) return false;
+    Lane& target = *lanes_[lane];
+    // A lane that sat idle rejoins at the current virtual time instead of cashing in the turns it skipped.
+    if (target.tasks.empty()) target.pass = std::max(target.pass, virtual_time_);
+    target.tasks.push_back(std::move(task));
+    WakeLocked(lane);
+    return true;
+}
+
+void LaneExecutor::Shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        stopping_ = true;
+        shared_cv_.notify_all();
+        for (auto& lane : lanes_) lane->reserved_cv.notify_all();
+    }
+    for (auto& thread : threads_) {
+        if (thread.joinable()) thread.join();
+    }
+}
+
+LaneExecutor::Stats LaneExecutor::GetStats() const {
+    Stats stats;
+    std::lock_guard<std::mutex> lock(mu_);
+    stats.lanes.reserve(lanes_.size());
+    for (const auto& lane : lanes_) {
+        LaneStats out;
+        out.name = lane->options.name;
+        out.queued = lane->tasks.size();
+        out.running = static_cast<uint64_t>(lane->running);
+        out.executed = lane->executed;
+        stats.lanes.push_back(std::move(out));
+    }
+    return stats;
+}
+
+bool LaneExecutor::Runnable(const Lane& lane) const {
+    return !lane.tasks.empty() && (lane.options.max_threads == 0 || lane.running < lane.options.max_threads);
+}
+
+int LaneExecutor::PickLocked() const {
+    int best = -1;
+    for (size_t i = 0; i < lanes_.size(); ++i) {
+        if (Runnable(*lanes_[i]) && (best < 0 || lanes_[i]->pass < lanes_[best]->pass)) best = static_cast<int>(i);
+    }
+    return best;
+}
+
+void LaneExecutor::WakeLocked(size_t lane) {
+    if (lanes_[lane]->options.reserved_threads > 0) lanes_[lane]->reserved_cv.notify_one();
+    shared_cv_.notify_one();
+}
+
+void LaneExecutor::Run(int reserved_lane, int thread_index) {
+    placement_.Apply(thread_index);
+    std::unique_lock<std::mutex> lock(mu_);
+    std::condition_variable& cv = reserved_lane < 0 ? shared_cv_ : lanes_[reserved_lane]->reserved_cv;
+    for (;;) {
+        const int index = reserved_lane < 0 ? PickLocked() : (Runnable(*lanes_[reserved_lane]) ? reserved_lane : -1);
+        if (index < 0) {
+            // Capped lanes may still hold work that a running task's completion will hand out.
+            const bool drained = reserved_lane < 0
+                ? std::all_of(lanes_.begin(), lanes_.end(), [](const auto& lane) { return lane->tasks.empty(); })
+                : lanes_[reserved_lane]->tasks.empty();
+            if (stopping_ && drained) {
+                // Workers parked behind a capped lane were waiting for this; let them see it too.
+                shared_cv_.notify_all();
+                for (auto& other : lanes_) other->reserved_cv.notify_all();
+                break;
+            }
+            cv.wait(lock);
+            continue;
+        }
+
+        Lane& lane = *lanes_[index];
+        Task task = std::move(lane.tasks.front());
+        lane.tasks.pop_front();
+        ++lane.running;
+        // Reserved capacity comes on top of the lane's share, so only shared workers advance its pass.
+        if (reserved_lane < 0) {
+            virtual_time_ = lane.pass;
+            lane.pass += lane.stride;
+        }
+        lock.unlock();
+        try {
+            task();
+        } catch (const std::exception& ex) {
+            spdlog::error("Lane '{}' task threw: {}", lane.options.name, ex.what());
+        }
+        task = nullptr;
+        lock.lock();
+        --lane.running;
+        ++lane.executed;
+        if (!lane.tasks.empty()) WakeLocked(static_cast<size_t>(index));
+    }
+}
+
+} // namespace prodstarter
@@ -0,0 +1,107 @@
+// ProdStarterHub - C++ gRPC Service
+// src/exec/lane_executor.h
+// Executor with one FIFO lane per priority class and weighted scheduling.
+//
+// The work-stealing Executor treats every task alike, so a burst of bulk work
+// queues in front of latency-critical handlers. A LaneExecutor keeps a queue
+// per lane instead and its shared workers pick the next task by stride
+// scheduling over the lanes that have work: with weights 8:4:1 a backlog of
+// bulk tasks gets one task in thirteen while critical work is waiting, and
+// every worker when nothing else is. Two knobs bound how much one lane can
+// take from the others:
+//
+//   max_threads       the lane never runs more tasks at once, so long tasks
+//                     leave the remaining workers to the other lanes
+//   reserved_threads  extra workers that only serve this lane, so it has
+//                     capacity even when the shared workers are all busy
+//
+// The async engines post handlers to the lane of their call's MethodClass
+// (call/method_class.h) when an AsyncEngine has lanes set; callback reactors
+// can do the same:
+//
+//   lanes.Post(static_cast<size_t>(prodstarter::CallMethodClass(ctx)), [=] { ...; Finish(status); });
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "exec/cpu_topology.h"
+
+namespace prodstarter {
+
+struct LaneOptions {
+    std::string name;
+    int weight = 1;           // share of the shared workers while lanes compete
+    int max_threads = 0;      // cap on tasks running at once, reserved threads included; 0: no cap
+    int reserved_threads = 0; // workers that serve only this lane
+};
+
+class LaneExecutor {
+public:
+    using Task = std::function<void()>;
+
+    struct LaneStats {
+        std::string name;
+        uint64_t queued = 0;
+        uint64_t running = 0;
+        uint64_t executed = 0;
+    };
+
+    struct Stats {
+        std::vector<LaneStats> lanes;
+    };
+
+    // `shared_threads` workers serve every lane; each lane adds its reserved ones. Worker i is placed by `placement`.
+    LaneExecutor(int shared_threads, std::vector<LaneOptions> lanes, ThreadPlacement placement = {});
+    ~LaneExecutor();
+
+    LaneExecutor(const LaneExecutor&) = delete;
+    LaneExecutor& operator=(const LaneExecutor&) = delete;
+
+    // Queues a task on `lane` (an index into the options; out of range maps to the last lane).
+    // Returns false if the executor is shutting down.
+    bool Post(size_t lane, Task task);
+
+    // Stops accepting tasks, runs everything already queued and joins the workers.
+    void Shutdown();
+
+    Stats GetStats() const;
+    size_t num_lanes() const { return lanes_.size(); }
+    int num_threads() const { return static_cast<int>(threads_.size()); }
+
+private:
+    struct Lane {
+        LaneOptions options;
+        std::deque<Task> tasks;
+        uint64_t pass = 0;   // stride-scheduling position; the lowest runnable one goes next
+        uint64_t stride = 0; // added to pass per task, inversely proportional to the weight
+        int running = 0;
+        uint64_t executed = 0;
+        std::condition_variable reserved_cv; // wakes this lane's reserved threads
+    };
+
+    void Run(int lane, int index); // lane < 0: a shared worker
+    // Index of the lane a shared worker should serve next, or -1; called with mu_ held.
+    int PickLocked() const;
+    bool Runnable(const Lane& lane) const;
+    void WakeLocked(size_t lane);
+
+    std::vector<std::unique_ptr<Lane>> lanes_;
+    ThreadPlacement placement_;
+    std::vector<std::thread> threads_;
+
+    mutable std::mutex mu_;
+    std::condition_variable shared_cv_;
+    uint64_t virtual_time_ = 0; // pass of the last task picked; idle lanes rejoin here
+    bool stopping_ = false;
+};
+
+} // namespace prodstarter
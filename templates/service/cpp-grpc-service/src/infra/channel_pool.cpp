@@ -0,0 +1,89 @@
+// ProdStarterHub - C++ gRPC Service
+// src/infra/channel_pool.cpp
+
+#include "infra/channel_pool.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace prodstarter {
+
+struct ChannelPool::Lease::Slot {
+    std::shared_ptr<grpc::Channel> channel;
+    alignas(64) std::atomic<int64_t> inflight{0}; // picks of neighbouring slots do not share a cache line
+    std::atomic<uint64_t> picks{0};
+};
+
+ChannelPool::Lease& ChannelPool::Lease::operator=(Lease&& other) noexcept {
+    if (this != &other) {
+        Release();
+        slot_ = other.slot_;
+        index_ = other.index_;
+        other.slot_ = nullptr;
+    }
+    return *this;
+}
+
+const std::shared_ptr<grpc::Channel>& ChannelPool::Lease::channel() const { return slot_->channel; }
+
+void ChannelPool::Lease::Release() {
+    if (slot_ == nullptr) return;
+    slot_->inflight.fetch_sub(1, std::memory_order_relaxed);
+    slot_ = nullptr;
+}
+
+ChannelPool::ChannelPool(ChannelPoolOptions options)
+    : name_(std::move(options.name)), least_loaded_(options.pick == "least-loaded") {
+    auto credentials = options.credentials ? options.credentials : grpc::InsecureChannelCredentials();
+    const int size = std::max(1, options.size);
+    for (int i = 0; i < size; ++i) {
+        grpc::ChannelArguments args = options.args;
+        // A channel shares subchannels with every channel of equal args through the global pool, which would
+        // collapse the pool back onto one connection per address.
+        args.SetInt(GRPC_ARG_USE_LOCAL_SUBCHANNEL_POOL, 1);
+        args.SetInt("prodstarter.channel_pool_index", i);
+        auto slot = std::make_unique<Lease::Slot>();
+        slot->channel = grpc::CreateCustomChannel(options.target, credentials, args);
+        slots_.push_back(std::move(slot));
+    }
+}
+
+ChannelPool::~ChannelPool() = default;
+
+ChannelPool::Lease ChannelPool::Acquire() {
+    const size_t count = slots_.size();
+    size_t index = next_.fetch_add(1, std::memory_order_relaxed) % count;
+    if (least_loaded_) {
+        // Scans from the rotating start so ties spread instead of piling onto the first channel.
+        int64_t best = slots_[index]->inflight.load(std::memory_order_relaxed);
+        for (size_t step = 1; step < count && best > 0; ++step) {
+            const size_t candidate = (index + step) % count;
+            const int64_t load = slots_[candidate]->inflight.load(std::memory_order_relaxed);
+            if (load < best) {
+                best = load;
+                index = candidate;
+            }
+        }
+    }
+    Lease::Slot* slot = slots_[index].get();
+    slot->inflight.fetch_add(1, std::memory_order_relaxed);
+    slot->picks.fetch_add(1, std::memory_order_relaxed);
+    return Lease(slot, static_cast<int>(index));
+}
+
+const std::shared_ptr<grpc::Channel>& ChannelPool::channel(int index) const { return slots_[index]->channel; }
+
+ChannelPool::Stats ChannelPool::GetStats() const {
+    Stats stats;
+    stats.channels.reserve(slots_.size());
+    for (const auto& slot : slots_) {
+        ChannelStats channel;
+        channel.inflight = std::max<int64_t>(0, slot->inflight.load(std::memory_order_relaxed));
+        channel.picks = slot->picks.load(std::memory_order_relaxed);
+        channel.connected = slot->channel->GetState(false) == GRPC_CHANNEL_READY;
+        stats.channels.push_back(channel);
+    }
+    return stats;
+}
+
+} // namespace prodstarter
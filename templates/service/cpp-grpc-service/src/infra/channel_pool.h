@@ -0,0 +1,118 @@
+// ProdStarterHub - C++ gRPC Service
+// src/infra/channel_pool.h
+// Pool of outbound channels to one downstream target.
+//
+// A grpc::Channel multiplexes every call over one HTTP/2 connection, so a
+// busy adapter is capped by that connection's flow-control window, its
+// MAX_CONCURRENT_STREAMS and the single poller that reads it. A ChannelPool
+// holds N channels to the same target, each with its own local subchannel
+// pool so that they really open N connections, and spreads calls over them:
+//
+//   round-robin   each pick takes the next channel
+//   least-loaded  each pick takes the channel with the fewest calls in flight
+//
+// Build one pool per downstream in main() and inject it into the service
+// implementations and infra adapters that call it:
+//
+//   ChannelPool pool(options);
+//   PooledStubs<myproto::Downstream> stubs(pool);
+//   ...
+//   ChannelPool::Lease lease = pool.Acquire();      // counts as in flight until destroyed
+//   grpc::ClientContext ctx;
+//   auto link = CallCancellation(server_ctx).Propagate(&ctx); // remaining deadline, cancelled with the call
+//   stubs.For(lease).MyRpc(&ctx, request, &response);
+//
+// Picking is lock-free; the pool itself is immutable after construction.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <grpcpp/grpcpp.h>
+
+namespace prodstarter {
+
+struct ChannelPoolOptions {
+    std::string name = "default"; // metrics label
+    std::string target;
+    std::shared_ptr<grpc::ChannelCredentials> credentials; // insecure when null
+    grpc::ChannelArguments args; // applied to every channel
+    int size = 4;
+    std::string pick = "round-robin"; // round-robin | least-loaded
+};
+
+class ChannelPool {
+public:
+    struct ChannelStats {
+        int64_t inflight = 0;
+        uint64_t picks = 0;
+        bool connected = false;
+    };
+
+    struct Stats {
+        std::vector<ChannelStats> channels;
+    };
+
+    // One pick; the call counts against its channel until the lease is destroyed.
+    class Lease {
+    public:
+        Lease() = default;
+        Lease(Lease&& other) noexcept : slot_(other.slot_), index_(other.index_) { other.slot_ = nullptr; }
+        Lease& operator=(Lease&& other) noexcept;
+        ~Lease() { Release(); }
+
+        const std::shared_ptr<grpc::Channel>& channel() const;
+        int index() const { return index_; }
+        explicit operator bool() const { return slot_ != nullptr; }
+
+    private:
+        friend class ChannelPool;
+        struct Slot;
+
+        Lease(Slot* slot, int index) : slot_(slot), index_(index) {}
+        void Release();
+
+        Slot* slot_ = nullptr;
+        int index_ = 0;
+    };
+
+    explicit ChannelPool(ChannelPoolOptions options);
+    ~ChannelPool();
+
+    ChannelPool(const ChannelPool&) = delete;
+    ChannelPool& operator=(const ChannelPool&) = delete;
+
+    Lease Acquire();
+
+    int size() const { return static_cast<int>(slots_.size()); }
+    const std::string& name() const { return name_; }
+    const std::shared_ptr<grpc::Channel>& channel(int index) const;
+
+    Stats GetStats() const;
+
+private:
+    const std::string name_;
+    const bool least_loaded_;
+    std::vector<std::unique_ptr<Lease::Slot>> slots_;
+    std::atomic<uint64_t> next_{0};
+};
+
+// One generated stub per pooled channel, indexed like the pool.
+template <typename Service>
+class PooledStubs {
+public:
+    explicit PooledStubs(const ChannelPool& pool) {
+        for (int i = 0; i < pool.size(); ++i) stubs_.push_back(Service::NewStub(pool.channel(i)));
+    }
+
+    typename Service::Stub& For(const ChannelPool::Lease& lease) const { return *stubs_[lease.index()]; }
+
+private:
+    std::vector<std::unique_ptr<typename Service::Stub>> stubs_;
+};
+
+} // namespace prodstarter
@@ -0,0 +1,64 @@
+// ProdStarterHub - C++ gRPC Service
+// src/lifecycle/inflight_tracker.cpp
+
+#include "lifecycle/inflight_tracker.h"
+
+namespace prodstarter {
+
+namespace {
+
+class InflightInterceptor final : public grpc::experimental::Interceptor {
+public:
+    explicit InflightInterceptor(InflightTracker& tracker) : tracker_(tracker) { tracker_.Begin(); }
+    ~InflightInterceptor() override { tracker_.End(); }
+
+    void Intercept(grpc::experimental::InterceptorBatchMethods* methods) override { methods->Proceed(); }
+
+private:
+    InflightTracker& tracker_;
+};
+
+} // namespace
+
+void InflightTracker::End() {
+    count_.Add(-1);
+    // Only pay for the lock while shutdown is waiting for the server to go idle.
+    // The fences pair with WaitIdleUntil(): either it sees the decrement or we see waiting_.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiting_.load(std::memory_order_relaxed)) {
+        std::lock_guard<std::mutex> lock(mu_);
+        idle_cv_.notify_all();
+    }
+}
+
+int64_t InflightTracker::WaitIdleUntil(std::chrono::steady_clock::time_point deadline) {
+    std::unique_lock<std::mutex> lock(mu_);
+    waiting_.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    idle_cv_.wait_until(lock, deadline, [this] { return count_.Sum() <= 0; });
+    waiting_.store(false, std::memory_order_relaxed);
+    const int64_t remaining = count_.Sum();
+    return remaining > 0 ? remaining : 0;
+}
+
+void InflightTracker::RecordDrain(int64_t drained, int64_t cancelled) {
+    std::lock_guard<std::mutex> lock(mu_);
+    drained_ = drained;
+    cancelled_ = cancelled;
+}
+
+InflightTracker::Stats InflightTracker::GetStats() const {
+    Stats stats;
+    stats.inflight = count_.Sum();
+    std::lock_guard<std::mutex> lock(mu_);
+    stats.drained = drained_;
+    stats.cancelled = cancelled_;
+    return stats;
+}
+
+grpc::experimental::Interceptor* InflightInterceptorFactory::CreateServerInterceptor(
+    grpc::experimental::ServerRpcInfo* /*info*/) {
+    return new InflightInterceptor(tracker_);
+}
+
+} // namespace prodstarter
@@ -0,0 +1,63 @@
+// ProdStarterHub - C++ gRPC Service
+// src/lifecycle/inflight_tracker.h
+// Counts in-flight RPCs across all engines so shutdown can report how many
+// calls drained within the deadline and how many had to be cancelled.
+//
+// The count is kept by a server interceptor: one is created when a call
+// starts and destroyed when it ends, whichever engine serves it.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+#include <grpcpp/support/server_interceptor.h>
+
+#include "metrics/sharded_counter.h"
+
+namespace prodstarter {
+
+class InflightTracker {
+public:
+    struct Stats {
+        int64_t inflight = 0;
+        int64_t drained = 0;   // calls that completed during the last drain
+        int64_t cancelled = 0; // calls still running when the drain deadline passed
+    };
+
+    void Begin() { count_.Add(1); }
+    void End();
+
+    int64_t inflight() const { return count_.Sum(); }
+
+    // Blocks until no call is in flight or `deadline` passes.
+    // Returns the number of calls still in flight.
+    int64_t WaitIdleUntil(std::chrono::steady_clock::time_point deadline);
+
+    void RecordDrain(int64_t drained, int64_t cancelled);
+    Stats GetStats() const;
+
+private:
+    ShardedCounter count_;
+
+    mutable std::mutex mu_;
+    std::condition_variable idle_cv_;
+    std::atomic<bool> waiting_{false};
+    int64_t drained_ = 0;
+    int64_t cancelled_ = 0;
+};
+
+class InflightInterceptorFactory : public grpc::experimental::ServerInterceptorFactoryInterface {
+public:
+    explicit InflightInterceptorFactory(InflightTracker& tracker) : tracker_(tracker) {}
+
+    grpc::experimental::Interceptor* CreateServerInterceptor(grpc::experimental::ServerRpcInfo* info) override;
+
+private:
+    InflightTracker& tracker_;
+};
+
+} // namespace prodstarter
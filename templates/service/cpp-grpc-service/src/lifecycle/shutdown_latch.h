@@ -0,0 +1,48 @@
+// ProdStarterHub - C++ gRPC Service
+// src/lifecycle/shutdown_latch.h
+// One-shot shutdown trigger that main() blocks on.
+//
+// Signals, admin endpoints or fatal component errors call Trigger(); the main
+// thread wakes immediately instead of polling a flag.
+
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+
+namespace prodstarter {
+
+class ShutdownLatch {
+public:
+    // Requests shutdown; only the first reason is kept.
+    void Trigger(const std::string& reason) {
+        {
+            std::lock_guard<std::mutex> lock(mu_);
+            if (triggered_) return;
+            triggered_ = true;
+            reason_ = reason;
+        }
+        cv_.notify_all();
+    }
+
+    // Blocks until Trigger() has been called and returns its reason.
+    std::string Wait() {
+        std::unique_lock<std::mutex> lock(mu_);
+        cv_.wait(lock, [this] { return triggered_; });
+        return reason_;
+    }
+
+    bool triggered() const {
+        std::lock_guard<std::mutex> lock(mu_);
+        return triggered_;
+    }
+
+private:
+    mutable std::mutex mu_;
+    std::condition_variable cv_;
+    bool triggered_ = false;
+    std::string reason_;
+};
+
+} // namespace prodstarter
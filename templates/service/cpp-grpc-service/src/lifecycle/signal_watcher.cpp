@@ -0,0 +1,56 @@
+// ProdStarterHub - C++ gRPC Service
+// src/lifecycle/signal_watcher.cpp
+
+#include "lifecycle/signal_watcher.h"
+
+#include <pthread.h>
+
+#include <spdlog/spdlog.h>
+
+namespace prodstarter {
+
+SignalWatcher::~SignalWatcher() {
+    Stop();
+}
+
+void SignalWatcher::Handle(int signum, Handler handler) {
+    handlers_[signum] = std::move(handler);
+}
+
+bool SignalWatcher::Start() {
+    if (handlers_.empty() || thread_.joinable()) return false;
+
+    sigemptyset(&mask_);
+    for (const auto& entry : handlers_) {
+        sigaddset(&mask_, entry.first);
+    }
+    const int rc = pthread_sigmask(SIG_BLOCK, &mask_, nullptr);
+    if (rc != 0) {
+        spdlog::error("pthread_sigmask failed: {}", rc);
+        return false;
+    }
+    thread_ = std::thread(&SignalWatcher::Run, this);
+    return true;
+}
+
+void SignalWatcher::Stop() {
+    if (!thread_.joinable()) return;
+    stopping_.store(true);
+    // Wake sigwait() with one of the watched signals aimed at the watcher thread only.
+    pthread_kill(thread_.native_handle(), handlers_.begin()->first);
+    thread_.join();
+}
+
+void SignalWatcher::Run() {
+    for (;;) {
+        int signum = 0;
+        if (sigwait(&mask_, &signum) != 0) continue;
+        if (stopping_.load()) break;
+        auto it = handlers_.find(signum);
+        if (it != handlers_.end()) {
+            it->second(signum);
+        }
+    }
+}
+
+} // namespace prodstarter
@@ -0,0 +1,51 @@
+// ProdStarterHub - C++ gRPC Service
+// src/lifecycle/signal_watcher.h
+// Delivers process signals to a dedicated thread instead of an async handler.
+//
+// Start() blocks the watched signals in the calling thread; threads created
+// afterwards inherit the mask, so the kernel can only hand the signal to the
+// watcher thread blocked in sigwait(). Handlers therefore run in a normal
+// thread context and may log, lock and notify condition variables freely.
+// Call Start() from main() before any other thread (gRPC, executor, exposer)
+// is created.
+
+#pragma once
+
+#include <atomic>
+#include <csignal>
+#include <functional>
+#include <map>
+#include <thread>
+
+namespace prodstarter {
+
+class SignalWatcher {
+public:
+    using Handler = std::function<void(int signum)>;
+
+    SignalWatcher() = default;
+    ~SignalWatcher();
+
+    SignalWatcher(const SignalWatcher&) = delete;
+    SignalWatcher& operator=(const SignalWatcher&) = delete;
+
+    // Registers a handler. Must be called before Start().
+    void Handle(int signum, Handler handler);
+
+    // Blocks the registered signals and starts the watcher thread.
+    // Returns false if the signal mask could not be changed.
+    bool Start();
+
+    // Stops and joins the watcher thread.
+    void Stop();
+
+private:
+    void Run();
+
+    std::map<int, Handler> handlers_;
+    sigset_t mask_{};
+    std::atomic<bool> stopping_{false};
+    std::thread thread_;
+};
+
+} // namespace prodstarter
@@ -0,0 +1,199 @@
+// ProdStarterHub - C++ gRPC Service
+// src/lifecycle/warmup.cpp
+
+#include "lifecycle/warmup.h"
+
+#include <algorithm>
+#include <cctype>
+#include <exception>
+#include <future>
+#include <utility>
+
+#include <grpcpp/client_context.h>
+#include <grpcpp/generic/generic_stub.h>
+#include <spdlog/fmt/fmt.h>
+
+#include "infra/channel_pool.h"
+
+namespace prodstarter {
+
+namespace {
+
+constexpr int kMaxWarmupCalls = 100000;
+constexpr auto kConnectPollInterval = std::chrono::milliseconds(100); // how soon a connecting task sees Cancel()
+
+double SecondsBetween(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to) {
+    return std::chrono::duration<double>(to - from).count();
+}
+
+} // namespace
+
+const char* WarmupResultName(WarmupResult result) {
+    switch (result) {
+    case WarmupResult::kOk: return "ok";
+    case WarmupResult::kFailed: return "failed";
+    case WarmupResult::kTimedOut: return "timed_out";
+    default: return "pending";
+    }
+}
+
+WarmupRegistry::WarmupRegistry(std::chrono::milliseconds timeout) : timeout_(timeout) {}
+
+WarmupRegistry::~WarmupRegistry() {
+    Cancel();
+    for (auto& thread : threads_) thread.join();
+}
+
+void WarmupRegistry::Add(std::string name, Task task) {
+    auto entry = std::make_unique<Entry>();
+    entry->name = std::move(name);
+    entry->task = std::move(task);
+    tasks_.push_back(std::move(entry));
+}
+
+void WarmupRegistry::Start(Callback done) {
+    CancellationToken token;
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        started_ = std::chrono::steady_clock::now();
+        source_ = std::make_unique<CancellationSource>(std::chrono::system_clock::now() + timeout_);
+        token = source_->token();
+    }
+    for (auto& task : tasks_) {
+        Entry* entry = task.get();
+        threads_.emplace_back([this, entry, token] {
+            std::string error;
+            bool ok = false;
+            try {
+                ok = entry->task(token, &error);
+            } catch (const std::exception& e) {
+                error = e.what();
+            }
+            {
+                std::lock_guard<std::mutex> lock(mu_);
+                if (entry->result == WarmupResult::kPending) { // not already given up on
+                    entry->result = ok ? WarmupResult::kOk : WarmupResult::kFailed;
+                    entry->error = std::move(error);
+                    entry->finished = std::chrono::steady_clock::now();
+                }
+                ++finished_;
+            }
+            cv_.notify_all();
+        });
+    }
+    waiter_ = std::thread([this, done = std::move(done)] { Wait(done); });
+}
+
+void WarmupRegistry::Wait(Callback done) {
+    std::unique_lock<std::mutex> lock(mu_);
+    cv_.wait_until(lock, started_ + timeout_, [this] { return cancelled_ || finished_ == tasks_.size(); });
+    if (cancelled_) return;
+    const auto now = std::chrono::steady_clock::now();
+    for (auto& entry : tasks_) {
+        if (entry->result != WarmupResult::kPending) continue;
+        entry->result = WarmupResult::kTimedOut;
+        entry->finished = now;
+    }
+    done_ = true;
+    done_at_ = now;
+    const WarmupReport report = ReportLocked(now);
+    lock.unlock();
+
+    source_->Cancel(); // tasks still running should give up now
+    done(report);
+}
+
+void WarmupRegistry::Cancel() {
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        if (!done_) cancelled_ = true;
+        if (source_) source_->Cancel();
+    }
+    cv_.notify_all();
+    if (waiter_.joinable()) waiter_.join();
+}
+
+WarmupReport WarmupRegistry::GetReport() const {
+    std::lock_guard<std::mutex> lock(mu_);
+    return ReportLocked(std::chrono::steady_clock::now());
+}
+
+WarmupReport WarmupRegistry::ReportLocked(std::chrono::steady_clock::time_point now) const {
+    WarmupReport report;
+    report.done = done_;
+    report.cancelled = cancelled_;
+    if (source_ == nullptr) return report; // not started
+    report.seconds = SecondsBetween(started_, done_ ? done_at_ : now);
+    for (const auto& entry : tasks_) {
+        WarmupTaskReport task;
+        task.name = entry->name;
+        task.result = entry->result;
+        task.error = entry->error;
+        task.seconds = SecondsBetween(started_, entry->result == WarmupResult::kPending ? now : entry->finished);
+        report.tasks.push_back(std::move(task));
+    }
+    return report;
+}
+
+WarmupRegistry::Task WarmChannelPool(ChannelPool& pool) {
+    return [&pool](const CancellationToken& token, std::string* error) {
+        // Ask every channel to connect first so the connections are made in parallel.
+        for (int i = 0; i < pool.size(); ++i) pool.channel(i)->GetState(/*try_to_connect=*/true);
+        for (int i = 0; i < pool.size(); ++i) {
+            const auto& channel = pool.channel(i);
+            while (!channel->WaitForConnected(
+                std::min(token.deadline(), std::chrono::system_clock::now() + kConnectPollInterval))) {
+                if (token.cancelled()) {
+                    *error = fmt::format("channel {} of {} to pool '{}' did not connect", i, pool.size(), pool.name());
+                    return false;
+                }
+            }
+        }
+        return true;
+    };
+}
+
+WarmupRegistry::Task WarmWithCalls(std::shared_ptr<grpc::Channel> channel, std::string method,
+                                   grpc::ByteBuffer request, int count) {
+    auto stub = std::make_shared<grpc::GenericStub>(std::move(channel));
+    return [stub, method = std::move(method), request = std::move(request), count](const CancellationToken& token,
+                                                                                   std::string* error) {
+        for (int i = 0; i < count; ++i) {
+            grpc::ClientContext ctx;
+            auto link = token.Propagate(&ctx); // the call gets the warm-up deadline and is cancelled with it
+            grpc::ByteBuffer response;
+            std::promise<grpc::Status> finished;
+            stub->UnaryCall(&ctx, method, grpc::StubOptions(), &request, &response,
+                            [&finished](grpc::Status status) { finished.set_value(std::move(status)); });
+            const grpc::Status status = finished.get_future().get();
+            if (!status.ok()) {
+                *error = fmt::format("call {} of {} to {} failed: {} ({})", i + 1, count, method, status.error_message(),
+                                     static_cast<int>(status.error_code()));
+                return false;
+            }
+        }
+        return true;
+    };
+}
+
+bool ParseWarmupCall(const std::string& spec, std::string* method, int* count, std::string* error) {
+    const size_t eq = spec.rfind('=');
+    *method = spec.substr(0, eq);
+    *count = 1;
+    if (method->size() < 2 || (*method)[0] != '/' || method->find('/', 1) == std::string::npos) {
+        *error = "expected /package.Service/Method or /package.Service/Method=COUNT";
+        return false;
+    }
+    if (eq == std::string::npos) return true;
+    const std::string digits = spec.substr(eq + 1);
+    const bool numeric = !digits.empty() && digits.size() <= 6 &&
+                         std::all_of(digits.begin(), digits.end(), [](unsigned char c) { return std::isdigit(c) != 0; });
+    if (!numeric || std::stoi(digits) < 1 || std::stoi(digits) > kMaxWarmupCalls) {
+        *error = fmt::format("count must be between 1 and {}", kMaxWarmupCalls);
+        return false;
+    }
+    *count = std::stoi(digits);
+    return true;
+}
+
+} // namespace prodstarter
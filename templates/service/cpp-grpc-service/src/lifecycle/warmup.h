@@ -0,0 +1,131 @@
+// ProdStarterHub - C++ gRPC Service
+// src/lifecycle/warmup.h
+// Warm-up tasks that run between BuildAndStart() and reporting SERVING.
+//
+// A server that reports SERVING the moment it listens takes its first real
+// traffic with cold caches, unconnected outbound channels and lazily built
+// state, and every deploy shows up as a p99 spike. Components register tasks
+// with the WarmupRegistry instead; health stays NOT_SERVING until all of them
+// have finished or --warmup-timeout has passed, whichever comes first:
+//
+//   WarmupRegistry warmup(std::chrono::seconds(30));
+//   warmup.Add("inventory-pool", WarmChannelPool(*inventory_pool));      // WaitForConnected on every channel
+//   warmup.Add("lookup", WarmWithCalls(in_process, "/myproto.Example/Lookup", request, 50)); // self-calls
+//   warmup.Start([&](const WarmupReport& report) { health.SetServingStatus(true); });
+//
+// Self-calls go through the server's in-process channel and the full
+// interceptor chain, so they also fill the response cache of cached methods,
+// allocate the arena pools and load whatever the handlers initialize lazily.
+//
+// Tasks run on threads of their own: they block (WaitForConnected, sync calls)
+// and must not occupy the executor or polling threads they are warming. Each
+// gets a CancellationToken with the warm-up deadline, cancelled as well when
+// the timeout passes or the server shuts down first; tasks still running then
+// are abandoned and only joined by the destructor, so they should pass the
+// token on (CancellationToken::Propagate) and return when it is cancelled.
+// A failed task is logged and does not hold readiness back.
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <grpcpp/channel.h>
+#include <grpcpp/support/byte_buffer.h>
+
+#include "call/cancellation.h"
+
+namespace prodstarter {
+
+class ChannelPool;
+
+enum class WarmupResult { kPending, kOk, kFailed, kTimedOut };
+
+const char* WarmupResultName(WarmupResult result);
+
+struct WarmupTaskReport {
+    std::string name;
+    WarmupResult result = WarmupResult::kPending;
+    std::string error;  // kFailed
+    double seconds = 0; // running time; so far for tasks still pending
+};
+
+struct WarmupReport {
+    bool done = false;      // every task finished, or the timeout passed
+    bool cancelled = false; // the server shut down before that
+    double seconds = 0;     // time from Start() until done; so far while running
+    std::vector<WarmupTaskReport> tasks;
+};
+
+class WarmupRegistry {
+public:
+    // Returns false with `error` set when the warm-up failed; return early once `token` is cancelled.
+    using Task = std::function<bool(const CancellationToken& token, std::string* error)>;
+    using Callback = std::function<void(const WarmupReport& report)>;
+
+    explicit WarmupRegistry(std::chrono::milliseconds timeout);
+    ~WarmupRegistry(); // cancels the warm-up and joins every task
+
+    WarmupRegistry(const WarmupRegistry&) = delete;
+    WarmupRegistry& operator=(const WarmupRegistry&) = delete;
+
+    // Registers a task. Must be called before Start().
+    void Add(std::string name, Task task);
+
+    // Starts every task and returns. `done` runs once, on a warm-up thread, when all tasks have finished or the
+    // timeout passed, unless Cancel() came first. Without tasks it runs right away.
+    void Start(Callback done);
+
+    // Cancels tasks still running and waits until `done` can no longer run; the server is shutting down.
+    void Cancel();
+
+    size_t size() const { return tasks_.size(); }
+
+    WarmupReport GetReport() const;
+
+private:
+    struct Entry {
+        std::string name;
+        Task task;
+        WarmupResult result = WarmupResult::kPending;
+        std::string error;
+        std::chrono::steady_clock::time_point finished;
+    };
+
+    void Wait(Callback done);
+    WarmupReport ReportLocked(std::chrono::steady_clock::time_point now) const;
+
+    const std::chrono::milliseconds timeout_;
+    std::vector<std::unique_ptr<Entry>> tasks_;
+    std::unique_ptr<CancellationSource> source_; // deadline = start + timeout; cancelled at the end
+    std::chrono::steady_clock::time_point started_;
+
+    mutable std::mutex mu_; // guards the entries' results, done_, cancelled_ and finished_
+    std::condition_variable cv_;
+    size_t finished_ = 0;
+    bool done_ = false;
+    bool cancelled_ = false;
+    std::chrono::steady_clock::time_point done_at_;
+
+    std::thread waiter_;
+    std::vector<std::thread> threads_;
+};
+
+// Connects every channel of `pool` (WaitForConnected until the warm-up deadline).
+WarmupRegistry::Task WarmChannelPool(ChannelPool& pool);
+
+// Calls `method` `count` times with the serialized `request` over `channel`, one call after the other; any status
+// but OK fails the task. Use the server's in-process channel (grpc::Server::InProcessChannel) for self-calls.
+WarmupRegistry::Task WarmWithCalls(std::shared_ptr<grpc::Channel> channel, std::string method,
+                                   grpc::ByteBuffer request, int count);
+
+// Parses a --warmup-call value, "METHOD" or "METHOD=COUNT". Returns false with `error` set when it does not parse.
+bool ParseWarmupCall(const std::string& spec, std::string* method, int* count, std::string* error);
+
+} // namespace prodstarter
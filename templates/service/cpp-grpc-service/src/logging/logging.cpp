@@ -0,0 +1,120 @@
+// ProdStarterHub - C++ gRPC Service
+// src/logging/logging.cpp
+
+#include "logging/logging.h"
+
+#include <chrono>
+#include <cmath>
+#include <exception>
+#include <memory>
+
+#include <spdlog/async.h>
+#include <spdlog/async_logger.h>
+#include <spdlog/pattern_formatter.h>
+#include <spdlog/sinks/stdout_sinks.h>
+
+namespace prodstarter {
+
+namespace {
+
+// Timestamps are UTC so `Z` is honest; %* is the JSON-escaped message.
+constexpr const char* kJsonPattern =
+    R"({"ts":"%Y-%m-%dT%H:%M:%S.%fZ","level":"%l","logger":"%n","pid":%P,"tid":%t,"msg":"%*"})";
+
+// %* flag: the message payload escaped for a JSON string.
+class JsonEscapedMessage final : public spdlog::custom_flag_formatter {
+public:
+    void format(const spdlog::details::log_msg& msg, const std::tm&, spdlog::memory_buf_t& dest) override {
+        static constexpr char kHex[] = "0123456789abcdef";
+        for (char c : msg.payload) {
+            switch (c) {
+            case '"': dest.append(std::string_view("\\\"")); break;
+            case '\\': dest.append(std::string_view("\\\\")); break;
+            case '\n': dest.append(std::string_view("\\n")); break;
+            case '\r': dest.append(std::string_view("\\r")); break;
+            case '\t': dest.append(std::string_view("\\t")); break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    const char escaped[] = {'\\', 'u', '0', '0', kHex[(c >> 4) & 0xf], kHex[c & 0xf]};
+                    dest.append(escaped, escaped + sizeof(escaped));
+                } else {
+                    dest.push_back(c);
+                }
+            }
+        }
+    }
+
+    std::unique_ptr<custom_flag_formatter> clone() const override { return std::make_unique<JsonEscapedMessage>(); }
+};
+
+std::shared_ptr<spdlog::logger> MakeAsyncJsonLogger(size_t queue_size) {
+    spdlog::init_thread_pool(queue_size, 1);
+    auto sink = std::make_shared<spdlog::sinks::stdout_sink_mt>();
+    auto logger = std::make_shared<spdlog::async_logger>("console", std::move(sink), spdlog::thread_pool(),
+                                                         spdlog::async_overflow_policy::overrun_oldest);
+    auto formatter = std::make_unique<spdlog::pattern_formatter>(spdlog::pattern_time_type::utc);
+    formatter->add_flag<JsonEscapedMessage>('*').set_pattern(kJsonPattern);
+    logger->set_formatter(std::move(formatter));
+    // Flushing is a request to the background thread, never a syscall on the caller.
+    logger->flush_on(spdlog::level::warn);
+    return logger;
+}
+
+} // namespace
+
+bool SetupLogging(const LoggingOptions& options, std::string& error) {
+    RequestLogSampler().SetRate(options.sample_rate);
+    const auto level = options.verbose ? spdlog::level::debug : spdlog::level::info;
+
+    if (options.mode == "console") {
+        spdlog::set_level(level);
+        return true;
+    }
+    if (options.mode != "async-json") {
+        error = "unknown log mode '" + options.mode + "' (expected console or async-json)";
+        return false;
+    }
+
+    try {
+        auto logger = MakeAsyncJsonLogger(options.queue_size);
+        logger->set_level(level);
+        spdlog::set_default_logger(std::move(logger));
+        spdlog::flush_every(std::chrono::seconds(1));
+    } catch (const std::exception& ex) {
+        error = ex.what();
+        return false;
+    }
+    return true;
+}
+
+LoggingStats GetLoggingStats() {
+    LoggingStats stats;
+    if (auto pool = spdlog::thread_pool()) {
+        stats.dropped = pool->overrun_counter();
+        stats.queued = pool->queue_size();
+    }
+    stats.sampled_out = RequestLogSampler().sampled_out();
+    return stats;
+}
+
+void LogSampler::SetRate(double rate) {
+    uint64_t every = 1;
+    if (rate > 0 && rate < 1) every = static_cast<uint64_t>(std::llround(1.0 / rate));
+    every_.store(every, std::memory_order_relaxed);
+}
+
+bool LogSampler::Sample() {
+    const uint64_t every = every_.load(std::memory_order_relaxed);
+    if (every <= 1) return true;
+    thread_local uint64_t seen = 0;
+    if (seen++ % every == 0) return true;
+    sampled_out_.Add(1);
+    return false;
+}
+
+LogSampler& RequestLogSampler() {
+    static LogSampler sampler;
+    return sampler;
+}
+
+} // namespace prodstarter
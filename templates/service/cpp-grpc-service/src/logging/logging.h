@@ -0,0 +1,73 @@
+// ProdStarterHub - C++ gRPC Service
+// src/logging/logging.h
+// Logger setup (--log-mode) and sampled per-request debug logging.
+//
+//   console     synchronous colored stdout logger, flushed on every info line;
+//               convenient for development
+//   async-json  one JSON object per line, formatted and written by spdlog's
+//               background thread. The queue is bounded and drops the oldest
+//               message when full (overrun_oldest), so a handler never waits
+//               on stdout; dropped messages are counted and exported.
+//
+// Per-request debug lines go through RequestDebug(), which only lets
+// --log-sample-rate of them through (e.g. 0.01 keeps one in a hundred per
+// thread), so enabling --verbose in production does not flood the pipeline:
+//
+//   prodstarter::RequestDebug("MyRpc from {} took {} us", ctx->peer(), elapsed_us);
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+#include <spdlog/spdlog.h>
+
+#include "metrics/sharded_counter.h"
+
+namespace prodstarter {
+
+struct LoggingOptions {
+    std::string mode = "console"; // console | async-json
+    size_t queue_size = 8192;     // async-json: messages buffered before the oldest are dropped
+    double sample_rate = 1.0;     // fraction of RequestDebug() lines kept
+    bool verbose = false;
+};
+
+struct LoggingStats {
+    uint64_t dropped = 0;     // overwritten in the async queue before they were written
+    uint64_t sampled_out = 0; // RequestDebug() lines skipped by the sampler
+    uint64_t queued = 0;      // currently waiting in the async queue
+};
+
+// Replaces the bootstrap console logger with the configured one.
+// Returns false (and leaves the current logger in place) on failure.
+bool SetupLogging(const LoggingOptions& options, std::string& error);
+
+LoggingStats GetLoggingStats();
+
+// Keeps one in every N events per thread, N = round(1 / rate). Lock-free.
+class LogSampler {
+public:
+    void SetRate(double rate);
+    bool Sample();
+    uint64_t sampled_out() const { return static_cast<uint64_t>(sampled_out_.Sum()); }
+
+private:
+    std::atomic<uint64_t> every_{1};
+    ShardedCounter sampled_out_;
+};
+
+// Process-wide sampler used by RequestDebug(); configured by SetupLogging().
+LogSampler& RequestLogSampler();
+
+template <class... Args>
+void RequestDebug(spdlog::format_string_t<Args...> fmt, Args&&... args) {
+    spdlog::logger* logger = spdlog::default_logger_raw();
+    if (!logger->should_log(spdlog::level::debug) || !RequestLogSampler().Sample()) return;
+    logger->debug(fmt, std::forward<Args>(args)...);
+}
+
+} // namespace prodstarter
@@ -1,23 +1,39 @@
 // ProdStarterHub - C++ gRPC Service
 // src/main.cpp
 // Production-ready gRPC server bootstrap with:
-//  - graceful shutdown (SIGINT/SIGTERM)
+//  - graceful shutdown (SIGINT/SIGTERM) with a bounded drain deadline
+//  - on-demand CPU and heap profiles into --profile-dir (Admin/CpuProfile, Admin/HeapProfile, SIGUSR2)
+//  - live reconfiguration of executor threads, limiter bounds, cache size and log level (--runtime-config, SIGHUP,
+//    Admin/Reconfigure)
 //  - optional TLS configuration
-//  - health checking (gRPC health probe service)
-//  - reflection (for debugging with grpc_cli)
-//  - structured logging via spdlog
+//  - health checking (gRPC health probe service), NOT_SERVING until warm-up tasks finish (--warmup-timeout)
+//  - reflection (for debugging with grpc_cli) and an admin debug service (slowest calls)
+//  - structured logging via spdlog (--log-mode=async-json: non-blocking JSON lines)
 //  - basic Prometheus metrics exposition (if enabled)
-//  - thread pool / completion queue usage
+//  - distributed tracing with W3C trace context, tail-based sampling and OTLP export (--otlp-endpoint)
+//  - thread pool / completion queue usage (sync API, --engine=async or --engine=callback)
+//  - zero-copy generic passthrough of unclaimed methods as raw bytes (--engine=generic)
+//  - optional SO_REUSEPORT sharding into N independent servers (--shards N)
+//  - unix domain socket listeners (--unix-listen) and in-process channels for co-located callers
+//  - work-stealing executor for background and offloaded CPU-heavy work
+//  - jemalloc or mimalloc at build time (-DUSE_JEMALLOC / -DUSE_MIMALLOC) with exported heap statistics
+//  - CPU pinning and NUMA-local shards (--cpu-set, --numa-policy=shard); thread defaults follow cgroup quotas
+//  - per-method response compression with a size threshold, in algorithms the client accepts (--compression)
+//  - saturation watchdog: completion queue and executor lag, optionally driving health (--saturation-health-service)
 //  - service registration placeholder
 //
 // Dependencies (add to your build system):
 //  - gRPC (>=1.46)
 //  - protobuf
 //  - spdlog
+//  - zlib (compression savings estimates; gRPC already links it)
+//  - gperftools (optional, -DUSE_GPERFTOOLS: pprof CPU profiles instead of the built-in sampler)
 //  - cxxopts (or any CLI parser) [optional]//  - prometheus-cpp (optional)
 //
 // Build notes: link with -lgrpc++ -lgrpc -lprotobuf and other required libs. Use C++17 or later.
 
+#include <algorithm>
+#include <chrono>
 #include <iostream>
 #include <memory>
 #include <string>
@@ -33,10 +49,49 @@
 #include <spdlog/spdlog.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
 
+#include "admin/admin_service.h"
+#include "call/call_interceptor.h"
+#include "call/method_class.h"
+#include "cache/response_cache.h"
+#include "cache/singleflight.h"
+#include "config/runtime_config.h"
+#include "config/server_config.h"
+#include "config/tuning.h"
+#include "engine/arena_pool.h"
+#include "engine/async_engine.h"
+#include "engine/passthrough.h"
+#include "engine/reactors.h"
+#include "engine/stream_writer.h"
+#include "engine/unary_call.h"
+#include "exec/cpu_topology.h"
+#include "exec/executor.h"
+#include "exec/lane_executor.h"
+#include "infra/channel_pool.h"
+#include "lifecycle/inflight_tracker.h"
+#include "lifecycle/shutdown_latch.h"
+#include "lifecycle/signal_watcher.h"
+#include "lifecycle/warmup.h"
+#include "logging/logging.h"
+#include "memory/allocator.h"
+#include "profiling/profiler.h"
+#include "server/compression_policy.h"
+#include "server/connection_monitor.h"
+#include "server/in_process_channels.h"
+#include "server/shard_set.h"
+#include "server/tls_credentials.h"
+#include "tracing/tracer.h"
+
 #ifdef USE_PROMETHEUS
 #include <prometheus/exposer.h>
-#include <prometheus/registry.h>
+
+#include "metrics/exporters.h"
+#include "metrics/scrape_collector.h"
 #endif
+#include "metrics/latency_breakdown.h"
+#include "metrics/rpc_metrics.h"
+#include "metrics/transport_metrics.h"
+#include "overload/concurrency_limiter.h"
+#include "overload/saturation_watchdog.h"
 
 // Include your generated service headers
 // #include "proto/myservice.grpc.pb.h"
@@ -46,33 +101,15 @@ using grpc::ServerBuilder;
 using grpc::ServerContext;
 using grpc::Status;
 
-// ---- Configuration struct ----
-struct ServerConfig {
-    std::string bind_address = "0.0.0.0:50051";
-    bool enable_tls = false;
-    std::string cert_chain_file;
-    std::string private_key_file;
-    std::string root_cert_file; // optional
-    bool enable_reflection = true;
-    bool enable_prometheus = false;
-    int num_worker_threads = std::thread::hardware_concurrency();
-};
-
-// Global running flag for graceful shutdown
-static std::atomic<bool> g_shutdown_requested{false};
-
-// Signal handler -> sets the shutdown flag
-static void signal_handler(int signum) {
-    spdlog::warn("Signal {} received, requesting shutdown", signum);
-    g_shutdown_requested.store(true);
-}
-
 // ---- Example of a minimal service implementation stub ----
 // Replace ExampleService with your actual service
 /*
 class ExampleServiceImpl final : public myproto::Example::Service {
 public:
     Status MyRpcMethod(ServerContext* ctx, const myproto::Request* req, myproto::Response* resp) override {
+        // Sync handlers run on gRPC's threads before the server can step in: skip calls the limiter rejected or
+        // whose client is gone, or --engine=sync sheds no load.
+        if (!prodstarter::BeginHandler(ctx)) return prodstarter::SkippedStatus(ctx);
         spdlog::info("Received MyRpcMethod request");
         // TODO: implement business logic
         return Status::OK;
@@ -80,8 +117,33 @@ public:
 };
 */
 
+// With --engine=callback the same service is written against the generated CallbackService.
+// Handlers return a reactor instead of occupying a gRPC thread until the RPC completes:
+/*
+class MyRpcReactor final : public prodstarter::UnaryReactor<myproto::Request, myproto::Response> {
+public:
+    using UnaryReactor::UnaryReactor;
+protected:
+    void OnStart() override {
+        // TODO: implement business logic; Complete() may be called later from any thread
+        Complete(Status::OK);
+    }
+};
+
+class ExampleCallbackServiceImpl final : public myproto::Example::CallbackService {
+public:
+    grpc::ServerUnaryReactor* MyRpcMethod(grpc::CallbackServerContext* ctx, const myproto::Request* req,
+                                          myproto::Response* resp) override {
+        return prodstarter::StartReactor<MyRpcReactor>(ctx, req, resp);
+    }
+};
+*/
+
 int main(int argc, char** argv) {
-    // ---- Basic logging setup ----
+    // Allocator options have to be set before any other thread allocates.
+    prodstarter::ConfigureAllocator();
+
+    // ---- Basic logging setup (bootstrap logger until the configuration is parsed) ----
     auto console = spdlog::stdout_color_mt("console");
     spdlog::set_default_logger(console);
     spdlog::set_level(spdlog::level::info); // default level
@@ -89,145 +151,690 @@ int main(int argc, char** argv) {
 
     spdlog::info("Starting ProdStarter C++ gRPC service");
 
-    // ---- Parse CLI / environment for simple config (minimal, replace with robust parser) ----
-    ServerConfig cfg;
-    for (int i = 1; i < argc; ++i) {
-        std::string arg = argv[i];
-        if (arg == "--bind" && i + 1 < argc) { cfg.bind_address = argv[++i]; }
-        else if (arg == "--tls" ) { cfg.enable_tls = true; }
-        else if (arg == "--cert" && i + 1 < argc) { cfg.cert_chain_file = argv[++i]; }
-        else if (arg == "--key" && i + 1 < argc) { cfg.private_key_file = argv[++i]; }
-        else if (arg == "--root" && i + 1 < argc) { cfg.root_cert_file = argv[++i]; }
-        else if (arg == "--no-reflection") { cfg.enable_reflection = false; }
-        else if (arg == "--prometheus") { cfg.enable_prometheus = true; }
-        else if (arg == "--threads" && i + 1 < argc) { cfg.num_worker_threads = std::stoi(argv[++i]); }
-        else if (arg == "--verbose") { spdlog::set_level(spdlog::level::debug); }
-        else if (arg == "--help") {
-            std::cout << "Usage: " << argv[0] << " [--bind host:port] [--tls --cert cert.pem --key key.pem] [--prometheus] [--threads N] [--verbose]" << std::endl;
-            return 0;
+    // ---- Install signal handling for graceful shutdown ----
+    // Must happen before any other thread is created so that only the watcher thread receives SIGINT/SIGTERM.
+    prodstarter::ShutdownLatch shutdown;
+    // Created once the configuration is known (--profile-dir); declared first so it outlives the watcher.
+    std::unique_ptr<prodstarter::Profiler> profiler;
+    std::atomic<prodstarter::Profiler*> signal_profiler{nullptr};
+    // Likewise the --runtime-config watcher. It is stopped explicitly before the components it reconfigures go away.
+    std::unique_ptr<prodstarter::RuntimeConfigWatcher> runtime_watcher;
+    std::atomic<prodstarter::RuntimeConfigWatcher*> signal_runtime_watcher{nullptr};
+    prodstarter::SignalWatcher signals;
+    for (int signum : {SIGINT, SIGTERM}) {
+        signals.Handle(signum, [&shutdown](int sig) {
+            spdlog::warn("Signal {} received, requesting shutdown", sig);
+            shutdown.Trigger(sig == SIGINT ? "SIGINT" : "SIGTERM");
+        });
+    }
+    // SIGUSR2 captures a CPU and a heap profile; the capture runs on the profiler's thread, so SIGTERM is still
+    // handled meanwhile.
+    signals.Handle(SIGUSR2, [&signal_profiler](int) {
+        prodstarter::Profiler* target = signal_profiler.load(std::memory_order_acquire);
+        if (target == nullptr) {
+            spdlog::warn("SIGUSR2 received but profiling is off (--profile-dir)");
+            return;
+        }
+        spdlog::info("SIGUSR2 received, capturing a {} s CPU profile", target->options().default_duration.count());
+        target->CaptureInBackground();
+    });
+    // SIGHUP re-reads --runtime-config now instead of at the next poll.
+    signals.Handle(SIGHUP, [&signal_runtime_watcher](int) {
+        prodstarter::RuntimeConfigWatcher* target = signal_runtime_watcher.load(std::memory_order_acquire);
+        if (target == nullptr) {
+            spdlog::warn("SIGHUP received but there is no --runtime-config to reload");
+            return;
+        }
+        spdlog::info("SIGHUP received, reloading {}", target->path());
+        target->Reload();
+    });
+    if (!signals.Start()) {
+        spdlog::error("Failed to install signal handling");
+        return 1;
+    }
+
+    // ---- Parse CLI / environment for simple config ----
+    prodstarter::ServerConfig cfg;
+    std::string parse_error;
+    switch (prodstarter::ParseArgs(argc, argv, cfg, parse_error)) {
+    case prodstarter::ParseOutcome::kHelp:
+        std::cout << prodstarter::Usage(argv[0]) << std::endl;
+        return 0;
+    case prodstarter::ParseOutcome::kError:
+        spdlog::error("{}", parse_error);
+        std::cerr << prodstarter::Usage(argv[0]) << std::endl;
+        return 2;
+    case prodstarter::ParseOutcome::kRun:
+        break;
+    }
+    const auto config_errors = prodstarter::ValidateConfig(cfg);
+    for (const auto& err : config_errors) {
+        spdlog::error("Invalid configuration: {}", err);
+    }
+    if (!config_errors.empty()) return 2;
+
+    // ---- CPU placement (--cpu-set, --numa-policy) ----
+    // The whole process moves onto the set first, so every thread started from here on, gRPC's own included, stays
+    // inside it; the executor, lanes and async polling threads are then pinned one CPU each.
+    const prodstarter::CpuTopology topology = prodstarter::DetectCpuTopology(cfg.cpu_set);
+    if (!cfg.cpu_set.empty()) {
+        std::string affinity_error;
+        if (!prodstarter::RestrictProcessToCpus(topology.cpus, &affinity_error)) {
+            spdlog::error("Failed to apply --cpu-set: {}", affinity_error);
+            return 2;
         }
     }
+    const bool numa_shards = cfg.numa_policy == "shard";
+    const bool pin_threads = !cfg.cpu_set.empty() || numa_shards;
+
+    // Switch from the bootstrap console logger to the configured pipeline (--log-mode)
+    prodstarter::LoggingOptions log_options;
+    log_options.mode = cfg.log_mode;
+    log_options.queue_size = static_cast<size_t>(cfg.log_queue_size);
+    log_options.sample_rate = cfg.log_sample_rate;
+    log_options.verbose = cfg.verbose;
+    std::string log_error;
+    if (!prodstarter::SetupLogging(log_options, log_error)) {
+        spdlog::error("Failed to set up logging: {}", log_error);
+        return 2;
+    }
 
-    spdlog::info("Configuration: bind={}, tls={}, reflection={}, prometheus={}, threads={}",
-                 cfg.bind_address, cfg.enable_tls, cfg.enable_reflection, cfg.enable_prometheus, cfg.num_worker_threads);
+    spdlog::info("Configuration: bind={}, tls={}, reflection={}, admin={}, prometheus={}, threads={}, "
+                 "executor_threads={}, engine={}, shards={}, arenas={} (initial_block={}, max_block={}), "
+                 "limiter={} (scope={}, limits={}..{}), log_mode={}, log_sample_rate={}, drain_timeout_ms={}",
+                 cfg.bind_address, cfg.enable_tls, cfg.enable_reflection, cfg.enable_admin, cfg.enable_prometheus,
+                 cfg.num_worker_threads, cfg.num_executor_threads, cfg.engine, cfg.num_shards, cfg.arenas,
+                 cfg.arena_initial_block_bytes, cfg.arena_max_block_bytes, cfg.limiter, cfg.limiter_scope,
+                 cfg.limiter_min, cfg.limiter_max, cfg.log_mode, cfg.log_sample_rate, cfg.drain_timeout.count());
+    spdlog::info("Tuning: {}", prodstarter::DescribeTuning(cfg.tuning));
+    spdlog::info("CPU topology: {}", prodstarter::DescribeCpuTopology(topology));
+    spdlog::info("Allocator: {}", prodstarter::AllocatorName());
 
     // ---- Setup optional Prometheus exposer ----
 #ifdef USE_PROMETHEUS
     std::unique_ptr<prometheus::Exposer> exposer;
-    std::shared_ptr<prometheus::Registry> registry;
+    std::shared_ptr<prodstarter::ScrapeCollector> collector;
     if (cfg.enable_prometheus) {
-        // prometheus-cpp exposes metrics over an HTTP endpoint. Choose port e.g., 9090 or embed in same port via proxy.
-        const std::string prometheus_listen = "0.0.0.0:9090";
+        // prometheus-cpp exposes metrics over a separate HTTP endpoint (--metrics-bind, default 0.0.0.0:9090).
         try {
-            exposer = std::make_unique<prometheus::Exposer>(prometheus_listen);
-            registry = std::make_shared<prometheus::Registry>();
-            exposer->RegisterCollectable(registry);
-            spdlog::info("Prometheus metrics exposed on {}", prometheus_listen);
+            exposer = std::make_unique<prometheus::Exposer>(cfg.metrics_bind_address);
+            collector = std::make_shared<prodstarter::ScrapeCollector>();
+            exposer->RegisterCollectable(collector);
+            spdlog::info("Prometheus metrics exposed on {}", cfg.metrics_bind_address);
         } catch (const std::exception& ex) {
             spdlog::error("Failed to start Prometheus exposer: {}", ex.what());
         }
     }
 #endif
 
+    // ---- Executor for background tasks and CPU-heavy work offloaded from RPC handlers ----
+    // Pinned workers alternate between NUMA nodes, so work posted from any shard has a local worker to land on.
+    prodstarter::ThreadPlacement worker_placement;
+    if (pin_threads) {
+        worker_placement =
+            numa_shards ? prodstarter::PlaceAcrossNodes(topology) : prodstarter::PlaceOnCpus(topology.cpus);
+    }
+    prodstarter::Executor executor(cfg.num_executor_threads, "default", worker_placement);
+#ifdef USE_PROMETHEUS
+    if (collector) {
+        prodstarter::ExportExecutorMetrics(*collector, executor);
+        prodstarter::ExportLoggingMetrics(*collector);
+        prodstarter::ExportAllocatorMetrics(*collector); // heap and per-arena stats; Admin/PurgeMemory trims them
+    }
+#endif
+
+    // ---- Priority lanes (--lane-threads): async handlers without their own executor queue per method class ----
+    // Weighted scheduling keeps bulk calls from starving critical ones; the system lane (health, reflection,
+    // admin) has --reserved-threads workers of its own.
+    std::unique_ptr<prodstarter::MethodClassifier> method_classes;
+    std::unique_ptr<prodstarter::LaneExecutor> lanes;
+    if (cfg.lane_threads > 0) {
+        method_classes = std::make_unique<prodstarter::MethodClassifier>();
+        std::string rule_error;
+        for (const auto& rule : cfg.method_classes) method_classes->AddRule(rule, &rule_error); // validated above
+        std::vector<prodstarter::LaneOptions> lane_options(prodstarter::kMethodClassCount);
+        auto lane = [&](prodstarter::MethodClass cls) -> prodstarter::LaneOptions& {
+            auto& options = lane_options[static_cast<size_t>(cls)];
+            options.name = prodstarter::MethodClassName(cls);
+            return options;
+        };
+        const int bulk_max_threads =
+            cfg.bulk_max_threads > 0 ? cfg.bulk_max_threads : std::max(1, cfg.lane_threads / 2);
+        lane(prodstarter::MethodClass::kSystem).weight = cfg.critical_weight * 2; // probes go ahead of critical calls
+        lane(prodstarter::MethodClass::kSystem).reserved_threads = cfg.reserved_threads;
+        lane(prodstarter::MethodClass::kCritical).weight = cfg.critical_weight;
+        lane(prodstarter::MethodClass::kDefault).weight = cfg.default_weight;
+        lane(prodstarter::MethodClass::kBulk).weight = cfg.bulk_weight;
+        lane(prodstarter::MethodClass::kBulk).max_threads = bulk_max_threads;
+        lanes =
+            std::make_unique<prodstarter::LaneExecutor>(cfg.lane_threads, std::move(lane_options), worker_placement);
+        spdlog::info("Priority lanes: {} shared threads, weights critical={} default={} bulk={}, bulk max threads {}, "
+                     "{} reserved for system methods, {} method rules",
+                     cfg.lane_threads, cfg.critical_weight, cfg.default_weight, cfg.bulk_weight, bulk_max_threads,
+                     cfg.reserved_threads, cfg.method_classes.size());
+#ifdef USE_PROMETHEUS
+        if (collector) prodstarter::ExportLaneExecutorMetrics(*collector, *lanes);
+#endif
+    }
+
     // ---- Build server
-    ServerBuilder builder;
+    // gRPC health check service (grpc.health.v1.Health); enabled before the server is built
+    grpc::EnableDefaultHealthCheckService(true);
 
-    // Set the max number of concurrent completion queues/threads by registering multiple async services or adjust thread pool
-    // For simplicity we will let gRPC manage completion queues internally via Sync API and thread pool
+    // Optional server reflection for grpc_cli / debugging. The plugin is picked up by builders
+    // constructed after this call, so it has to run before the shards create theirs.
+    if (cfg.enable_reflection) {
+        grpc::reflection::InitProtoReflectionServerBuilderPlugin();
+    }
 
-    // TLS credentials if enabled
+    // TLS credentials if enabled; with --tls-reload-interval rotated files are picked up by new handshakes
+    std::shared_ptr<grpc::ServerCredentials> creds;
     if (cfg.enable_tls) {
-        if (cfg.cert_chain_file.empty() || cfg.private_key_file.empty()) {
-            spdlog::error("TLS enabled but cert or key file not provided");
+        prodstarter::TlsOptions tls_options;
+        tls_options.cert_chain_file = cfg.cert_chain_file;
+        tls_options.private_key_file = cfg.private_key_file;
+        tls_options.root_cert_file = cfg.root_cert_file;
+        tls_options.reload_interval = cfg.tls_reload_interval;
+        std::string tls_error;
+        creds = prodstarter::MakeTlsServerCredentials(tls_options, tls_error);
+        if (!creds) {
+            spdlog::error("Failed to read TLS files: {}", tls_error);
             return 2;
         }
-        std::string cert, key, root;
-        try {
-            std::ifstream cert_in(cfg.cert_chain_file);
-            cert.assign((std::istreambuf_iterator<char>(cert_in)), std::istreambuf_iterator<char>());
-            std::ifstream key_in(cfg.private_key_file);
-            key.assign((std::istreambuf_iterator<char>(key_in)), std::istreambuf_iterator<char>());
-            if (!cfg.root_cert_file.empty()) {
-                std::ifstream root_in(cfg.root_cert_file);
-                root.assign((std::istreambuf_iterator<char>(root_in)), std::istreambuf_iterator<char>());
-            }
-        } catch (const std::exception& ex) {
-            spdlog::error("Failed to read TLS files: {}", ex.what());
-            return 2;
-        }
-        grpc::SslServerCredentialsOptions ssl_opts;
-        grpc::SslServerCredentialsOptions::PemKeyCertPair pkp{key, cert};
-        ssl_opts.pem_key_cert_pairs.push_back(pkp);
-        if (!root.empty()) ssl_opts.pem_root_certs = root;
-        auto creds = grpc::SslServerCredentials(ssl_opts);
-        builder.AddListeningPort(cfg.bind_address, creds);
     } else {
-        builder.AddListeningPort(cfg.bind_address, grpc::InsecureServerCredentials());
+        creds = grpc::InsecureServerCredentials();
     }
 
-    // Register services
-    // Example: register your service implementations here
-    // ExampleServiceImpl service_impl;
-    // builder.RegisterService(&service_impl);
+    // In-flight call accounting for the shutdown drain (applies to every engine and shard)
+    prodstarter::InflightTracker inflight;
+#ifdef USE_PROMETHEUS
+    if (collector) {
+        prodstarter::ExportInflightMetrics(*collector, inflight);
+        // Handlers skipped because their client's deadline passed in a queue or the client cancelled
+        // (call/call_context.h); every engine checks at dispatch
+        prodstarter::ExportAbandonedCallMetrics(*collector);
+    }
+#endif
 
-    // gRPC health check service
-    grpc::health::HealthCheckServiceInterface* health_service = grpc::health::HealthCheckServiceInterface::Get();
-    builder.RegisterService(health_service);
+    // Per-method request/error counters and latency histograms, merged from per-thread cells on scrape
+    std::unique_ptr<prodstarter::RpcMetrics> rpc_metrics;
+#ifdef USE_PROMETHEUS
+    if (collector) {
+        rpc_metrics = std::make_unique<prodstarter::RpcMetrics>();
+        prodstarter::ExportRpcMetrics(*collector, *rpc_metrics);
+    }
+#endif
 
-    // Optional server reflection for grpc_cli / debugging
-    if (cfg.enable_reflection) {
-        grpc::reflection::InitProtoReflectionServerBuilderPlugin();
+    // Call latency by transport (tcp, unix, inproc), to compare co-located callers on a socket with remote ones
+    std::unique_ptr<prodstarter::TransportMetrics> transport_metrics;
+#ifdef USE_PROMETHEUS
+    if (collector) {
+        transport_metrics = std::make_unique<prodstarter::TransportMetrics>();
+        prodstarter::ExportTransportMetrics(*collector, *transport_metrics);
     }
+#endif
 
-    std::unique_ptr<Server> server(builder.BuildAndStart());
+    // Tracing (--otlp-endpoint): every call is recorded into per-thread rings, and tail sampling keeps failed and
+    // slow traces plus --trace-sample-rate of the rest
+    std::unique_ptr<prodstarter::Tracer> tracer;
+    if (!cfg.otlp_endpoint.empty()) {
+        prodstarter::TracerOptions tracer_options;
+        tracer_options.service_name = cfg.service_name;
+        tracer_options.otlp_endpoint = cfg.otlp_endpoint;
+        tracer_options.sample_rate = cfg.trace_sample_rate;
+        tracer_options.slow_threshold = std::chrono::milliseconds(cfg.trace_slow_ms);
+        tracer = std::make_unique<prodstarter::Tracer>(tracer_options);
+        tracer->Start();
+        spdlog::info("Tracing: exporting to {} as '{}', keeping failed traces, traces slower than {} ms and {} of "
+                     "the rest", cfg.otlp_endpoint, cfg.service_name, cfg.trace_slow_ms, cfg.trace_sample_rate);
+#ifdef USE_PROMETHEUS
+        if (collector) prodstarter::ExportTracingMetrics(*collector, *tracer);
+#endif
+    }
 
-    if (!server) {
-        spdlog::error("Failed to start gRPC server");
-        return 1;
+    // Per-call phase breakdown (queue wait, handler, serialize, write); the slowest calls are served by Admin/SlowCalls
+    std::unique_ptr<prodstarter::LatencyBreakdown> latency;
+    if (cfg.enable_admin || cfg.enable_prometheus) {
+        latency = std::make_unique<prodstarter::LatencyBreakdown>(static_cast<size_t>(cfg.slow_call_capacity),
+                                                                  cfg.slow_call_window);
+#ifdef USE_PROMETHEUS
+        if (collector) prodstarter::ExportLatencyBreakdownMetrics(*collector, *latency);
+#endif
     }
 
-    spdlog::info("gRPC server listening on {}", cfg.bind_address);
+    // Adaptive concurrency limit: calls beyond it fail fast with RESOURCE_EXHAUSTED instead of queueing (--limiter)
+    std::unique_ptr<prodstarter::ConcurrencyLimiter> limiter;
+    if (cfg.limiter != "off") {
+        prodstarter::LimiterOptions limiter_options;
+        limiter_options.algorithm = cfg.limiter;
+        limiter_options.per_method = cfg.limiter_scope == "method";
+        limiter_options.initial_limit = cfg.limiter_initial;
+        limiter_options.min_limit = cfg.limiter_min;
+        limiter_options.max_limit = cfg.limiter_max;
+        limiter_options.latency_target = std::chrono::milliseconds(cfg.limiter_latency_ms);
+        limiter_options.health_service = cfg.overload_health_service;
+        limiter_options.overload_after = std::chrono::milliseconds(cfg.overload_after_ms);
+        limiter = std::make_unique<prodstarter::ConcurrencyLimiter>(limiter_options);
+#ifdef USE_PROMETHEUS
+        if (collector) prodstarter::ExportConcurrencyLimiterMetrics(*collector, *limiter);
+#endif
+    }
 
-    // Mark health as SERVING
-    health_service->SetServingStatus("", grpc::health::HealthCheckResponse::SERVING);
+    // On-demand profiling (--profile-dir): Admin/CpuProfile and Admin/HeapProfile, or SIGUSR2
+    if (!cfg.profile_dir.empty()) {
+        prodstarter::ProfilerOptions profiler_options;
+        profiler_options.directory = cfg.profile_dir;
+        profiler_options.default_duration = std::chrono::seconds(cfg.profile_seconds);
+        profiler = std::make_unique<prodstarter::Profiler>(profiler_options);
+        signal_profiler.store(profiler.get(), std::memory_order_release);
+        const bool rpcs_refused = cfg.enable_admin && cfg.admin_token_file.empty();
+        spdlog::info("Profiling: profiles go to {} (SIGUSR2 captures {} s{})", cfg.profile_dir, cfg.profile_seconds,
+                     rpcs_refused ? "; the admin RPCs need --admin-token-file" : "");
+    }
 
-    // ---- Install signal handlers for graceful shutdown ----
-    std::signal(SIGINT, signal_handler);
-    std::signal(SIGTERM, signal_handler);
+    // Settings that can change while the server runs; components subscribe once they exist (see below)
+    prodstarter::RuntimeConfigStore runtime_config(prodstarter::RuntimeConfigFromFlags(cfg));
+
+    // Optional admin debug service, registered next to reflection on every shard
+    std::unique_ptr<prodstarter::AdminService> admin_service;
+    if (cfg.enable_admin) {
+        std::string admin_token;
+        if (!cfg.admin_token_file.empty()) {
+            std::string token_error;
+            if (!prodstarter::ReadAdminToken(cfg.admin_token_file, &admin_token, &token_error)) {
+                spdlog::error("{}", token_error);
+                return 2;
+            }
+        }
+        admin_service = std::make_unique<prodstarter::AdminService>(latency.get(), profiler.get(), &runtime_config,
+                                                                    std::move(admin_token));
+    }
 
-    // Optional: spawn worker threads to handle background tasks
-    std::vector<std::thread> workers;
-    workers.reserve(cfg.num_worker_threads);
-    for (int i = 0; i < cfg.num_worker_threads; ++i) {
-        workers.emplace_back([i]() {
-            spdlog::debug("Worker thread {} started", i);
-            // Worker loop placeholder — replace with queue consumers, periodic tasks, etc.
-            while (!g_shutdown_requested.load()) {
-                std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    // Per-call protobuf arenas for request/response messages, recycled through per-thread caches
+    std::unique_ptr<prodstarter::ArenaPool> arena_pool;
+    if (cfg.arenas) {
+        prodstarter::ArenaPoolOptions arena_options;
+        arena_options.initial_block_bytes = static_cast<size_t>(cfg.arena_initial_block_bytes);
+        arena_options.max_block_bytes = static_cast<size_t>(cfg.arena_max_block_bytes);
+        arena_pool = std::make_unique<prodstarter::ArenaPool>(arena_options);
+#ifdef USE_PROMETHEUS
+        if (collector) prodstarter::ExportArenaPoolMetrics(*collector, *arena_pool);
+#endif
+    }
+
+    // Serialized responses of idempotent unary methods bound with a CachePolicy (engine/cached_call.h)
+    std::unique_ptr<prodstarter::ResponseCache> response_cache;
+    if (cfg.response_cache_bytes > 0) {
+        response_cache = std::make_unique<prodstarter::ResponseCache>(static_cast<size_t>(cfg.response_cache_bytes));
+#ifdef USE_PROMETHEUS
+        if (collector) prodstarter::ExportResponseCacheMetrics(*collector, *response_cache);
+#endif
+    }
+    // Identical concurrent calls to those methods wait for one execution instead of each running the handler
+    std::unique_ptr<prodstarter::Singleflight> singleflight;
+    if (cfg.coalesce) {
+        singleflight = std::make_unique<prodstarter::Singleflight>();
+#ifdef USE_PROMETHEUS
+        if (collector) prodstarter::ExportSingleflightMetrics(*collector, *singleflight);
+#endif
+    }
+
+    // ---- Runtime reconfiguration: --runtime-config (polled, SIGHUP) and Admin/Reconfigure ----
+    // Each component checks and applies its part; an update either reaches all of them or none (runtime_config.h).
+    runtime_config.Subscribe({}, [&executor](const prodstarter::RuntimeConfig& next,
+                                             const prodstarter::RuntimeConfig& current) {
+        if (next.executor_threads != current.executor_threads) executor.Resize(next.executor_threads);
+    });
+    runtime_config.Subscribe(
+        [&limiter](const prodstarter::RuntimeConfig& next, const prodstarter::RuntimeConfig& current,
+                   std::string* error) {
+            if (limiter || (next.limiter_min == current.limiter_min && next.limiter_max == current.limiter_max)) {
+                return true;
+            }
+            *error = "limiter-min and limiter-max need a limiter (--limiter aimd|gradient)";
+            return false;
+        },
+        [&limiter](const prodstarter::RuntimeConfig& next, const prodstarter::RuntimeConfig& current) {
+            if (limiter && (next.limiter_min != current.limiter_min || next.limiter_max != current.limiter_max)) {
+                limiter->SetBounds(next.limiter_min, next.limiter_max);
             }
-            spdlog::debug("Worker thread {} exiting", i);
         });
+    runtime_config.Subscribe({}, [&response_cache](const prodstarter::RuntimeConfig& next,
+                                                   const prodstarter::RuntimeConfig& current) {
+        if (response_cache && next.response_cache_bytes != current.response_cache_bytes) {
+            response_cache->SetMaxBytes(static_cast<size_t>(next.response_cache_bytes));
+        }
+    });
+    runtime_config.Subscribe({}, [](const prodstarter::RuntimeConfig& next, const prodstarter::RuntimeConfig&) {
+        spdlog::set_level(spdlog::level::from_str(next.log_level)); // every registered logger, the default included
+        prodstarter::RequestLogSampler().SetRate(next.log_sample_rate);
+    });
+    if (!cfg.runtime_config_file.empty()) {
+        runtime_watcher = std::make_unique<prodstarter::RuntimeConfigWatcher>(runtime_config, cfg.runtime_config_file);
+        std::string runtime_error;
+        if (!runtime_watcher->Start(&runtime_error)) {
+            spdlog::error("Invalid runtime configuration: {}", runtime_error);
+            return 2;
+        }
+        signal_runtime_watcher.store(runtime_watcher.get(), std::memory_order_release);
+        spdlog::info("Runtime config: watching {} (v{})", cfg.runtime_config_file, runtime_config.Current()->version);
     }
 
-    // Main loop — wait for shutdown flag. Use server->Wait() for blocking if not managing threads.
-    while (!g_shutdown_requested.load()) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    // Responses are compressed per method at a level gRPC maps to an algorithm the client accepts, except for
+    // methods whose responses average under --compression-min-bytes (server/compression_policy.h)
+    std::unique_ptr<prodstarter::CompressionPolicy> compression;
+    {
+        prodstarter::CompressionOptions compression_options;
+        prodstarter::ParseCompressionLevel(cfg.compression, &compression_options.level);
+        compression_options.min_bytes = cfg.compression_min_bytes;
+        auto policy = std::make_unique<prodstarter::CompressionPolicy>(compression_options);
+        std::string ignored; // the rules were validated with the config
+        for (const auto& rule : cfg.compression_methods) policy->AddRule(rule, &ignored);
+        if (policy->enabled()) {
+            spdlog::info("Compression: level {} by default, {} method rule(s), {} byte threshold",
+                         prodstarter::CompressionLevelName(compression_options.level), cfg.compression_methods.size(),
+                         cfg.compression_min_bytes);
+            compression = std::move(policy);
+#ifdef USE_PROMETHEUS
+            if (collector) prodstarter::ExportCompressionMetrics(*collector, *compression);
+#endif
+        }
     }
 
-    spdlog::info("Shutdown requested — initiating graceful stop");
+    // Server-streaming methods write through a coalescing, byte-bounded writer (engine/stream_writer.h); every
+    // stream shares these options and reports into stream_stats
+    prodstarter::StreamWriterStats stream_stats;
+    prodstarter::StreamWriterOptions stream_options;
+    stream_options.max_queued_bytes = cfg.stream_max_queued_bytes;
+    stream_options.flush_bytes = cfg.stream_flush_bytes;
+    stream_options.flush_delay = std::chrono::microseconds(cfg.stream_flush_delay_us);
+    stream_options.stats = &stream_stats;
+    stream_options.min_compress_bytes = compression ? cfg.compression_min_bytes : 0;
+#ifdef USE_PROMETHEUS
+    if (collector) prodstarter::ExportStreamWriterMetrics(*collector, stream_stats);
+#endif
 
-    // Set health to NOT_SERVING
-    health_service->SetServingStatus("", grpc::health::HealthCheckResponse::NOT_SERVING);
+    // Register services
+    // Example: declare your service implementations here. Sync and callback implementations are shared by all
+    // shards and must outlive the servers.
+    // ExampleServiceImpl service_impl;
+    // ExampleCallbackServiceImpl callback_impl;
+    //
+    // Callback methods opt into the arena pool through the generated allocator hook:
+    // using MyRpcAllocator = prodstarter::ArenaMessageAllocator<myproto::Request, myproto::Response>;
+    // auto my_rpc_allocator = arena_pool ? std::make_unique<MyRpcAllocator>(*arena_pool) : nullptr;
+    // if (my_rpc_allocator) callback_impl.SetMessageAllocatorFor_MyRpcMethod(my_rpc_allocator.get());
+    //
+    // Read-only lookups can be answered from the response cache; the method is shared by all shards:
+    // auto my_lookup = prodstarter::MakeCachedUnaryMethod<myproto::Request, myproto::Response>(
+    //     response_cache.get(), singleflight.get(),
+    //     prodstarter::CachePolicy{"/myproto.Example/Lookup", std::chrono::seconds(5), {}},
+    //     arena_pool.get(), [](grpc::ServerContextBase* ctx, const myproto::Request& req, myproto::Response* resp) {
+    //         return Status::OK;
+    //     });
+    //
+    // Server-streaming callback methods return a ServerStreamReactor built with the shared options:
+    // return prodstarter::StartReactor<TailReactor>(ctx, request, stream_options);
+
+    // Generic engine: methods no registered service claims arrive as raw bytes and are routed by name and metadata
+    // (engine/passthrough.h). Handlers forward or answer with ByteBuffers, so nothing is parsed or re-serialized.
+    // Outbound calls go through a ChannelPool per downstream (infra/channel_pool.h): --channel-pool-size
+    // connections instead of one, picked --channel-pool-pick. Create each pool here and inject it into the service
+    // implementations and adapters that call that downstream:
+    // auto inventory_pool = make_pool("inventory", "inventory.internal:50051");
+    // InventoryClient inventory(*inventory_pool);
+    std::vector<std::unique_ptr<prodstarter::ChannelPool>> channel_pools;
+    auto make_pool = [&](std::string name, std::string target) {
+        prodstarter::ChannelPoolOptions pool_options;
+        pool_options.name = std::move(name);
+        pool_options.target = std::move(target);
+        pool_options.size = cfg.channel_pool_size;
+        pool_options.pick = cfg.channel_pool_pick;
+        channel_pools.push_back(std::make_unique<prodstarter::ChannelPool>(std::move(pool_options)));
+#ifdef USE_PROMETHEUS
+        if (collector) prodstarter::ExportChannelPoolMetrics(*collector, *channel_pools.back());
+#endif
+        return channel_pools.back().get();
+    };
 
-    // Ask server to shutdown and wait for in-flight rpcs to finish
-    server->Shutdown(); // Initiates shutdown; existing rpcs continue
-    // Optionally block until shutdown completed or until a timeout
-    server->Wait();
+    prodstarter::PassthroughRouter passthrough;
+    if (!cfg.passthrough_upstream.empty()) {
+        passthrough.HandlePrefix("/", prodstarter::ForwardTo(*make_pool("passthrough", cfg.passthrough_upstream)));
+    }
+    // passthrough.Handle("/myproto.Example/Version", prodstarter::ReplyWith(prodstarter::SerializePayload(version)));
+
+    // One server per shard, all bound to cfg.bind_address (a single shard unless --shards N); the --unix-listen
+    // sockets are served by shard 0.
+    // Sync engine (default): gRPC manages completion queues internally via the Sync API and its thread pool.
+    // Async engine: one ServerCompletionQueue per polling thread; cfg.num_worker_threads are split across shards.
+    // Callback engine: services derive from the generated CallbackService and return reactors; gRPC runs them on its
+    // internal callback threads, so no queues are added.
+    // Generic engine: the async engine's queues, serving a per-shard AsyncGenericService.
+    prodstarter::ShardOptions shard_options;
+    shard_options.bind_address = cfg.bind_address;
+    shard_options.credentials = creds;
+    shard_options.unix_listeners = cfg.unix_listeners;
+    shard_options.num_shards = cfg.num_shards;
+    shard_options.async_engine = cfg.engine == "async" || cfg.engine == "generic";
+    shard_options.engine_threads = cfg.num_worker_threads;
+    shard_options.tuning = cfg.tuning;
+    shard_options.arenas = arena_pool.get(); // async calls allocate their messages on pooled arenas
+    shard_options.lanes = lanes.get();       // and run handlers without an executor on their class's lane
+    if (pin_threads) {
+        // With --numa-policy=shard shard i lives on node i % nodes: its polling threads, and the memory they allocate.
+        const int threads_per_shard = (cfg.num_worker_threads + cfg.num_shards - 1) / cfg.num_shards;
+        shard_options.placements = prodstarter::PlaceShards(topology, cfg.num_shards, threads_per_shard, numa_shards);
+        std::string polling = shard_options.async_engine ? "" : "not ours (gRPC threads stay within the CPU set)";
+        for (size_t i = 0; shard_options.async_engine && i < shard_options.placements.size(); ++i) {
+            polling += fmt::format("{}shard {}: {}", i == 0 ? "" : ", ", i, shard_options.placements[i].Describe());
+        }
+        spdlog::info("Thread placement: executor and lane workers on {}; polling threads {}",
+                     worker_placement.Describe(), polling);
+        if (numa_shards && static_cast<size_t>(cfg.num_shards) < topology.nodes.size()) {
+            spdlog::warn("--numa-policy=shard with {} shard(s) on {} NUMA nodes leaves nodes without polling threads; "
+                         "use --shards {}", cfg.num_shards, topology.nodes.size(), topology.nodes.size());
+        }
+    }
+    prodstarter::ShardSet shards(shard_options);
+    // Channels into the running shards for callers inside the binary; inject it into services that call each
+    // other's RPCs, so those calls skip the network stack but not the interceptors (server/in_process_channels.h).
+    prodstarter::InProcessChannelFactory in_process;
+    // Replayed onto each shard's health service as it starts; SERVING comes once warm-up is over.
+    shards.health().SetServingStatus(false);
+
+    const bool started = shards.Start([&](prodstarter::ServerShard& shard) {
+        ServerBuilder& builder = shard.builder();
+
+        // Interceptor factories are owned by the builder, so every shard gets its own set. The call-context
+        // interceptor goes first so the ones after it can find the call's CallContext; the limiter marks rejected
+        // calls on it before any handler runs, and it cancels the call's CancellationTokens when the client leaves.
+        // The tracing interceptor publishes the call's trace context on it for outbound calls.
+        std::vector<std::unique_ptr<grpc::experimental::ServerInterceptorFactoryInterface>> interceptors;
+        if (latency || limiter || cfg.track_cancellation || method_classes || tracer) {
+            interceptors.push_back(
+                std::make_unique<prodstarter::CallContextInterceptorFactory>(latency.get(), method_classes.get()));
+        }
+        if (tracer) interceptors.push_back(std::make_unique<prodstarter::TracingInterceptorFactory>(*tracer));
+        if (limiter) interceptors.push_back(std::make_unique<prodstarter::LimiterInterceptorFactory>(*limiter));
+        if (rpc_metrics) interceptors.push_back(std::make_unique<prodstarter::RpcMetricsInterceptorFactory>(*rpc_metrics));
+        if (transport_metrics) {
+            interceptors.push_back(std::make_unique<prodstarter::TransportInterceptorFactory>(*transport_metrics));
+        }
+        if (compression) {
+            interceptors.push_back(std::make_unique<prodstarter::CompressionInterceptorFactory>(*compression));
+        }
+        interceptors.push_back(std::make_unique<prodstarter::InflightInterceptorFactory>(inflight));
+        builder.experimental().SetInterceptorCreators(std::move(interceptors));
+
+        if (admin_service) builder.RegisterService(admin_service.get());
+
+        if (cfg.engine == "generic") {
+            auto& generic = shard.Emplace<grpc::AsyncGenericService>();
+            builder.RegisterAsyncGenericService(&generic);
+            prodstarter::AddPassthroughService(*shard.engine(), &generic, &passthrough);
+        }
+
+        // builder.RegisterService(&service_impl);
+        //
+        // With --engine=async each shard registers its own AsyncService and binds each method to a handler:
+        // auto& async_service = shard.Emplace<myproto::Example::AsyncService>();
+        // builder.RegisterService(&async_service);
+        // prodstarter::AddUnaryMethod(*shard.engine(), &async_service, &myproto::Example::AsyncService::RequestMyRpc,
+        //     [](ServerContext* ctx, const myproto::Request& req, myproto::Response* resp) { return Status::OK; },
+        //     &executor); // optional: run the handler on the executor instead of the polling thread
+        //
+        // Cached methods are bound through the generated raw method instead (see engine/cached_call.h):
+        // prodstarter::AddCachedUnaryMethod(*shard.engine(), &raw_service, &RawService::RequestLookup, my_lookup);
+        //
+        // With --engine=callback register the CallbackService implementation:
+        // builder.RegisterService(&callback_impl);
+    });
+
+    if (!started) {
+        spdlog::error("Failed to start gRPC server");
+        if (runtime_watcher) runtime_watcher->Stop();
+        return 1;
+    }
+
+    spdlog::info("gRPC server listening on {}", shards.listening_address());
+    for (const auto& address : cfg.unix_listeners) spdlog::info("gRPC server listening on {} (plaintext)", address);
+    in_process.Bind(shards);
+
+    // ---- Warm-up: health stays NOT_SERVING until the tasks finish or --warmup-timeout passes ----
+    // Outbound pools connect first, and --warmup-call methods are called through the in-process channel, so the
+    // first real calls find connections, caches and lazily built state ready (lifecycle/warmup.h).
+    prodstarter::HealthReporter& health = shards.health();
+    prodstarter::WarmupRegistry warmup(cfg.warmup_timeout);
+    for (auto& pool : channel_pools) warmup.Add("pool/" + pool->name(), prodstarter::WarmChannelPool(*pool));
+    for (const auto& spec : cfg.warmup_calls) {
+        std::string method;
+        int count = 0;
+        std::string ignored; // validated with the config
+        prodstarter::ParseWarmupCall(spec, &method, &count, &ignored);
+        grpc::Slice empty; // an empty serialized message: every field at its default
+        warmup.Add("call" + method,
+                   prodstarter::WarmWithCalls(in_process.Get(), method, grpc::ByteBuffer(&empty, 1), count));
+    }
+    // Components add their own tasks, e.g. self-calls that fill the response cache of a cached method:
+    // warmup.Add("lookup",
+    //            prodstarter::WarmWithCalls(in_process.Get(), "/myproto.Example/Lookup", lookup_request, 20));
+#ifdef USE_PROMETHEUS
+    if (collector) prodstarter::ExportWarmupMetrics(*collector, warmup);
+#endif
+    if (warmup.size() == 0 || cfg.warmup_timeout.count() == 0) {
+        health.SetServingStatus(true);
+    } else {
+        spdlog::info("Warm-up: {} task(s), NOT_SERVING for up to {} ms", warmup.size(), cfg.warmup_timeout.count());
+        warmup.Start([&health](const prodstarter::WarmupReport& report) {
+            size_t ok = 0;
+            for (const auto& task : report.tasks) {
+                if (task.result == prodstarter::WarmupResult::kOk) {
+                    ++ok;
+                } else {
+                    spdlog::warn("Warm-up task {} {} after {:.3f} s{}{}", task.name,
+                                 prodstarter::WarmupResultName(task.result), task.seconds,
+                                 task.error.empty() ? "" : ": ", task.error);
+                }
+            }
+            spdlog::info("Warm-up finished in {:.3f} s ({} of {} tasks ok), serving", report.seconds, ok,
+                         report.tasks.size());
+            health.SetServingStatus(true);
+        });
+    }
+    if (limiter) limiter->Start(&health); // flips --overload-health-service under sustained overload
+
+    // ---- Saturation watchdog (--watchdog-interval-ms): no-op probes measure how long queued work waits ----
+    // Async polling threads are probed per shard, gRPC's callback threads, the executor and the lanes for every
+    // shard; with --saturation-health-service a shard whose lag stays high reports NOT_SERVING.
+    std::unique_ptr<prodstarter::SaturationWatchdog> watchdog;
+    if (cfg.watchdog_interval_ms > 0) {
+        prodstarter::WatchdogOptions watchdog_options;
+        watchdog_options.interval = std::chrono::milliseconds(cfg.watchdog_interval_ms);
+        watchdog_options.lag_threshold = std::chrono::milliseconds(cfg.saturation_lag_ms);
+        watchdog_options.saturated_after = std::chrono::milliseconds(cfg.saturation_after_ms);
+        watchdog_options.health_service = cfg.saturation_health_service;
+        watchdog = std::make_unique<prodstarter::SaturationWatchdog>(watchdog_options);
+        for (size_t i = 0; i < shards.size(); ++i) {
+            prodstarter::AsyncEngine* engine = shards.shard(i).engine();
+            for (int q = 0; engine != nullptr && q < engine->num_threads(); ++q) {
+                watchdog->AddCompletionQueue(static_cast<int>(i), q, engine->completion_queue(q));
+            }
+        }
+        if (cfg.engine == "callback") watchdog->AddCallbackThreads();
+        watchdog->AddExecutor(executor);
+        for (size_t lane = 0; lanes && lane < lanes->num_lanes(); ++lane) {
+            // The bulk lane is capped by --bulk-max-threads and expected to back up; it is measured only.
+            const auto cls = static_cast<prodstarter::MethodClass>(lane);
+            watchdog->AddLane(*lanes, lane, prodstarter::MethodClassName(cls), cls != prodstarter::MethodClass::kBulk);
+        }
+        watchdog->Start(&health, shards.size());
+        spdlog::info("Saturation watchdog: probing every {} ms{}, saturated after {} ms above {} ms of lag{}",
+                     cfg.watchdog_interval_ms, cfg.engine == "sync" ? " (executors only: sync queues are gRPC's)" : "",
+                     cfg.saturation_after_ms, cfg.saturation_lag_ms,
+                     cfg.saturation_health_service.empty() ? "" : ", reported as " + cfg.saturation_health_service);
+#ifdef USE_PROMETHEUS
+        if (collector) prodstarter::ExportSaturationMetrics(*collector, *watchdog);
+#endif
+    }
 
-    // Join worker threads
-    for (auto& w : workers) {
-        if (w.joinable()) w.join();
+#ifdef USE_PROMETHEUS
+    // Connection counts are polled from channelz, which is only worth doing when something scrapes them.
+    std::unique_ptr<prodstarter::ConnectionMonitor> connections;
+    if (collector) {
+        prodstarter::ConnectionMonitorOptions connection_options;
+        connection_options.max_connection_age = std::chrono::milliseconds(cfg.tuning.max_connection_age_ms);
+        connections = std::make_unique<prodstarter::ConnectionMonitor>(connection_options);
+        prodstarter::ExportConnectionMetrics(*collector, *connections);
+        connections->Start();
     }
+#endif
+
+    // Background work (queue consumers, periodic tasks, ...) is posted to the executor, e.g.
+    // executor.Post([] { /* consume one batch */ });
+
+    // Main thread sleeps until a signal (or another component) triggers shutdown — no polling.
+    const std::string reason = shutdown.Wait();
+
+    spdlog::info("Shutdown requested ({}) — draining in-flight RPCs for up to {} ms", reason, cfg.drain_timeout.count());
+
+    // Set health to NOT_SERVING; warm-up, the overload monitor and the watchdog stop first so they cannot flip it
+    // back. Runtime changes stop too: the components they reach are about to shut down.
+    if (runtime_watcher) runtime_watcher->Stop();
+    warmup.Cancel();
+    if (limiter) limiter->Stop();
+    if (watchdog) watchdog->Stop(); // and no probe may be sent to an engine queue once it shuts down
+    health.SetServingStatus(false);
+
+    // Stop accepting RPCs on every shard and give in-flight ones until the deadline; gRPC cancels whatever is still
+    // running then.
+    // Shutdown(deadline) blocks, so it runs on a helper thread while we watch the in-flight count.
+    const auto drain_started = std::chrono::steady_clock::now();
+    const int64_t inflight_at_shutdown = inflight.inflight();
+    std::thread stopper([&shards, &cfg] { shards.Shutdown(std::chrono::system_clock::now() + cfg.drain_timeout); });
+    const int64_t cancelled = inflight.WaitIdleUntil(drain_started + cfg.drain_timeout);
+    stopper.join();
+    const int64_t drained = std::max<int64_t>(0, inflight_at_shutdown - cancelled);
+    inflight.RecordDrain(drained, cancelled);
+    spdlog::info("Drain finished in {} ms: {} in-flight RPCs drained, {} cancelled at the deadline",
+                 std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - drain_started)
+                     .count(),
+                 drained, cancelled);
+
+    // Offloaded handlers finish their calls through the engine queues, so stop the executor and lanes first.
+    // Completion queues can only be shut down once the server no longer matches new calls.
+    executor.Shutdown();
+    if (lanes) lanes->Shutdown();
+    shards.ShutdownEngines();
+    shards.Wait();
+    // Every call has finished, so its spans are in the rings; send the kept ones.
+    if (tracer) tracer->Stop();
+
+#ifdef USE_PROMETHEUS
+    if (connections) connections->Stop();
+    // Stop scraping before the components the collector reads from go away
+    exposer.reset();
+#endif
+    signals.Stop();
 
     spdlog::info("Server shutdown complete");
     spdlog::shutdown();
@@ -0,0 +1,187 @@
+// ProdStarterHub - C++ gRPC Service
+// src/memory/allocator.cpp
+
+#include "memory/allocator.h"
+
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#include <spdlog/fmt/fmt.h>
+
+#if defined(USE_JEMALLOC)
+#include <jemalloc/jemalloc.h>
+#elif defined(USE_MIMALLOC)
+#include <mimalloc.h>
+#else
+#include <gnu/libc-version.h>
+#include <malloc.h>
+#endif
+
+#if defined(USE_JEMALLOC)
+// Read by jemalloc before its first allocation; MALLOC_CONF from the environment is applied on top.
+//   background_thread  decay-based purging runs on jemalloc's threads, not inside free() on a request path
+//   dirty/muzzy decay  freed pages go back to the kernel within seconds instead of lingering as RSS
+//   lg_tcache_max:16   per-thread caches hold sizes up to 64 KiB (default 32 KiB), which covers most message buffers
+extern "C" {
+const char* malloc_conf = "background_thread:true,dirty_decay_ms:5000,muzzy_decay_ms:5000,lg_tcache_max:16";
+}
+#endif
+
+namespace prodstarter {
+
+namespace {
+
+#if defined(USE_JEMALLOC)
+
+template <class T>
+T ReadMallctl(const std::string& name) {
+    T value{};
+    size_t size = sizeof(value);
+    if (mallctl(name.c_str(), &value, &size, nullptr, 0) != 0) return T{};
+    return value;
+}
+
+#endif
+
+#if !defined(USE_MIMALLOC)
+
+uint64_t ProcessResidentBytes() {
+    std::ifstream statm("/proc/self/statm");
+    uint64_t size = 0;
+    uint64_t resident = 0;
+    if (!(statm >> size >> resident)) return 0;
+    return resident * static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+}
+
+#endif
+
+} // namespace
+
+std::string AllocatorName() {
+#if defined(USE_JEMALLOC)
+    const char* version = ReadMallctl<const char*>("version");
+    return fmt::format("jemalloc {}", version != nullptr ? version : "unknown");
+#elif defined(USE_MIMALLOC)
+    const int version = mi_version();
+    return fmt::format("mimalloc {}.{}.{}", version / 100, version / 10 % 10, version % 10);
+#else
+    return fmt::format("glibc {}", gnu_get_libc_version());
+#endif
+}
+
+void ConfigureAllocator() {
+#if defined(USE_MIMALLOC) && MI_MALLOC_VERSION >= 210
+    // Freed pages are purged after 100 ms instead of 10: fewer madvise() calls while a burst is still
+    // allocating, and memory still goes back within a scrape interval once it is over.
+    mi_option_set(mi_option_purge_delay, 100);
+#endif
+    // jemalloc is tuned through malloc_conf above; glibc is left at its defaults.
+}
+
+AllocatorStats GetAllocatorStats() {
+    AllocatorStats stats;
+    stats.allocator = AllocatorName();
+#if defined(USE_JEMALLOC)
+    // Statistics are cached by jemalloc until the epoch advances.
+    uint64_t epoch = 1;
+    size_t epoch_size = sizeof(epoch);
+    mallctl("epoch", &epoch, &epoch_size, &epoch, epoch_size);
+
+    stats.allocated = ReadMallctl<size_t>("stats.allocated");
+    stats.active = ReadMallctl<size_t>("stats.active");
+    stats.resident = ReadMallctl<size_t>("stats.resident");
+    stats.mapped = ReadMallctl<size_t>("stats.mapped");
+
+    const uint64_t page = ReadMallctl<size_t>("arenas.page");
+    const unsigned narenas = ReadMallctl<unsigned>("arenas.narenas");
+    for (unsigned i = 0; i < narenas; ++i) {
+        const std::string prefix = fmt::format("stats.arenas.{}.", i);
+        AllocatorArenaStats arena;
+        arena.index = i;
+        arena.threads = ReadMallctl<unsigned>(prefix + "nthreads");
+        arena.active = ReadMallctl<size_t>(prefix + "pactive") * page;
+        arena.dirty = ReadMallctl<size_t>(prefix + "pdirty") * page;
+        arena.allocated =
+            ReadMallctl<size_t>(prefix + "small.allocated") + ReadMallctl<size_t>(prefix + "large.allocated");
+        if (arena.threads == 0 && arena.active == 0 && arena.dirty == 0) continue;
+        stats.arenas.push_back(arena);
+    }
+    stats.process_resident = ProcessResidentBytes();
+#elif defined(USE_MIMALLOC)
+    size_t elapsed = 0, user = 0, system = 0, rss = 0, peak_rss = 0, commit = 0, peak_commit = 0, faults = 0;
+    mi_process_info(&elapsed, &user, &system, &rss, &peak_rss, &commit, &peak_commit, &faults);
+    stats.active = commit;
+    stats.resident = commit;
+    stats.mapped = commit;
+    stats.process_resident = rss;
+#else
+    // glibc cannot tell live pages from free chunks inside them; resident is what its arenas and mmapped
+    // chunks hold from the kernel.
+    const struct mallinfo2 info = mallinfo2();
+    stats.allocated = info.uordblks + info.hblkhd;
+    stats.active = stats.allocated;
+    stats.resident = info.arena + info.hblkhd;
+    stats.mapped = stats.resident;
+    stats.process_resident = ProcessResidentBytes();
+#endif
+    return stats;
+}
+
+void PurgeAllocator() {
+#if defined(USE_JEMALLOC)
+    mallctl(fmt::format("arena.{}.purge", MALLCTL_ARENAS_ALL).c_str(), nullptr, nullptr, nullptr, 0);
+#elif defined(USE_MIMALLOC)
+    mi_collect(true);
+#else
+    malloc_trim(0);
+#endif
+}
+
+const char* HeapProfileFormat() {
+#if defined(USE_JEMALLOC)
+    return "heap";
+#elif defined(USE_MIMALLOC)
+    return "txt";
+#else
+    return "xml";
+#endif
+}
+
+bool DumpHeapProfile(const std::string& path, std::string* error) {
+#if defined(USE_JEMALLOC)
+    if (!ReadMallctl<bool>("opt.prof")) {
+        *error = "jemalloc heap profiling is off; start the process with MALLOC_CONF=prof:true";
+        return false;
+    }
+    const char* filename = path.c_str();
+    const int rc = mallctl("prof.dump", nullptr, nullptr, &filename, sizeof(filename));
+    if (rc != 0) {
+        *error = fmt::format("mallctl(prof.dump, {}): {}", path, std::strerror(rc));
+        return false;
+    }
+    return true;
+#else
+    FILE* out = std::fopen(path.c_str(), "w");
+    if (out == nullptr) {
+        *error = fmt::format("cannot create {}: {}", path, std::strerror(errno));
+        return false;
+    }
+#if defined(USE_MIMALLOC)
+    mi_stats_print_out([](const char* msg, void* arg) { std::fputs(msg, static_cast<FILE*>(arg)); }, out);
+    const bool ok = true;
+#else
+    const bool ok = malloc_info(0, out) == 0;
+#endif
+    if (std::fclose(out) != 0 || !ok) {
+        *error = fmt::format("writing {} failed", path);
+        return false;
+    }
+    return true;
+#endif
+}
+
+} // namespace prodstarter
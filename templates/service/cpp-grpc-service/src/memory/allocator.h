@@ -0,0 +1,73 @@
+// ProdStarterHub - C++ gRPC Service
+// src/memory/allocator.h
+// Heap statistics and page purging for the allocator the binary is linked with.
+//
+// glibc malloc fragments under gRPC and protobuf workloads: per-thread arenas
+// keep freed chunks they rarely hand back, and RSS climbs over days of uptime.
+// Linking jemalloc or mimalloc instead is a build option:
+//
+//   -DUSE_JEMALLOC   link jemalloc (target_link_libraries(... jemalloc)); per-thread
+//                    caches and decay are tuned through malloc_conf, and MALLOC_CONF
+//                    in the environment still overrides them
+//   -DUSE_MIMALLOC   link mimalloc (mimalloc-override or the static object) so it
+//                    replaces malloc; options are set at startup
+//
+// Without either the glibc allocator is reported. GetAllocatorStats() is what
+// the allocator_* metrics and Admin/PurgeMemory report:
+//
+//   const AllocatorStats before = GetAllocatorStats();
+//   PurgeAllocator();
+//   spdlog::info("released {} bytes", before.resident - GetAllocatorStats().resident);
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace prodstarter {
+
+struct AllocatorArenaStats {
+    unsigned index = 0;
+    uint64_t allocated = 0; // bytes in live allocations served by this arena
+    uint64_t active = 0;    // bytes in the arena's pages that hold live allocations
+    uint64_t dirty = 0;     // freed pages the arena still holds resident; purging returns them
+    uint64_t threads = 0;   // threads currently assigned to the arena
+};
+
+struct AllocatorStats {
+    std::string allocator;  // "jemalloc 5.3.0-...", "mimalloc 2.1.2", "glibc 2.36"
+    uint64_t allocated = 0; // bytes in live allocations; 0 where the allocator cannot tell (mimalloc)
+    uint64_t active = 0;    // bytes in pages holding live allocations
+    uint64_t resident = 0;  // bytes of allocator memory in RAM, dirty pages included
+    uint64_t mapped = 0;    // bytes the allocator has mapped from the kernel
+    uint64_t process_resident = 0; // RSS of the whole process, for comparison
+    std::vector<AllocatorArenaStats> arenas; // jemalloc only; arenas without threads or pages are left out
+
+    // Share of resident allocator memory that holds no live allocation.
+    double fragmentation() const {
+        return resident > 0 && allocated > 0 && allocated < resident ? 1.0 - double(allocated) / double(resident) : 0;
+    }
+};
+
+// Name and version of the allocator in use.
+std::string AllocatorName();
+
+// Sets the runtime options of the linked allocator; call once at startup, before other threads are started.
+void ConfigureAllocator();
+
+// Gathers fresh statistics. Takes allocator locks briefly; meant for scrapes, not hot paths.
+AllocatorStats GetAllocatorStats();
+
+// Returns free and dirty pages of every arena to the kernel (arena.<all>.purge, mi_collect, malloc_trim).
+void PurgeAllocator();
+
+// Kind of file DumpHeapProfile() writes, which is also its extension: "heap" (jemalloc, read with jeprof or pprof),
+// "xml" (glibc malloc_info) or "txt" (mimalloc statistics).
+const char* HeapProfileFormat();
+
+// Writes the allocator's heap profile to `path`. jemalloc records allocation stacks only when started with
+// MALLOC_CONF=prof:true (and built with --enable-prof); without it this returns false with `error` set.
+bool DumpHeapProfile(const std::string& path, std::string* error);
+
+} // namespace prodstarter
@@ -0,0 +1,648 @@
+// ProdStarterHub - C++ gRPC Service
+// src/metrics/exporters.cpp
+
+#include "metrics/exporters.h"
+
+#ifdef USE_PROMETHEUS
+
+#include <string>
+
+#include "cache/response_cache.h"
+#include "call/call_context.h"
+#include "cache/singleflight.h"
+#include "engine/arena_pool.h"
+#include "engine/stream_writer.h"
+#include "exec/executor.h"
+#include "exec/lane_executor.h"
+#include "infra/channel_pool.h"
+#include "lifecycle/inflight_tracker.h"
+#include "lifecycle/warmup.h"
+#include "logging/logging.h"
+#include "memory/allocator.h"
+#include "metrics/latency_breakdown.h"
+#include "metrics/rpc_metrics.h"
+#include "metrics/transport_metrics.h"
+#include "overload/concurrency_limiter.h"
+#include "overload/saturation_watchdog.h"
+#include "server/compression_policy.h"
+#include "server/connection_monitor.h"
+#include "tracing/tracer.h"
+
+namespace prodstarter {
+
+namespace {
+const char* StatusCodeName(int code) {
+    static const char* const kNames[RpcMetrics::kNumCodes] = {
+        "OK", "CANCELLED", "UNKNOWN", "INVALID_ARGUMENT", "DEADLINE_EXCEEDED", "NOT_FOUND",
+        "ALREADY_EXISTS", "PERMISSION_DENIED", "RESOURCE_EXHAUSTED", "FAILED_PRECONDITION", "ABORTED",
+        "OUT_OF_RANGE", "UNIMPLEMENTED", "INTERNAL", "UNAVAILABLE", "DATA_LOSS", "UNAUTHENTICATED",
+    };
+    return code >= 0 && code < RpcMetrics::kNumCodes ? kNames[code] : "UNKNOWN";
+}
+} // namespace
+
+void ExportExecutorMetrics(ScrapeCollector& collector, const Executor& executor) {
+    collector.Add([&executor](std::vector<prometheus::MetricFamily>& out) {
+        const auto stats = executor.GetStats();
+        const prometheus::ClientMetric::Label name{"executor", executor.name()};
+
+        auto threads = MakeFamily("executor_threads", "Worker threads in the executor", prometheus::MetricType::Gauge);
+        AddGauge(threads, executor.num_threads(), {name});
+
+        auto depth = MakeFamily("executor_queue_depth", "Tasks waiting in each worker deque", prometheus::MetricType::Gauge);
+        for (size_t i = 0; i < stats.queue_depths.size(); ++i) {
+            AddGauge(depth, static_cast<double>(stats.queue_depths[i]), {name, {"worker", std::to_string(i)}});
+        }
+
+        auto submitted = MakeFamily("executor_tasks_submitted_total", "Tasks accepted by the executor",
+                                    prometheus::MetricType::Counter);
+        AddCounter(submitted, static_cast<double>(stats.submitted), {name});
+
+        auto executed = MakeFamily("executor_tasks_executed_total", "Tasks run to completion",
+                                   prometheus::MetricType::Counter);
+        AddCounter(executed, static_cast<double>(stats.executed), {name});
+
+        auto steals = MakeFamily("executor_steals_total", "Tasks taken from a sibling worker's deque",
+                                 prometheus::MetricType::Counter);
+        AddCounter(steals, static_cast<double>(stats.stolen), {name});
+
+        out.push_back(std::move(threads));
+        out.push_back(std::move(depth));
+        out.push_back(std::move(submitted));
+        out.push_back(std::move(executed));
+        out.push_back(std::move(steals));
+    });
+}
+
+void ExportLaneExecutorMetrics(ScrapeCollector& collector, const LaneExecutor& lanes) {
+    collector.Add([&lanes](std::vector<prometheus::MetricFamily>& out) {
+        const auto stats = lanes.GetStats();
+
+        auto queued = MakeFamily("executor_lane_queued", "Tasks waiting in each priority lane",
+                                 prometheus::MetricType::Gauge);
+        auto running = MakeFamily("executor_lane_running", "Tasks running from each priority lane",
+                                  prometheus::MetricType::Gauge);
+        auto executed = MakeFamily("executor_lane_tasks_total", "Tasks run to completion from each priority lane",
+                                   prometheus::MetricType::Counter);
+        for (const auto& lane : stats.lanes) {
+            const prometheus::ClientMetric::Label name{"lane", lane.name};
+            AddGauge(queued, static_cast<double>(lane.queued), {name});
+            AddGauge(running, static_cast<double>(lane.running), {name});
+            AddCounter(executed, static_cast<double>(lane.executed), {name});
+        }
+
+        out.push_back(std::move(queued));
+        out.push_back(std::move(running));
+        out.push_back(std::move(executed));
+    });
+}
+
+void ExportArenaPoolMetrics(ScrapeCollector& collector, const ArenaPool& pool) {
+    collector.Add([&pool](std::vector<prometheus::MetricFamily>& out) {
+        const auto stats = pool.GetStats();
+
+        auto acquired = MakeFamily("arena_pool_acquired_total", "Per-call arenas handed out",
+                                   prometheus::MetricType::Counter);
+        AddCounter(acquired, static_cast<double>(stats.acquired));
+
+        auto recycled = MakeFamily("arena_pool_recycled_total", "Arenas served from a thread cache without allocating",
+                                   prometheus::MetricType::Counter);
+        AddCounter(recycled, static_cast<double>(stats.recycled));
+
+        auto created = MakeFamily("arena_pool_created_total", "Arenas allocated because the thread cache was empty",
+                                  prometheus::MetricType::Counter);
+        AddCounter(created, static_cast<double>(stats.created));
+
+        auto discarded = MakeFamily("arena_pool_discarded_total", "Released arenas freed because the thread cache was full",
+                                    prometheus::MetricType::Counter);
+        AddCounter(discarded, static_cast<double>(stats.discarded));
+
+        auto bytes = MakeFamily("arena_bytes_used_total", "Arena bytes used by call messages",
+                                prometheus::MetricType::Counter);
+        AddCounter(bytes, static_cast<double>(stats.bytes_used));
+
+        out.push_back(std::move(acquired));
+        out.push_back(std::move(recycled));
+        out.push_back(std::move(created));
+        out.push_back(std::move(discarded));
+        out.push_back(std::move(bytes));
+    });
+}
+
+void ExportStreamWriterMetrics(ScrapeCollector& collector, const StreamWriterStats& writers) {
+    collector.Add([&writers](std::vector<prometheus::MetricFamily>& out) {
+        const auto stats = writers.GetStats();
+
+        auto streams = MakeFamily("stream_writer_streams", "Server streams writing through a coalescing writer",
+                                  prometheus::MetricType::Gauge);
+        AddGauge(streams, static_cast<double>(stats.streams));
+
+        auto queued = MakeFamily("stream_writer_queued_bytes", "Stream message bytes queued and not yet written",
+                                 prometheus::MetricType::Gauge);
+        AddGauge(queued, static_cast<double>(stats.queued_bytes));
+
+        auto messages = MakeFamily("stream_writer_messages_total", "Stream messages handed to gRPC",
+                                   prometheus::MetricType::Counter);
+        AddCounter(messages, static_cast<double>(stats.messages));
+
+        auto flushes = MakeFamily("stream_writer_flushes_total", "Unhinted stream writes, each flushing one batch",
+                                  prometheus::MetricType::Counter);
+        AddCounter(flushes, static_cast<double>(stats.flushes));
+
+        auto backpressure = MakeFamily("stream_writer_backpressure_total",
+                                       "Stream messages refused because the stream's queue budget was used up",
+                                       prometheus::MetricType::Counter);
+        AddCounter(backpressure, static_cast<double>(stats.backpressure));
+
+        out.push_back(std::move(streams));
+        out.push_back(std::move(queued));
+        out.push_back(std::move(messages));
+        out.push_back(std::move(flushes));
+        out.push_back(std::move(backpressure));
+    });
+}
+
+void ExportCompressionMetrics(ScrapeCollector& collector, const CompressionPolicy& policy) {
+    collector.Add([&policy](std::vector<prometheus::MetricFamily>& out) {
+        const auto stats = policy.GetStats();
+
+        auto messages = MakeFamily("grpc_server_compression_messages_total",
+                                   "Response messages sent with compression on", prometheus::MetricType::Counter);
+        auto bytes = MakeFamily("grpc_server_compression_uncompressed_bytes_total",
+                                "Size of those messages before compression", prometheus::MetricType::Counter);
+        auto saved = MakeFamily("grpc_server_compression_saved_bytes_total",
+                                "Bytes compression kept off the wire, estimated from sampled messages",
+                                prometheus::MetricType::Counter);
+        auto cpu = MakeFamily("grpc_server_compression_cpu_seconds_total",
+                              "CPU time spent compressing, estimated from sampled messages",
+                              prometheus::MetricType::Counter);
+        for (auto level : {GRPC_COMPRESS_LEVEL_LOW, GRPC_COMPRESS_LEVEL_MED, GRPC_COMPRESS_LEVEL_HIGH}) {
+            const auto& level_stats = stats.levels[level];
+            const prometheus::ClientMetric::Label label{"level", CompressionLevelName(level)};
+            AddCounter(messages, static_cast<double>(level_stats.messages), {label});
+            AddCounter(bytes, static_cast<double>(level_stats.bytes), {label});
+            AddCounter(saved, static_cast<double>(level_stats.saved_bytes), {label});
+            AddCounter(cpu, level_stats.cpu_seconds, {label});
+        }
+
+        auto skipped = MakeFamily("grpc_server_compression_skipped_total",
+                                  "Calls and stream messages sent uncompressed because they were under the threshold",
+                                  prometheus::MetricType::Counter);
+        AddCounter(skipped, static_cast<double>(stats.below_min_bytes), {{"reason", "below_min_bytes"}});
+
+        out.push_back(std::move(messages));
+        out.push_back(std::move(bytes));
+        out.push_back(std::move(saved));
+        out.push_back(std::move(cpu));
+        out.push_back(std::move(skipped));
+    });
+}
+
+void ExportRpcMetrics(ScrapeCollector& collector, const RpcMetrics& metrics) {
+    collector.Add([&metrics](std::vector<prometheus::MetricFamily>& out) {
+        const auto snapshot = metrics.Snapshot();
+        const auto& bound_array = RpcMetrics::BucketBounds();
+        const std::vector<double> bounds(bound_array.begin(), bound_array.end());
+
+        auto requests = MakeFamily("rpc_requests_total", "RPCs completed, by method and status code",
+                                   prometheus::MetricType::Counter);
+        auto errors = MakeFamily("rpc_errors_total", "RPCs completed with a non-OK status, by method and status code",
+                                 prometheus::MetricType::Counter);
+        auto duration = MakeFamily("rpc_duration_seconds", "Time from call start until the status was sent",
+                                   prometheus::MetricType::Histogram);
+
+        for (const auto& method : snapshot) {
+            const prometheus::ClientMetric::Label name{"method", method.method};
+            for (int code = 0; code < RpcMetrics::kNumCodes; ++code) {
+                const uint64_t count = method.codes[code];
+                if (count == 0) continue;
+                const prometheus::ClientMetric::Label code_label{"code", StatusCodeName(code)};
+                AddCounter(requests, static_cast<double>(count), {name, code_label});
+                if (code != 0) AddCounter(errors, static_cast<double>(count), {name, code_label});
+            }
+            AddHistogram(duration, bounds, std::vector<uint64_t>(method.buckets.begin(), method.buckets.end()),
+                         method.sum_seconds, {name});
+        }
+
+        out.push_back(std::move(requests));
+        out.push_back(std::move(errors));
+        out.push_back(std::move(duration));
+    });
+}
+
+void ExportTransportMetrics(ScrapeCollector& collector, const TransportMetrics& metrics) {
+    collector.Add([&metrics](std::vector<prometheus::MetricFamily>& out) {
+        std::vector<double> bounds;
+        for (int64_t us : kLatencyBoundsUs) bounds.push_back(static_cast<double>(us) / 1e6);
+
+        auto duration = MakeFamily("grpc_server_transport_duration_seconds",
+                                   "Call duration by the transport the call arrived on (tcp, unix, inproc)",
+                                   prometheus::MetricType::Histogram);
+        for (size_t i = 0; i < kNumTransports; ++i) {
+            const auto transport = static_cast<Transport>(i);
+            const auto snapshot = metrics.Collect(transport);
+            AddHistogram(duration, bounds, std::vector<uint64_t>(snapshot.buckets.begin(), snapshot.buckets.end()),
+                         snapshot.sum_seconds, {{"transport", TransportName(transport)}});
+        }
+        out.push_back(std::move(duration));
+    });
+}
+
+void ExportLatencyBreakdownMetrics(ScrapeCollector& collector, const LatencyBreakdown& latency) {
+    collector.Add([&latency](std::vector<prometheus::MetricFamily>& out) {
+        std::vector<double> bounds;
+        for (int64_t us : kLatencyBoundsUs) bounds.push_back(static_cast<double>(us) / 1e6);
+
+        auto phases = MakeFamily("rpc_phase_seconds", "Unary call latency by phase (queue_wait, handler, serialize, write)",
+                                 prometheus::MetricType::Histogram);
+        for (size_t i = 0; i < LatencyBreakdown::kNumPhases; ++i) {
+            const auto phase = static_cast<LatencyBreakdown::Phase>(i);
+            const auto snapshot = latency.CollectPhase(phase);
+            AddHistogram(phases, bounds, std::vector<uint64_t>(snapshot.buckets.begin(), snapshot.buckets.end()),
+                         snapshot.sum_seconds, {{"phase", LatencyBreakdown::PhaseName(phase)}});
+        }
+        out.push_back(std::move(phases));
+    });
+}
+
+void ExportLoggingMetrics(ScrapeCollector& collector) {
+    collector.Add([](std::vector<prometheus::MetricFamily>& out) {
+        const auto stats = GetLoggingStats();
+
+        auto dropped = MakeFamily("log_messages_dropped_total",
+                                  "Log messages overwritten in the async queue before they were written",
+                                  prometheus::MetricType::Counter);
+        AddCounter(dropped, static_cast<double>(stats.dropped));
+
+        auto sampled = MakeFamily("log_messages_sampled_out_total", "Per-request debug lines skipped by sampling",
+                                  prometheus::MetricType::Counter);
+        AddCounter(sampled, static_cast<double>(stats.sampled_out));
+
+        auto queued = MakeFamily("log_queue_depth", "Log messages waiting for the async logging thread",
+                                 prometheus::MetricType::Gauge);
+        AddGauge(queued, static_cast<double>(stats.queued));
+
+        out.push_back(std::move(dropped));
+        out.push_back(std::move(sampled));
+        out.push_back(std::move(queued));
+    });
+}
+
+void ExportResponseCacheMetrics(ScrapeCollector& collector, const ResponseCache& cache) {
+    collector.Add([&cache](std::vector<prometheus::MetricFamily>& out) {
+        const auto stats = cache.GetStats();
+
+        auto hits = MakeFamily("response_cache_hits_total", "Calls answered from the response cache",
+                               prometheus::MetricType::Counter);
+        AddCounter(hits, static_cast<double>(stats.hits));
+
+        auto misses = MakeFamily("response_cache_misses_total", "Cache lookups that ran the handler",
+                                 prometheus::MetricType::Counter);
+        AddCounter(misses, static_cast<double>(stats.misses));
+
+        auto inserts = MakeFamily("response_cache_inserts_total", "Responses stored in the cache",
+                                  prometheus::MetricType::Counter);
+        AddCounter(inserts, static_cast<double>(stats.inserts));
+
+        auto evictions = MakeFamily("response_cache_evictions_total",
+                                    "Entries dropped to stay within the byte budget", prometheus::MetricType::Counter);
+        AddCounter(evictions, static_cast<double>(stats.evictions));
+
+        auto expirations = MakeFamily("response_cache_expirations_total", "Entries found past their TTL",
+                                      prometheus::MetricType::Counter);
+        AddCounter(expirations, static_cast<double>(stats.expirations));
+
+        auto entries = MakeFamily("response_cache_entries", "Entries currently cached", prometheus::MetricType::Gauge);
+        AddGauge(entries, static_cast<double>(stats.entries));
+
+        auto bytes = MakeFamily("response_cache_bytes", "Bytes charged to cached entries", prometheus::MetricType::Gauge);
+        AddGauge(bytes, static_cast<double>(stats.bytes));
+
+        out.push_back(std::move(hits));
+        out.push_back(std::move(misses));
+        out.push_back(std::move(inserts));
+        out.push_back(std::move(evictions));
+        out.push_back(std::move(expirations));
+        out.push_back(std::move(entries));
+        out.push_back(std::move(bytes));
+    });
+}
+
+void ExportSingleflightMetrics(ScrapeCollector& collector, const Singleflight& flights) {
+    collector.Add([&flights](std::vector<prometheus::MetricFamily>& out) {
+        const auto stats = flights.GetStats();
+
+        auto leaders = MakeFamily("singleflight_leaders_total", "Cached-method executions that ran the handler",
+                                  prometheus::MetricType::Counter);
+        AddCounter(leaders, static_cast<double>(stats.leaders));
+
+        auto coalesced = MakeFamily("singleflight_coalesced_total",
+                                    "Calls that shared an identical in-flight execution", prometheus::MetricType::Counter);
+        AddCounter(coalesced, static_cast<double>(stats.coalesced));
+
+        auto timeouts = MakeFamily("singleflight_wait_timeouts_total",
+                                   "Coalesced calls that gave up before their execution finished",
+                                   prometheus::MetricType::Counter);
+        AddCounter(timeouts, static_cast<double>(stats.timeouts));
+
+        auto waiting = MakeFamily("singleflight_waiting", "Coalesced calls currently waiting",
+                                  prometheus::MetricType::Gauge);
+        AddGauge(waiting, static_cast<double>(stats.waiting));
+
+        out.push_back(std::move(leaders));
+        out.push_back(std::move(coalesced));
+        out.push_back(std::move(timeouts));
+        out.push_back(std::move(waiting));
+    });
+}
+
+void ExportAllocatorMetrics(ScrapeCollector& collector) {
+    collector.Add([](std::vector<prometheus::MetricFamily>& out) {
+        const auto stats = GetAllocatorStats();
+
+        auto info = MakeFamily("allocator_info", "Allocator the binary is linked with", prometheus::MetricType::Gauge);
+        AddGauge(info, 1, {{"allocator", stats.allocator}});
+
+        auto allocated = MakeFamily("allocator_allocated_bytes", "Bytes in live heap allocations",
+                                    prometheus::MetricType::Gauge);
+        AddGauge(allocated, static_cast<double>(stats.allocated));
+        auto active = MakeFamily("allocator_active_bytes", "Bytes in allocator pages that hold live allocations",
+                                 prometheus::MetricType::Gauge);
+        AddGauge(active, static_cast<double>(stats.active));
+        auto resident = MakeFamily("allocator_resident_bytes", "Allocator memory resident in RAM, dirty pages included",
+                                   prometheus::MetricType::Gauge);
+        AddGauge(resident, static_cast<double>(stats.resident));
+        auto mapped = MakeFamily("allocator_mapped_bytes", "Memory the allocator has mapped from the kernel",
+                                 prometheus::MetricType::Gauge);
+        AddGauge(mapped, static_cast<double>(stats.mapped));
+        auto fragmentation = MakeFamily("allocator_fragmentation_ratio",
+                                        "Share of resident allocator memory holding no live allocation",
+                                        prometheus::MetricType::Gauge);
+        AddGauge(fragmentation, stats.fragmentation());
+        auto rss = MakeFamily("process_resident_memory_bytes", "Resident set size of the process",
+                              prometheus::MetricType::Gauge);
+        AddGauge(rss, static_cast<double>(stats.process_resident));
+
+        out.push_back(std::move(info));
+        out.push_back(std::move(allocated));
+        out.push_back(std::move(active));
+        out.push_back(std::move(resident));
+        out.push_back(std::move(mapped));
+        out.push_back(std::move(fragmentation));
+        out.push_back(std::move(rss));
+        if (stats.arenas.empty()) return;
+
+        auto arena_allocated = MakeFamily("allocator_arena_allocated_bytes", "Bytes in live allocations per arena",
+                                          prometheus::MetricType::Gauge);
+        auto arena_active = MakeFamily("allocator_arena_active_bytes", "Bytes in pages with live allocations per arena",
+                                       prometheus::MetricType::Gauge);
+        auto arena_dirty = MakeFamily("allocator_arena_dirty_bytes", "Freed pages each arena keeps resident",
+                                      prometheus::MetricType::Gauge);
+        auto arena_threads = MakeFamily("allocator_arena_threads", "Threads assigned to each arena",
+                                        prometheus::MetricType::Gauge);
+        for (const auto& arena : stats.arenas) {
+            const prometheus::ClientMetric::Label index{"arena", std::to_string(arena.index)};
+            AddGauge(arena_allocated, static_cast<double>(arena.allocated), {index});
+            AddGauge(arena_active, static_cast<double>(arena.active), {index});
+            AddGauge(arena_dirty, static_cast<double>(arena.dirty), {index});
+            AddGauge(arena_threads, static_cast<double>(arena.threads), {index});
+        }
+        out.push_back(std::move(arena_allocated));
+        out.push_back(std::move(arena_active));
+        out.push_back(std::move(arena_dirty));
+        out.push_back(std::move(arena_threads));
+    });
+}
+
+void ExportAbandonedCallMetrics(ScrapeCollector& collector) {
+    collector.Add([](std::vector<prometheus::MetricFamily>& out) {
+        const auto stats = GetAbandonedCallStats();
+
+        auto skipped = MakeFamily("grpc_server_handlers_skipped_total",
+                                  "Handlers not run because the client had given up by the time they were dispatched",
+                                  prometheus::MetricType::Counter);
+        AddCounter(skipped, static_cast<double>(stats.skipped_expired), {{"reason", "deadline_exceeded"}});
+        AddCounter(skipped, static_cast<double>(stats.skipped_cancelled), {{"reason", "cancelled"}});
+
+        auto running = MakeFamily("grpc_server_calls_cancelled_running_total",
+                                  "Calls whose client went away while the handler was running",
+                                  prometheus::MetricType::Counter);
+        AddCounter(running, static_cast<double>(stats.cancelled_running));
+
+        out.push_back(std::move(skipped));
+        out.push_back(std::move(running));
+    });
+}
+
+void ExportInflightMetrics(ScrapeCollector& collector, const InflightTracker& tracker) {
+    collector.Add([&tracker](std::vector<prometheus::MetricFamily>& out) {
+        const auto stats = tracker.GetStats();
+
+        auto inflight = MakeFamily("grpc_inflight_calls", "RPCs currently being served", prometheus::MetricType::Gauge);
+        AddGauge(inflight, static_cast<double>(stats.inflight));
+
+        auto drained = MakeFamily("shutdown_drained_calls", "In-flight RPCs that completed during the shutdown drain",
+                                  prometheus::MetricType::Gauge);
+        AddGauge(drained, static_cast<double>(stats.drained));
+
+        auto cancelled = MakeFamily("shutdown_cancelled_calls",
+                                    "In-flight RPCs still running when the drain deadline passed",
+                                    prometheus::MetricType::Gauge);
+        AddGauge(cancelled, static_cast<double>(stats.cancelled));
+
+        out.push_back(std::move(inflight));
+        out.push_back(std::move(drained));
+        out.push_back(std::move(cancelled));
+    });
+}
+
+void ExportChannelPoolMetrics(ScrapeCollector& collector, const ChannelPool& pool) {
+    collector.Add([&pool](std::vector<prometheus::MetricFamily>& out) {
+        const auto stats = pool.GetStats();
+        const prometheus::ClientMetric::Label name{"pool", pool.name()};
+
+        auto channels = MakeFamily("channel_pool_channels", "Channels (connections) in the outbound pool",
+                                   prometheus::MetricType::Gauge);
+        AddGauge(channels, static_cast<double>(stats.channels.size()), {name});
+
+        auto connected = MakeFamily("channel_pool_connected_channels", "Pooled channels currently READY",
+                                    prometheus::MetricType::Gauge);
+        auto inflight = MakeFamily("channel_pool_inflight", "Outbound calls in flight on each pooled channel",
+                                   prometheus::MetricType::Gauge);
+        auto picks = MakeFamily("channel_pool_picks_total", "Calls assigned to each pooled channel",
+                                prometheus::MetricType::Counter);
+        int ready = 0;
+        for (size_t i = 0; i < stats.channels.size(); ++i) {
+            const auto& channel = stats.channels[i];
+            const prometheus::ClientMetric::Label index{"channel", std::to_string(i)};
+            AddGauge(inflight, static_cast<double>(channel.inflight), {name, index});
+            AddCounter(picks, static_cast<double>(channel.picks), {name, index});
+            if (channel.connected) ++ready;
+        }
+        AddGauge(connected, ready, {name});
+
+        out.push_back(std::move(channels));
+        out.push_back(std::move(connected));
+        out.push_back(std::move(inflight));
+        out.push_back(std::move(picks));
+    });
+}
+
+void ExportConnectionMetrics(ScrapeCollector& collector, const ConnectionMonitor& monitor) {
+    collector.Add([&monitor](std::vector<prometheus::MetricFamily>& out) {
+        const auto stats = monitor.GetStats();
+
+        auto active = MakeFamily("grpc_server_connections", "Open HTTP/2 connections across all shards",
+                                 prometheus::MetricType::Gauge);
+        AddGauge(active, static_cast<double>(stats.active));
+
+        auto opened = MakeFamily("grpc_server_connections_opened_total", "HTTP/2 connections accepted",
+                                 prometheus::MetricType::Counter);
+        AddCounter(opened, static_cast<double>(stats.opened));
+
+        auto closed = MakeFamily("grpc_server_connections_closed_total", "HTTP/2 connections closed for any reason",
+                                 prometheus::MetricType::Counter);
+        AddCounter(closed, static_cast<double>(stats.closed));
+
+        auto aged_out = MakeFamily("grpc_server_connections_aged_out_total",
+                                   "Connections closed after the GOAWAY sent at their max connection age",
+                                   prometheus::MetricType::Counter);
+        AddCounter(aged_out, static_cast<double>(stats.aged_out));
+
+        auto oldest = MakeFamily("grpc_server_connection_oldest_age_seconds", "Age of the oldest open connection",
+                                 prometheus::MetricType::Gauge);
+        AddGauge(oldest, stats.oldest_age_seconds);
+
+        out.push_back(std::move(active));
+        out.push_back(std::move(opened));
+        out.push_back(std::move(closed));
+        out.push_back(std::move(aged_out));
+        out.push_back(std::move(oldest));
+    });
+}
+
+void ExportWarmupMetrics(ScrapeCollector& collector, const WarmupRegistry& warmup) {
+    collector.Add([&warmup](std::vector<prometheus::MetricFamily>& out) {
+        const auto report = warmup.GetReport();
+
+        auto done = MakeFamily("server_warmup_done", "1 once warm-up finished or timed out and health reports SERVING",
+                               prometheus::MetricType::Gauge);
+        AddGauge(done, report.done ? 1 : 0);
+
+        auto duration = MakeFamily("server_warmup_duration_seconds", "Time spent warming up; grows until it is done",
+                                   prometheus::MetricType::Gauge);
+        AddGauge(duration, report.seconds);
+
+        auto tasks = MakeFamily("server_warmup_task_duration_seconds", "Running time of each warm-up task",
+                                prometheus::MetricType::Gauge);
+        for (const auto& task : report.tasks) {
+            AddGauge(tasks, task.seconds, {{"task", task.name}, {"result", WarmupResultName(task.result)}});
+        }
+
+        out.push_back(std::move(done));
+        out.push_back(std::move(duration));
+        out.push_back(std::move(tasks));
+    });
+}
+
+void ExportConcurrencyLimiterMetrics(ScrapeCollector& collector, const ConcurrencyLimiter& limiter) {
+    collector.Add([&limiter](std::vector<prometheus::MetricFamily>& out) {
+        const auto stats = limiter.GetStats();
+
+        auto limit = MakeFamily("concurrency_limit", "Current adaptive concurrency limit",
+                                prometheus::MetricType::Gauge);
+        auto inflight = MakeFamily("concurrency_limit_inflight", "Calls admitted and still running",
+                                   prometheus::MetricType::Gauge);
+        auto rejected = MakeFamily("concurrency_limit_rejected_total",
+                                   "Calls rejected with RESOURCE_EXHAUSTED because the limit was reached",
+                                   prometheus::MetricType::Counter);
+        for (const auto& entry : stats.limits) {
+            const prometheus::ClientMetric::Label method{"method", entry.name};
+            AddGauge(limit, static_cast<double>(entry.limit), {method});
+            AddGauge(inflight, static_cast<double>(entry.inflight), {method});
+            AddCounter(rejected, static_cast<double>(entry.rejected), {method});
+        }
+
+        auto overloaded = MakeFamily("server_overloaded", "1 while calls have been rejected for the overload period",
+                                     prometheus::MetricType::Gauge);
+        AddGauge(overloaded, stats.overloaded ? 1 : 0);
+
+        out.push_back(std::move(limit));
+        out.push_back(std::move(inflight));
+        out.push_back(std::move(rejected));
+        out.push_back(std::move(overloaded));
+    });
+}
+
+void ExportTracingMetrics(ScrapeCollector& collector, const Tracer& tracer) {
+    collector.Add([&tracer](std::vector<prometheus::MetricFamily>& out) {
+        const auto stats = tracer.GetStats();
+
+        auto recorded = MakeFamily("tracing_spans_recorded_total", "Spans finished and handed to the exporter",
+                                   prometheus::MetricType::Counter);
+        AddCounter(recorded, static_cast<double>(stats.spans_recorded));
+
+        auto dropped = MakeFamily("tracing_spans_dropped_total", "Spans lost before they could be exported",
+                                  prometheus::MetricType::Counter);
+        AddCounter(dropped, static_cast<double>(stats.spans_dropped_buffer_full), {{"reason", "buffer_full"}});
+        AddCounter(dropped, static_cast<double>(stats.spans_dropped_pending_full), {{"reason", "pending_full"}});
+        AddCounter(dropped, static_cast<double>(stats.spans_dropped_export_failed), {{"reason", "export_failed"}});
+
+        auto exported = MakeFamily("tracing_spans_exported_total", "Spans accepted by the OTLP collector",
+                                   prometheus::MetricType::Counter);
+        AddCounter(exported, static_cast<double>(stats.spans_exported));
+
+        auto kept = MakeFamily("tracing_traces_kept_total", "Traces kept by tail sampling, by the rule that kept them",
+                               prometheus::MetricType::Counter);
+        AddCounter(kept, static_cast<double>(stats.traces_kept_error), {{"reason", "error"}});
+        AddCounter(kept, static_cast<double>(stats.traces_kept_slow), {{"reason", "slow"}});
+        AddCounter(kept, static_cast<double>(stats.traces_kept_sampled), {{"reason", "sampled"}});
+
+        auto discarded = MakeFamily("tracing_traces_discarded_total", "Fast, successful traces not sampled",
+                                    prometheus::MetricType::Counter);
+        AddCounter(discarded, static_cast<double>(stats.traces_discarded));
+
+        auto pending = MakeFamily("tracing_spans_pending", "Spans waiting for their trace's local root to finish",
+                                  prometheus::MetricType::Gauge);
+        AddGauge(pending, static_cast<double>(stats.pending_spans));
+
+        out.push_back(std::move(recorded));
+        out.push_back(std::move(dropped));
+        out.push_back(std::move(exported));
+        out.push_back(std::move(kept));
+        out.push_back(std::move(discarded));
+        out.push_back(std::move(pending));
+    });
+}
+
+void ExportSaturationMetrics(ScrapeCollector& collector, const SaturationWatchdog& watchdog) {
+    collector.Add([&watchdog](std::vector<prometheus::MetricFamily>& out) {
+        const auto stats = watchdog.GetStats();
+        std::vector<double> bounds;
+        for (int64_t us : kLatencyBoundsUs) bounds.push_back(static_cast<double>(us) / 1e6);
+
+        auto lag = MakeFamily("saturation_probe_lag_seconds",
+                              "Time a watchdog probe waited in a completion queue or executor before it ran",
+                              prometheus::MetricType::Histogram);
+        for (const auto& target : stats.targets) {
+            AddHistogram(lag, bounds, std::vector<uint64_t>(target.lag.buckets.begin(), target.lag.buckets.end()),
+                         target.lag.sum_seconds,
+                         {{"target", WatchdogKindName(target.kind)},
+                          {"shard", target.shard < 0 ? "*" : std::to_string(target.shard)},
+                          {"name", target.name}});
+        }
+
+        auto saturated = MakeFamily("server_saturated", "1 while the shard's scheduling lag stays above the threshold",
+                                    prometheus::MetricType::Gauge);
+        for (size_t i = 0; i < stats.saturated.size(); ++i) {
+            AddGauge(saturated, stats.saturated[i] ? 1 : 0, {{"shard", std::to_string(i)}});
+        }
+
+        out.push_back(std::move(lag));
+        out.push_back(std::move(saturated));
+    });
+}
+
+} // namespace prodstarter
+
+#endif // USE_PROMETHEUS
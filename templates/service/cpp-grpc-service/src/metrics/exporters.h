@@ -0,0 +1,110 @@
+// ProdStarterHub - C++ gRPC Service
+// src/metrics/exporters.h
+// Registers the stats of runtime components with the ScrapeCollector.
+// The exported component must outlive the collector's exposer.
+
+#pragma once
+
+#ifdef USE_PROMETHEUS
+
+#include "metrics/scrape_collector.h"
+
+namespace prodstarter {
+
+class ArenaPool;
+class ChannelPool;
+class CompressionPolicy;
+class ResponseCache;
+class Singleflight;
+class StreamWriterStats;
+class ConcurrencyLimiter;
+class ConnectionMonitor;
+class Executor;
+class InflightTracker;
+class LaneExecutor;
+class LatencyBreakdown;
+class RpcMetrics;
+class SaturationWatchdog;
+class Tracer;
+class TransportMetrics;
+class WarmupRegistry;
+
+// executor_threads, executor_queue_depth{worker}, executor_tasks_submitted_total,
+// executor_tasks_executed_total, executor_steals_total; all labelled with executor="<name>".
+void ExportExecutorMetrics(ScrapeCollector& collector, const Executor& executor);
+
+// executor_lane_queued{lane}, executor_lane_running{lane}, executor_lane_tasks_total{lane}.
+void ExportLaneExecutorMetrics(ScrapeCollector& collector, const LaneExecutor& lanes);
+
+// arena_pool_acquired_total, arena_pool_recycled_total, arena_pool_created_total,
+// arena_pool_discarded_total, arena_bytes_used_total.
+void ExportArenaPoolMetrics(ScrapeCollector& collector, const ArenaPool& pool);
+
+// response_cache_hits_total, response_cache_misses_total, response_cache_inserts_total,
+// response_cache_evictions_total, response_cache_expirations_total, response_cache_entries, response_cache_bytes.
+void ExportResponseCacheMetrics(ScrapeCollector& collector, const ResponseCache& cache);
+
+// singleflight_leaders_total, singleflight_coalesced_total, singleflight_wait_timeouts_total, singleflight_waiting.
+void ExportSingleflightMetrics(ScrapeCollector& collector, const Singleflight& flights);
+
+// stream_writer_streams, stream_writer_queued_bytes, stream_writer_messages_total, stream_writer_flushes_total,
+// stream_writer_backpressure_total.
+void ExportStreamWriterMetrics(ScrapeCollector& collector, const StreamWriterStats& stats);
+
+// grpc_server_compression_messages_total{level}, grpc_server_compression_uncompressed_bytes_total{level},
+// grpc_server_compression_saved_bytes_total{level} and grpc_server_compression_cpu_seconds_total{level}
+// (estimated from sampled messages), grpc_server_compression_skipped_total{reason="below_min_bytes"}.
+void ExportCompressionMetrics(ScrapeCollector& collector, const CompressionPolicy& policy);
+
+// rpc_requests_total{method,code}, rpc_errors_total{method,code} (non-OK codes only),
+// rpc_duration_seconds{method} histogram.
+void ExportRpcMetrics(ScrapeCollector& collector, const RpcMetrics& metrics);
+
+// grpc_server_transport_duration_seconds{transport} histogram (tcp, unix, inproc).
+void ExportTransportMetrics(ScrapeCollector& collector, const TransportMetrics& metrics);
+
+// rpc_phase_seconds{phase} histograms (queue_wait, handler, serialize, write).
+void ExportLatencyBreakdownMetrics(ScrapeCollector& collector, const LatencyBreakdown& latency);
+
+// log_messages_dropped_total, log_messages_sampled_out_total, log_queue_depth.
+void ExportLoggingMetrics(ScrapeCollector& collector);
+
+// allocator_info{allocator}, allocator_allocated_bytes, allocator_active_bytes, allocator_resident_bytes,
+// allocator_mapped_bytes, allocator_fragmentation_ratio, process_resident_memory_bytes and, with jemalloc,
+// allocator_arena_{allocated,active,dirty}_bytes{arena}, allocator_arena_threads{arena}.
+void ExportAllocatorMetrics(ScrapeCollector& collector);
+
+// grpc_server_handlers_skipped_total{reason} (deadline_exceeded, cancelled),
+// grpc_server_calls_cancelled_running_total.
+void ExportAbandonedCallMetrics(ScrapeCollector& collector);
+
+// grpc_inflight_calls, shutdown_drained_calls, shutdown_cancelled_calls.
+void ExportInflightMetrics(ScrapeCollector& collector, const InflightTracker& tracker);
+
+// channel_pool_channels, channel_pool_connected_channels, channel_pool_inflight{channel},
+// channel_pool_picks_total{channel}; all labelled with pool="<name>".
+void ExportChannelPoolMetrics(ScrapeCollector& collector, const ChannelPool& pool);
+
+// grpc_server_connections, grpc_server_connections_opened_total, grpc_server_connections_closed_total,
+// grpc_server_connections_aged_out_total, grpc_server_connection_oldest_age_seconds.
+void ExportConnectionMetrics(ScrapeCollector& collector, const ConnectionMonitor& monitor);
+
+// server_warmup_done, server_warmup_duration_seconds, server_warmup_task_duration_seconds{task,result}.
+void ExportWarmupMetrics(ScrapeCollector& collector, const WarmupRegistry& warmup);
+
+// concurrency_limit{method}, concurrency_limit_inflight{method}, concurrency_limit_rejected_total{method}
+// (method="*" for the server-wide limit), server_overloaded.
+void ExportConcurrencyLimiterMetrics(ScrapeCollector& collector, const ConcurrencyLimiter& limiter);
+
+// tracing_spans_recorded_total, tracing_spans_dropped_total{reason="buffer_full|pending_full|export_failed"},
+// tracing_spans_exported_total, tracing_traces_kept_total{reason="error|slow|sampled"},
+// tracing_traces_discarded_total, tracing_spans_pending.
+void ExportTracingMetrics(ScrapeCollector& collector, const Tracer& tracer);
+
+// saturation_probe_lag_seconds{target="cq|callback|executor|lane",shard,name} (shard="*" for shared executors),
+// server_saturated{shard}.
+void ExportSaturationMetrics(ScrapeCollector& collector, const SaturationWatchdog& watchdog);
+
+} // namespace prodstarter
+
+#endif // USE_PROMETHEUS
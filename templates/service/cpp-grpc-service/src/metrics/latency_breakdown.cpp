@@ -0,0 +1,134 @@
+// ProdStarterHub - C++ gRPC Service
+// src/metrics/latency_breakdown.cpp
+
+#include "metrics/latency_breakdown.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace prodstarter {
+
+namespace {
+int64_t Elapsed(int64_t from_ns, int64_t to_ns) {
+    return std::max<int64_t>(0, to_ns - from_ns);
+}
+} // namespace
+
+const char* LatencyBreakdown::PhaseName(Phase phase) {
+    switch (phase) {
+    case Phase::kQueueWait: return "queue_wait";
+    case Phase::kHandler: return "handler";
+    case Phase::kSerialize: return "serialize";
+    case Phase::kWrite: return "write";
+    case Phase::kCount: break;
+    }
+    return "unknown";
+}
+
+LatencyBreakdown::LatencyBreakdown(size_t slow_call_capacity, std::chrono::seconds slow_call_window)
+    : capacity_(slow_call_capacity),
+      window_(slow_call_window),
+      interval_ns_(std::max<int64_t>(1, std::chrono::nanoseconds(slow_call_window).count() /
+                                            static_cast<int64_t>(kSlowCallIntervals))) {
+    for (auto& interval : slow_) interval.calls.reserve(capacity_);
+}
+
+void LatencyBreakdown::Record(std::string_view method, grpc::StatusCode code, const CallContext& call, int64_t end_ns) {
+    using Mark = CallContext::Mark;
+    // Missing marks collapse onto their predecessor, so a call that never sent
+    // a message reports zero serialize time rather than a bogus gap.
+    const int64_t received = call.at(Mark::kReceived) != 0 ? call.at(Mark::kReceived) : call.arrival();
+    const int64_t dispatched = call.at(Mark::kDispatched) != 0 ? call.at(Mark::kDispatched) : received;
+    const int64_t handler_done = call.at(Mark::kHandlerDone) != 0 ? call.at(Mark::kHandlerDone) : end_ns;
+    const int64_t serialized = call.at(Mark::kSerialized) != 0 ? call.at(Mark::kSerialized) : handler_done;
+    const int64_t written = call.at(Mark::kWritten) != 0 ? call.at(Mark::kWritten) : end_ns;
+
+    std::array<int64_t, kNumPhases> phase_ns{};
+    phase_ns[static_cast<size_t>(Phase::kQueueWait)] = Elapsed(received, dispatched);
+    phase_ns[static_cast<size_t>(Phase::kHandler)] = Elapsed(dispatched, handler_done);
+    phase_ns[static_cast<size_t>(Phase::kSerialize)] = Elapsed(handler_done, serialized);
+    phase_ns[static_cast<size_t>(Phase::kWrite)] = Elapsed(serialized, written);
+
+    std::array<int64_t, kNumPhases> phase_us{};
+    for (size_t i = 0; i < kNumPhases; ++i) {
+        phases_[i].Observe(std::chrono::nanoseconds(phase_ns[i]));
+        phase_us[i] = phase_ns[i] / 1000;
+    }
+
+    if (capacity_ > 0) {
+        const int64_t total_us = Elapsed(call.arrival(), std::max(written, end_ns)) / 1000;
+        const int64_t interval = end_ns / interval_ns_;
+        // The first call of a new interval takes the lock to open it; after that, only calls slower than its
+        // current N-th slowest do.
+        if (interval != admit_interval_.load(std::memory_order_acquire) ||
+            total_us > admit_above_us_.load(std::memory_order_relaxed)) {
+            OfferSlowCall(interval, method, code, total_us, phase_us);
+        }
+    }
+}
+
+void LatencyBreakdown::OfferSlowCall(int64_t interval, std::string_view method, grpc::StatusCode code,
+                                     int64_t total_us, const std::array<int64_t, kNumPhases>& phase_us) {
+    std::lock_guard<std::mutex> lock(slow_mu_);
+    Interval& bucket = slow_[static_cast<size_t>(interval) % kSlowCallIntervals];
+    if (bucket.index > interval) return; // finished just before a boundary another thread already crossed
+    if (bucket.index < interval) {
+        // Reuses the slot of the interval that just left the window.
+        bucket.index = interval;
+        bucket.calls.clear();
+    }
+    if (interval > admit_interval_.load(std::memory_order_relaxed)) {
+        admit_above_us_.store(-1, std::memory_order_relaxed);
+        admit_interval_.store(interval, std::memory_order_release);
+    }
+
+    std::vector<CallRecord>& calls = bucket.calls;
+    auto fastest = std::min_element(calls.begin(), calls.end(), [](const CallRecord& a, const CallRecord& b) {
+        return a.total_us < b.total_us;
+    });
+    CallRecord* slot = nullptr;
+    if (calls.size() < capacity_) {
+        slot = &calls.emplace_back();
+    } else if (fastest != calls.end() && fastest->total_us < total_us) {
+        slot = &*fastest;
+    } else {
+        return;
+    }
+
+    const auto now_us =
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch())
+            .count();
+    slot->method.assign(method.data(), method.size());
+    slot->code = code;
+    slot->total_us = total_us;
+    slot->start_unix_us = now_us - total_us;
+    slot->phase_us = phase_us;
+
+    if (calls.size() == capacity_ && interval == admit_interval_.load(std::memory_order_relaxed)) {
+        const auto min_it = std::min_element(calls.begin(), calls.end(), [](const CallRecord& a, const CallRecord& b) {
+            return a.total_us < b.total_us;
+        });
+        admit_above_us_.store(min_it->total_us, std::memory_order_relaxed);
+    }
+}
+
+ShardedHistogram::Snapshot LatencyBreakdown::CollectPhase(Phase phase) const {
+    return phases_[static_cast<size_t>(phase)].Collect();
+}
+
+std::vector<LatencyBreakdown::CallRecord> LatencyBreakdown::SlowCalls() const {
+    const int64_t now = CallContext::NowNs() / interval_ns_;
+    std::vector<CallRecord> calls;
+    {
+        std::lock_guard<std::mutex> lock(slow_mu_);
+        for (const auto& interval : slow_) {
+            if (interval.index <= now - static_cast<int64_t>(kSlowCallIntervals)) continue; // aged out
+            calls.insert(calls.end(), interval.calls.begin(), interval.calls.end());
+        }
+    }
+    std::sort(calls.begin(), calls.end(), [](const CallRecord& a, const CallRecord& b) { return a.total_us > b.total_us; });
+    if (calls.size() > capacity_) calls.resize(capacity_);
+    return calls;
+}
+
+} // namespace prodstarter
@@ -0,0 +1,89 @@
+// ProdStarterHub - C++ gRPC Service
+// src/metrics/latency_breakdown.h
+// Splits each call's latency into phases and keeps the slowest calls.
+//
+//   queue_wait  request parsed → handler started (engine queues, executor)
+//   handler     handler started → response or status handed to gRPC
+//   serialize   response handed over → response encoded
+//   write       response encoded → send batch completed (slow clients, flow control)
+//
+// Every phase has its own contention-free histogram (rpc_phase_seconds). The
+// N slowest recent calls by total time are kept for the admin SlowCalls RPC.
+// "Recent" is a window split into kSlowCallIntervals intervals, each keeping
+// its own N slowest; the oldest interval is dropped as a new one starts, so a
+// stall at startup ages out instead of hiding today's regression. A call
+// faster than the N-th slowest of its interval is rejected with two atomic
+// loads. Phases are taken from the CallContext timeline (call/call_context.h).
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <grpcpp/support/status.h>
+
+#include "call/call_context.h"
+#include "metrics/sharded_histogram.h"
+
+namespace prodstarter {
+
+class LatencyBreakdown {
+public:
+    enum class Phase { kQueueWait, kHandler, kSerialize, kWrite, kCount };
+    static constexpr size_t kNumPhases = static_cast<size_t>(Phase::kCount);
+
+    struct CallRecord {
+        std::string method;
+        grpc::StatusCode code = grpc::StatusCode::OK;
+        int64_t start_unix_us = 0;
+        int64_t total_us = 0;
+        std::array<int64_t, kNumPhases> phase_us{};
+    };
+
+    static const char* PhaseName(Phase phase);
+
+    static constexpr size_t kSlowCallIntervals = 5;
+
+    // Keeps up to `slow_call_capacity` calls of the last `slow_call_window`; 0 disables the slow-call log.
+    explicit LatencyBreakdown(size_t slow_call_capacity,
+                              std::chrono::seconds slow_call_window = std::chrono::minutes(5));
+
+    // Records a finished call whose last event happened at `end_ns` (steady clock).
+    void Record(std::string_view method, grpc::StatusCode code, const CallContext& call, int64_t end_ns);
+
+    ShardedHistogram::Snapshot CollectPhase(Phase phase) const;
+
+    // The slowest calls that finished within the window, slowest first; at most the capacity.
+    std::vector<CallRecord> SlowCalls() const;
+
+    size_t slow_call_capacity() const { return capacity_; }
+    std::chrono::seconds slow_call_window() const { return window_; }
+
+private:
+    struct Interval {
+        int64_t index = -1; // steady clock time / interval_ns_; -1 while unused
+        std::vector<CallRecord> calls;
+    };
+
+    void OfferSlowCall(int64_t interval, std::string_view method, grpc::StatusCode code, int64_t total_us,
+                       const std::array<int64_t, kNumPhases>& phase_us);
+
+    std::array<ShardedHistogram, kNumPhases> phases_;
+
+    const size_t capacity_;
+    const std::chrono::seconds window_;
+    const int64_t interval_ns_;
+    std::atomic<int64_t> admit_interval_{-1}; // the newest interval; admit_above_us_ belongs to it
+    std::atomic<int64_t> admit_above_us_{-1}; // total of its fastest kept call once full
+    mutable std::mutex slow_mu_;
+    std::array<Interval, kSlowCallIntervals> slow_; // ring indexed by interval % kSlowCallIntervals
+};
+
+} // namespace prodstarter
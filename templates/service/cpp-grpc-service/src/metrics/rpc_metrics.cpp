@@ -0,0 +1,219 @@
+// ProdStarterHub - C++ gRPC Service
+// src/metrics/rpc_metrics.cpp
+
+#include "metrics/rpc_metrics.h"
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+namespace prodstarter {
+
+namespace {
+
+constexpr size_t kOtherMethod = 0;
+
+// Cells are written by one thread only, so a load/store pair replaces a locked read-modify-write.
+inline void Bump(std::atomic<uint64_t>& cell, uint64_t delta) {
+    cell.store(cell.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+}
+
+struct MethodCells {
+    std::array<std::atomic<uint64_t>, RpcMetrics::kNumCodes> codes{};
+    std::array<std::atomic<uint64_t>, RpcMetrics::kNumBuckets> buckets{};
+    std::atomic<uint64_t> sum_us{0};
+};
+
+struct ThreadBlock {
+    ~ThreadBlock() {
+        for (auto& cells : methods) delete cells.load(std::memory_order_relaxed);
+    }
+
+    // Allocated lazily by the owning thread; published with release so a scrape sees initialised cells.
+    std::array<std::atomic<MethodCells*>, RpcMetrics::kMaxMethods> methods{};
+};
+
+} // namespace
+
+struct RpcMetrics::Registry {
+    // Returns the id of `method`, adding it while there is room, and a view of
+    // the interned name that stays valid for the registry's lifetime. Once the
+    // table is full it never changes again and is read without the lock, so
+    // methods counted as "other" do not serialize on mu.
+    std::pair<size_t, std::string_view> Intern(std::string_view method) {
+        if (full.load(std::memory_order_acquire)) return Find(method);
+        std::lock_guard<std::mutex> lock(mu);
+        if (names.size() >= kMaxMethods) return Find(method);
+        auto it = ids.find(method);
+        if (it != ids.end()) return {it->second, it->first};
+        names.emplace_back(method);
+        const size_t id = names.size() - 1;
+        ids.emplace(names.back(), id);
+        if (names.size() >= kMaxMethods) full.store(true, std::memory_order_release);
+        return {id, names.back()};
+    }
+
+    std::pair<size_t, std::string_view> Find(std::string_view method) const {
+        auto it = ids.find(method);
+        if (it != ids.end()) return {it->second, it->first};
+        return {kOtherMethod, {}};
+    }
+
+    ThreadBlock* AcquireBlock() {
+        std::lock_guard<std::mutex> lock(mu);
+        if (!free_blocks.empty()) {
+            ThreadBlock* block = free_blocks.back();
+            free_blocks.pop_back();
+            return block;
+        }
+        blocks.push_back(std::make_unique<ThreadBlock>());
+        return blocks.back().get();
+    }
+
+    void ReleaseBlock(ThreadBlock* block) {
+        std::lock_guard<std::mutex> lock(mu);
+        free_blocks.push_back(block);
+    }
+
+    mutable std::mutex mu;
+    std::deque<std::string> names{"other"}; // index is the method id; deque keeps the strings in place
+    std::unordered_map<std::string_view, size_t> ids;
+    std::atomic<bool> full{false}; // names and ids are frozen
+    std::vector<std::unique_ptr<ThreadBlock>> blocks;
+    std::vector<ThreadBlock*> free_blocks; // blocks of exited threads, counts retained
+};
+
+struct RpcMetrics::ThreadState {
+    ~ThreadState() {
+        if (block != nullptr) registry->ReleaseBlock(block);
+    }
+
+    std::shared_ptr<Registry> registry; // keeps the block alive until this thread exits
+    ThreadBlock* block = nullptr;
+    std::unordered_map<std::string_view, size_t> ids; // keys point into Registry::names
+};
+
+RpcMetrics::ThreadState& RpcMetrics::LocalState() {
+    thread_local ThreadState state;
+    return state;
+}
+
+const std::array<double, RpcMetrics::kNumBuckets - 1>& RpcMetrics::BucketBounds() {
+    static const auto bounds = [] {
+        std::array<double, kNumBuckets - 1> seconds{};
+        for (size_t i = 0; i < seconds.size(); ++i) seconds[i] = static_cast<double>(kLatencyBoundsUs[i]) / 1e6;
+        return seconds;
+    }();
+    return bounds;
+}
+
+RpcMetrics::RpcMetrics() : registry_(std::make_shared<Registry>()) {}
+
+RpcMetrics::~RpcMetrics() = default;
+
+void RpcMetrics::Record(std::string_view method, grpc::StatusCode code, std::chrono::nanoseconds elapsed) {
+    ThreadState& state = LocalState();
+    if (state.registry != registry_) {
+        if (state.block != nullptr) state.registry->ReleaseBlock(state.block);
+        state.ids.clear();
+        state.registry = registry_;
+        state.block = registry_->AcquireBlock();
+    }
+
+    size_t id;
+    auto it = state.ids.find(method);
+    if (it != state.ids.end()) {
+        id = it->second;
+    } else {
+        const auto [interned, name] = registry_->Intern(method);
+        id = interned;
+        // The overflow bucket is not cached: its names are not interned and have no stable key. Intern() no
+        // longer locks once the table is full, which is when such names show up.
+        if (id != kOtherMethod) state.ids.emplace(name, id);
+    }
+
+    MethodCells* cells = state.block->methods[id].load(std::memory_order_relaxed);
+    if (cells == nullptr) {
+        cells = new MethodCells();
+        state.block->methods[id].store(cells, std::memory_order_release);
+    }
+
+    const int code_index = std::clamp(static_cast<int>(code), 0, kNumCodes - 1);
+    const int64_t us = std::max<int64_t>(0, std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+    const size_t bucket = LatencyBucket(us);
+
+    Bump(cells->codes[code_index], 1);
+    Bump(cells->buckets[bucket], 1);
+    Bump(cells->sum_us, static_cast<uint64_t>(us));
+}
+
+std::vector<RpcMetrics::MethodSnapshot> RpcMetrics::Snapshot() const {
+    std::lock_guard<std::mutex> lock(registry_->mu);
+    std::vector<MethodSnapshot> merged(registry_->names.size());
+    for (size_t id = 0; id < merged.size(); ++id) {
+        merged[id].method = registry_->names[id];
+    }
+
+    for (const auto& block : registry_->blocks) {
+        for (size_t id = 0; id < merged.size(); ++id) {
+            const MethodCells* cells = block->methods[id].load(std::memory_order_acquire);
+            if (cells == nullptr) continue;
+            MethodSnapshot& out = merged[id];
+            for (int c = 0; c < kNumCodes; ++c) {
+                const uint64_t n = cells->codes[c].load(std::memory_order_relaxed);
+                out.codes[c] += n;
+                out.count += n;
+            }
+            for (size_t b = 0; b < kNumBuckets; ++b) {
+                out.buckets[b] += cells->buckets[b].load(std::memory_order_relaxed);
+            }
+            out.sum_seconds += static_cast<double>(cells->sum_us.load(std::memory_order_relaxed)) / 1e6;
+        }
+    }
+
+    merged.erase(std::remove_if(merged.begin(), merged.end(), [](const MethodSnapshot& m) { return m.count == 0; }),
+                 merged.end());
+    return merged;
+}
+
+namespace {
+
+class RpcMetricsInterceptor final : public grpc::experimental::Interceptor {
+public:
+    RpcMetricsInterceptor(RpcMetrics& metrics, const char* method)
+        : metrics_(metrics), method_(method != nullptr ? method : ""), start_(std::chrono::steady_clock::now()) {}
+
+    ~RpcMetricsInterceptor() override {
+        if (!recorded_) Finish(grpc::StatusCode::CANCELLED);
+    }
+
+    void Intercept(grpc::experimental::InterceptorBatchMethods* methods) override {
+        if (methods->QueryInterceptionHookPoint(grpc::experimental::InterceptionHookPoints::PRE_SEND_STATUS)) {
+            Finish(methods->GetSendStatus().error_code());
+        }
+        methods->Proceed();
+    }
+
+private:
+    void Finish(grpc::StatusCode code) {
+        recorded_ = true;
+        metrics_.Record(method_, code, std::chrono::steady_clock::now() - start_);
+    }
+
+    RpcMetrics& metrics_;
+    std::string_view method_; // owned by the call, valid while the interceptor lives
+    std::chrono::steady_clock::time_point start_;
+    bool recorded_ = false;
+};
+
+} // namespace
+
+grpc::experimental::Interceptor* RpcMetricsInterceptorFactory::CreateServerInterceptor(
+    grpc::experimental::ServerRpcInfo* info) {
+    return new RpcMetricsInterceptor(metrics_, info->method());
+}
+
+} // namespace prodstarter
@@ -0,0 +1,84 @@
+// ProdStarterHub - C++ gRPC Service
+// src/metrics/rpc_metrics.h
+// Per-method RPC counters and latency histograms recorded by a server interceptor.
+//
+// Every thread that finishes RPCs owns a block of plain cells (one set per
+// method: a counter per status code, histogram buckets and a latency sum).
+// Only the owning thread writes them, so recording a call is a handful of
+// relaxed loads and stores with no locks and no shared cache lines. Blocks are
+// merged when Snapshot() runs, i.e. on a /metrics scrape. A block outlives its
+// thread and is handed to the next new thread, so totals never go backwards.
+//
+// Method names are interned once; each thread caches the name → id lookup.
+// Past kMaxMethods the table is frozen and looked up without a lock, so an
+// unbounded set of names (e.g. the generic engine) lands in "other" cheaply.
+// The duration histogram is per method; status codes only split the counters.
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <grpcpp/support/server_interceptor.h>
+#include <grpcpp/support/status.h>
+
+#include "metrics/sharded_histogram.h"
+
+namespace prodstarter {
+
+class RpcMetrics {
+public:
+    static constexpr int kNumCodes = 17;        // grpc::StatusCode OK .. UNAUTHENTICATED
+    static constexpr size_t kMaxMethods = 512;  // beyond this, methods are counted as "other"
+    static constexpr size_t kNumBuckets = kLatencyBuckets; // kLatencyBoundsUs plus +Inf
+
+    struct MethodSnapshot {
+        std::string method;
+        std::array<uint64_t, kNumCodes> codes{};
+        std::array<uint64_t, kNumBuckets> buckets{}; // per bucket, not cumulative
+        uint64_t count = 0;
+        double sum_seconds = 0;
+    };
+
+    // Upper bounds of the first kNumBuckets - 1 buckets, in seconds.
+    static const std::array<double, kNumBuckets - 1>& BucketBounds();
+
+    RpcMetrics();
+    ~RpcMetrics();
+
+    RpcMetrics(const RpcMetrics&) = delete;
+    RpcMetrics& operator=(const RpcMetrics&) = delete;
+
+    // Records one finished call on the calling thread's block.
+    void Record(std::string_view method, grpc::StatusCode code, std::chrono::nanoseconds elapsed);
+
+    // Merges all thread blocks; methods that saw no calls are skipped.
+    std::vector<MethodSnapshot> Snapshot() const;
+
+private:
+    struct Registry;
+    struct ThreadState;
+    static ThreadState& LocalState();
+
+    std::shared_ptr<Registry> registry_; // shared with thread-local state that may outlive this object
+};
+
+// Records every call's method, status code and latency. The status is taken
+// when the server sends it; calls that end without one count as CANCELLED.
+class RpcMetricsInterceptorFactory : public grpc::experimental::ServerInterceptorFactoryInterface {
+public:
+    explicit RpcMetricsInterceptorFactory(RpcMetrics& metrics) : metrics_(metrics) {}
+
+    grpc::experimental::Interceptor* CreateServerInterceptor(grpc::experimental::ServerRpcInfo* info) override;
+
+private:
+    RpcMetrics& metrics_;
+};
+
+} // namespace prodstarter
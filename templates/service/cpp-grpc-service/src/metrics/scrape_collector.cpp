@@ -0,0 +1,68 @@
+// ProdStarterHub - C++ gRPC Service
+// src/metrics/scrape_collector.cpp
+
+#include "metrics/scrape_collector.h"
+
+#ifdef USE_PROMETHEUS
+
+#include <limits>
+#include <utility>
+
+namespace prodstarter {
+
+void ScrapeCollector::Add(Source source) {
+    std::lock_guard<std::mutex> lock(mu_);
+    sources_.push_back(std::move(source));
+}
+
+std::vector<prometheus::MetricFamily> ScrapeCollector::Collect() const {
+    std::vector<prometheus::MetricFamily> families;
+    std::lock_guard<std::mutex> lock(mu_);
+    for (const auto& source : sources_) {
+        source(families);
+    }
+    return families;
+}
+
+prometheus::MetricFamily MakeFamily(std::string name, std::string help, prometheus::MetricType type) {
+    prometheus::MetricFamily family;
+    family.name = std::move(name);
+    family.help = std::move(help);
+    family.type = type;
+    return family;
+}
+
+void AddCounter(prometheus::MetricFamily& family, double value, std::vector<prometheus::ClientMetric::Label> labels) {
+    prometheus::ClientMetric metric;
+    metric.label = std::move(labels);
+    metric.counter.value = value;
+    family.metric.push_back(std::move(metric));
+}
+
+void AddGauge(prometheus::MetricFamily& family, double value, std::vector<prometheus::ClientMetric::Label> labels) {
+    prometheus::ClientMetric metric;
+    metric.label = std::move(labels);
+    metric.gauge.value = value;
+    family.metric.push_back(std::move(metric));
+}
+
+void AddHistogram(prometheus::MetricFamily& family, const std::vector<double>& bounds,
+                  const std::vector<uint64_t>& counts, double sum, std::vector<prometheus::ClientMetric::Label> labels) {
+    prometheus::ClientMetric metric;
+    metric.label = std::move(labels);
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i < counts.size(); ++i) {
+        cumulative += counts[i];
+        prometheus::ClientMetric::Bucket bucket;
+        bucket.cumulative_count = cumulative;
+        bucket.upper_bound = i < bounds.size() ? bounds[i] : std::numeric_limits<double>::infinity();
+        metric.histogram.bucket.push_back(bucket);
+    }
+    metric.histogram.sample_count = cumulative;
+    metric.histogram.sample_sum = sum;
+    family.metric.push_back(std::move(metric));
+}
+
+} // namespace prodstarter
+
+#endif // USE_PROMETHEUS
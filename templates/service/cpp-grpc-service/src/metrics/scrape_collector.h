@@ -0,0 +1,52 @@
+// ProdStarterHub - C++ gRPC Service
+// src/metrics/scrape_collector.h
+// prometheus-cpp Collectable that builds metric families on scrape.
+//
+// Runtime components keep their own cheap counters (atomics, thread-local
+// shards) and expose plain stats snapshots. Sources registered here turn those
+// snapshots into MetricFamily values only when /metrics is scraped, so the hot
+// path never touches prometheus-cpp objects or their mutexes.
+
+#pragma once
+
+#ifdef USE_PROMETHEUS
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <prometheus/collectable.h>
+#include <prometheus/metric_family.h>
+
+namespace prodstarter {
+
+class ScrapeCollector : public prometheus::Collectable {
+public:
+    // Appends the families of one component to `out`.
+    using Source = std::function<void(std::vector<prometheus::MetricFamily>& out)>;
+
+    void Add(Source source);
+
+    std::vector<prometheus::MetricFamily> Collect() const override;
+
+private:
+    mutable std::mutex mu_;
+    std::vector<Source> sources_;
+};
+
+// Helpers for building families inside a Source.
+prometheus::MetricFamily MakeFamily(std::string name, std::string help, prometheus::MetricType type);
+void AddCounter(prometheus::MetricFamily& family, double value,
+                std::vector<prometheus::ClientMetric::Label> labels = {});
+void AddGauge(prometheus::MetricFamily& family, double value,
+              std::vector<prometheus::ClientMetric::Label> labels = {});
+// `counts` holds one non-cumulative count per bound plus a final +Inf bucket.
+void AddHistogram(prometheus::MetricFamily& family, const std::vector<double>& bounds,
+                  const std::vector<uint64_t>& counts, double sum,
+                  std::vector<prometheus::ClientMetric::Label> labels = {});
+
+} // namespace prodstarter
+
+#endif // USE_PROMETHEUS
@@ -0,0 +1,50 @@
+// ProdStarterHub - C++ gRPC Service
+// src/metrics/sharded_counter.h
+// Contention-free counters for per-call hot paths.
+//
+// A ShardedCounter spreads updates over cache-line sized cells picked by the
+// calling thread, so concurrent RPC threads never bounce the same line.
+// Reads sum all cells and are meant for scrapes and shutdown bookkeeping.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace prodstarter {
+
+constexpr size_t kCounterShards = 32;
+
+// Cell index of the calling thread, assigned round-robin on first use.
+inline size_t ThisThreadShard() {
+    static std::atomic<size_t> next{0};
+    thread_local const size_t shard = next.fetch_add(1, std::memory_order_relaxed) % kCounterShards;
+    return shard;
+}
+
+class ShardedCounter {
+public:
+    void Add(int64_t delta) {
+        cells_[ThisThreadShard()].value.fetch_add(delta, std::memory_order_relaxed);
+    }
+
+    // Individual cells may go negative when a value is incremented on one thread
+    // and decremented on another; the sum is always exact.
+    int64_t Sum() const {
+        int64_t sum = 0;
+        for (const auto& cell : cells_) {
+            sum += cell.value.load(std::memory_order_relaxed);
+        }
+        return sum;
+    }
+
+private:
+    struct alignas(64) Cell {
+        std::atomic<int64_t> value{0};
+    };
+    std::array<Cell, kCounterShards> cells_;
+};
+
+} // namespace prodstarter
@@ -0,0 +1,73 @@
+// ProdStarterHub - C++ gRPC Service
+// src/metrics/sharded_histogram.h
+// Contention-free latency histogram for per-call hot paths.
+//
+// Like ShardedCounter, updates go to a cache-line aligned shard picked by the
+// calling thread. A shard holds all buckets and the sum (144 bytes, three
+// lines), so an observation touches at most two lines, its bucket's and the
+// sum's, and none shared with another shard. Collect() merges the shards into
+// a Snapshot for a scrape.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include "metrics/sharded_counter.h"
+
+namespace prodstarter {
+
+// Shared latency bucket bounds in microseconds (100 us .. 10 s); a final +Inf bucket follows.
+constexpr std::array<int64_t, 16> kLatencyBoundsUs = {
+    100, 250, 500, 1000, 2500, 5000, 10000, 25000, 50000, 100000, 250000, 500000, 1000000, 2500000, 5000000, 10000000,
+};
+constexpr size_t kLatencyBuckets = kLatencyBoundsUs.size() + 1;
+
+inline size_t LatencyBucket(int64_t us) {
+    return static_cast<size_t>(std::lower_bound(kLatencyBoundsUs.begin(), kLatencyBoundsUs.end(), us) -
+                               kLatencyBoundsUs.begin());
+}
+
+class ShardedHistogram {
+public:
+    struct Snapshot {
+        std::array<uint64_t, kLatencyBuckets> buckets{}; // per bucket, not cumulative
+        uint64_t count = 0;
+        double sum_seconds = 0;
+    };
+
+    void Observe(std::chrono::nanoseconds elapsed) {
+        const int64_t us = std::max<int64_t>(0, std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+        Shard& shard = shards_[ThisThreadShard()];
+        shard.buckets[LatencyBucket(us)].fetch_add(1, std::memory_order_relaxed);
+        shard.sum_us.fetch_add(static_cast<uint64_t>(us), std::memory_order_relaxed);
+    }
+
+    Snapshot Collect() const {
+        Snapshot out;
+        uint64_t sum_us = 0;
+        for (const auto& shard : shards_) {
+            for (size_t b = 0; b < kLatencyBuckets; ++b) {
+                const uint64_t n = shard.buckets[b].load(std::memory_order_relaxed);
+                out.buckets[b] += n;
+                out.count += n;
+            }
+            sum_us += shard.sum_us.load(std::memory_order_relaxed);
+        }
+        out.sum_seconds = static_cast<double>(sum_us) / 1e6;
+        return out;
+    }
+
+private:
+    struct alignas(64) Shard {
+        std::array<std::atomic<uint64_t>, kLatencyBuckets> buckets{};
+        std::atomic<uint64_t> sum_us{0};
+    };
+    std::array<Shard, kCounterShards> shards_;
+};
+
+} // namespace prodstarter
@@ -0,0 +1,50 @@
+// ProdStarterHub - C++ gRPC Service
+// src/metrics/transport_metrics.cpp
+
+#include "metrics/transport_metrics.h"
+
+#include <chrono>
+
+#include <grpcpp/server_context.h>
+
+namespace prodstarter {
+
+namespace {
+
+class TransportInterceptor final : public grpc::experimental::Interceptor {
+public:
+    TransportInterceptor(TransportMetrics& metrics, Transport transport)
+        : metrics_(metrics), transport_(transport), start_(std::chrono::steady_clock::now()) {}
+
+    ~TransportInterceptor() override { metrics_.Record(transport_, std::chrono::steady_clock::now() - start_); }
+
+    void Intercept(grpc::experimental::InterceptorBatchMethods* methods) override { methods->Proceed(); }
+
+private:
+    TransportMetrics& metrics_;
+    const Transport transport_;
+    const std::chrono::steady_clock::time_point start_;
+};
+
+} // namespace
+
+const char* TransportName(Transport transport) {
+    switch (transport) {
+    case Transport::kTcp: return "tcp";
+    case Transport::kUnix: return "unix";
+    default: return "inproc";
+    }
+}
+
+Transport TransportOfPeer(std::string_view peer) {
+    if (peer.substr(0, 5) == "ipv4:" || peer.substr(0, 5) == "ipv6:") return Transport::kTcp;
+    if (peer.substr(0, 5) == "unix:" || peer.substr(0, 14) == "unix-abstract:") return Transport::kUnix;
+    return Transport::kInProcess;
+}
+
+grpc::experimental::Interceptor* TransportInterceptorFactory::CreateServerInterceptor(
+    grpc::experimental::ServerRpcInfo* info) {
+    return new TransportInterceptor(metrics_, TransportOfPeer(info->server_context()->peer()));
+}
+
+} // namespace prodstarter
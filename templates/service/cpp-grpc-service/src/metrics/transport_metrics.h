@@ -0,0 +1,61 @@
+// ProdStarterHub - C++ gRPC Service
+// src/metrics/transport_metrics.h
+// Call latency split by the transport a call arrived on.
+//
+// Co-located callers can reach the server over TCP (possibly with TLS), over
+// a unix domain socket (--unix-listen) or, inside the binary, over the
+// in-process channel (server/in_process_channels.h). The interceptor reads
+// the call's peer ("ipv4:...", "unix:...", anything else is in-process) and
+// records the call's duration under that transport, which is what shows
+// whether moving a sidecar to a socket paid off:
+//
+//   grpc_server_transport_duration_seconds{transport="tcp|unix|inproc"}
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <string_view>
+
+#include <grpcpp/support/server_interceptor.h>
+
+#include "metrics/sharded_histogram.h"
+
+namespace prodstarter {
+
+enum class Transport { kTcp, kUnix, kInProcess };
+
+constexpr size_t kNumTransports = 3;
+
+const char* TransportName(Transport transport);
+
+// Transport of a call whose ServerContext::peer() is `peer`.
+Transport TransportOfPeer(std::string_view peer);
+
+class TransportMetrics {
+public:
+    void Record(Transport transport, std::chrono::nanoseconds elapsed) {
+        histograms_[static_cast<size_t>(transport)].Observe(elapsed);
+    }
+
+    ShardedHistogram::Snapshot Collect(Transport transport) const {
+        return histograms_[static_cast<size_t>(transport)].Collect();
+    }
+
+private:
+    std::array<ShardedHistogram, kNumTransports> histograms_;
+};
+
+// Records every call's duration, from its start until the interceptor is released, under its transport.
+class TransportInterceptorFactory : public grpc::experimental::ServerInterceptorFactoryInterface {
+public:
+    explicit TransportInterceptorFactory(TransportMetrics& metrics) : metrics_(metrics) {}
+
+    grpc::experimental::Interceptor* CreateServerInterceptor(grpc::experimental::ServerRpcInfo* info) override;
+
+private:
+    TransportMetrics& metrics_;
+};
+
+} // namespace prodstarter
@@ -0,0 +1,312 @@
+// ProdStarterHub - C++ gRPC Service
+// src/overload/concurrency_limiter.cpp
+
+#include "overload/concurrency_limiter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include <spdlog/spdlog.h>
+
+#include "call/call_context.h"
+#include "server/health_reporter.h"
+
+namespace prodstarter {
+
+namespace {
+
+using grpc::experimental::InterceptionHookPoints;
+
+constexpr double kAimdBackoff = 0.9;
+constexpr double kGradientTolerance = 1.5; // latency may grow by this much before the limit shrinks
+constexpr double kGradientSmoothing = 0.2;
+constexpr double kLongRttWeight = 0.05;    // ~20 windows of history
+constexpr int64_t kEpisodeGapNs = 1000000000; // a second without rejections ends a burst
+
+int64_t NowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+uint64_t PackBounds(int min_limit, int max_limit) {
+    return static_cast<uint64_t>(min_limit) << 32 | static_cast<uint32_t>(max_limit);
+}
+
+bool IsDrop(grpc::StatusCode code) {
+    return code == grpc::StatusCode::DEADLINE_EXCEEDED || code == grpc::StatusCode::RESOURCE_EXHAUSTED ||
+           code == grpc::StatusCode::UNAVAILABLE;
+}
+
+} // namespace
+
+struct ConcurrencyLimiter::Limit {
+    Limit(std::string limit_name, double initial)
+        : name(std::move(limit_name)), limit(std::llround(initial)), estimate(initial) {}
+
+    const std::string name;
+
+    // Admission, touched by every call.
+    alignas(64) std::atomic<int64_t> inflight{0};
+    std::atomic<int64_t> limit;
+    std::atomic<uint64_t> rejected{0};
+
+    // Samples of the current window, drained by Recompute().
+    alignas(64) std::atomic<int64_t> samples{0};
+    std::atomic<int64_t> latency_sum_ns{0};
+    std::atomic<int64_t> drops{0};
+    std::atomic<int64_t> peak_inflight{0};
+    std::atomic<int64_t> window_end_ns{0};
+
+    // Algorithm state, owned by whichever thread holds update_mu.
+    std::mutex update_mu;
+    double estimate;
+    double long_rtt_ns = 0;
+};
+
+ConcurrencyLimiter::ConcurrencyLimiter(LimiterOptions options)
+    : options_(std::move(options)),
+      gradient_(options_.algorithm == "gradient"),
+      bounds_(PackBounds(options_.min_limit, options_.max_limit)),
+      global_(MakeLimit(options_.per_method ? "other" : "*")) {}
+
+ConcurrencyLimiter::~ConcurrencyLimiter() {
+    Stop();
+}
+
+std::unique_ptr<ConcurrencyLimiter::Limit> ConcurrencyLimiter::MakeLimit(std::string name) const {
+    const auto [lo, hi] = Bounds();
+    const double initial = std::clamp(static_cast<double>(options_.initial_limit), lo, hi);
+    return std::make_unique<Limit>(std::move(name), initial);
+}
+
+ConcurrencyLimiter::Limit* ConcurrencyLimiter::LimitFor(std::string_view method) {
+    for (const auto& prefix : options_.exempt_prefixes) {
+        if (method.substr(0, prefix.size()) == prefix) return nullptr;
+    }
+    if (!options_.per_method) return global_.get();
+
+    {
+        std::shared_lock<std::shared_mutex> lock(mu_);
+        auto it = methods_.find(method);
+        if (it != methods_.end()) return it->second.get();
+    }
+    std::unique_lock<std::shared_mutex> lock(mu_);
+    auto it = methods_.find(method);
+    if (it != methods_.end()) return it->second.get();
+    if (methods_.size() >= kMaxMethods) return global_.get();
+    auto limit = MakeLimit(std::string(method));
+    Limit* raw = limit.get();
+    methods_.emplace(std::string_view(raw->name), std::move(limit)); // the key points into the limit's name
+    return raw;
+}
+
+bool ConcurrencyLimiter::TryAcquire(Limit* limit) {
+    const int64_t inflight = limit->inflight.fetch_add(1, std::memory_order_relaxed) + 1;
+    if (inflight > limit->limit.load(std::memory_order_relaxed)) {
+        limit->inflight.fetch_sub(1, std::memory_order_relaxed);
+        limit->rejected.fetch_add(1, std::memory_order_relaxed);
+        rejected_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    int64_t peak = limit->peak_inflight.load(std::memory_order_relaxed);
+    while (inflight > peak &&
+           !limit->peak_inflight.compare_exchange_weak(peak, inflight, std::memory_order_relaxed)) {
+    }
+    return true;
+}
+
+void ConcurrencyLimiter::Release(Limit* limit, std::chrono::nanoseconds latency, grpc::StatusCode code,
+                                 bool finished) {
+    limit->inflight.fetch_sub(1, std::memory_order_relaxed);
+    if (!finished) return;
+
+    const bool slow = options_.latency_target.count() > 0 && latency > options_.latency_target;
+    limit->samples.fetch_add(1, std::memory_order_relaxed);
+    limit->latency_sum_ns.fetch_add(latency.count(), std::memory_order_relaxed);
+    if (IsDrop(code) || slow) limit->drops.fetch_add(1, std::memory_order_relaxed);
+
+    const int64_t now = NowNs();
+    if (now >= limit->window_end_ns.load(std::memory_order_relaxed)) Recompute(*limit, now);
+}
+
+void ConcurrencyLimiter::Recompute(Limit& limit, int64_t now_ns) {
+    // One thread per window does the update; the others keep serving.
+    std::unique_lock<std::mutex> lock(limit.update_mu, std::try_to_lock);
+    if (!lock.owns_lock() || now_ns < limit.window_end_ns.load(std::memory_order_relaxed)) return;
+    limit.window_end_ns.store(now_ns + std::chrono::nanoseconds(options_.window).count(), std::memory_order_relaxed);
+
+    const int64_t samples = limit.samples.exchange(0, std::memory_order_relaxed);
+    const int64_t latency_sum = limit.latency_sum_ns.exchange(0, std::memory_order_relaxed);
+    const int64_t drops = limit.drops.exchange(0, std::memory_order_relaxed);
+    const int64_t peak = limit.peak_inflight.exchange(limit.inflight.load(std::memory_order_relaxed),
+                                                      std::memory_order_relaxed);
+    if (samples == 0) return;
+
+    const double current = limit.estimate;
+    // Less than half the limit in use: the calls say nothing about a higher limit.
+    const bool app_limited = static_cast<double>(peak) * 2 < current;
+    double next = current;
+    if (gradient_) {
+        const double short_rtt = std::max(1.0, static_cast<double>(latency_sum) / static_cast<double>(samples));
+        double& long_rtt = limit.long_rtt_ns;
+        long_rtt = long_rtt == 0 ? short_rtt : long_rtt + (short_rtt - long_rtt) * kLongRttWeight;
+        // After an overload the average lags far behind the recovered latency; let it catch up.
+        if (long_rtt / short_rtt > 2) long_rtt *= 0.95;
+        if (!app_limited) {
+            const double gradient = std::clamp(kGradientTolerance * long_rtt / short_rtt, 0.5, 1.0);
+            const double target = current * gradient + std::sqrt(current);
+            next = current * (1 - kGradientSmoothing) + target * kGradientSmoothing;
+        }
+    } else if (drops > 0) {
+        next = current * kAimdBackoff;
+    } else if (!app_limited) {
+        next = current + static_cast<double>(samples) / current;
+    }
+
+    const auto [lo, hi] = Bounds();
+    next = std::clamp(next, lo, hi);
+    limit.estimate = next;
+    limit.limit.store(std::llround(next), std::memory_order_relaxed);
+}
+
+std::pair<double, double> ConcurrencyLimiter::Bounds() const {
+    const uint64_t bounds = bounds_.load(std::memory_order_relaxed);
+    return {static_cast<double>(bounds >> 32), static_cast<double>(bounds & 0xffffffff)};
+}
+
+void ConcurrencyLimiter::Clamp(Limit& limit) const {
+    const auto [lo, hi] = Bounds();
+    std::lock_guard<std::mutex> lock(limit.update_mu);
+    limit.estimate = std::clamp(limit.estimate, lo, hi);
+    limit.limit.store(std::llround(limit.estimate), std::memory_order_relaxed);
+}
+
+void ConcurrencyLimiter::SetBounds(int min_limit, int max_limit) {
+    bounds_.store(PackBounds(min_limit, max_limit), std::memory_order_relaxed);
+    Clamp(*global_);
+    std::shared_lock<std::shared_mutex> lock(mu_);
+    for (const auto& entry : methods_) Clamp(*entry.second);
+}
+
+void ConcurrencyLimiter::Start(HealthReporter* health) {
+    std::lock_guard<std::mutex> lock(monitor_mu_);
+    if (monitor_.joinable()) return;
+    health_ = options_.health_service.empty() ? nullptr : health;
+    // NOT_SERVING until the first window; from then on the monitor re-asserts the current state every window.
+    if (health_ != nullptr) health_->SetServingStatus(options_.health_service, false);
+    monitor_ = std::thread(&ConcurrencyLimiter::Monitor, this);
+}
+
+void ConcurrencyLimiter::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(monitor_mu_);
+        stopping_ = true;
+        monitor_cv_.notify_all();
+    }
+    if (monitor_.joinable()) monitor_.join();
+}
+
+void ConcurrencyLimiter::Monitor() {
+    const int64_t hold_ns = std::chrono::nanoseconds(options_.overload_after).count();
+    uint64_t seen = rejected_.load(std::memory_order_relaxed);
+    int64_t episode_start = 0; // first rejection of the current burst, 0 when calm
+    int64_t last_reject = 0;
+
+    std::unique_lock<std::mutex> lock(monitor_mu_);
+    while (!monitor_cv_.wait_for(lock, options_.window, [this] { return stopping_; })) {
+        const int64_t now = NowNs();
+        const uint64_t total = rejected_.load(std::memory_order_relaxed);
+        if (total != seen) {
+            seen = total;
+            last_reject = now;
+            if (episode_start == 0) episode_start = now;
+        }
+
+        if (!overloaded_.load(std::memory_order_relaxed)) {
+            if (episode_start != 0 && now - last_reject > kEpisodeGapNs) episode_start = 0;
+            if (episode_start != 0 && now - episode_start >= hold_ns) {
+                overloaded_.store(true, std::memory_order_relaxed);
+                spdlog::warn("Overloaded: calls rejected for {} ms, {} rejected so far",
+                             (now - episode_start) / 1000000, total);
+            }
+        } else if (now - last_reject >= hold_ns) {
+            overloaded_.store(false, std::memory_order_relaxed);
+            episode_start = 0;
+            spdlog::info("Overload cleared: no call rejected for {} ms", options_.overload_after.count());
+        }
+
+        // Every window, not only on transitions, so a status someone else overwrote is put right; HealthReporter
+        // skips unchanged ones.
+        if (health_ != nullptr) health_->SetServingStatus(options_.health_service, !overloaded());
+    }
+}
+
+ConcurrencyLimiter::Stats ConcurrencyLimiter::GetStats() const {
+    auto snapshot = [](const Limit& limit) {
+        LimitStats stats;
+        stats.name = limit.name;
+        stats.limit = limit.limit.load(std::memory_order_relaxed);
+        stats.inflight = limit.inflight.load(std::memory_order_relaxed);
+        stats.rejected = limit.rejected.load(std::memory_order_relaxed);
+        return stats;
+    };
+
+    Stats stats;
+    stats.rejected = rejected_.load(std::memory_order_relaxed);
+    stats.overloaded = overloaded();
+    stats.limits.push_back(snapshot(*global_));
+    std::shared_lock<std::shared_mutex> lock(mu_);
+    for (const auto& entry : methods_) stats.limits.push_back(snapshot(*entry.second));
+    return stats;
+}
+
+namespace {
+
+class LimiterInterceptor final : public grpc::experimental::Interceptor {
+public:
+    LimiterInterceptor(grpc::experimental::ServerRpcInfo* info, ConcurrencyLimiter& limiter)
+        : limiter_(limiter),
+          limit_(limiter.LimitFor(info->method() != nullptr ? info->method() : "")),
+          start_(std::chrono::steady_clock::now()) {
+        if (limit_ == nullptr) return;
+        admitted_ = limiter_.TryAcquire(limit_);
+        if (!admitted_) {
+            if (CallContext* call = FindCallContext(info->server_context())) call->Reject();
+        }
+    }
+
+    ~LimiterInterceptor() override {
+        if (admitted_) limiter_.Release(limit_, std::chrono::steady_clock::now() - start_, code_, finished_);
+    }
+
+    void Intercept(grpc::experimental::InterceptorBatchMethods* methods) override {
+        if (limit_ != nullptr && methods->QueryInterceptionHookPoint(InterceptionHookPoints::PRE_SEND_STATUS)) {
+            if (admitted_) {
+                code_ = methods->GetSendStatus().error_code();
+                finished_ = true;
+            } else if (methods->GetSendStatus().error_code() != grpc::StatusCode::RESOURCE_EXHAUSTED) {
+                // The handler ran anyway (a sync handler that does not check BeginHandler()).
+                methods->ModifySendStatus(OverloadStatus());
+            }
+        }
+        methods->Proceed();
+    }
+
+private:
+    ConcurrencyLimiter& limiter_;
+    ConcurrencyLimiter::Limit* limit_; // null for exempt methods
+    const std::chrono::steady_clock::time_point start_;
+    bool admitted_ = false;
+    bool finished_ = false;
+    grpc::StatusCode code_ = grpc::StatusCode::OK;
+};
+
+} // namespace
+
+grpc::experimental::Interceptor* LimiterInterceptorFactory::CreateServerInterceptor(
+    grpc::experimental::ServerRpcInfo* info) {
+    return new LimiterInterceptor(info, limiter_);
+}
+
+} // namespace prodstarter
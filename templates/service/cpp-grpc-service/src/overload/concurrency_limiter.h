@@ -0,0 +1,171 @@
+// ProdStarterHub - C++ gRPC Service
+// src/overload/concurrency_limiter.h
+// Adaptive concurrency limit and load shedding (enable with --limiter aimd|gradient).
+//
+// A fixed thread pool or queue bound says nothing about how much work the
+// server can finish in time; the limiter learns it from the calls themselves.
+// Each limit (one for the server, or one per method with --limiter-scope
+// method) admits calls while fewer than `limit` are in flight and rejects the
+// rest with RESOURCE_EXHAUSTED before their handler runs, so excess load fails
+// fast instead of queueing until every call misses its deadline. Every window
+// the limit is recomputed from the calls that finished in it:
+//
+//   aimd      +1 per `limit` successful calls; x0.9 when a window saw drops
+//             (DEADLINE_EXCEEDED, RESOURCE_EXHAUSTED or UNAVAILABLE from the
+//             handler, or latency above --limiter-latency-ms)
+//   gradient  limit * clamp(1.5 * long_rtt / short_rtt, 0.5, 1) + sqrt(limit),
+//             smoothed; grows while latency stays near its long-term average
+//             and shrinks as soon as queueing inflates it
+//
+// The limit only grows while at least half of it is in use, so an idle server
+// does not drift towards max. Health, reflection and admin calls are never
+// limited.
+//
+// With --engine=sync the handler runs on gRPC's threads before the limiter can
+// skip it, so sync handlers only shed load when they open with
+//   if (!BeginHandler(ctx)) return SkippedStatus(ctx);
+// Otherwise a rejected call still does all its work and only its status is
+// rewritten to RESOURCE_EXHAUSTED.
+//
+// When calls keep being rejected for --overload-after-ms, the limiter marks the
+// server overloaded and sets --overload-health-service to NOT_SERVING, so load
+// balancers that watch that name move traffic elsewhere; it returns to SERVING
+// once no call was rejected for the same period. The status is re-sent every
+// window, and HealthReporter keeps it NOT_SERVING until the server is ready.
+//
+// SetBounds() moves min_limit and max_limit while the server runs (see
+// config/runtime_config.h); each limit is clamped into the new range at once
+// and keeps adapting inside it.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <grpcpp/support/server_interceptor.h>
+#include <grpcpp/support/status.h>
+
+namespace prodstarter {
+
+class HealthReporter;
+
+struct LimiterOptions {
+    std::string algorithm = "gradient"; // aimd | gradient
+    bool per_method = false;            // one limit per method instead of one for the server
+    int initial_limit = 64;
+    int min_limit = 4;
+    int max_limit = 1024;
+    std::chrono::milliseconds window{100};        // how often each limit is recomputed
+    std::chrono::milliseconds latency_target{0};  // aimd: slower calls count as drops; 0 disables
+    std::string health_service;                   // flipped under sustained overload; empty disables
+    std::chrono::milliseconds overload_after{5000};
+    // Calls whose method starts with one of these are neither limited nor counted.
+    std::vector<std::string> exempt_prefixes{"/grpc.health.", "/grpc.reflection.", "/prodstarter.admin."};
+};
+
+class ConcurrencyLimiter {
+public:
+    static constexpr size_t kMaxMethods = 512; // with per_method, later methods share the "other" limit
+
+    struct Limit; // one admission counter and its algorithm state
+
+    struct LimitStats {
+        std::string name; // method, "*" for the server-wide limit
+        int64_t limit = 0;
+        int64_t inflight = 0;
+        uint64_t rejected = 0;
+    };
+    struct Stats {
+        std::vector<LimitStats> limits;
+        uint64_t rejected = 0;
+        bool overloaded = false;
+    };
+
+    explicit ConcurrencyLimiter(LimiterOptions options);
+    ~ConcurrencyLimiter();
+
+    ConcurrencyLimiter(const ConcurrencyLimiter&) = delete;
+    ConcurrencyLimiter& operator=(const ConcurrencyLimiter&) = delete;
+
+    // The limit that governs `method`, or null for exempt methods.
+    Limit* LimitFor(std::string_view method);
+
+    // Counts a call against `limit`. False when the limit is reached; the call
+    // must then be rejected and not passed to Release().
+    bool TryAcquire(Limit* limit);
+
+    // Ends an admitted call. `finished` is false when no status was sent (the
+    // call was cancelled); such calls free their slot without a sample.
+    void Release(Limit* limit, std::chrono::nanoseconds latency, grpc::StatusCode code, bool finished);
+
+    // Starts the overload monitor. `health` may be null; otherwise the
+    // configured health service is set to NOT_SERVING now and to the current
+    // state every window from the first one on.
+    void Start(HealthReporter* health);
+
+    // Stops the monitor. Call before the overall health status goes NOT_SERVING
+    // at shutdown, so a late recovery cannot flip the named service back.
+    void Stop();
+
+    // Replaces options().min_limit and max_limit; requires 1 <= min_limit <= max_limit.
+    void SetBounds(int min_limit, int max_limit);
+
+    int min_limit() const { return static_cast<int>(bounds_.load(std::memory_order_relaxed) >> 32); }
+    int max_limit() const { return static_cast<int>(bounds_.load(std::memory_order_relaxed) & 0xffffffff); }
+
+    bool overloaded() const { return overloaded_.load(std::memory_order_relaxed); }
+    const LimiterOptions& options() const { return options_; } // min_limit and max_limit as started
+    Stats GetStats() const;
+
+private:
+    std::unique_ptr<Limit> MakeLimit(std::string name) const;
+    void Recompute(Limit& limit, int64_t now_ns);
+    void Clamp(Limit& limit) const;
+    // min_limit and max_limit, read together so a concurrent SetBounds() cannot pair an old one with a new one.
+    std::pair<double, double> Bounds() const;
+    void Monitor();
+
+    const LimiterOptions options_;
+    const bool gradient_;
+    std::atomic<uint64_t> bounds_; // min_limit << 32 | max_limit
+
+    mutable std::shared_mutex mu_; // guards methods_
+    std::unordered_map<std::string_view, std::unique_ptr<Limit>> methods_; // keyed by Limit::name
+    std::unique_ptr<Limit> global_; // the server-wide limit, or "other" with per_method
+
+    std::atomic<uint64_t> rejected_{0};
+    std::atomic<bool> overloaded_{false};
+
+    HealthReporter* health_ = nullptr;
+    std::mutex monitor_mu_;
+    std::condition_variable monitor_cv_;
+    bool stopping_ = false;
+    std::thread monitor_;
+};
+
+// Admits or rejects each call against the ConcurrencyLimiter. Install it right
+// after CallContextInterceptorFactory: a rejected call is marked on its
+// CallContext so the engines skip its handler (see BeginHandler()), and its
+// status is forced to RESOURCE_EXHAUSTED for handlers that do not check.
+class LimiterInterceptorFactory : public grpc::experimental::ServerInterceptorFactoryInterface {
+public:
+    explicit LimiterInterceptorFactory(ConcurrencyLimiter& limiter) : limiter_(limiter) {}
+
+    grpc::experimental::Interceptor* CreateServerInterceptor(grpc::experimental::ServerRpcInfo* info) override;
+
+private:
+    ConcurrencyLimiter& limiter_;
+};
+
+} // namespace prodstarter
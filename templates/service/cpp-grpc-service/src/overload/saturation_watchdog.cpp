@@ -0,0 +1,270 @@
+// ProdStarterHub - C++ gRPC Service
+// src/overload/saturation_watchdog.cpp
+
+#include "overload/saturation_watchdog.h"
+
+#include <algorithm>
+#include <utility>
+
+#include <grpcpp/alarm.h>
+#include <spdlog/spdlog.h>
+
+#include "engine/async_engine.h"
+#include "exec/executor.h"
+#include "exec/lane_executor.h"
+#include "server/health_reporter.h"
+
+namespace prodstarter {
+
+namespace {
+
+int64_t NowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+std::string ShardServiceName(const std::string& service, size_t shard) {
+    return service + "/shard-" + std::to_string(shard);
+}
+
+} // namespace
+
+struct SaturationWatchdog::Target {
+    Kind kind = Kind::kCompletionQueue;
+    std::string name;
+    int shard = -1;
+    bool drives_health = true;
+    grpc::CompletionQueue* cq = nullptr;
+    Executor* executor = nullptr;
+    LaneExecutor* lanes = nullptr;
+    size_t lane = 0;
+
+    // Lag of the outstanding probe once it ran, -1 until then; written by the probed thread.
+    std::atomic<int64_t> ran_lag_ns{-1};
+
+    // Watchdog thread only.
+    bool in_flight = false;
+    int64_t sent_ns = 0;
+    int64_t last_lag_ns = 0;
+    ShardedHistogram lag;
+
+    void Ran(int64_t sent) { ran_lag_ns.store(std::max<int64_t>(0, NowNs() - sent), std::memory_order_release); }
+};
+
+namespace {
+
+// Tag of an expired alarm on an engine queue; Proceed() runs on the queue's polling thread.
+class AlarmProbe final : public CallTag {
+public:
+    AlarmProbe(std::shared_ptr<SaturationWatchdog::Target> target, int64_t sent)
+        : target_(std::move(target)), sent_(sent) {}
+
+    void Arm(grpc::CompletionQueue* cq) { alarm_.Set(cq, gpr_time_0(GPR_CLOCK_MONOTONIC), this); }
+
+    void Proceed(bool ok) override {
+        if (ok) target_->Ran(sent_); // not ok: the queue is shutting down
+        delete this;
+    }
+
+private:
+    std::shared_ptr<SaturationWatchdog::Target> target_;
+    const int64_t sent_;
+    grpc::Alarm alarm_;
+};
+
+} // namespace
+
+const char* WatchdogKindName(SaturationWatchdog::Kind kind) {
+    switch (kind) {
+    case SaturationWatchdog::Kind::kCompletionQueue: return "cq";
+    case SaturationWatchdog::Kind::kCallback: return "callback";
+    case SaturationWatchdog::Kind::kExecutor: return "executor";
+    case SaturationWatchdog::Kind::kLane: return "lane";
+    }
+    return "unknown";
+}
+
+SaturationWatchdog::SaturationWatchdog(WatchdogOptions options) : options_(std::move(options)) {}
+
+SaturationWatchdog::~SaturationWatchdog() {
+    Stop();
+}
+
+void SaturationWatchdog::AddCompletionQueue(int shard, int index, grpc::CompletionQueue* cq) {
+    auto target = std::make_shared<Target>();
+    target->kind = Kind::kCompletionQueue;
+    target->name = std::to_string(index);
+    target->shard = shard;
+    target->cq = cq;
+    targets_.push_back(std::move(target));
+}
+
+void SaturationWatchdog::AddCallbackThreads() {
+    auto target = std::make_shared<Target>();
+    target->kind = Kind::kCallback;
+    target->name = "grpc";
+    targets_.push_back(std::move(target));
+}
+
+void SaturationWatchdog::AddExecutor(Executor& executor, bool drives_health) {
+    auto target = std::make_shared<Target>();
+    target->kind = Kind::kExecutor;
+    target->name = executor.name();
+    target->drives_health = drives_health;
+    target->executor = &executor;
+    targets_.push_back(std::move(target));
+}
+
+void SaturationWatchdog::AddLane(LaneExecutor& lanes, size_t lane, std::string name, bool drives_health) {
+    auto target = std::make_shared<Target>();
+    target->kind = Kind::kLane;
+    target->name = std::move(name);
+    target->drives_health = drives_health;
+    target->lanes = &lanes;
+    target->lane = lane;
+    targets_.push_back(std::move(target));
+}
+
+void SaturationWatchdog::Start(HealthReporter* health, size_t num_shards) {
+    std::lock_guard<std::mutex> lock(mu_);
+    if (thread_.joinable()) return;
+    num_shards_ = std::max<size_t>(1, num_shards);
+    shards_.assign(num_shards_, ShardState{});
+    saturated_ = std::make_unique<std::atomic<bool>[]>(num_shards_);
+    for (size_t i = 0; i < num_shards_; ++i) saturated_[i].store(false, std::memory_order_relaxed);
+    health_ = options_.health_service.empty() ? nullptr : health;
+    // NOT_SERVING until the first tick has measured something; from then on Publish() re-asserts the state.
+    if (health_ != nullptr) {
+        health_->SetServingStatus(options_.health_service, false);
+        for (size_t i = 0; i < num_shards_; ++i) {
+            health_->SetServingStatus(ShardServiceName(options_.health_service, i), false);
+        }
+    }
+    thread_ = std::thread(&SaturationWatchdog::Run, this);
+}
+
+void SaturationWatchdog::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        stopping_ = true;
+        cv_.notify_all();
+    }
+    if (thread_.joinable()) thread_.join();
+}
+
+void SaturationWatchdog::Run() {
+    const int64_t threshold_ns = std::chrono::nanoseconds(options_.lag_threshold).count();
+    std::vector<int64_t> worst(num_shards_);
+
+    std::unique_lock<std::mutex> lock(mu_);
+    while (!cv_.wait_for(lock, options_.interval, [this] { return stopping_; })) {
+        const int64_t now = NowNs();
+        int64_t shared_worst = 0;
+        std::fill(worst.begin(), worst.end(), 0);
+        for (const auto& target : targets_) {
+            const int64_t lag = Probe(target, now);
+            if (!target->drives_health) continue;
+            if (target->shard < 0) {
+                shared_worst = std::max(shared_worst, lag);
+            } else if (static_cast<size_t>(target->shard) < num_shards_) {
+                worst[target->shard] = std::max(worst[target->shard], lag);
+            }
+        }
+        for (size_t i = 0; i < num_shards_; ++i) {
+            const int64_t lag = std::max(worst[i], shared_worst);
+            Evaluate(i, lag > threshold_ns ? lag : 0, now);
+        }
+        Publish();
+    }
+}
+
+void SaturationWatchdog::Publish() {
+    if (health_ == nullptr) return;
+    // Every tick, not only on transitions, so a status someone else overwrote is put right; unchanged statuses
+    // cost HealthReporter a comparison.
+    for (size_t i = 0; i < num_shards_; ++i) {
+        health_->SetServingStatus(ShardServiceName(options_.health_service, i), !shards_[i].saturated);
+    }
+    health_->SetServingStatus(options_.health_service, num_saturated_ == 0);
+}
+
+int64_t SaturationWatchdog::Probe(const std::shared_ptr<Target>& target, int64_t now) {
+    if (target->in_flight) {
+        const int64_t lag = target->ran_lag_ns.exchange(-1, std::memory_order_acquire);
+        if (lag < 0) return now - target->sent_ns; // still waiting: its lag so far
+        target->in_flight = false;
+        target->last_lag_ns = lag;
+        target->lag.Observe(std::chrono::nanoseconds(lag));
+    }
+
+    target->sent_ns = now;
+    switch (target->kind) {
+    case Kind::kCompletionQueue: {
+        auto* probe = new AlarmProbe(target, now);
+        probe->Arm(target->cq);
+        target->in_flight = true;
+        break;
+    }
+    case Kind::kCallback: {
+        // Deleting a callback alarm from its own callback is fine: gRPC holds a reference until it returns.
+        auto* alarm = new grpc::Alarm;
+        alarm->Set(gpr_time_0(GPR_CLOCK_MONOTONIC), [alarm, target, now](bool ok) {
+            if (ok) target->Ran(now);
+            delete alarm;
+        });
+        target->in_flight = true;
+        break;
+    }
+    case Kind::kExecutor:
+        target->in_flight = target->executor->Post([target, now] { target->Ran(now); });
+        break;
+    case Kind::kLane:
+        target->in_flight = target->lanes->Post(target->lane, [target, now] { target->Ran(now); });
+        break;
+    }
+    return target->last_lag_ns;
+}
+
+void SaturationWatchdog::Evaluate(size_t shard, int64_t lag_ns, int64_t now) {
+    const int64_t hold_ns = std::chrono::nanoseconds(options_.saturated_after).count();
+    ShardState& state = shards_[shard];
+    if (lag_ns > 0) {
+        state.under_since = 0;
+        if (state.over_since == 0) state.over_since = now;
+    } else {
+        state.over_since = 0;
+        if (state.under_since == 0) state.under_since = now;
+    }
+
+    if (!state.saturated && state.over_since != 0 && now - state.over_since >= hold_ns) {
+        state.saturated = true;
+        ++num_saturated_;
+        spdlog::warn("Shard {} saturated: scheduling lag above {} ms for {} ms, now {} ms", shard,
+                     options_.lag_threshold.count(), (now - state.over_since) / 1000000, lag_ns / 1000000);
+    } else if (state.saturated && state.under_since != 0 && now - state.under_since >= hold_ns) {
+        state.saturated = false;
+        --num_saturated_;
+        spdlog::info("Shard {} no longer saturated: scheduling lag below {} ms for {} ms", shard,
+                     options_.lag_threshold.count(), options_.saturated_after.count());
+    } else {
+        return;
+    }
+
+    saturated_[shard].store(state.saturated, std::memory_order_relaxed);
+}
+
+SaturationWatchdog::Stats SaturationWatchdog::GetStats() const {
+    Stats stats;
+    for (const auto& target : targets_) {
+        TargetStats entry;
+        entry.kind = target->kind;
+        entry.name = target->name;
+        entry.shard = target->shard;
+        entry.lag = target->lag.Collect();
+        stats.targets.push_back(std::move(entry));
+    }
+    for (size_t i = 0; i < num_shards_; ++i) stats.saturated.push_back(saturated_[i].load(std::memory_order_relaxed));
+    return stats;
+}
+
+} // namespace prodstarter
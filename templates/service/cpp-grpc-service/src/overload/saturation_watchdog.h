@@ -0,0 +1,143 @@
+// ProdStarterHub - C++ gRPC Service
+// src/overload/saturation_watchdog.h
+// Scheduling lag of the completion queues and executors, and health from it.
+//
+// CPU utilization says little about saturation: a server with one hot polling
+// thread or a backlogged executor misses its latency targets long before the
+// host looks busy. The watchdog measures the lag directly. Every interval it
+// hands a no-op probe to each target and records how long the probe waited
+// before it ran:
+//
+//   cq        an already expired grpc::Alarm on an async engine queue; it runs
+//             once the queue's polling thread gets to it
+//   callback  an expired callback alarm, run by gRPC's internal executor; the
+//             closest probe of the threads behind --engine=callback
+//   executor  a task posted to the Executor
+//   lane      a task posted to one lane of the LaneExecutor
+//
+// A target has at most one probe outstanding. A probe that has not run by the
+// next tick counts with its lag so far, so a stuck thread shows up at once and
+// not only when it recovers. Probes only take a clock read and an atomic
+// store on the probed thread; the lags are put into histograms on the
+// watchdog's own thread.
+//
+// With a health service name, a shard whose lag stays above the threshold on
+// every probe for `saturated_after` is reported NOT_SERVING as NAME/shard-<i>,
+// and NAME goes NOT_SERVING while any shard is saturated. Executors and lanes
+// are shared, so their lag counts for every shard. A shard returns to SERVING
+// once its lag stayed below the threshold for the same period. The statuses
+// start out NOT_SERVING and are re-sent on every tick; HealthReporter ANDs
+// them with readiness, so they stay NOT_SERVING until warm-up is over.
+//
+//   SaturationWatchdog watchdog(options);
+//   watchdog.AddCompletionQueue(0, 0, engine.completion_queue(0)); // ... per queue and shard
+//   watchdog.AddExecutor(executor);
+//   watchdog.Start(&health, shards.size());
+//   ...
+//   watchdog.Stop(); // before the queues are shut down
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <grpcpp/completion_queue.h>
+
+#include "metrics/sharded_histogram.h"
+
+namespace prodstarter {
+
+class Executor;
+class HealthReporter;
+class LaneExecutor;
+
+struct WatchdogOptions {
+    std::chrono::milliseconds interval{100};          // how often each target is probed
+    std::chrono::milliseconds lag_threshold{50};      // lag above this counts towards saturation
+    std::chrono::milliseconds saturated_after{5000};  // ...when it lasts this long; as long below it clears
+    std::string health_service;                       // NAME and NAME/shard-<i>; empty disables
+};
+
+class SaturationWatchdog {
+public:
+    enum class Kind { kCompletionQueue, kCallback, kExecutor, kLane };
+
+    struct Target; // one probed queue or executor and its lag histogram
+
+    struct TargetStats {
+        Kind kind = Kind::kCompletionQueue;
+        std::string name; // queue index within its shard, executor or lane name
+        int shard = -1;   // -1: shared by every shard
+        ShardedHistogram::Snapshot lag;
+    };
+    struct Stats {
+        std::vector<TargetStats> targets;
+        std::vector<bool> saturated; // per shard
+    };
+
+    explicit SaturationWatchdog(WatchdogOptions options);
+    ~SaturationWatchdog();
+
+    SaturationWatchdog(const SaturationWatchdog&) = delete;
+    SaturationWatchdog& operator=(const SaturationWatchdog&) = delete;
+
+    // Targets, added before Start(). The queue and executors must outlive the watchdog's probes: stop the watchdog
+    // before they shut down; probes already handed out then still run as they drain.
+    void AddCompletionQueue(int shard, int index, grpc::CompletionQueue* cq);
+    void AddCallbackThreads();
+    // `drives_health` false only measures the target, e.g. a lane whose backlog is expected.
+    void AddExecutor(Executor& executor, bool drives_health = true);
+    void AddLane(LaneExecutor& lanes, size_t lane, std::string name, bool drives_health = true);
+
+    // Starts probing. `health` may be null; otherwise the configured names for `num_shards` shards are set to
+    // NOT_SERVING now, and from the first tick on to the current state on every tick.
+    void Start(HealthReporter* health, size_t num_shards);
+
+    // Stops probing. Call before the overall health status goes NOT_SERVING at shutdown, so a late recovery cannot
+    // flip the named services back.
+    void Stop();
+
+    Stats GetStats() const;
+    const WatchdogOptions& options() const { return options_; }
+
+private:
+    struct ShardState {
+        bool saturated = false;
+        int64_t over_since = 0;  // first probe of the current run above the threshold, 0 when below
+        int64_t under_since = 0; // first probe of the current run below it, 0 when above
+    };
+
+    void Run();
+    // Collects the last probe's lag and sends the next one; returns the target's current lag.
+    int64_t Probe(const std::shared_ptr<Target>& target, int64_t now);
+    // Updates a shard's state from the worst lag that counts for it.
+    void Evaluate(size_t shard, int64_t lag_ns, int64_t now);
+    // Sends every shard's state and the server-wide one to the health services.
+    void Publish();
+
+    const WatchdogOptions options_;
+    std::vector<std::shared_ptr<Target>> targets_; // shared with probes still in flight
+
+    HealthReporter* health_ = nullptr;
+    std::vector<ShardState> shards_;                // watchdog thread only
+    std::unique_ptr<std::atomic<bool>[]> saturated_; // per shard, for GetStats()
+    size_t num_shards_ = 0;
+    size_t num_saturated_ = 0;
+
+    std::mutex mu_;
+    std::condition_variable cv_;
+    bool stopping_ = false;
+    std::thread thread_;
+};
+
+const char* WatchdogKindName(SaturationWatchdog::Kind kind);
+
+} // namespace prodstarter
@@ -0,0 +1,299 @@
+// ProdStarterHub - C++ gRPC Service
+// src/profiling/profiler.cpp
+
+#include "profiling/profiler.h"
+
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <signal.h>
+#include <sys/prctl.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <map>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <spdlog/fmt/fmt.h>
+#include <spdlog/spdlog.h>
+
+#ifdef USE_GPERFTOOLS
+#include <gperftools/profiler.h>
+#endif
+
+#include "memory/allocator.h"
+
+namespace prodstarter {
+
+namespace {
+
+constexpr size_t kSlots = 4096; // ~40 s of one busy thread at 99 Hz between two drains; drains run far more often
+constexpr int kMaxDepth = 64;
+constexpr int kSkipFrames = 2;  // the handler and the signal trampoline
+constexpr auto kDrainInterval = std::chrono::milliseconds(50);
+
+enum SlotState : int { kFree, kWriting, kReady };
+
+struct Slot {
+    std::atomic<int> state{kFree};
+    char thread[16]; // PR_GET_NAME: gRPC's sync workers come and go, so the name is taken while the thread runs
+    int depth = 0;
+    void* frames[kMaxDepth];
+};
+
+struct SampleRing {
+    std::atomic<uint64_t> next{0};
+    std::atomic<uint64_t> dropped{0};
+    Slot slots[kSlots];
+};
+
+// Published while a built-in capture runs. The ring is allocated once and never freed, so a SIGPROF still being
+// handled when a capture ends writes into memory that stays valid.
+std::atomic<SampleRing*> g_ring{nullptr};
+
+// Runs on the interrupted thread: no locks and no allocation. backtrace() is warmed up before the first capture, so
+// it no longer loads the unwinder from here.
+void OnSigprof(int, siginfo_t*, void*) {
+    SampleRing* ring = g_ring.load(std::memory_order_acquire);
+    if (ring == nullptr) return;
+    const int saved_errno = errno;
+    Slot& slot = ring->slots[ring->next.fetch_add(1, std::memory_order_relaxed) % kSlots];
+    int expected = kFree;
+    if (slot.state.compare_exchange_strong(expected, kWriting, std::memory_order_acquire)) {
+        if (prctl(PR_GET_NAME, slot.thread) != 0) slot.thread[0] = '\0';
+        slot.depth = backtrace(slot.frames, kMaxDepth);
+        slot.state.store(kReady, std::memory_order_release);
+    } else {
+        ring->dropped.fetch_add(1, std::memory_order_relaxed); // the drain thread has not caught up
+    }
+    errno = saved_errno;
+}
+
+// Installs the SIGPROF handler once. It stays installed after a capture: with no ring published it returns at
+// once, so a SIGPROF still pending when the timer stops cannot take the default action and end the process.
+bool InstallSigprofHandler(std::string* error) {
+    static std::once_flag once;
+    static int result = 0;
+    std::call_once(once, [] {
+        void* warm_up[1];
+        backtrace(warm_up, 1);
+        struct sigaction action {};
+        action.sa_sigaction = OnSigprof;
+        action.sa_flags = SA_RESTART | SA_SIGINFO;
+        sigemptyset(&action.sa_mask);
+        result = sigaction(SIGPROF, &action, nullptr) == 0 ? 0 : errno;
+    });
+    if (result != 0) *error = fmt::format("sigaction(SIGPROF): {}", std::strerror(result));
+    return result == 0;
+}
+
+class StackAggregator {
+public:
+    // Moves the recorded samples out of `ring`.
+    void Drain(SampleRing& ring) {
+        for (Slot& slot : ring.slots) {
+            if (slot.state.load(std::memory_order_acquire) != kReady) continue;
+            const int depth = slot.depth;
+            std::vector<void*> frames;
+            if (depth > kSkipFrames) frames.assign(slot.frames + kSkipFrames, slot.frames + depth);
+            std::string thread(slot.thread, strnlen(slot.thread, sizeof(slot.thread)));
+            slot.state.store(kFree, std::memory_order_release);
+            ++stacks_[{ThreadName(std::move(thread)), std::move(frames)}];
+            ++samples_;
+        }
+    }
+
+    uint64_t samples() const { return samples_; }
+
+    // One "thread;outer;...;leaf count" line per distinct stack.
+    bool Write(const std::string& path, std::string* error) {
+        std::ofstream out(path, std::ios::trunc);
+        if (!out) {
+            *error = fmt::format("cannot create {}: {}", path, std::strerror(errno));
+            return false;
+        }
+        std::string line;
+        for (const auto& [stack, count] : stacks_) {
+            line = stack.first;
+            // backtrace() lists the leaf first; only its address is exact, the others are return addresses.
+            for (size_t i = stack.second.size(); i-- > 0;) {
+                line.push_back(';');
+                line += FrameName(stack.second[i], i == 0);
+            }
+            out << line << ' ' << count << '\n';
+        }
+        out.flush();
+        if (!out) {
+            *error = fmt::format("writing {} failed", path);
+            return false;
+        }
+        return true;
+    }
+
+private:
+    static std::string ThreadName(std::string name) {
+        if (name.empty()) return "unnamed";
+        std::replace(name.begin(), name.end(), ';', '_');
+        std::replace(name.begin(), name.end(), ' ', '_');
+        return name;
+    }
+
+    const std::string& FrameName(void* pc, bool leaf) {
+        // A return address may already belong to the next line or function; one byte back is still the call.
+        const auto address = reinterpret_cast<uintptr_t>(pc) - (leaf ? 0 : 1);
+        auto it = frames_.find(address);
+        if (it != frames_.end()) return it->second;
+        std::string name;
+        Dl_info info{};
+        if (dladdr(reinterpret_cast<void*>(address), &info) != 0 && info.dli_sname != nullptr) {
+            int status = 0;
+            char* demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+            name = status == 0 && demangled != nullptr ? demangled : info.dli_sname;
+            std::free(demangled);
+        } else if (info.dli_fname != nullptr && info.dli_fbase != nullptr) {
+            const char* slash = std::strrchr(info.dli_fname, '/');
+            name = fmt::format("{}+0x{:x}", slash != nullptr ? slash + 1 : info.dli_fname,
+                               address - reinterpret_cast<uintptr_t>(info.dli_fbase));
+        } else {
+            name = fmt::format("0x{:x}", address);
+        }
+        std::replace(name.begin(), name.end(), ';', ':');
+        return frames_.emplace(address, std::move(name)).first->second;
+    }
+
+    std::map<std::pair<std::string, std::vector<void*>>, uint64_t> stacks_;
+    std::unordered_map<uintptr_t, std::string> frames_;
+    uint64_t samples_ = 0;
+};
+
+// Sleeps until `deadline` or `stop`, calling `tick` every drain interval.
+template <class Stop, class Tick>
+void RunUntil(std::chrono::steady_clock::time_point deadline, const Stop& stop, const Tick& tick) {
+    for (auto now = std::chrono::steady_clock::now(); now < deadline && !stop();
+         now = std::chrono::steady_clock::now()) {
+        std::this_thread::sleep_for(std::min<std::chrono::steady_clock::duration>(kDrainInterval, deadline - now));
+        tick();
+    }
+}
+
+} // namespace
+
+Profiler::Profiler(ProfilerOptions options) : options_(std::move(options)) {}
+
+Profiler::~Profiler() {
+    stopping_.store(true, std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(background_mu_);
+    if (background_.joinable()) background_.join();
+}
+
+std::string Profiler::NextPath(const char* kind, const char* extension) const {
+    const auto now = std::chrono::system_clock::now();
+    const std::time_t seconds = std::chrono::system_clock::to_time_t(now);
+    const auto millis =
+        std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count() % 1000;
+    std::tm utc{};
+    gmtime_r(&seconds, &utc);
+    char stamp[32];
+    std::strftime(stamp, sizeof(stamp), "%Y%m%dT%H%M%S", &utc);
+    return fmt::format("{}/{}-{}.{:03d}Z-{}.{}", options_.directory, kind, stamp, millis, getpid(), extension);
+}
+
+bool Profiler::CaptureCpu(std::chrono::seconds duration, const std::function<bool()>& cancelled,
+                          ProfileResult* result, std::string* error) {
+    if (busy_.exchange(true, std::memory_order_acq_rel)) {
+        *error = "a CPU profile is already being captured";
+        return false;
+    }
+    if (duration.count() <= 0) duration = options_.default_duration;
+    duration = std::min(duration, options_.max_duration);
+    auto stop = [&] { return stopping_.load(std::memory_order_relaxed) || (cancelled && cancelled()); };
+    const auto start = std::chrono::steady_clock::now();
+    bool ok = false;
+
+#ifdef USE_GPERFTOOLS
+    result->path = NextPath("cpu", "prof");
+    result->format = "pprof";
+    if (ProfilerStart(result->path.c_str())) {
+        RunUntil(start + duration, stop, [] {});
+        ProfilerStop();
+        ok = true;
+    } else {
+        *error = fmt::format("ProfilerStart({}) failed", result->path);
+    }
+#else
+    result->path = NextPath("cpu", "folded");
+    result->format = "folded";
+    if (InstallSigprofHandler(error)) {
+        static SampleRing* const ring = new SampleRing(); // 2 MiB, kept for the lifetime of the process
+        for (Slot& slot : ring->slots) slot.state.store(kFree, std::memory_order_relaxed);
+        ring->dropped.store(0, std::memory_order_relaxed);
+        g_ring.store(ring, std::memory_order_release);
+
+        itimerval timer{};
+        timer.it_interval.tv_usec = 1000000 / std::clamp(options_.hz, 1, 1000);
+        timer.it_value = timer.it_interval;
+        StackAggregator stacks;
+        if (setitimer(ITIMER_PROF, &timer, nullptr) == 0) {
+            RunUntil(start + duration, stop, [&] { stacks.Drain(*ring); });
+            const itimerval off{};
+            setitimer(ITIMER_PROF, &off, nullptr);
+            ok = true;
+        } else {
+            *error = fmt::format("setitimer(ITIMER_PROF): {}", std::strerror(errno));
+        }
+        g_ring.store(nullptr, std::memory_order_release);
+        if (ok) {
+            stacks.Drain(*ring);
+            result->samples = stacks.samples();
+            result->dropped = ring->dropped.load(std::memory_order_relaxed);
+            ok = stacks.Write(result->path, error);
+        }
+    }
+#endif
+
+    result->seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    busy_.store(false, std::memory_order_release);
+    return ok;
+}
+
+bool Profiler::CaptureHeap(ProfileResult* result, std::string* error) {
+    result->format = HeapProfileFormat();
+    result->path = NextPath("heap", HeapProfileFormat());
+    return DumpHeapProfile(result->path, error);
+}
+
+void Profiler::CaptureInBackground() {
+    std::lock_guard<std::mutex> lock(background_mu_);
+    if (busy()) {
+        spdlog::warn("Profiler: a CPU profile is already being captured, request ignored");
+        return;
+    }
+    if (background_.joinable()) background_.join(); // the previous capture, finished or writing its heap profile
+    background_ = std::thread([this] {
+        ProfileResult cpu;
+        std::string error;
+        if (CaptureCpu(std::chrono::seconds(0), {}, &cpu, &error)) {
+            spdlog::info("Profiler: CPU profile written to {} ({:.1f} s, {} samples, {} dropped)", cpu.path,
+                         cpu.seconds, cpu.samples, cpu.dropped);
+        } else {
+            spdlog::warn("Profiler: CPU profile failed: {}", error);
+        }
+        ProfileResult heap;
+        if (CaptureHeap(&heap, &error)) {
+            spdlog::info("Profiler: heap profile written to {}", heap.path);
+        } else {
+            spdlog::warn("Profiler: heap profile failed: {}", error);
+        }
+    });
+}
+
+} // namespace prodstarter
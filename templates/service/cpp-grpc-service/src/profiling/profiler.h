@@ -0,0 +1,97 @@
+// ProdStarterHub - C++ gRPC Service
+// src/profiling/profiler.h
+// On-demand CPU and heap profiles of the running process (Admin/CpuProfile, Admin/HeapProfile, SIGUSR2).
+//
+// Profiling a production hot path should not need a special build. The
+// profiler is idle until asked for a capture, which writes one file into
+// --profile-dir:
+//
+//   cpu-<time>-<pid>.folded   built-in sampler: setitimer(ITIMER_PROF) sends
+//                             SIGPROF at `hz` per CPU second the process uses;
+//                             the handler records the interrupted thread's
+//                             backtrace into a preallocated ring, a drain thread
+//                             aggregates them. One "thread;outer;...;leaf count"
+//                             line per stack, the input of flamegraph.pl and
+//                             speedscope. Frames are named through dladdr(), so
+//                             link with -rdynamic for names of the binary's own
+//                             functions; others show as "binary+0xoffset".
+//   cpu-<time>-<pid>.prof     with -DUSE_GPERFTOOLS (link -lprofiler): gperftools'
+//                             ProfilerStart/ProfilerStop, in pprof format.
+//   heap-<time>-<pid>.<ext>   DumpHeapProfile() of the linked allocator
+//                             (memory/allocator.h): a jeprof/pprof heap profile
+//                             under jemalloc with MALLOC_CONF=prof:true, glibc's
+//                             malloc_info() XML, or mimalloc's statistics.
+//
+// One capture runs at a time; a second request is refused while the first is
+// running. SIGPROF is a normal signal and reaches whichever thread is on CPU.
+// The handler is installed with SA_RESTART, so most syscalls it interrupts
+// are restarted; the few the kernel never restarts (e.g. poll, epoll_wait,
+// nanosleep) return EINTR, which gRPC and the standard library retry.
+//
+//   Profiler profiler({"/var/tmp/profiles"});
+//   ProfileResult result;
+//   std::string error;
+//   if (!profiler.CaptureCpu(std::chrono::seconds(30), {}, &result, &error)) spdlog::warn("{}", error);
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace prodstarter {
+
+struct ProfilerOptions {
+    std::string directory;                     // profiles are written here; must exist
+    std::chrono::seconds default_duration{30}; // CPU captures that do not ask for a duration
+    std::chrono::seconds max_duration{300};    // longer requests are shortened to this
+    int hz = 99;                               // built-in sampler: samples per CPU second
+};
+
+struct ProfileResult {
+    std::string path;   // file written
+    std::string format; // "folded", "pprof", or the heap format of the allocator
+    uint64_t samples = 0; // CPU: stacks recorded (built-in sampler only)
+    uint64_t dropped = 0; // CPU: samples lost because the ring was full
+    double seconds = 0;   // CPU: wall time captured
+};
+
+class Profiler {
+public:
+    explicit Profiler(ProfilerOptions options);
+    ~Profiler(); // stops a background capture early and waits for it
+
+    Profiler(const Profiler&) = delete;
+    Profiler& operator=(const Profiler&) = delete;
+
+    // Samples the whole process for `duration` (0: the default, clamped to the maximum), or until `cancelled`
+    // returns true, and writes the profile. Blocks the caller. Returns false with `error` set when a capture is
+    // already running or the profile cannot be written.
+    bool CaptureCpu(std::chrono::seconds duration, const std::function<bool()>& cancelled, ProfileResult* result,
+                    std::string* error);
+
+    // Writes a heap profile of the allocator. Returns false with `error` set when the allocator cannot produce one.
+    bool CaptureHeap(ProfileResult* result, std::string* error);
+
+    // Captures a CPU profile for the default duration followed by a heap profile on a thread of the profiler, and
+    // logs where they went (SIGUSR2). Returns immediately.
+    void CaptureInBackground();
+
+    const ProfilerOptions& options() const { return options_; }
+    bool busy() const { return busy_.load(std::memory_order_acquire); }
+
+private:
+    std::string NextPath(const char* kind, const char* extension) const;
+
+    const ProfilerOptions options_;
+    std::atomic<bool> busy_{false};     // a CPU capture is running
+    std::atomic<bool> stopping_{false}; // destructor: background capture ends early
+    std::mutex background_mu_;          // guards background_
+    std::thread background_;
+};
+
+} // namespace prodstarter
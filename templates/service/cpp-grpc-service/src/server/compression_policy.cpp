@@ -0,0 +1,239 @@
+// ProdStarterHub - C++ gRPC Service
+// src/server/compression_policy.cpp
+
+#include "server/compression_policy.h"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <ctime>
+
+#include <grpcpp/server_context.h>
+#include <grpcpp/support/byte_buffer.h>
+
+namespace prodstarter {
+
+namespace {
+
+using grpc::experimental::InterceptionHookPoints;
+
+constexpr int64_t kAverageWeight = 8; // each response moves a method's average by 1/8 of the difference
+
+uint64_t ThreadCpuNs() {
+    timespec ts{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+// Size of `message` compressed the way gRPC core does it (zlib at its default level).
+uint64_t CompressedSize(const grpc::ByteBuffer& message, bool gzip) {
+    z_stream zs{};
+    if (deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, gzip ? 15 + 16 : 15, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        return message.Length();
+    }
+    std::vector<grpc::Slice> slices;
+    message.Dump(&slices);
+    unsigned char out[16 * 1024];
+    uint64_t produced = 0;
+    for (size_t i = 0; i <= slices.size(); ++i) {
+        const bool last = i == slices.size();
+        zs.next_in = last ? nullptr : const_cast<Bytef*>(slices[i].begin());
+        zs.avail_in = last ? 0 : static_cast<uInt>(slices[i].size());
+        do {
+            zs.next_out = out;
+            zs.avail_out = sizeof(out);
+            deflate(&zs, last ? Z_FINISH : Z_NO_FLUSH);
+            produced += sizeof(out) - zs.avail_out;
+        } while (zs.avail_out == 0);
+    }
+    deflateEnd(&zs);
+    return produced;
+}
+
+class CompressionInterceptor final : public grpc::experimental::Interceptor {
+public:
+    CompressionInterceptor(grpc::experimental::ServerRpcInfo* info, CompressionPolicy& policy)
+        : policy_(policy), method_(info->method() != nullptr ? info->method() : ""),
+          single_response_(info->type() == grpc::experimental::ServerRpcInfo::Type::UNARY ||
+                           info->type() == grpc::experimental::ServerRpcInfo::Type::CLIENT_STREAMING),
+          state_(policy_.LevelFor(method_) != GRPC_COMPRESS_LEVEL_NONE ? policy_.Track(method_) : nullptr),
+          level_(policy_.Choose(method_, state_)) {
+        // Read by gRPC when the handler queues its response; a level the handler sets itself replaces this one.
+        if (level_ != GRPC_COMPRESS_LEVEL_NONE) info->server_context()->set_compression_level(level_);
+    }
+
+    void Intercept(grpc::experimental::InterceptorBatchMethods* methods) override {
+        if (methods->QueryInterceptionHookPoint(InterceptionHookPoints::PRE_SEND_MESSAGE)) {
+            const grpc::ByteBuffer* message = methods->GetSerializedSendMessage();
+            if (message != nullptr) OnResponse(*message, methods);
+        }
+        methods->Proceed();
+    }
+
+private:
+    void OnResponse(const grpc::ByteBuffer& message, grpc::experimental::InterceptorBatchMethods* methods) {
+        const int64_t bytes = static_cast<int64_t>(message.Length());
+        // A message sent with the status is the call's only response (generic calls finished with WriteAndFinish
+        // included); stream messages are judged one by one and stay out of the average.
+        const bool single = single_response_ ||
+                            methods->QueryInterceptionHookPoint(InterceptionHookPoints::PRE_SEND_STATUS);
+        if (single) policy_.Observe(state_, bytes);
+        if (level_ == GRPC_COMPRESS_LEVEL_NONE) return;
+        if (!single && bytes < policy_.min_bytes()) {
+            policy_.RecordSkipped(); // the stream writers send it uncompressed
+            return;
+        }
+        policy_.RecordMessage(level_, message);
+    }
+
+    CompressionPolicy& policy_;
+    std::string_view method_; // owned by the call, valid while the interceptor lives
+    const bool single_response_;
+    CompressionPolicy::Method* const state_;
+    const grpc_compression_level level_;
+};
+
+} // namespace
+
+struct CompressionPolicy::Method {
+    explicit Method(std::string method) : name(std::move(method)) {}
+
+    const std::string name;
+    std::atomic<int64_t> average_bytes{-1}; // moving average of the single responses; -1 until the first one
+};
+
+CompressionPolicy::CompressionPolicy(CompressionOptions options) : options_(options) {}
+
+CompressionPolicy::~CompressionPolicy() = default;
+
+bool ParseCompressionLevel(std::string_view text, grpc_compression_level* level) {
+    if (text == "none") {
+        *level = GRPC_COMPRESS_LEVEL_NONE;
+    } else if (text == "low" || text == "gzip") {
+        *level = GRPC_COMPRESS_LEVEL_LOW;
+    } else if (text == "medium") {
+        *level = GRPC_COMPRESS_LEVEL_MED;
+    } else if (text == "high" || text == "deflate") {
+        *level = GRPC_COMPRESS_LEVEL_HIGH;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char* CompressionLevelName(grpc_compression_level level) {
+    switch (level) {
+    case GRPC_COMPRESS_LEVEL_LOW: return "low";
+    case GRPC_COMPRESS_LEVEL_MED: return "medium";
+    case GRPC_COMPRESS_LEVEL_HIGH: return "high";
+    default: return "none";
+    }
+}
+
+bool CompressionPolicy::AddRule(const std::string& rule, std::string* error) {
+    const size_t eq = rule.rfind('=');
+    if (eq == std::string::npos || eq == 0 || rule[0] != '/') {
+        *error = "expected /package.Service/Method=LEVEL or /package.Service/*=LEVEL";
+        return false;
+    }
+    grpc_compression_level level = GRPC_COMPRESS_LEVEL_NONE;
+    if (!ParseCompressionLevel(std::string_view(rule).substr(eq + 1), &level)) {
+        *error = "level must be none, low, medium, high, gzip or deflate";
+        return false;
+    }
+    has_rule_ = has_rule_ || level != GRPC_COMPRESS_LEVEL_NONE;
+    std::string pattern = rule.substr(0, eq);
+    if (pattern.back() != '*') {
+        exact_[pattern] = level;
+        return true;
+    }
+    pattern.pop_back();
+    prefixes_.emplace_back(std::move(pattern), level);
+    std::stable_sort(prefixes_.begin(), prefixes_.end(),
+                     [](const auto& a, const auto& b) { return a.first.size() > b.first.size(); });
+    return true;
+}
+
+grpc_compression_level CompressionPolicy::LevelFor(std::string_view method) const {
+    if (!exact_.empty()) {
+        auto found = exact_.find(std::string(method));
+        if (found != exact_.end()) return found->second;
+    }
+    for (const auto& [prefix, level] : prefixes_) {
+        if (method.substr(0, prefix.size()) == prefix) return level;
+    }
+    return options_.level;
+}
+
+CompressionPolicy::Method* CompressionPolicy::Track(std::string_view method) {
+    {
+        std::shared_lock<std::shared_mutex> lock(mu_);
+        auto it = methods_.find(method);
+        if (it != methods_.end()) return it->second.get();
+    }
+    std::unique_lock<std::shared_mutex> lock(mu_);
+    auto it = methods_.find(method);
+    if (it != methods_.end()) return it->second.get();
+    if (methods_.size() >= kMaxMethods) return nullptr;
+    auto state = std::make_unique<Method>(std::string(method));
+    Method* raw = state.get();
+    methods_.emplace(std::string_view(raw->name), std::move(state)); // the key points into the method's name
+    return raw;
+}
+
+grpc_compression_level CompressionPolicy::Choose(std::string_view method, const Method* state) {
+    const grpc_compression_level level = LevelFor(method);
+    if (level == GRPC_COMPRESS_LEVEL_NONE || state == nullptr) return level;
+    const int64_t average = state->average_bytes.load(std::memory_order_relaxed);
+    if (average >= 0 && average < options_.min_bytes) {
+        below_min_bytes_.fetch_add(1, std::memory_order_relaxed);
+        return GRPC_COMPRESS_LEVEL_NONE;
+    }
+    return level;
+}
+
+void CompressionPolicy::Observe(Method* state, int64_t bytes) {
+    if (state == nullptr) return;
+    // Concurrent responses may overwrite each other's update; the average only has to follow the trend.
+    const int64_t average = state->average_bytes.load(std::memory_order_relaxed);
+    state->average_bytes.store(average < 0 ? bytes : average + (bytes - average) / kAverageWeight,
+                               std::memory_order_relaxed);
+}
+
+void CompressionPolicy::RecordMessage(grpc_compression_level level, const grpc::ByteBuffer& message) {
+    Counters& counters = counters_[level];
+    const uint64_t count = counters.messages.fetch_add(1, std::memory_order_relaxed);
+    const uint64_t length = message.Length();
+    counters.bytes.fetch_add(length, std::memory_order_relaxed);
+    if (options_.sample_every <= 0 || count % static_cast<uint64_t>(options_.sample_every) != 0) return;
+
+    // Low prefers gzip, the others deflate; the two differ only in their framing.
+    const uint64_t start = ThreadCpuNs();
+    const uint64_t compressed = CompressedSize(message, level == GRPC_COMPRESS_LEVEL_LOW);
+    const uint64_t cpu_ns = ThreadCpuNs() - start;
+    // gRPC sends a message uncompressed when compressing does not make it smaller.
+    const uint64_t saved = compressed < length ? length - compressed : 0;
+    const uint64_t weight = static_cast<uint64_t>(options_.sample_every);
+    counters.saved_bytes.fetch_add(saved * weight, std::memory_order_relaxed);
+    counters.cpu_ns.fetch_add(cpu_ns * weight, std::memory_order_relaxed);
+}
+
+CompressionPolicy::Stats CompressionPolicy::GetStats() const {
+    Stats stats;
+    for (size_t i = 0; i < counters_.size(); ++i) {
+        LevelStats& out = stats.levels[i];
+        out.messages = counters_[i].messages.load(std::memory_order_relaxed);
+        out.bytes = counters_[i].bytes.load(std::memory_order_relaxed);
+        out.saved_bytes = counters_[i].saved_bytes.load(std::memory_order_relaxed);
+        out.cpu_seconds = static_cast<double>(counters_[i].cpu_ns.load(std::memory_order_relaxed)) / 1e9;
+    }
+    stats.below_min_bytes = below_min_bytes_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+grpc::experimental::Interceptor* CompressionInterceptorFactory::CreateServerInterceptor(
+    grpc::experimental::ServerRpcInfo* info) {
+    return new CompressionInterceptor(info, policy_);
+}
+
+} // namespace prodstarter
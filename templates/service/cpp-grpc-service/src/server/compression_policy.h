@@ -0,0 +1,147 @@
+// ProdStarterHub - C++ gRPC Service
+// src/server/compression_policy.h
+// Per-call response compression: level per method, size threshold, client support.
+//
+// ServerBuilder::SetDefaultCompressionLevel() compresses every response of
+// every method, tiny ones included. The policy decides per call instead, in a
+// server interceptor when the call starts:
+//
+//   * the level comes from the longest matching --compression-method rule, else
+//     from --compression;
+//   * gRPC turns the level into an algorithm the client lists in its
+//     grpc-accept-encoding (low prefers gzip, medium and high prefer deflate,
+//     each falls back to the other) and sends the response uncompressed when
+//     the client lists neither, so no client gets an encoding it cannot read;
+//   * a method whose responses average under --compression-min-bytes is left
+//     uncompressed. The average is a moving one per method, kept from every
+//     response whether compressed or not, so a method that starts returning
+//     large responses is compressed again. Streams are judged per message as
+//     well: the stream writers (engine/stream_writer.h) send messages under the
+//     threshold uncompressed.
+//
+// The level has to be chosen before the handler runs: gRPC reads it when the
+// response is queued, after which neither the handler's nor an interceptor's
+// view of the size can change it. A handler that calls
+// ServerContext::set_compression_level() itself replaces the policy's choice;
+// give methods that use set_compression_algorithm() a "=none" rule, since a
+// level would override it.
+//
+// Every Nth message sent with a level on (sample_every) is also compressed
+// with zlib on the side to estimate the bytes saved and the CPU spent, which
+// the compression metrics report. gRPC does not say which algorithm it picked,
+// so messages to the rare client that accepts neither are counted as well.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <grpc/compression.h>
+#include <grpcpp/support/server_interceptor.h>
+
+namespace prodstarter {
+
+// Parses none, low, medium or high, and gzip / deflate as the levels that prefer them (low / high).
+bool ParseCompressionLevel(std::string_view text, grpc_compression_level* level);
+const char* CompressionLevelName(grpc_compression_level level);
+
+struct CompressionOptions {
+    grpc_compression_level level = GRPC_COMPRESS_LEVEL_NONE; // for methods without a rule
+    int64_t min_bytes = 1024; // methods whose responses average less, and smaller stream messages, stay uncompressed
+    int sample_every = 64;    // 1 in N compressed messages is measured; 0 disables the estimates
+};
+
+class CompressionPolicy {
+public:
+    static constexpr size_t kMaxMethods = 512; // beyond this, methods are compressed by their rule alone
+
+    struct Method; // response size history of one method
+
+    struct LevelStats {
+        uint64_t messages = 0;    // messages sent while the level was on
+        uint64_t bytes = 0;       // their uncompressed size
+        uint64_t saved_bytes = 0; // estimated from the sampled messages
+        double cpu_seconds = 0;   // estimated from the sampled messages
+    };
+
+    struct Stats {
+        std::array<LevelStats, GRPC_COMPRESS_LEVEL_COUNT> levels; // indexed by level; NONE stays empty
+        uint64_t below_min_bytes = 0; // calls and stream messages left uncompressed because they were small
+    };
+
+    explicit CompressionPolicy(CompressionOptions options);
+    ~CompressionPolicy();
+
+    CompressionPolicy(const CompressionPolicy&) = delete;
+    CompressionPolicy& operator=(const CompressionPolicy&) = delete;
+
+    // `rule` is "PATTERN=LEVEL" with a full method name or a prefix ending in '*'. Returns false with `error` set
+    // when it does not parse.
+    bool AddRule(const std::string& rule, std::string* error);
+
+    // Level for `method`: the longest matching rule, else the default.
+    grpc_compression_level LevelFor(std::string_view method) const;
+
+    // Size history of `method`; null once kMaxMethods are tracked. Only methods that compress need one.
+    Method* Track(std::string_view method);
+
+    // Level for a call on `method` starting now: LevelFor(), unless the method's responses average under
+    // min_bytes. Counts the calls skipped for their size.
+    grpc_compression_level Choose(std::string_view method, const Method* state);
+
+    // Folds a response of `bytes` into the method's average; `state` may be null.
+    void Observe(Method* state, int64_t bytes);
+
+    // Accounts a message sent while `level` was on; `message` is its serialized form.
+    void RecordMessage(grpc_compression_level level, const grpc::ByteBuffer& message);
+
+    // Accounts a stream message sent uncompressed because it was small.
+    void RecordSkipped() { below_min_bytes_.fetch_add(1, std::memory_order_relaxed); }
+
+    int64_t min_bytes() const { return options_.min_bytes; }
+    // False when neither the default nor any rule compresses.
+    bool enabled() const { return options_.level != GRPC_COMPRESS_LEVEL_NONE || has_rule_; }
+
+    Stats GetStats() const;
+
+private:
+    struct Counters {
+        std::atomic<uint64_t> messages{0};
+        std::atomic<uint64_t> bytes{0};
+        std::atomic<uint64_t> saved_bytes{0};
+        std::atomic<uint64_t> cpu_ns{0};
+    };
+
+    const CompressionOptions options_;
+    std::unordered_map<std::string, grpc_compression_level> exact_;
+    std::vector<std::pair<std::string, grpc_compression_level>> prefixes_; // longest first
+    bool has_rule_ = false;
+
+    mutable std::shared_mutex mu_; // guards methods_
+    std::unordered_map<std::string_view, std::unique_ptr<Method>> methods_; // keyed by Method::name
+
+    std::array<Counters, GRPC_COMPRESS_LEVEL_COUNT> counters_;
+    std::atomic<uint64_t> below_min_bytes_{0};
+};
+
+// Applies `policy` to every call of the server it is installed on.
+class CompressionInterceptorFactory : public grpc::experimental::ServerInterceptorFactoryInterface {
+public:
+    explicit CompressionInterceptorFactory(CompressionPolicy& policy) : policy_(policy) {}
+
+    grpc::experimental::Interceptor* CreateServerInterceptor(grpc::experimental::ServerRpcInfo* info) override;
+
+private:
+    CompressionPolicy& policy_;
+};
+
+} // namespace prodstarter
@@ -0,0 +1,126 @@
+// ProdStarterHub - C++ gRPC Service
+// src/server/connection_monitor.cpp
+
+#include "server/connection_monitor.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <grpc/grpc.h>
+#include <grpc/support/alloc.h>
+
+namespace prodstarter {
+
+namespace {
+
+// channelz returns a JSON string allocated by gRPC.
+std::string TakeJson(char* json) {
+    if (json == nullptr) return {};
+    std::string out(json);
+    gpr_free(json);
+    return out;
+}
+
+// Every id in `json` for `key`, e.g. "socketId":"42". channelz encodes int64 ids as strings.
+std::vector<int64_t> ExtractIds(const std::string& json, const std::string& key) {
+    std::vector<int64_t> ids;
+    const std::string needle = "\"" + key + "\":\"";
+    for (size_t pos = json.find(needle); pos != std::string::npos; pos = json.find(needle, pos)) {
+        pos += needle.size();
+        ids.push_back(std::strtoll(json.c_str() + pos, nullptr, 10));
+    }
+    return ids;
+}
+
+// Pages through a channelz listing; `fetch` returns one page starting at the given id.
+template <typename Fetch>
+std::vector<int64_t> ListAll(const std::string& key, Fetch fetch) {
+    std::vector<int64_t> all;
+    int64_t start = 0;
+    for (;;) {
+        const std::string page = fetch(start);
+        const std::vector<int64_t> ids = ExtractIds(page, key);
+        all.insert(all.end(), ids.begin(), ids.end());
+        if (ids.empty() || page.find("\"end\":true") != std::string::npos) break;
+        start = *std::max_element(ids.begin(), ids.end()) + 1;
+    }
+    return all;
+}
+
+} // namespace
+
+void ConnectionMonitor::Start() {
+    std::lock_guard<std::mutex> lock(mu_);
+    if (poller_.joinable()) return;
+    poller_ = std::thread(&ConnectionMonitor::Run, this);
+}
+
+void ConnectionMonitor::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        stopping_ = true;
+        cv_.notify_all();
+    }
+    if (poller_.joinable()) poller_.join();
+}
+
+void ConnectionMonitor::Run() {
+    std::unique_lock<std::mutex> lock(mu_);
+    do {
+        lock.unlock();
+        Poll();
+        lock.lock();
+    } while (!cv_.wait_for(lock, options_.poll_interval, [this] { return stopping_; }));
+}
+
+void ConnectionMonitor::Poll() {
+    std::unordered_set<int64_t> current;
+    const auto servers = ListAll("serverId", [](int64_t start) { return TakeJson(grpc_channelz_get_servers(start)); });
+    for (int64_t server : servers) {
+        for (int64_t socket : ListAll("socketId", [server](int64_t start) {
+                 return TakeJson(grpc_channelz_get_server_sockets(server, start, 0));
+             })) {
+            current.insert(socket);
+        }
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    // The youngest a connection can be when its jittered max-age GOAWAY goes out, less what polling may have missed.
+    const auto aged_after = options_.max_connection_age * 9 / 10 - options_.poll_interval;
+    for (auto it = sockets_.begin(); it != sockets_.end();) {
+        if (current.count(it->first) != 0) {
+            ++it;
+            continue;
+        }
+        closed_.fetch_add(1, std::memory_order_relaxed);
+        if (options_.max_connection_age.count() > 0 && now - it->second >= aged_after) {
+            aged_out_.fetch_add(1, std::memory_order_relaxed);
+        }
+        it = sockets_.erase(it);
+    }
+
+    auto oldest = now;
+    for (int64_t socket : current) {
+        auto [it, inserted] = sockets_.emplace(socket, now);
+        if (inserted) opened_.fetch_add(1, std::memory_order_relaxed);
+        oldest = std::min(oldest, it->second);
+    }
+    active_.store(sockets_.size(), std::memory_order_relaxed);
+    oldest_ms_.store(std::chrono::duration_cast<std::chrono::milliseconds>(now - oldest).count(),
+                     std::memory_order_relaxed);
+}
+
+ConnectionMonitor::Stats ConnectionMonitor::GetStats() const {
+    Stats stats;
+    stats.active = active_.load(std::memory_order_relaxed);
+    stats.opened = opened_.load(std::memory_order_relaxed);
+    stats.closed = closed_.load(std::memory_order_relaxed);
+    stats.aged_out = aged_out_.load(std::memory_order_relaxed);
+    stats.oldest_age_seconds = static_cast<double>(oldest_ms_.load(std::memory_order_relaxed)) / 1000.0;
+    return stats;
+}
+
+} // namespace prodstarter
@@ -0,0 +1,75 @@
+// ProdStarterHub - C++ gRPC Service
+// src/server/connection_monitor.h
+// Counts the server's HTTP/2 connections from channelz.
+//
+// The connection lifecycle itself (max age with jitter, grace, max idle and
+// keepalive enforcement) is plain gRPC channel arguments set by ApplyTuning();
+// gRPC has no public hook for connection events, so this polls the channelz
+// socket list of every server in the process and diffs it against the last
+// poll. A connection that disappears after living at least the jittered max
+// age (0.9 x max_connection_age, less one poll interval) is counted as aged
+// out, i.e. closed by the GOAWAY the age policy sent; anything shorter-lived
+// was closed by the client, the idle timer or an error.
+//
+// Connections that open and close between two polls are never seen, so the
+// opened/closed counters are a lower bound at the poll granularity.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace prodstarter {
+
+struct ConnectionMonitorOptions {
+    std::chrono::milliseconds poll_interval{1000};
+    std::chrono::milliseconds max_connection_age{0}; // 0: no age policy, nothing is counted as aged out
+};
+
+class ConnectionMonitor {
+public:
+    struct Stats {
+        uint64_t active = 0;
+        uint64_t opened = 0;
+        uint64_t closed = 0;
+        uint64_t aged_out = 0;
+        double oldest_age_seconds = 0.0;
+    };
+
+    explicit ConnectionMonitor(ConnectionMonitorOptions options) : options_(options) {}
+    ~ConnectionMonitor() { Stop(); }
+
+    ConnectionMonitor(const ConnectionMonitor&) = delete;
+    ConnectionMonitor& operator=(const ConnectionMonitor&) = delete;
+
+    // Starts polling once the servers are running.
+    void Start();
+    void Stop();
+
+    Stats GetStats() const;
+
+private:
+    void Poll();
+    void Run();
+
+    const ConnectionMonitorOptions options_;
+
+    std::unordered_map<int64_t, std::chrono::steady_clock::time_point> sockets_; // socket id -> first seen
+    std::atomic<uint64_t> active_{0};
+    std::atomic<uint64_t> opened_{0};
+    std::atomic<uint64_t> closed_{0};
+    std::atomic<uint64_t> aged_out_{0};
+    std::atomic<int64_t> oldest_ms_{0};
+
+    std::mutex mu_;
+    std::condition_variable cv_;
+    bool stopping_ = false;
+    std::thread poller_;
+};
+
+} // namespace prodstarter
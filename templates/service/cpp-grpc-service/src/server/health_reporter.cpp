@@ -0,0 +1,55 @@
+// ProdStarterHub - C++ gRPC Service
+// src/server/health_reporter.cpp
+
+#include "server/health_reporter.h"
+
+#include <algorithm>
+
+namespace prodstarter {
+
+void HealthReporter::Add(grpc::HealthCheckServiceInterface* service) {
+    if (service == nullptr) return;
+    std::lock_guard<std::mutex> lock(mu_);
+    services_.push_back(service);
+    // Only the named overload is used: the unnamed one would override every named service.
+    if (ready_set_) service->SetServingStatus(std::string(), ready_);
+    for (const auto& entry : statuses_) service->SetServingStatus(entry.service_name, entry.published);
+}
+
+void HealthReporter::SetServingStatus(bool serving) {
+    SetServingStatus(std::string(), serving);
+}
+
+void HealthReporter::SetServingStatus(const std::string& service_name, bool serving) {
+    std::lock_guard<std::mutex> lock(mu_);
+    if (service_name.empty()) {
+        ready_ = serving;
+        ready_set_ = true;
+        PublishLocked(service_name, serving);
+        for (auto& entry : statuses_) {
+            const bool published = entry.serving && ready_;
+            if (published == entry.published) continue;
+            entry.published = published;
+            PublishLocked(entry.service_name, published);
+        }
+        return;
+    }
+
+    auto it = std::find_if(statuses_.begin(), statuses_.end(),
+                           [&](const Entry& entry) { return entry.service_name == service_name; });
+    const bool published = serving && ready_;
+    if (it == statuses_.end()) {
+        statuses_.push_back(Entry{service_name, serving, published});
+    } else {
+        it->serving = serving;
+        if (it->published == published) return;
+        it->published = published;
+    }
+    PublishLocked(service_name, published);
+}
+
+void HealthReporter::PublishLocked(const std::string& service_name, bool serving) {
+    for (auto* service : services_) service->SetServingStatus(service_name, serving);
+}
+
+} // namespace prodstarter
@@ -0,0 +1,54 @@
+// ProdStarterHub - C++ gRPC Service
+// src/server/health_reporter.h
+// Publishes serving status to the grpc.health.v1 service of every shard.
+//
+// Each grpc::Server owns its own default health service, so with --shards N a
+// status change has to reach all N of them; otherwise a probe would see a
+// different answer depending on which shard the kernel routed it to.
+//
+// The overall status (the empty service name) is the server's readiness:
+// startup, warm-up and shutdown set it. Named services belong to components
+// such as the concurrency limiter and the saturation watchdog, and what they
+// publish is their own status ANDed with readiness. A readiness change never
+// overwrites a component's status, so a server that becomes ready while
+// overloaded keeps reporting the overload.
+
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <grpcpp/health_check_service_interface.h>
+
+namespace prodstarter {
+
+class HealthReporter {
+public:
+    // Adds a shard's health service. Statuses already set are replayed onto it.
+    void Add(grpc::HealthCheckServiceInterface* service);
+
+    // Overall server readiness (the empty service name). Named services report NOT_SERVING while it is false.
+    void SetServingStatus(bool serving);
+
+    // Status of a component-owned service, e.g. "overload". Cheap when nothing changes, so owners may re-assert it
+    // periodically. The empty name sets readiness.
+    void SetServingStatus(const std::string& service_name, bool serving);
+
+private:
+    struct Entry {
+        std::string service_name;
+        bool serving;   // as set by its owner
+        bool published; // serving && ready_, as last sent to the services
+    };
+
+    void PublishLocked(const std::string& service_name, bool serving);
+
+    std::mutex mu_;
+    std::vector<grpc::HealthCheckServiceInterface*> services_;
+    bool ready_ = true;      // gRPC's default health service starts out SERVING
+    bool ready_set_ = false; // replayed by Add() only once set
+    std::vector<Entry> statuses_; // named services, replayed by Add()
+};
+
+} // namespace prodstarter
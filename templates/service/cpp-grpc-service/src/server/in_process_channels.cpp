@@ -0,0 +1,24 @@
+// ProdStarterHub - C++ gRPC Service
+// src/server/in_process_channels.cpp
+
+#include "server/in_process_channels.h"
+
+#include "server/shard_set.h"
+
+namespace prodstarter {
+
+void InProcessChannelFactory::Bind(ShardSet& shards) {
+    if (bound()) return;
+    for (size_t i = 0; i < shards.size(); ++i) {
+        grpc::Server* server = shards.shard(i).server();
+        if (server != nullptr) channels_.push_back(server->InProcessChannel(args_));
+    }
+    bound_.store(!channels_.empty(), std::memory_order_release);
+}
+
+std::shared_ptr<grpc::Channel> InProcessChannelFactory::Get() {
+    if (!bound()) return nullptr;
+    return channels_[next_.fetch_add(1, std::memory_order_relaxed) % channels_.size()];
+}
+
+} // namespace prodstarter
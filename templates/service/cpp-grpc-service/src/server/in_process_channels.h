@@ -0,0 +1,59 @@
+// ProdStarterHub - C++ gRPC Service
+// src/server/in_process_channels.h
+// Channels into this process's own server, for callers inside the binary.
+//
+// A module that calls another module's RPC in the same binary does not need
+// the network stack: grpc::Server::InProcessChannel() hands over the call
+// without sockets, HTTP/2 framing or TLS, yet it still runs through the server
+// interceptors (deadlines, limits, caching, metrics) like a remote call. The
+// factory is created before the shards start, so it can be injected into the
+// services that use it, and is bound to the running shards afterwards:
+//
+//   InProcessChannelFactory in_process;
+//   MyService service(in_process);                 // keeps the reference
+//   shards.Start(...);
+//   in_process.Bind(shards);
+//   ...
+//   auto stub = myproto::Example::NewStub(in_process.Get()); // in the handler
+//
+// With --shards N there is one channel per shard and Get() rotates over them,
+// so self-calls are spread like the kernel spreads TCP connections.
+// Calls made after shutdown fail with UNAVAILABLE.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <grpcpp/grpcpp.h>
+
+namespace prodstarter {
+
+class ShardSet;
+
+class InProcessChannelFactory {
+public:
+    explicit InProcessChannelFactory(grpc::ChannelArguments args = {}) : args_(std::move(args)) {}
+
+    InProcessChannelFactory(const InProcessChannelFactory&) = delete;
+    InProcessChannelFactory& operator=(const InProcessChannelFactory&) = delete;
+
+    // Creates a channel to every started shard. Call once, after ShardSet::Start() and before calls are made.
+    void Bind(ShardSet& shards);
+
+    // A channel into the server; null before Bind().
+    std::shared_ptr<grpc::Channel> Get();
+
+    bool bound() const { return bound_.load(std::memory_order_acquire); }
+
+private:
+    grpc::ChannelArguments args_;
+    std::vector<std::shared_ptr<grpc::Channel>> channels_; // written once by Bind()
+    std::atomic<bool> bound_{false};
+    std::atomic<uint64_t> next_{0};
+};
+
+} // namespace prodstarter
@@ -0,0 +1,139 @@
+// ProdStarterHub - C++ gRPC Service
+// src/server/shard_set.cpp
+
+#include "server/shard_set.h"
+
+#include <algorithm>
+#include <thread>
+
+#include <spdlog/spdlog.h>
+
+namespace prodstarter {
+
+namespace {
+
+// Splits the process-wide quota and thread limits so N shards together stay
+// within what the tuning profile allows for one server.
+TuningConfig PerShardTuning(TuningConfig tuning, int num_shards) {
+    if (num_shards <= 1) return tuning;
+    constexpr int64_t kMinQuotaBytes = 1024 * 1024;
+    if (tuning.resource_quota_bytes > 0) {
+        tuning.resource_quota_bytes = std::max(kMinQuotaBytes, tuning.resource_quota_bytes / num_shards);
+    }
+    if (tuning.max_threads > 0) {
+        tuning.max_threads = std::max(2, tuning.max_threads / num_shards);
+    }
+    return tuning;
+}
+
+// Replaces a trailing ":0" with the port the first shard was given, so the
+// remaining shards join the same listener group.
+std::string WithPort(const std::string& address, int port) {
+    const auto colon = address.rfind(':');
+    if (colon == std::string::npos || address.substr(colon + 1) != "0") return address;
+    return address.substr(0, colon + 1) + std::to_string(port);
+}
+
+} // namespace
+
+ServerShard::ServerShard(int index, int engine_threads, ThreadPlacement placement)
+    : index_(index), builder_(std::make_unique<grpc::ServerBuilder>()) {
+    if (engine_threads > 0) engine_ = std::make_unique<AsyncEngine>(engine_threads, std::move(placement));
+}
+
+ShardSet::ShardSet(ShardOptions options)
+    : options_(std::move(options)), listening_address_(options_.bind_address) {
+    if (options_.num_shards < 1) options_.num_shards = 1;
+}
+
+ShardSet::~ShardSet() {
+    if (!stopped_) {
+        Shutdown(std::chrono::system_clock::now());
+        ShutdownEngines();
+    }
+}
+
+bool ShardSet::Start(const Configurer& configure) {
+    const int count = options_.num_shards;
+    const TuningConfig tuning = PerShardTuning(options_.tuning, count);
+
+    for (int i = 0; i < count; ++i) {
+        // Spread the polling threads evenly; the first shards take the remainder.
+        int engine_threads = 0;
+        if (options_.async_engine) {
+            engine_threads = std::max(1, options_.engine_threads / count + (i < options_.engine_threads % count ? 1 : 0));
+        }
+        ThreadPlacement placement;
+        if (static_cast<size_t>(i) < options_.placements.size()) placement = options_.placements[i];
+        auto shard = std::make_unique<ServerShard>(i, engine_threads, std::move(placement));
+        grpc::ServerBuilder& builder = shard->builder();
+
+        ApplyTuning(tuning, builder);
+        if (count > 1) builder.AddChannelArgument(GRPC_ARG_ALLOW_REUSEPORT, 1);
+        builder.AddListeningPort(listening_address_, options_.credentials, &shard->selected_port_);
+        std::vector<int> unix_ports(i == 0 ? options_.unix_listeners.size() : 0);
+        for (size_t l = 0; l < unix_ports.size(); ++l) {
+            builder.AddListeningPort(options_.unix_listeners[l], grpc::InsecureServerCredentials(), &unix_ports[l]);
+        }
+        if (shard->engine_) {
+            shard->engine_->SetArenaPool(options_.arenas);
+            shard->engine_->SetLanes(options_.lanes);
+            shard->engine_->AddCompletionQueues(builder);
+        }
+
+        configure(*shard);
+
+        shard->server_ = builder.BuildAndStart();
+        const bool unix_failed = std::count(unix_ports.begin(), unix_ports.end(), 0) > 0;
+        if (!shard->server_ || shard->selected_port_ == 0 || unix_failed) {
+            // One address that cannot be bound fails the whole build; name the ones that were not bound.
+            std::string addresses = shard->selected_port_ == 0 ? listening_address_ : "";
+            for (size_t l = 0; l < unix_ports.size(); ++l) {
+                if (unix_ports[l] == 0) addresses += (addresses.empty() ? "" : ", ") + options_.unix_listeners[l];
+            }
+            if (addresses.empty()) addresses = listening_address_;
+            spdlog::error("Failed to start server shard {} on {}", i, addresses);
+            shards_.push_back(std::move(shard));
+            return false;
+        }
+        if (i == 0) listening_address_ = WithPort(listening_address_, shard->selected_port_);
+        health_.Add(shard->server_->GetHealthCheckService());
+        shards_.push_back(std::move(shard));
+    }
+
+    for (auto& shard : shards_) {
+        if (shard->engine_) shard->engine_->Start();
+    }
+    if (count > 1) {
+        spdlog::info("Started {} server shards on {} (SO_REUSEPORT)", count, listening_address_);
+    }
+    return true;
+}
+
+void ShardSet::Shutdown(std::chrono::system_clock::time_point deadline) {
+    stopped_ = true;
+    // Server::Shutdown blocks until its calls finish or the deadline passes;
+    // run them side by side so N shards drain within one deadline, not N.
+    std::vector<std::thread> stoppers;
+    stoppers.reserve(shards_.size());
+    for (auto& shard : shards_) {
+        if (!shard->server_) continue;
+        grpc::Server* server = shard->server_.get();
+        stoppers.emplace_back([server, deadline] { server->Shutdown(deadline); });
+    }
+    for (auto& t : stoppers) t.join();
+}
+
+void ShardSet::ShutdownEngines() {
+    for (auto& shard : shards_) {
+        if (shard->engine_) shard->engine_->Shutdown();
+    }
+}
+
+void ShardSet::Wait() {
+    for (auto& shard : shards_) {
+        if (shard->server_) shard->server_->Wait();
+    }
+}
+
+} // namespace prodstarter
@@ -0,0 +1,134 @@
+// ProdStarterHub - C++ gRPC Service
+// src/server/shard_set.h
+// N independent grpc::Server shards listening on the same address (--shards N).
+//
+// A single server funnels every connection through one listener and one set
+// of pollers, which stops scaling long before a 64-core host is busy. With
+// shards each server binds the same address with SO_REUSEPORT
+// (GRPC_ARG_ALLOW_REUSEPORT), so the kernel spreads incoming connections
+// across them, and each shard has its own completion queues and threads:
+// a connection and all of its calls stay on one shard.
+//
+//   ShardSet shards(options);
+//   shards.Start([&](ServerShard& shard) {
+//       shard.builder().RegisterService(&sync_or_callback_impl); // may be shared by all shards
+//       auto& async_service = shard.Emplace<myproto::Example::AsyncService>(); // one per shard
+//       shard.builder().RegisterService(&async_service);
+//       AddUnaryMethod(*shard.engine(), &async_service, ...);
+//   });
+//
+// Sync and callback service objects can be registered with every shard. An
+// AsyncService can only belong to one server, so async services are created
+// per shard. Health status is fanned out to all shards through health().
+//
+// Unix domain socket listeners (--unix-listen) are added to shard 0 only: a
+// socket path cannot be shared through SO_REUSEPORT. They accept plaintext,
+// since only local processes can reach them and the socket file's permissions
+// (set by the umask and its directory) decide which.
+
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <grpcpp/grpcpp.h>
+
+#include "config/tuning.h"
+#include "engine/arena_pool.h"
+#include "engine/async_engine.h"
+#include "exec/cpu_topology.h"
+#include "server/health_reporter.h"
+
+namespace prodstarter {
+
+struct ShardOptions {
+    std::string bind_address;
+    std::shared_ptr<grpc::ServerCredentials> credentials;
+    std::vector<std::string> unix_listeners; // unix:PATH or unix-abstract:NAME, plaintext, on shard 0
+    int num_shards = 1;
+    bool async_engine = false;
+    int engine_threads = 1; // total across shards; each shard gets an equal share
+    TuningConfig tuning;    // quota and thread limits are split across shards
+    ArenaPool* arenas = nullptr; // per-call message arenas for the async engines; shared by all shards
+    LaneExecutor* lanes = nullptr; // priority lanes for the async engines' handlers; shared by all shards
+    std::vector<ThreadPlacement> placements; // polling threads of shard i (--cpu-set, --numa-policy); empty: float
+};
+
+class ServerShard {
+public:
+    ServerShard(int index, int engine_threads, ThreadPlacement placement = {});
+
+    ServerShard(const ServerShard&) = delete;
+    ServerShard& operator=(const ServerShard&) = delete;
+
+    int index() const { return index_; }
+    grpc::ServerBuilder& builder() { return *builder_; }
+
+    // Null unless the async engine is selected.
+    AsyncEngine* engine() { return engine_.get(); }
+    grpc::Server* server() { return server_.get(); }
+
+    // Creates an object owned by this shard, e.g. a per-shard AsyncService.
+    template <class T, class... Args>
+    T& Emplace(Args&&... args) {
+        auto object = std::make_shared<T>(std::forward<Args>(args)...);
+        T& ref = *object;
+        owned_.push_back(std::move(object));
+        return ref;
+    }
+
+private:
+    friend class ShardSet;
+
+    int index_;
+    int selected_port_ = 0;
+    std::vector<std::shared_ptr<void>> owned_; // outlives the server and engine
+    std::unique_ptr<AsyncEngine> engine_;      // queues must outlive the server
+    std::unique_ptr<grpc::ServerBuilder> builder_;
+    std::unique_ptr<grpc::Server> server_;
+};
+
+class ShardSet {
+public:
+    using Configurer = std::function<void(ServerShard&)>;
+
+    explicit ShardSet(ShardOptions options);
+    ~ShardSet();
+
+    ShardSet(const ShardSet&) = delete;
+    ShardSet& operator=(const ShardSet&) = delete;
+
+    // Builds every shard: applies tuning, adds the listener and queues, then
+    // calls `configure` to register services before BuildAndStart(). Starts the
+    // async engines once all shards are up. Returns false if any shard fails.
+    bool Start(const Configurer& configure);
+
+    // Stops every shard in parallel; calls still running at `deadline` are cancelled.
+    void Shutdown(std::chrono::system_clock::time_point deadline);
+
+    // Shuts down the engine queues. Call only after Shutdown().
+    void ShutdownEngines();
+
+    void Wait();
+
+    HealthReporter& health() { return health_; }
+    size_t size() const { return shards_.size(); }
+    ServerShard& shard(size_t index) { return *shards_[index]; }
+
+    // The address actually bound; differs from the configured one only when
+    // port 0 asked the kernel to pick a port.
+    const std::string& listening_address() const { return listening_address_; }
+
+private:
+    ShardOptions options_;
+    std::string listening_address_;
+    std::vector<std::unique_ptr<ServerShard>> shards_;
+    HealthReporter health_;
+    bool stopped_ = false;
+};
+
+} // namespace prodstarter
@@ -0,0 +1,60 @@
+// ProdStarterHub - C++ gRPC Service
+// src/server/tls_credentials.cpp
+
+#include "server/tls_credentials.h"
+
+#include <fstream>
+#include <iterator>
+
+#include <grpcpp/security/tls_certificate_provider.h>
+#include <grpcpp/security/tls_credentials_options.h>
+#include <spdlog/spdlog.h>
+
+namespace prodstarter {
+
+namespace {
+
+bool ReadFile(const std::string& path, std::string& contents, std::string& error) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        error = "cannot open " + path;
+        return false;
+    }
+    contents.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    if (contents.empty()) {
+        error = path + " is empty";
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+std::shared_ptr<grpc::ServerCredentials> MakeTlsServerCredentials(const TlsOptions& options, std::string& error) {
+    // Read everything up front even when watching: a bad path should fail startup, not every handshake.
+    std::string cert, key, root;
+    if (!ReadFile(options.cert_chain_file, cert, error) || !ReadFile(options.private_key_file, key, error)) {
+        return nullptr;
+    }
+    if (!options.root_cert_file.empty() && !ReadFile(options.root_cert_file, root, error)) return nullptr;
+
+    if (options.reload_interval.count() <= 0) {
+        grpc::SslServerCredentialsOptions ssl_opts;
+        ssl_opts.pem_key_cert_pairs.push_back({key, cert});
+        if (!root.empty()) ssl_opts.pem_root_certs = root;
+        return grpc::SslServerCredentials(ssl_opts);
+    }
+
+    auto provider = std::make_shared<grpc::experimental::FileWatcherCertificateProvider>(
+        options.private_key_file, options.cert_chain_file, options.root_cert_file,
+        static_cast<unsigned int>(options.reload_interval.count()));
+    grpc::experimental::TlsServerCredentialsOptions tls_opts(provider);
+    tls_opts.watch_identity_key_cert_pairs();
+    if (!options.root_cert_file.empty()) tls_opts.watch_root_certs();
+    // Same client-certificate policy as the static credentials.
+    tls_opts.set_cert_request_type(GRPC_SSL_DONT_REQUEST_CLIENT_CERTIFICATE);
+    spdlog::info("TLS certificates reloaded from disk every {} s", options.reload_interval.count());
+    return grpc::experimental::TlsServerCredentials(tls_opts);
+}
+
+} // namespace prodstarter
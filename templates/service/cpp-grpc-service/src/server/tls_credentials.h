@@ -0,0 +1,35 @@
+// ProdStarterHub - C++ gRPC Service
+// src/server/tls_credentials.h
+// Server credentials from PEM files, optionally reloaded while serving.
+//
+// Without a reload interval the files are read once and baked into
+// SslServerCredentials; rotating them needs a restart, which drops every
+// HTTP/2 connection. With --tls-reload-interval the credentials are backed by
+// grpc::experimental::FileWatcherCertificateProvider instead: gRPC re-reads
+// the files on that interval and new handshakes use whatever was last loaded
+// successfully, while established connections keep the certificate they
+// negotiated. Replace the key and chain atomically (write elsewhere, then
+// rename), or the watcher may pick up a key that does not match its chain; a
+// mismatched pair is ignored until the next interval.
+
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <string>
+
+#include <grpcpp/security/server_credentials.h>
+
+namespace prodstarter {
+
+struct TlsOptions {
+    std::string cert_chain_file;
+    std::string private_key_file;
+    std::string root_cert_file;               // optional
+    std::chrono::seconds reload_interval{0};  // 0 reads the files once at startup
+};
+
+// Returns null and sets `error` when the files cannot be read.
+std::shared_ptr<grpc::ServerCredentials> MakeTlsServerCredentials(const TlsOptions& options, std::string& error);
+
+} // namespace prodstarter
@@ -0,0 +1,151 @@
+// ProdStarterHub - C++ gRPC Service
+// src/tracing/otlp_exporter.cpp
+
+#include "tracing/otlp_exporter.h"
+
+#include <cstdint>
+#include <future>
+#include <utility>
+
+#include <spdlog/fmt/fmt.h>
+
+namespace prodstarter {
+
+namespace {
+
+constexpr char kExportMethod[] = "/opentelemetry.proto.collector.trace.v1.TraceService/Export";
+constexpr char kScopeName[] = "prodstarter.tracing";
+constexpr int kStatusCodeError = 2; // opentelemetry.proto.trace.v1.Status.StatusCode
+
+enum WireType : uint32_t { kVarint = 0, kFixed64 = 1, kLength = 2 };
+
+void PutVarint(std::string* out, uint64_t value) {
+    while (value >= 0x80) {
+        out->push_back(static_cast<char>(value | 0x80));
+        value >>= 7;
+    }
+    out->push_back(static_cast<char>(value));
+}
+
+void PutTag(std::string* out, uint32_t field, WireType type) { PutVarint(out, field << 3 | type); }
+
+void PutBytes(std::string* out, uint32_t field, std::string_view bytes) {
+    PutTag(out, field, kLength);
+    PutVarint(out, bytes.size());
+    out->append(bytes.data(), bytes.size());
+}
+
+void PutFixed64(std::string* out, uint32_t field, uint64_t value) {
+    PutTag(out, field, kFixed64);
+    for (int i = 0; i < 8; ++i) out->push_back(static_cast<char>(value >> (8 * i)));
+}
+
+void PutUint(std::string* out, uint32_t field, uint64_t value) {
+    PutTag(out, field, kVarint);
+    PutVarint(out, value);
+}
+
+std::string_view Bytes(const uint8_t* data, size_t size) {
+    return std::string_view(reinterpret_cast<const char*>(data), size);
+}
+
+// KeyValue{key = 1, value = 2: AnyValue{string_value = 1}}
+void PutStringAttribute(std::string* out, uint32_t field, std::string_view key, std::string_view value) {
+    std::string any;
+    PutBytes(&any, 1, value);
+    std::string kv;
+    PutBytes(&kv, 1, key);
+    PutBytes(&kv, 2, any);
+    PutBytes(out, field, kv);
+}
+
+// KeyValue{key = 1, value = 2: AnyValue{int_value = 3}}
+void PutIntAttribute(std::string* out, uint32_t field, std::string_view key, int64_t value) {
+    std::string any;
+    PutUint(&any, 3, static_cast<uint64_t>(value));
+    std::string kv;
+    PutBytes(&kv, 1, key);
+    PutBytes(&kv, 2, any);
+    PutBytes(out, field, kv);
+}
+
+void PutSpan(std::string* out, const SpanRecord& span, std::string_view method) {
+    // "/package.Service/Method" -> span name "package.Service/Method"
+    const std::string_view name = !method.empty() && method[0] == '/' ? method.substr(1) : method;
+    const size_t slash = name.rfind('/');
+
+    std::string s;
+    PutBytes(&s, 1, Bytes(span.trace_id.data(), span.trace_id.size()));
+    PutBytes(&s, 2, Bytes(span.span_id.data(), span.span_id.size()));
+    if (span.parent_span_id != SpanId{}) {
+        PutBytes(&s, 4, Bytes(span.parent_span_id.data(), span.parent_span_id.size()));
+    }
+    PutBytes(&s, 5, name);
+    PutUint(&s, 6, static_cast<uint64_t>(span.kind));
+    PutFixed64(&s, 7, static_cast<uint64_t>(span.start_unix_ns));
+    PutFixed64(&s, 8, static_cast<uint64_t>(span.end_unix_ns));
+    PutStringAttribute(&s, 9, "rpc.system", "grpc");
+    if (slash != std::string_view::npos) {
+        PutStringAttribute(&s, 9, "rpc.service", name.substr(0, slash));
+        PutStringAttribute(&s, 9, "rpc.method", name.substr(slash + 1));
+    }
+    PutIntAttribute(&s, 9, "rpc.grpc.status_code", span.code);
+    if (SpanFailed(span)) {
+        std::string status;
+        PutUint(&status, 3, kStatusCodeError);
+        PutBytes(&s, 15, status);
+    }
+    PutBytes(out, 2, s); // ScopeSpans.spans
+}
+
+} // namespace
+
+std::string EncodeExportTraceRequest(const std::string& resource, const std::vector<SpanRecord>& spans,
+                                     const std::vector<std::string_view>& names) {
+    std::string scope;
+    PutBytes(&scope, 1, kScopeName);
+
+    std::string scope_spans;
+    PutBytes(&scope_spans, 1, scope);
+    for (const auto& span : spans) PutSpan(&scope_spans, span, span.name < names.size() ? names[span.name] : "");
+
+    std::string resource_spans;
+    PutBytes(&resource_spans, 1, resource);
+    PutBytes(&resource_spans, 2, scope_spans);
+
+    std::string request;
+    PutBytes(&request, 1, resource_spans);
+    return request;
+}
+
+OtlpExporter::OtlpExporter(const std::string& endpoint, std::string service_name)
+    : channel_(grpc::CreateChannel(endpoint, grpc::InsecureChannelCredentials())),
+      stub_(channel_),
+      resource_([&service_name] {
+          std::string resource;
+          PutStringAttribute(&resource, 1, "service.name", service_name);
+          PutStringAttribute(&resource, 1, "telemetry.sdk.language", "cpp");
+          return resource;
+      }()) {}
+
+bool OtlpExporter::Export(const std::vector<SpanRecord>& spans, const std::vector<std::string_view>& names,
+                          std::string* error) {
+    const std::string encoded = EncodeExportTraceRequest(resource_, spans, names);
+    grpc::Slice slice(encoded);
+    const grpc::ByteBuffer request(&slice, 1);
+    grpc::ByteBuffer response;
+    grpc::ClientContext ctx;
+    ctx.set_deadline(std::chrono::system_clock::now() + kTimeout);
+
+    std::promise<grpc::Status> finished;
+    stub_.UnaryCall(&ctx, kExportMethod, grpc::StubOptions(), &request, &response,
+                    [&finished](grpc::Status status) { finished.set_value(std::move(status)); });
+    const grpc::Status status = finished.get_future().get();
+    if (!status.ok()) {
+        *error = fmt::format("{} ({})", status.error_message(), static_cast<int>(status.error_code()));
+        return false;
+    }
+    return true;
+}
+
+} // namespace prodstarter
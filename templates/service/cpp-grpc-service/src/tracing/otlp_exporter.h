@@ -0,0 +1,50 @@
+// ProdStarterHub - C++ gRPC Service
+// src/tracing/otlp_exporter.h
+// Sends finished spans to an OpenTelemetry collector over OTLP/gRPC.
+//
+// The request (opentelemetry.proto.collector.trace.v1.ExportTraceServiceRequest)
+// is encoded by hand in protobuf wire format and sent with a GenericStub, so
+// the template needs neither the OpenTelemetry SDK nor its generated protos.
+// Each span carries rpc.system, rpc.service, rpc.method and
+// rpc.grpc.status_code; the resource carries service.name.
+//
+// Export() blocks until the collector answers; it is only called from the
+// tracer's exporter thread.
+
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <grpcpp/generic/generic_stub.h>
+#include <grpcpp/grpcpp.h>
+
+#include "tracing/span_buffer.h"
+
+namespace prodstarter {
+
+class OtlpExporter {
+public:
+    static constexpr auto kTimeout = std::chrono::seconds(10);
+
+    // Plaintext channel to `endpoint` (host:port); collectors are usually a local agent or sidecar.
+    OtlpExporter(const std::string& endpoint, std::string service_name);
+
+    // Sends `spans` in one request; `names` maps SpanRecord::name to the full method name. Returns false with
+    // `error` set when the collector did not accept them.
+    bool Export(const std::vector<SpanRecord>& spans, const std::vector<std::string_view>& names, std::string* error);
+
+private:
+    std::shared_ptr<grpc::Channel> channel_;
+    grpc::GenericStub stub_;
+    const std::string resource_; // encoded Resource message, the same for every request
+};
+
+// The ExportTraceServiceRequest for `spans`, in protobuf wire format.
+std::string EncodeExportTraceRequest(const std::string& resource, const std::vector<SpanRecord>& spans,
+                                     const std::vector<std::string_view>& names);
+
+} // namespace prodstarter
@@ -0,0 +1,97 @@
+// ProdStarterHub - C++ gRPC Service
+// src/tracing/span_buffer.h
+// Finished spans, and the per-thread ring they are handed to the exporter in.
+//
+// Every thread that finishes spans owns one SpanRing. It is a single-producer
+// single-consumer ring: the owning thread writes a fixed-size SpanRecord into
+// the next slot and publishes it with one release store, and the exporter
+// thread drains it. Nothing is allocated, locked or formatted on the calling
+// thread; a full ring drops the span and counts it, so a stalled exporter can
+// never slow the calls down.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include <grpcpp/support/status.h>
+
+#include "tracing/trace_context.h"
+
+namespace prodstarter {
+
+enum class SpanKind : uint8_t { kServer = 2, kClient = 3 }; // OTLP Span.SpanKind values
+
+struct SpanRecord {
+    TraceId trace_id{};
+    SpanId span_id{};
+    SpanId parent_span_id{}; // zero for a trace started here
+    int64_t start_unix_ns = 0;
+    int64_t end_unix_ns = 0;
+    uint32_t name = 0; // Tracer::Intern() id of the full method name
+    SpanKind kind = SpanKind::kServer;
+    uint8_t code = 0;  // grpc::StatusCode
+    bool local_root = false; // first span of the trace in this process; it decides whether the trace is kept
+};
+
+// Server spans fail on the codes that mean the server could not do its job (OpenTelemetry's gRPC conventions), so
+// rejected and invalid requests do not count as errors; client spans fail on every code but OK.
+inline bool SpanFailed(const SpanRecord& span) {
+    if (span.kind == SpanKind::kClient) return static_cast<grpc::StatusCode>(span.code) != grpc::StatusCode::OK;
+    switch (static_cast<grpc::StatusCode>(span.code)) {
+    case grpc::StatusCode::UNKNOWN:
+    case grpc::StatusCode::DEADLINE_EXCEEDED:
+    case grpc::StatusCode::UNIMPLEMENTED:
+    case grpc::StatusCode::INTERNAL:
+    case grpc::StatusCode::UNAVAILABLE:
+    case grpc::StatusCode::DATA_LOSS: return true;
+    default: return false;
+    }
+}
+
+class SpanRing {
+public:
+    static constexpr size_t kCapacity = 1024; // a power of two
+
+    // Producer side, owning thread only. Returns false when the ring is full; the span is then dropped.
+    bool Push(const SpanRecord& span) {
+        const uint64_t head = head_.load(std::memory_order_relaxed);
+        if (head - tail_.load(std::memory_order_acquire) == kCapacity) {
+            Bump(dropped_);
+            return false;
+        }
+        slots_[head & (kCapacity - 1)] = span;
+        head_.store(head + 1, std::memory_order_release);
+        Bump(pushed_);
+        return true;
+    }
+
+    // Consumer side, exporter thread only. Calls `sink` for every span published so far.
+    template <typename Sink>
+    size_t Drain(Sink&& sink) {
+        const uint64_t tail = tail_.load(std::memory_order_relaxed);
+        const uint64_t head = head_.load(std::memory_order_acquire);
+        for (uint64_t i = tail; i != head; ++i) sink(slots_[i & (kCapacity - 1)]);
+        tail_.store(head, std::memory_order_release);
+        return static_cast<size_t>(head - tail);
+    }
+
+    uint64_t pushed() const { return pushed_.load(std::memory_order_relaxed); }
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    // Counters have a single writer, so a load/store pair replaces a locked read-modify-write.
+    static void Bump(std::atomic<uint64_t>& cell) {
+        cell.store(cell.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    std::array<SpanRecord, kCapacity> slots_{};
+    alignas(64) std::atomic<uint64_t> head_{0}; // written by the producer
+    std::atomic<uint64_t> pushed_{0};
+    std::atomic<uint64_t> dropped_{0};
+    alignas(64) std::atomic<uint64_t> tail_{0}; // written by the consumer
+};
+
+} // namespace prodstarter
@@ -0,0 +1,115 @@
+// ProdStarterHub - C++ gRPC Service
+// src/tracing/trace_context.cpp
+
+#include "tracing/trace_context.h"
+
+#include <chrono>
+#include <functional>
+#include <random>
+#include <thread>
+
+namespace prodstarter {
+
+namespace {
+
+constexpr size_t kVersion00Size = 55; // 2 + 1 + 32 + 1 + 16 + 1 + 2
+
+int HexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1; // upper case is not allowed
+}
+
+bool ParseHex(std::string_view hex, uint8_t* out) {
+    for (size_t i = 0; i < hex.size() / 2; ++i) {
+        const int high = HexValue(hex[2 * i]);
+        const int low = HexValue(hex[2 * i + 1]);
+        if (high < 0 || low < 0) return false;
+        out[i] = static_cast<uint8_t>(high << 4 | low);
+    }
+    return true;
+}
+
+// splitmix64: fast, and good enough for ids that only need to be unique and uniform.
+uint64_t NextRandom() {
+    thread_local uint64_t state = [] {
+        std::random_device device;
+        const uint64_t seed = static_cast<uint64_t>(device()) << 32 ^ device();
+        return seed ^ static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count()) ^
+               std::hash<std::thread::id>()(std::this_thread::get_id());
+    }();
+    uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+void FillRandom(uint8_t* out, size_t size) {
+    for (size_t i = 0; i < size; i += 8) {
+        const uint64_t bits = NextRandom();
+        for (size_t b = 0; b < 8 && i + b < size; ++b) out[i + b] = static_cast<uint8_t>(bits >> (8 * b));
+    }
+}
+
+} // namespace
+
+bool ParseTraceparent(std::string_view value, TraceContext* out) {
+    if (value.size() < kVersion00Size || value[2] != '-' || value[35] != '-' || value[52] != '-') return false;
+    uint8_t version = 0;
+    if (!ParseHex(value.substr(0, 2), &version) || version == 0xff) return false;
+    // Version 00 has exactly these fields; later versions may append more after a dash.
+    if (value.size() > kVersion00Size && (version == 0 || value[kVersion00Size] != '-')) return false;
+
+    TraceContext parsed;
+    if (!ParseHex(value.substr(3, 32), parsed.trace_id.data()) ||
+        !ParseHex(value.substr(36, 16), parsed.span_id.data()) || !ParseHex(value.substr(53, 2), &parsed.flags) ||
+        !parsed.valid()) {
+        return false;
+    }
+    *out = parsed;
+    return true;
+}
+
+std::string FormatTraceparent(const TraceContext& context) {
+    std::string out = "00-";
+    out += ToHex(context.trace_id.data(), context.trace_id.size());
+    out += '-';
+    out += ToHex(context.span_id.data(), context.span_id.size());
+    out += '-';
+    out += ToHex(&context.flags, 1);
+    return out;
+}
+
+TraceId NewTraceId() {
+    TraceId id;
+    do {
+        FillRandom(id.data(), id.size());
+    } while (id == TraceId{});
+    return id;
+}
+
+SpanId NewSpanId() {
+    SpanId id;
+    do {
+        FillRandom(id.data(), id.size());
+    } while (id == SpanId{});
+    return id;
+}
+
+uint64_t TraceIdRandom(const TraceId& id) {
+    uint64_t bits = 0;
+    for (size_t i = 8; i < id.size(); ++i) bits = bits << 8 | id[i];
+    return bits;
+}
+
+std::string ToHex(const uint8_t* data, size_t size) {
+    static constexpr char kDigits[] = "0123456789abcdef";
+    std::string out(2 * size, '0');
+    for (size_t i = 0; i < size; ++i) {
+        out[2 * i] = kDigits[data[i] >> 4];
+        out[2 * i + 1] = kDigits[data[i] & 0xf];
+    }
+    return out;
+}
+
+} // namespace prodstarter
@@ -0,0 +1,52 @@
+// ProdStarterHub - C++ gRPC Service
+// src/tracing/trace_context.h
+// W3C trace context: ids of a trace and a span, and the traceparent header.
+//
+//   traceparent: 00-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7-01
+//                ver trace id (16 bytes)             parent span id   flags
+//
+// Ids are generated from a per-thread generator, so starting a span takes no
+// lock and no syscall. The low 8 bytes of a trace id are random, which lets
+// every service make the same ratio-sampling decision for a trace (see
+// tracing/tracer.h).
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace prodstarter {
+
+using TraceId = std::array<uint8_t, 16>;
+using SpanId = std::array<uint8_t, 8>;
+
+inline constexpr std::string_view kTraceparentHeader = "traceparent";
+
+struct TraceContext {
+    static constexpr uint8_t kSampled = 0x01;
+
+    TraceId trace_id{};
+    SpanId span_id{}; // the span that is current in this process, or the remote parent once parsed
+    uint8_t flags = 0;
+
+    bool valid() const { return trace_id != TraceId{} && span_id != SpanId{}; }
+};
+
+// Parses a traceparent header value. Returns false for malformed values, the all-zero ids and version ff; later
+// versions are read by their version 00 prefix, as the specification asks.
+bool ParseTraceparent(std::string_view value, TraceContext* out);
+
+std::string FormatTraceparent(const TraceContext& context);
+
+// Random non-zero ids from the calling thread's generator.
+TraceId NewTraceId();
+SpanId NewSpanId();
+
+// The low 8 bytes of the trace id as a number, uniform over [0, 2^64) for W3C-compliant ids.
+uint64_t TraceIdRandom(const TraceId& id);
+
+std::string ToHex(const uint8_t* data, size_t size);
+
+} // namespace prodstarter
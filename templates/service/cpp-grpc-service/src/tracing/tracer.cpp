@@ -0,0 +1,429 @@
+// ProdStarterHub - C++ gRPC Service
+// src/tracing/tracer.cpp
+
+#include "tracing/tracer.h"
+
+#include <deque>
+#include <iterator>
+#include <map>
+#include <utility>
+
+#include <spdlog/spdlog.h>
+
+#include "call/call_context.h"
+#include "metrics/transport_metrics.h"
+#include "tracing/otlp_exporter.h"
+
+namespace prodstarter {
+
+namespace {
+
+constexpr uint32_t kOtherName = 0;
+constexpr auto kExpireInterval = std::chrono::seconds(1);
+
+int64_t UnixNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+int64_t ElapsedNs(std::chrono::steady_clock::time_point since) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - since).count();
+}
+
+} // namespace
+
+struct Tracer::Shared {
+    // Returns the id of `name`, adding it while there is room, and a view of the interned name that stays valid
+    // for the lifetime of this object. A full table never changes again and is read without the lock, as in
+    // RpcMetrics, so spans named "other" do not serialize on mu.
+    std::pair<uint32_t, std::string_view> Intern(std::string_view name) {
+        if (full.load(std::memory_order_acquire)) return Find(name);
+        std::lock_guard<std::mutex> lock(mu);
+        if (names.size() >= kMaxSpanNames) return Find(name);
+        auto it = ids.find(name);
+        if (it != ids.end()) return {it->second, it->first};
+        names.emplace_back(name);
+        const auto id = static_cast<uint32_t>(names.size() - 1);
+        ids.emplace(names.back(), id);
+        if (names.size() >= kMaxSpanNames) full.store(true, std::memory_order_release);
+        return {id, names.back()};
+    }
+
+    std::pair<uint32_t, std::string_view> Find(std::string_view name) const {
+        auto it = ids.find(name);
+        if (it != ids.end()) return {it->second, it->first};
+        return {kOtherName, {}};
+    }
+
+    std::vector<std::string_view> Names() const {
+        std::lock_guard<std::mutex> lock(mu);
+        return std::vector<std::string_view>(names.begin(), names.end());
+    }
+
+    SpanRing* AcquireRing() {
+        std::lock_guard<std::mutex> lock(mu);
+        if (!free_rings.empty()) {
+            SpanRing* ring = free_rings.back();
+            free_rings.pop_back();
+            return ring;
+        }
+        rings.push_back(std::make_unique<SpanRing>());
+        return rings.back().get();
+    }
+
+    void ReleaseRing(SpanRing* ring) {
+        std::lock_guard<std::mutex> lock(mu);
+        free_rings.push_back(ring);
+    }
+
+    std::vector<SpanRing*> Rings() const {
+        std::lock_guard<std::mutex> lock(mu);
+        std::vector<SpanRing*> out;
+        for (const auto& ring : rings) out.push_back(ring.get());
+        return out;
+    }
+
+    mutable std::mutex mu;
+    std::deque<std::string> names{"other"}; // index is the name id; deque keeps the strings in place
+    std::unordered_map<std::string_view, uint32_t> ids;
+    std::atomic<bool> full{false}; // names and ids are frozen
+    std::vector<std::unique_ptr<SpanRing>> rings; // one per thread that finished spans, kept for the next thread
+    std::vector<SpanRing*> free_rings;            // rings of exited threads; the exporter still drains them
+};
+
+struct Tracer::ThreadState {
+    ~ThreadState() {
+        if (ring != nullptr) shared->ReleaseRing(ring);
+    }
+
+    std::shared_ptr<Shared> shared; // keeps the ring alive until this thread exits
+    SpanRing* ring = nullptr;       // taken when the thread finishes its first span
+    std::unordered_map<std::string_view, uint32_t> ids; // keys point into Shared::names
+};
+
+Tracer::ThreadState& Tracer::LocalState() {
+    thread_local ThreadState state;
+    return state;
+}
+
+Tracer::ThreadState& Tracer::BoundState() {
+    ThreadState& state = LocalState();
+    if (state.shared != shared_) {
+        if (state.ring != nullptr) state.shared->ReleaseRing(state.ring);
+        state.ring = nullptr;
+        state.ids.clear();
+        state.shared = shared_;
+    }
+    return state;
+}
+
+ClientSpan::ClientSpan(ClientSpan&& other) noexcept
+    : tracer_(std::exchange(other.tracer_, nullptr)), record_(other.record_), flags_(other.flags_),
+      start_(other.start_) {}
+
+ClientSpan& ClientSpan::operator=(ClientSpan&& other) noexcept {
+    if (this != &other) {
+        End(grpc::StatusCode::CANCELLED);
+        tracer_ = std::exchange(other.tracer_, nullptr);
+        record_ = other.record_;
+        flags_ = other.flags_;
+        start_ = other.start_;
+    }
+    return *this;
+}
+
+ClientSpan::~ClientSpan() {
+    End(grpc::StatusCode::CANCELLED);
+}
+
+void ClientSpan::End(grpc::StatusCode code) {
+    if (tracer_ == nullptr) return;
+    record_.code = static_cast<uint8_t>(code);
+    record_.end_unix_ns = record_.start_unix_ns + ElapsedNs(start_);
+    std::exchange(tracer_, nullptr)->Record(record_);
+}
+
+Tracer::Tracer(TracerOptions options)
+    : options_(std::move(options)),
+      sample_below_(options_.sample_rate <= 0 ? 0
+                                              : static_cast<uint64_t>(options_.sample_rate * 18446744073709551616.0)),
+      sample_all_(options_.sample_rate >= 1),
+      shared_(std::make_shared<Shared>()),
+      exporter_(std::make_unique<OtlpExporter>(options_.otlp_endpoint, options_.service_name)) {}
+
+Tracer::~Tracer() {
+    Stop();
+}
+
+void Tracer::Start() {
+    last_flush_ = std::chrono::steady_clock::now();
+    thread_ = std::thread(&Tracer::Run, this);
+}
+
+void Tracer::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    if (thread_.joinable()) thread_.join();
+}
+
+uint32_t Tracer::Intern(std::string_view name) {
+    ThreadState& state = BoundState();
+    auto it = state.ids.find(name);
+    if (it != state.ids.end()) return it->second;
+    const auto [id, interned] = shared_->Intern(name);
+    // The overflow name is not cached: its names are not interned and have no stable key. Shared::Intern() no
+    // longer locks once the table is full, which is when such names show up.
+    if (id != kOtherName) state.ids.emplace(interned, id);
+    return id;
+}
+
+void Tracer::Record(const SpanRecord& span) {
+    ThreadState& state = BoundState();
+    if (state.ring == nullptr) state.ring = shared_->AcquireRing();
+    state.ring->Push(span);
+}
+
+ClientSpan Tracer::StartClientSpan(const TraceContext* parent, grpc::ClientContext* client, std::string_view method) {
+    ClientSpan span;
+    span.tracer_ = this;
+    span.start_ = std::chrono::steady_clock::now();
+    span.record_.start_unix_ns = UnixNowNs();
+    span.record_.kind = SpanKind::kClient;
+    span.record_.name = Intern(method);
+    span.record_.span_id = NewSpanId();
+    if (parent != nullptr && parent->valid()) {
+        span.record_.trace_id = parent->trace_id;
+        span.record_.parent_span_id = parent->span_id;
+        span.flags_ = parent->flags;
+    } else {
+        span.record_.trace_id = NewTraceId();
+        span.record_.local_root = true;
+    }
+    client->AddMetadata(std::string(kTraceparentHeader), FormatTraceparent(span.context()));
+    return span;
+}
+
+void Tracer::Run() {
+    std::unique_lock<std::mutex> lock(mu_);
+    auto last_expire = std::chrono::steady_clock::now();
+    for (;;) {
+        cv_.wait_for(lock, kDrainInterval, [this] { return stopping_; });
+        const bool last = stopping_;
+        lock.unlock();
+
+        const auto now = std::chrono::steady_clock::now();
+        Drain(now);
+        if (last || now - last_expire >= kExpireInterval) {
+            ExpireOrphans(now, last);
+            last_expire = now;
+        }
+        if (!batch_.empty() && (last || now - last_flush_ >= options_.export_interval)) Flush();
+        pending_gauge_.store(pending_spans_, std::memory_order_relaxed);
+        if (last) return;
+        lock.lock();
+    }
+}
+
+void Tracer::Drain(std::chrono::steady_clock::time_point now) {
+    for (SpanRing* ring : shared_->Rings()) {
+        ring->Drain([this, now](const SpanRecord& span) {
+            Admit(span, now);
+            if (batch_.size() >= kMaxBatchSpans) Flush();
+        });
+    }
+}
+
+void Tracer::Admit(const SpanRecord& span, std::chrono::steady_clock::time_point now) {
+    if (kept_.count(span.trace_id) != 0) {
+        batch_.push_back(span);
+        return;
+    }
+    auto it = pending_.find(span.trace_id);
+    if (span.local_root) {
+        std::vector<SpanRecord> spans;
+        if (it != pending_.end()) {
+            spans = std::move(it->second.spans);
+            pending_spans_ -= spans.size();
+            pending_.erase(it);
+        }
+        spans.push_back(span);
+        Settle(span.trace_id, std::move(spans), &span, now);
+        return;
+    }
+    if (pending_spans_ >= kMaxPendingSpans) {
+        dropped_pending_full_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    if (it == pending_.end()) it = pending_.emplace(span.trace_id, Pending{{}, now}).first;
+    it->second.spans.push_back(span);
+    ++pending_spans_;
+}
+
+Tracer::Decision Tracer::Decide(const std::vector<SpanRecord>& spans, const SpanRecord* root) const {
+    const int64_t slow_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(options_.slow_threshold).count();
+    bool slow = root != nullptr && root->end_unix_ns - root->start_unix_ns >= slow_ns;
+    for (const auto& span : spans) {
+        if (SpanFailed(span)) return Decision::kError;
+        // Without a root the slowest span stands in for it.
+        if (root == nullptr && span.end_unix_ns - span.start_unix_ns >= slow_ns) slow = true;
+    }
+    if (slow) return Decision::kSlow;
+    if (sample_all_ || TraceIdRandom(spans.front().trace_id) < sample_below_) return Decision::kSampled;
+    return Decision::kDiscard;
+}
+
+void Tracer::Settle(const TraceId& trace, std::vector<SpanRecord> spans, const SpanRecord* root,
+                    std::chrono::steady_clock::time_point now) {
+    switch (Decide(spans, root)) {
+    case Decision::kError: kept_error_.fetch_add(1, std::memory_order_relaxed); break;
+    case Decision::kSlow: kept_slow_.fetch_add(1, std::memory_order_relaxed); break;
+    case Decision::kSampled: kept_sampled_.fetch_add(1, std::memory_order_relaxed); break;
+    case Decision::kDiscard: discarded_.fetch_add(1, std::memory_order_relaxed); return;
+    }
+    // Children that finish after the root, e.g. fire-and-forget calls, follow it for a while.
+    kept_[trace] = now;
+    batch_.insert(batch_.end(), spans.begin(), spans.end());
+}
+
+void Tracer::ExpireOrphans(std::chrono::steady_clock::time_point now, bool all) {
+    for (auto it = pending_.begin(); it != pending_.end();) {
+        if (!all && now - it->second.first_seen < kOrphanTimeout) {
+            ++it;
+            continue;
+        }
+        pending_spans_ -= it->second.spans.size();
+        const TraceId trace = it->first;
+        std::vector<SpanRecord> spans = std::move(it->second.spans);
+        it = pending_.erase(it);
+        Settle(trace, std::move(spans), nullptr, now);
+    }
+    for (auto it = kept_.begin(); it != kept_.end();) {
+        it = now - it->second >= kLateSpanWindow ? kept_.erase(it) : std::next(it);
+    }
+}
+
+void Tracer::Flush() {
+    last_flush_ = std::chrono::steady_clock::now();
+    if (batch_.empty()) return;
+    std::string error;
+    if (exporter_->Export(batch_, shared_->Names(), &error)) {
+        exported_.fetch_add(batch_.size(), std::memory_order_relaxed);
+        if (export_failing_) spdlog::info("Trace export to {} recovered", options_.otlp_endpoint);
+        export_failing_ = false;
+    } else {
+        dropped_export_failed_.fetch_add(batch_.size(), std::memory_order_relaxed);
+        if (!export_failing_) {
+            spdlog::warn("Trace export to {} failed: {}; dropping spans until it recovers", options_.otlp_endpoint,
+                         error);
+        }
+        export_failing_ = true;
+    }
+    batch_.clear();
+}
+
+TracerStats Tracer::GetStats() const {
+    TracerStats stats;
+    for (const SpanRing* ring : shared_->Rings()) {
+        stats.spans_recorded += ring->pushed();
+        stats.spans_dropped_buffer_full += ring->dropped();
+    }
+    stats.spans_dropped_pending_full = dropped_pending_full_.load(std::memory_order_relaxed);
+    stats.spans_dropped_export_failed = dropped_export_failed_.load(std::memory_order_relaxed);
+    stats.spans_exported = exported_.load(std::memory_order_relaxed);
+    stats.traces_kept_error = kept_error_.load(std::memory_order_relaxed);
+    stats.traces_kept_slow = kept_slow_.load(std::memory_order_relaxed);
+    stats.traces_kept_sampled = kept_sampled_.load(std::memory_order_relaxed);
+    stats.traces_discarded = discarded_.load(std::memory_order_relaxed);
+    stats.pending_spans = pending_gauge_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+namespace {
+
+using grpc::experimental::InterceptionHookPoints;
+
+class TracingInterceptor final : public grpc::experimental::Interceptor {
+public:
+    TracingInterceptor(Tracer& tracer, grpc::experimental::ServerRpcInfo* info)
+        : tracer_(tracer), server_context_(info->server_context()), start_(std::chrono::steady_clock::now()) {
+        record_.kind = SpanKind::kServer;
+        record_.start_unix_ns = UnixNowNs();
+        record_.name = tracer.Intern(info->method() != nullptr ? info->method() : "");
+        record_.span_id = NewSpanId();
+    }
+
+    ~TracingInterceptor() override {
+        if (record_.trace_id == TraceId{}) { // the call ended before its metadata arrived
+            record_.trace_id = NewTraceId();
+            record_.local_root = true;
+        }
+        record_.code = static_cast<uint8_t>(code_);
+        record_.end_unix_ns = record_.start_unix_ns + ElapsedNs(start_);
+        tracer_.Record(record_);
+    }
+
+    void Intercept(grpc::experimental::InterceptorBatchMethods* methods) override {
+        if (methods->QueryInterceptionHookPoint(InterceptionHookPoints::POST_RECV_INITIAL_METADATA)) {
+            Begin(methods->GetRecvInitialMetadata());
+        }
+        if (methods->QueryInterceptionHookPoint(InterceptionHookPoints::PRE_SEND_STATUS)) {
+            code_ = methods->GetSendStatus().error_code();
+        }
+        methods->Proceed();
+    }
+
+private:
+    void Begin(const std::multimap<grpc::string_ref, grpc::string_ref>* metadata) {
+        TraceContext parent;
+        bool continued = false;
+        if (metadata != nullptr) {
+            auto it = metadata->find(grpc::string_ref(kTraceparentHeader.data(), kTraceparentHeader.size()));
+            if (it != metadata->end()) {
+                continued = ParseTraceparent(std::string_view(it->second.data(), it->second.size()), &parent);
+            }
+        }
+        if (continued) {
+            record_.trace_id = parent.trace_id;
+            record_.parent_span_id = parent.span_id;
+            flags_ = parent.flags;
+            // An in-process self-call's caller is in this process too, and its root decides for the trace.
+            record_.local_root = TransportOfPeer(server_context_->peer()) != Transport::kInProcess;
+        } else {
+            record_.trace_id = NewTraceId();
+            record_.local_root = true;
+        }
+        if (CallContext* call = FindCallContext(server_context_)) {
+            call->set_trace(&tracer_, TraceContext{record_.trace_id, record_.span_id, flags_});
+        }
+    }
+
+    Tracer& tracer_;
+    const grpc::ServerContextBase* server_context_;
+    const std::chrono::steady_clock::time_point start_;
+    SpanRecord record_;
+    uint8_t flags_ = 0;
+    grpc::StatusCode code_ = grpc::StatusCode::CANCELLED; // until a status is sent
+};
+
+} // namespace
+
+grpc::experimental::Interceptor* TracingInterceptorFactory::CreateServerInterceptor(
+    grpc::experimental::ServerRpcInfo* info) {
+    return new TracingInterceptor(tracer_, info);
+}
+
+ClientSpan TraceOutbound(const grpc::ServerContextBase* ctx, grpc::ClientContext* client, std::string_view method) {
+    const CallContext* call = ctx != nullptr ? FindCallContext(ctx) : nullptr;
+    if (call == nullptr || call->tracer() == nullptr) return {};
+    return call->tracer()->StartClientSpan(&call->trace(), client, method);
+}
+
+TraceContext CallTraceContext(const grpc::ServerContextBase* ctx) {
+    const CallContext* call = FindCallContext(ctx);
+    return call != nullptr ? call->trace() : TraceContext{};
+}
+
+} // namespace prodstarter
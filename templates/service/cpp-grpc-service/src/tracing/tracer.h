@@ -0,0 +1,213 @@
+// ProdStarterHub - C++ gRPC Service
+// src/tracing/tracer.h
+// Distributed tracing with tail-based sampling, cheap enough to leave on.
+//
+// Head sampling decides when a call starts, before anyone knows whether it
+// will be slow or fail, and the usual SDK pays for building every span it
+// might keep. Here every call is recorded, and the decision is taken once the
+// trace's first span in this process has finished:
+//
+//   error    any span of the trace failed (see SpanFailed())          kept
+//   slow     the local root took at least --trace-slow-ms             kept
+//   sampled  the trace id falls within --trace-sample-rate            kept
+//   else                                                              discarded
+//
+// The ratio is taken from the random half of the trace id, so services with
+// the same rate keep the same traces and sampled traces stay whole.
+//
+// Recording a span costs two ids from a thread-local generator, a few clock
+// reads and one SpanRecord copied into the calling thread's SpanRing
+// (tracing/span_buffer.h). The exporter thread drains the rings, groups the
+// spans by trace until the local root arrives, decides, and sends the kept
+// spans to the collector in batches (tracing/otlp_exporter.h). Spans of
+// traces whose root never arrives are decided on their own after a timeout.
+// Everything that cannot keep up is dropped and counted, never waited for.
+//
+// TracingInterceptorFactory opens a server span for every call. It continues
+// the caller's trace from its traceparent header and stores the call's trace
+// context on its CallContext, so it must come after the call-context
+// interceptor. Handlers propagate it into outbound calls like the deadline:
+//
+//   grpc::ClientContext downstream;
+//   auto link = prodstarter::CallCancellation(ctx).Propagate(&downstream);
+//   prodstarter::ClientSpan span = prodstarter::TraceOutbound(ctx, &downstream, "/myproto.Downstream/Get");
+//   grpc::Status status = stub->Get(&downstream, request, &response);
+//   span.End(status);
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <grpcpp/client_context.h>
+#include <grpcpp/server_context.h>
+#include <grpcpp/support/server_interceptor.h>
+#include <grpcpp/support/status.h>
+
+#include "tracing/span_buffer.h"
+#include "tracing/trace_context.h"
+
+namespace prodstarter {
+
+class OtlpExporter;
+class Tracer;
+
+struct TracerOptions {
+    std::string service_name = "cpp-grpc-service"; // service.name resource attribute
+    std::string otlp_endpoint;                      // host:port of an OTLP/gRPC collector
+    double sample_rate = 0.01;                      // share of traces kept that are neither slow nor failed
+    std::chrono::milliseconds slow_threshold{500};  // local roots at least this slow are always kept
+    std::chrono::milliseconds export_interval{1000}; // kept spans are sent at least this often
+};
+
+struct TracerStats {
+    uint64_t spans_recorded = 0;
+    uint64_t spans_dropped_buffer_full = 0; // the thread's ring was full
+    uint64_t spans_dropped_pending_full = 0; // too many spans waiting for their trace's root
+    uint64_t spans_dropped_export_failed = 0;
+    uint64_t spans_exported = 0;
+    uint64_t traces_kept_error = 0;
+    uint64_t traces_kept_slow = 0;
+    uint64_t traces_kept_sampled = 0;
+    uint64_t traces_discarded = 0;
+    uint64_t pending_spans = 0; // waiting for a decision
+};
+
+// An outbound call's span. Records itself when End() is called or, with CANCELLED, when destroyed before that.
+class ClientSpan {
+public:
+    ClientSpan() = default; // records nothing
+    ClientSpan(ClientSpan&& other) noexcept;
+    ClientSpan& operator=(ClientSpan&& other) noexcept;
+    ~ClientSpan();
+
+    void End(const grpc::Status& status) { End(status.error_code()); }
+    void End(grpc::StatusCode code);
+
+    // The context sent downstream: the trace and this span's id.
+    TraceContext context() const { return {record_.trace_id, record_.span_id, flags_}; }
+    explicit operator bool() const { return tracer_ != nullptr; }
+
+private:
+    friend class Tracer;
+
+    Tracer* tracer_ = nullptr;
+    SpanRecord record_;
+    uint8_t flags_ = 0;
+    std::chrono::steady_clock::time_point start_;
+};
+
+class Tracer {
+public:
+    static constexpr size_t kMaxSpanNames = 1024;     // beyond this, spans are named "other"
+    static constexpr size_t kMaxPendingSpans = 65536; // spans waiting for their trace's root
+    static constexpr size_t kMaxBatchSpans = 512;
+    static constexpr auto kDrainInterval = std::chrono::milliseconds(50);
+    static constexpr auto kOrphanTimeout = std::chrono::seconds(30); // a root that is this late is not coming
+    static constexpr auto kLateSpanWindow = std::chrono::seconds(10); // spans ending after a kept root still go
+
+    explicit Tracer(TracerOptions options);
+    ~Tracer();
+
+    Tracer(const Tracer&) = delete;
+    Tracer& operator=(const Tracer&) = delete;
+
+    // Starts the exporter thread.
+    void Start();
+    // Decides every pending trace, sends what is kept and stops the thread. Spans finished later are not sent.
+    void Stop();
+
+    // Starts a client span below `parent` (a new trace when it is null or invalid, e.g. for background work) and
+    // adds its traceparent to `client`'s metadata.
+    ClientSpan StartClientSpan(const TraceContext* parent, grpc::ClientContext* client, std::string_view method);
+
+    // Hands a finished span to the exporter; lock-free, drops it when the calling thread's ring is full.
+    void Record(const SpanRecord& span);
+
+    // Id of a span name for SpanRecord::name. Cached per thread after the first lookup.
+    uint32_t Intern(std::string_view name);
+
+    TracerStats GetStats() const;
+    const TracerOptions& options() const { return options_; }
+
+private:
+    struct Shared;
+    struct ThreadState;
+    struct Pending {
+        std::vector<SpanRecord> spans;
+        std::chrono::steady_clock::time_point first_seen;
+    };
+    struct TraceIdHash {
+        size_t operator()(const TraceId& id) const { return static_cast<size_t>(TraceIdRandom(id)); }
+    };
+    enum class Decision { kError, kSlow, kSampled, kDiscard };
+
+    static ThreadState& LocalState();
+    ThreadState& BoundState(); // the calling thread's state, switched over to this tracer
+
+    void Run();
+    void Drain(std::chrono::steady_clock::time_point now);
+    void Admit(const SpanRecord& span, std::chrono::steady_clock::time_point now);
+    Decision Decide(const std::vector<SpanRecord>& spans, const SpanRecord* root) const;
+    void Settle(const TraceId& trace, std::vector<SpanRecord> spans, const SpanRecord* root,
+                std::chrono::steady_clock::time_point now);
+    void ExpireOrphans(std::chrono::steady_clock::time_point now, bool all);
+    void Flush();
+
+    const TracerOptions options_;
+    const uint64_t sample_below_; // trace ids whose random half is below this are sampled
+    const bool sample_all_;
+    std::shared_ptr<Shared> shared_; // rings and names; shared with thread-local state that may outlive this object
+    std::unique_ptr<OtlpExporter> exporter_;
+
+    // Exporter thread state.
+    std::unordered_map<TraceId, Pending, TraceIdHash> pending_;
+    size_t pending_spans_ = 0;
+    std::unordered_map<TraceId, std::chrono::steady_clock::time_point, TraceIdHash> kept_; // recently kept traces
+    std::vector<SpanRecord> batch_;
+    std::chrono::steady_clock::time_point last_flush_;
+    bool export_failing_ = false;
+
+    std::atomic<uint64_t> dropped_pending_full_{0};
+    std::atomic<uint64_t> dropped_export_failed_{0};
+    std::atomic<uint64_t> exported_{0};
+    std::atomic<uint64_t> kept_error_{0};
+    std::atomic<uint64_t> kept_slow_{0};
+    std::atomic<uint64_t> kept_sampled_{0};
+    std::atomic<uint64_t> discarded_{0};
+    std::atomic<uint64_t> pending_gauge_{0};
+
+    std::mutex mu_;
+    std::condition_variable cv_;
+    bool stopping_ = false;
+    std::thread thread_;
+};
+
+// Opens a server span per call and publishes the call's trace context on its CallContext.
+class TracingInterceptorFactory : public grpc::experimental::ServerInterceptorFactoryInterface {
+public:
+    explicit TracingInterceptorFactory(Tracer& tracer) : tracer_(tracer) {}
+
+    grpc::experimental::Interceptor* CreateServerInterceptor(grpc::experimental::ServerRpcInfo* info) override;
+
+private:
+    Tracer& tracer_;
+};
+
+// Client span for an outbound call made while serving `ctx`; records nothing when the call is not traced.
+ClientSpan TraceOutbound(const grpc::ServerContextBase* ctx, grpc::ClientContext* client, std::string_view method);
+
+// Trace context of the call behind `ctx` (its trace and server span id); invalid when it is not traced. Handy for
+// trace_id fields in log lines.
+TraceContext CallTraceContext(const grpc::ServerContextBase* ctx);
+
+} // namespace prodstarter